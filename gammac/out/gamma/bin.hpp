@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2017 Cyril Deguet <cyril.deguet@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+// Runtime support for the Bin trait: values are stored in little-endian
+// order, with the size of their in-memory representation
+namespace gm
+{
+
+constexpr bool kLittleEndian = __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__;
+
+template <size_t Size>
+struct UInt;
+
+template <>
+struct UInt<1>
+{
+    typedef uint8_t type;
+};
+
+template <>
+struct UInt<2>
+{
+    typedef uint16_t type;
+};
+
+template <>
+struct UInt<4>
+{
+    typedef uint32_t type;
+};
+
+template <>
+struct UInt<8>
+{
+    typedef uint64_t type;
+};
+
+template <typename T>
+inline void store(uint8_t *out, T value)
+{
+    if (kLittleEndian)
+    {
+        std::memcpy(out, &value, sizeof(T));
+        return;
+    }
+    typename UInt<sizeof(T)>::type bits;
+    std::memcpy(&bits, &value, sizeof(T));
+    for (size_t i = 0; i < sizeof(T); i++)
+    {
+        out[i] = static_cast<uint8_t>(bits >> (8 * i));
+    }
+}
+
+template <typename T>
+inline T load(const uint8_t *in)
+{
+    T value;
+    if (kLittleEndian)
+    {
+        std::memcpy(&value, in, sizeof(T));
+        return value;
+    }
+    typename UInt<sizeof(T)>::type bits = 0;
+    for (size_t i = 0; i < sizeof(T); i++)
+    {
+        bits |= static_cast<typename UInt<sizeof(T)>::type>(in[i]) << (8 * i);
+    }
+    std::memcpy(&value, &bits, sizeof(T));
+    return value;
+}
+
+// Decoded enums and bools are checked, as other values of their types are
+// undefined
+inline int32_t loadEnum(const uint8_t *in, int32_t count)
+{
+    int32_t value = load<int32_t>(in);
+    if (value < 0 || value >= count)
+    {
+        throw std::runtime_error("Invalid enum value");
+    }
+    return value;
+}
+
+inline bool loadBool(const uint8_t *in)
+{
+    uint8_t value = load<uint8_t>(in);
+    if (value > 1)
+    {
+        throw std::runtime_error("Invalid bool value");
+    }
+    return value != 0;
+}
+
+// A stream of encoded values starts with the fingerprint of their schema
+inline void encodeFingerprint(uint8_t *&out, uint64_t fingerprint)
+{
+    store(out, fingerprint);
+    out += sizeof(fingerprint);
+}
+
+inline void decodeFingerprint(const uint8_t *&in, uint64_t fingerprint)
+{
+    if (load<uint64_t>(in) != fingerprint)
+    {
+        throw std::runtime_error("Schema fingerprint mismatch");
+    }
+    in += sizeof(fingerprint);
+}
+
+} // namespace gm
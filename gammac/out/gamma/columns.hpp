@@ -0,0 +1,228 @@
+/*
+ * Copyright (C) 2017 Cyril Deguet <cyril.deguet@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "gamma/bin.hpp"
+
+// Runtime support for the Columns trait. A column file starts with a header
+// (magic, schema fingerprint, field count), followed by chunks of records.
+// Each chunk has a header (chunk size, record count, offset of each column
+// from the chunk start), followed by one column per field, which holds the
+// Bin encoding of that field for all the records of the chunk. Chunks and
+// columns are aligned on 8 bytes, so that a mapped file can be read in place.
+namespace gm
+{
+
+static const char kColumnMagic[8] = {'G', 'M', 'C', 'O', 'L', 'U', 'M', 'N'};
+static const size_t kColumnFileHeaderSize = 24;
+static const size_t kColumnAlign = 8;
+
+inline size_t alignColumn(size_t offset)
+{
+    return (offset + kColumnAlign - 1) & ~(kColumnAlign - 1);
+}
+
+class ColumnWriter
+{
+  public:
+    // Creates the file, or adds chunks at the end of an existing file with
+    // the same schema when append is set
+    ColumnWriter(const std::string &path, uint64_t fingerprint, size_t fieldCount, bool append = false)
+        : fieldCount(fieldCount)
+    {
+        file = std::fopen(path.c_str(), append ? "a+b" : "wb");
+        if (!file)
+        {
+            throw std::runtime_error("Cannot open " + path);
+        }
+        uint8_t header[kColumnFileHeaderSize];
+        std::fseek(file, 0, SEEK_END);
+        if (std::ftell(file) > 0)
+        {
+            std::fseek(file, 0, SEEK_SET);
+            if (std::fread(header, 1, sizeof(header), file) != sizeof(header) ||
+                std::memcmp(header, kColumnMagic, sizeof(kColumnMagic)) != 0 ||
+                load<uint64_t>(header + 8) != fingerprint || load<uint64_t>(header + 16) != fieldCount)
+            {
+                std::fclose(file);
+                throw std::runtime_error("Schema mismatch in " + path);
+            }
+            std::fseek(file, 0, SEEK_END);
+            return;
+        }
+        std::memcpy(header, kColumnMagic, sizeof(kColumnMagic));
+        store<uint64_t>(header + 8, fingerprint);
+        store<uint64_t>(header + 16, fieldCount);
+        write(header, sizeof(header));
+    }
+
+    ~ColumnWriter()
+    {
+        std::fclose(file);
+    }
+
+    ColumnWriter(const ColumnWriter &) = delete;
+    ColumnWriter &operator=(const ColumnWriter &) = delete;
+
+    // Prepares a chunk of count records, given the encoded size of each field
+    void beginChunk(size_t count, const size_t *fieldSizes)
+    {
+        offsets.resize(fieldCount);
+        size_t offset = 16 + 8 * fieldCount;
+        for (size_t i = 0; i < fieldCount; i++)
+        {
+            offset = alignColumn(offset);
+            offsets[i] = offset;
+            offset += count * fieldSizes[i];
+        }
+        offset = alignColumn(offset);
+        buffer.assign(offset, 0);
+        store<uint64_t>(buffer.data(), offset);
+        store<uint64_t>(buffer.data() + 8, count);
+        for (size_t i = 0; i < fieldCount; i++)
+        {
+            store<uint64_t>(buffer.data() + 16 + 8 * i, offsets[i]);
+        }
+    }
+
+    uint8_t *column(size_t field)
+    {
+        return buffer.data() + offsets[field];
+    }
+
+    void endChunk()
+    {
+        write(buffer.data(), buffer.size());
+    }
+
+  private:
+    void write(const uint8_t *data, size_t size)
+    {
+        if (std::fwrite(data, 1, size, file) != size || std::fflush(file) != 0)
+        {
+            throw std::runtime_error("Cannot write column file");
+        }
+    }
+
+    std::FILE *file;
+    size_t fieldCount;
+    std::vector<size_t> offsets;
+    std::vector<uint8_t> buffer;
+};
+
+struct ColumnChunk
+{
+    explicit ColumnChunk(const uint8_t *data) noexcept : data(data) {}
+    size_t size() const noexcept { return load<uint64_t>(data + 8); }
+    const uint8_t *column(size_t field) const noexcept { return data + load<uint64_t>(data + 16 + 8 * field); }
+
+    const uint8_t *data;
+};
+
+// Maps a column file in memory; the chunks are read in place, after checking
+// that their columns fit in them, given the encoded size of each field
+class ColumnReader
+{
+  public:
+    ColumnReader(const std::string &path, uint64_t fingerprint, size_t fieldCount, const size_t *fieldSizes)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw std::runtime_error("Cannot open " + path);
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < kColumnFileHeaderSize)
+        {
+            ::close(fd);
+            throw std::runtime_error("Invalid column file " + path);
+        }
+        mapSize = st.st_size;
+        void *map = ::mmap(nullptr, mapSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED)
+        {
+            throw std::runtime_error("Cannot map " + path);
+        }
+        data = static_cast<const uint8_t *>(map);
+        if (std::memcmp(data, kColumnMagic, sizeof(kColumnMagic)) != 0 ||
+            load<uint64_t>(data + 8) != fingerprint || load<uint64_t>(data + 16) != fieldCount)
+        {
+            ::munmap(map, mapSize);
+            throw std::runtime_error("Schema mismatch in " + path);
+        }
+        size_t offset = kColumnFileHeaderSize;
+        while (offset < mapSize)
+        {
+            size_t chunkSize = load<uint64_t>(data + offset);
+            if (chunkSize < 16 + 8 * fieldCount || chunkSize > mapSize - offset ||
+                !checkColumns(data + offset, chunkSize, fieldCount, fieldSizes))
+            {
+                ::munmap(map, mapSize);
+                throw std::runtime_error("Invalid chunk in " + path);
+            }
+            chunks.push_back(ColumnChunk(data + offset));
+            recordCount += chunks.back().size();
+            offset += chunkSize;
+        }
+    }
+
+    ~ColumnReader()
+    {
+        ::munmap(const_cast<uint8_t *>(data), mapSize);
+    }
+
+    ColumnReader(const ColumnReader &) = delete;
+    ColumnReader &operator=(const ColumnReader &) = delete;
+
+    size_t chunkCount() const noexcept { return chunks.size(); }
+    ColumnChunk chunk(size_t index) const noexcept { return chunks[index]; }
+    size_t size() const noexcept { return recordCount; }
+
+  private:
+    static bool checkColumns(const uint8_t *chunk, size_t chunkSize, size_t fieldCount, const size_t *fieldSizes)
+    {
+        uint64_t count = load<uint64_t>(chunk + 8);
+        for (size_t i = 0; i < fieldCount; i++)
+        {
+            uint64_t offset = load<uint64_t>(chunk + 16 + 8 * i);
+            if (offset < 16 + 8 * fieldCount || offset > chunkSize ||
+                (fieldSizes[i] > 0 && count > (chunkSize - offset) / fieldSizes[i]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const uint8_t *data;
+    size_t mapSize;
+    size_t recordCount = 0;
+    std::vector<ColumnChunk> chunks;
+};
+
+} // namespace gm
@@ -0,0 +1,323 @@
+/*
+ * Copyright (C) 2017 Cyril Deguet <cyril.deguet@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Container types of the fields
+namespace gm
+{
+
+// Exactly N values, stored inline. It is an aggregate, trivially copyable
+// when T is.
+template <typename T, size_t N>
+struct Array
+{
+    T items[N];
+
+    static constexpr size_t size()
+    {
+        return N;
+    }
+
+    T &operator[](size_t i)
+    {
+        return items[i];
+    }
+
+    const T &operator[](size_t i) const
+    {
+        return items[i];
+    }
+
+    T *begin()
+    {
+        return items;
+    }
+
+    T *end()
+    {
+        return items + N;
+    }
+
+    const T *begin() const
+    {
+        return items;
+    }
+
+    const T *end() const
+    {
+        return items + N;
+    }
+};
+
+// Up to N values, stored inline with their count, so that it never
+// allocates. It is trivially copyable when T is; growing it beyond its
+// capacity throws std::length_error.
+template <typename T, size_t N>
+class SmallVec
+{
+  public:
+    typedef typename std::conditional<
+        N < 256, uint8_t, typename std::conditional<N < 65536, uint16_t, uint32_t>::type>::type SizeType;
+
+    constexpr SmallVec() : items(), count(0) {}
+
+    SmallVec(std::initializer_list<T> values) : items(), count(0)
+    {
+        for (const auto &value : values)
+        {
+            push_back(value);
+        }
+    }
+
+    size_t size() const
+    {
+        return count;
+    }
+
+    static constexpr size_t capacity()
+    {
+        return N;
+    }
+
+    bool empty() const
+    {
+        return count == 0;
+    }
+
+    T &operator[](size_t i)
+    {
+        return items[i];
+    }
+
+    const T &operator[](size_t i) const
+    {
+        return items[i];
+    }
+
+    T *begin()
+    {
+        return items;
+    }
+
+    T *end()
+    {
+        return items + count;
+    }
+
+    const T *begin() const
+    {
+        return items;
+    }
+
+    const T *end() const
+    {
+        return items + count;
+    }
+
+    void push_back(const T &value)
+    {
+        if (count == N)
+        {
+            throw std::length_error("SmallVec: capacity exceeded");
+        }
+        items[count++] = value;
+    }
+
+    void pop_back()
+    {
+        items[--count] = T();
+    }
+
+    // The values beyond the size are reset, so that two vectors with the same
+    // values have the same bytes
+    void resize(size_t size)
+    {
+        if (size > N)
+        {
+            throw std::length_error("SmallVec: capacity exceeded");
+        }
+        for (size_t i = size; i < count; i++)
+        {
+            items[i] = T();
+        }
+        count = static_cast<SizeType>(size);
+    }
+
+    void clear()
+    {
+        resize(0);
+    }
+
+  private:
+    T items[N];
+    SizeType count;
+};
+
+// Any number of values on the heap
+template <typename T>
+class Vec : public std::vector<T>
+{
+  public:
+    using std::vector<T>::vector;
+};
+
+// Up to N characters stored inline with their length, for short names. It is
+// trivially copyable, and the characters beyond the length are zero, so that
+// equal strings have the same bytes.
+template <size_t N>
+class Str
+{
+    static_assert(N > 0 && N < 256, "Str: the length must fit in a byte");
+
+  public:
+    constexpr Str() : length(0), chars() {}
+
+    Str(const char *text) : Str()
+    {
+        assign(text, std::strlen(text));
+    }
+
+    Str(const char *text, size_t size) : Str()
+    {
+        assign(text, size);
+    }
+
+    Str(const std::string &text) : Str()
+    {
+        assign(text.data(), text.size());
+    }
+
+    void assign(const char *text, size_t size)
+    {
+        if (size > N)
+        {
+            throw std::length_error("Str: capacity exceeded");
+        }
+        std::memmove(chars, text, size);
+        std::memset(chars + size, 0, N - size);
+        length = static_cast<uint8_t>(size);
+    }
+
+    size_t size() const
+    {
+        return length;
+    }
+
+    static constexpr size_t capacity()
+    {
+        return N;
+    }
+
+    bool empty() const
+    {
+        return length == 0;
+    }
+
+    const char *data() const
+    {
+        return chars;
+    }
+
+    const char *begin() const
+    {
+        return chars;
+    }
+
+    const char *end() const
+    {
+        return chars + length;
+    }
+
+    char operator[](size_t i) const
+    {
+        return chars[i];
+    }
+
+    std::string str() const
+    {
+        return std::string(chars, length);
+    }
+
+    // The whole buffer is compared, which takes a fixed number of
+    // instructions
+    bool operator==(const Str &other) const
+    {
+        return length == other.length && std::memcmp(chars, other.chars, N) == 0;
+    }
+
+    bool operator!=(const Str &other) const
+    {
+        return !(*this == other);
+    }
+
+  private:
+    uint8_t length;
+    char chars[N];
+};
+
+template <typename T, size_t N>
+inline bool operator==(const Array<T, N> &a, const Array<T, N> &b)
+{
+    for (size_t i = 0; i < N; i++)
+    {
+        if (!(a[i] == b[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename T, size_t N>
+inline bool operator!=(const Array<T, N> &a, const Array<T, N> &b)
+{
+    return !(a == b);
+}
+
+template <typename T, size_t N>
+inline bool operator==(const SmallVec<T, N> &a, const SmallVec<T, N> &b)
+{
+    if (a.size() != b.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        if (!(a[i] == b[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename T, size_t N>
+inline bool operator!=(const SmallVec<T, N> &a, const SmallVec<T, N> &b)
+{
+    return !(a == b);
+}
+
+} // namespace gm
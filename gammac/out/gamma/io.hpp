@@ -0,0 +1,295 @@
+/*
+ * Copyright (C) 2017 Cyril Deguet <cyril.deguet@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "gamma/out.hpp"
+#include "gamma/text.hpp"
+
+// Buffered text input and output on file descriptors, used instead of the
+// standard streams to avoid their synchronization and flushing costs. The
+// overloads for the containers, optionals and symbols are in the io_*.hpp
+// headers.
+namespace gm
+{
+
+// Reads its input in large chunks, with a single read per refill. Only
+// complete tokens are visible to the parser: a value cut by the end of the
+// buffer is parsed again once more input is available.
+class InputBuffer
+{
+  public:
+    explicit InputBuffer(int fd = 0, size_t capacity = 1 << 16)
+        : fd(fd), data(capacity), size(0), eof(false), cur(nullptr), end(nullptr)
+    {
+    }
+
+    InputBuffer(const InputBuffer &) = delete;
+    InputBuffer &operator=(const InputBuffer &) = delete;
+
+    template <typename T>
+    InputBuffer &operator>>(T &value);
+
+    // Returns false if only whitespace is left until the end of the input
+    bool more()
+    {
+        for (;;)
+        {
+            text::skipSpace(cur, end);
+            if (cur != end)
+            {
+                return true;
+            }
+            if (!refill())
+            {
+                return false;
+            }
+        }
+    }
+
+    // Reads more input, keeping the characters not parsed yet; returns false
+    // at the end of the input
+    bool refill()
+    {
+        if (eof)
+        {
+            return false;
+        }
+        size_t offset = cur ? cur - data.data() : 0;
+        size -= offset;
+        std::memmove(data.data(), data.data() + offset, size);
+        if (size == data.size())
+        {
+            data.resize(data.size() * 2);
+        }
+        ssize_t count;
+        do
+        {
+            count = ::read(fd, data.data() + size, data.size() - size);
+        } while (count < 0 && errno == EINTR);
+        if (count < 0)
+        {
+            throw std::runtime_error("InputBuffer: read failed");
+        }
+        if (count == 0)
+        {
+            eof = true;
+        }
+        size += count;
+        cur = data.data();
+        end = cur + size;
+        while (!eof && end != cur && !text::isSpace(end[-1]))
+        {
+            end--;
+        }
+        return true;
+    }
+
+  private:
+    int fd;
+    std::vector<char> data;
+    size_t size;
+    bool eof;
+
+  public:
+    const char *cur;
+    const char *end;
+};
+
+// Accumulates its output in memory until flush() is called, typically once
+// per turn
+class OutputBuffer
+{
+  public:
+    explicit OutputBuffer(int fd = 1) : fd(fd) {}
+
+    OutputBuffer(const OutputBuffer &) = delete;
+    OutputBuffer &operator=(const OutputBuffer &) = delete;
+
+    ~OutputBuffer()
+    {
+        try
+        {
+            flush();
+        }
+        catch (const std::runtime_error &)
+        {
+        }
+    }
+
+    template <typename T>
+    OutputBuffer &operator<<(const T &value);
+
+    void append(const char *text, size_t length)
+    {
+        buffer.append(text, length);
+    }
+
+    void put(char c)
+    {
+        buffer.push_back(c);
+    }
+
+    const std::string &str() const
+    {
+        return buffer;
+    }
+
+    void flush()
+    {
+        const char *cur = buffer.data();
+        size_t left = buffer.size();
+        while (left > 0)
+        {
+            ssize_t count = ::write(fd, cur, left);
+            if (count < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (count < 0)
+            {
+                buffer.clear();
+                throw std::runtime_error("OutputBuffer: write failed");
+            }
+            cur += count;
+            left -= count;
+        }
+        buffer.clear();
+    }
+
+  private:
+    int fd;
+    std::string buffer;
+};
+
+// Writes a decimal integer; smaller integer types are promoted to int
+template <typename T>
+inline void writeInteger(OutputBuffer &out, T value)
+{
+    char buf[21];
+    char *cur = buf + sizeof(buf);
+    uint64_t n = static_cast<uint64_t>(value);
+    bool negative = std::numeric_limits<T>::is_signed && static_cast<int64_t>(n) < 0;
+    if (negative)
+    {
+        n = 0 - n;
+    }
+    do
+    {
+        *--cur = '0' + n % 10;
+        n /= 10;
+    } while (n != 0);
+    if (negative)
+    {
+        *--cur = '-';
+    }
+    out.append(cur, buf + sizeof(buf) - cur);
+}
+
+inline void writeText(OutputBuffer &out, int value)
+{
+    writeInteger(out, value);
+}
+
+inline void writeText(OutputBuffer &out, unsigned int value)
+{
+    writeInteger(out, value);
+}
+
+inline void writeText(OutputBuffer &out, int64_t value)
+{
+    writeInteger(out, value);
+}
+
+inline void writeText(OutputBuffer &out, uint64_t value)
+{
+    writeInteger(out, value);
+}
+
+inline void writeText(OutputBuffer &out, bool value)
+{
+    out.put(value ? '1' : '0');
+}
+
+inline void writeText(OutputBuffer &out, char value)
+{
+    out.put(value);
+}
+
+// Same output as the default formatting of std::ostream
+inline void writeText(OutputBuffer &out, double value)
+{
+    char buf[32];
+    int length = std::snprintf(buf, sizeof(buf), "%g", value);
+    out.append(buf, length);
+}
+
+inline void writeText(OutputBuffer &out, float value)
+{
+    writeText(out, static_cast<double>(value));
+}
+
+inline void writeText(OutputBuffer &out, const char *value)
+{
+    out.append(value, std::strlen(value));
+}
+
+inline void writeText(OutputBuffer &out, const std::string &value)
+{
+    out.append(value.data(), value.size());
+}
+
+template <typename T>
+InputBuffer &InputBuffer::operator>>(T &value)
+{
+    for (;;)
+    {
+        const char *start = cur;
+        try
+        {
+            readText(cur, end, value);
+            return *this;
+        }
+        catch (const text::EndOfInput &)
+        {
+            cur = start;
+            if (!refill())
+            {
+                throw;
+            }
+        }
+    }
+}
+
+template <typename T>
+OutputBuffer &OutputBuffer::operator<<(const T &value)
+{
+    writeText(*this, value);
+    return *this;
+}
+
+} // namespace gm
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2017 Cyril Deguet <cyril.deguet@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "gamma/containers.hpp"
+#include "gamma/io.hpp"
+
+// Buffered output of the containers and fixed-size strings
+namespace gm
+{
+
+template <size_t N>
+inline void writeText(OutputBuffer &out, const Str<N> &value)
+{
+    out.append(value.data(), value.size());
+}
+
+// Containers are written as to the standard streams
+template <typename T, size_t N>
+inline void writeText(OutputBuffer &out, const Array<T, N> &value)
+{
+    writeItems(out, value, false);
+}
+
+template <typename T, size_t N>
+inline void writeText(OutputBuffer &out, const SmallVec<T, N> &value)
+{
+    writeItems(out, value, true);
+}
+
+template <typename T>
+inline void writeText(OutputBuffer &out, const Vec<T> &value)
+{
+    writeItems(out, value, true);
+}
+
+} // namespace gm
@@ -0,0 +1,34 @@
+/*
+ * Copyright (C) 2017 Cyril Deguet <cyril.deguet@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "gamma/io.hpp"
+#include "gamma/optional.hpp"
+#include "gamma/out_optional.hpp"
+
+// Buffered output of the optionals
+namespace gm
+{
+
+// Optionals are written as to the standard streams
+template <typename T, typename Niche>
+inline void writeText(OutputBuffer &out, const Optional<T, Niche> &value)
+{
+    writeOptional(out, value);
+}
+
+} // namespace gm
@@ -0,0 +1,587 @@
+/*
+ * Copyright (C) 2017 Cyril Deguet <cyril.deguet@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+// Runtime support for the Json trait: builtin values are written to and
+// parsed from JSON text directly, without building a document tree. The
+// overloads for the containers, optionals and symbols are in the json_*.hpp
+// headers.
+namespace gm
+{
+
+inline void writeJson(std::string &out, bool value)
+{
+    out += value ? "true" : "false";
+}
+
+// Smaller integer types are promoted to int
+template <typename T>
+inline void writeJsonInteger(std::string &out, T value)
+{
+    char buf[21];
+    char *end = buf + sizeof(buf);
+    char *p = end;
+    uint64_t n = static_cast<uint64_t>(value);
+    bool negative = std::numeric_limits<T>::is_signed && static_cast<int64_t>(n) < 0;
+    if (negative)
+    {
+        n = 0 - n;
+    }
+    do
+    {
+        *--p = '0' + n % 10;
+        n /= 10;
+    } while (n != 0);
+    if (negative)
+    {
+        *--p = '-';
+    }
+    out.append(p, end - p);
+}
+
+inline void writeJson(std::string &out, int value)
+{
+    writeJsonInteger(out, value);
+}
+
+inline void writeJson(std::string &out, unsigned int value)
+{
+    writeJsonInteger(out, value);
+}
+
+inline void writeJson(std::string &out, int64_t value)
+{
+    writeJsonInteger(out, value);
+}
+
+inline void writeJson(std::string &out, uint64_t value)
+{
+    writeJsonInteger(out, value);
+}
+
+// JSON has no infinities or NaN: they are written as null, and read back as
+// NaN
+inline void writeJson(std::string &out, double value)
+{
+    if (!std::isfinite(value))
+    {
+        out += "null";
+        return;
+    }
+    char buf[32];
+    int length = std::snprintf(buf, sizeof(buf), "%.17g", value);
+    out.append(buf, length);
+}
+
+inline void writeJson(std::string &out, float value)
+{
+    if (!std::isfinite(value))
+    {
+        out += "null";
+        return;
+    }
+    char buf[32];
+    int length = std::snprintf(buf, sizeof(buf), "%.9g", value);
+    out.append(buf, length);
+}
+
+inline void writeJsonString(std::string &out, const char *str, size_t length)
+{
+    static const char kHex[] = "0123456789abcdef";
+    out += '"';
+    for (size_t i = 0; i < length; i++)
+    {
+        char c = str[i];
+        switch (c)
+        {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        case '\r':
+            out += "\\r";
+            break;
+        case '\t':
+            out += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                out += "\\u00";
+                out += kHex[c >> 4];
+                out += kHex[c & 0xf];
+            }
+            else
+            {
+                out += c;
+            }
+        }
+    }
+    out += '"';
+}
+
+inline void writeJson(std::string &out, char value)
+{
+    writeJsonString(out, &value, 1);
+}
+
+inline void writeJson(std::string &out, const std::string &value)
+{
+    writeJsonString(out, value.data(), value.size());
+}
+
+namespace json
+{
+
+inline void error(const char *message)
+{
+    throw std::runtime_error(std::string("JSON: ") + message);
+}
+
+inline void skipSpace(const char *&cur, const char *end)
+{
+    while (cur != end && (*cur == ' ' || *cur == '\t' || *cur == '\n' || *cur == '\r'))
+    {
+        cur++;
+    }
+}
+
+// Consumes c if it is the next character
+inline bool consume(const char *&cur, const char *end, char c)
+{
+    skipSpace(cur, end);
+    if (cur != end && *cur == c)
+    {
+        cur++;
+        return true;
+    }
+    return false;
+}
+
+inline void expect(const char *&cur, const char *end, char c)
+{
+    if (!consume(cur, end, c))
+    {
+        error("unexpected character");
+    }
+}
+
+inline bool consumeWord(const char *&cur, const char *end, const char *word, size_t length)
+{
+    skipSpace(cur, end);
+    if (static_cast<size_t>(end - cur) >= length && std::memcmp(cur, word, length) == 0)
+    {
+        cur += length;
+        return true;
+    }
+    return false;
+}
+
+inline bool consumeNull(const char *&cur, const char *end)
+{
+    return consumeWord(cur, end, "null", 4);
+}
+
+// Reads a string without escape sequences, such as a key or an enum format,
+// returning a pointer into the input
+inline void readRawString(const char *&cur, const char *end, const char *&str, size_t &length)
+{
+    expect(cur, end, '"');
+    str = cur;
+    while (cur != end && *cur != '"')
+    {
+        if (*cur == '\\')
+        {
+            error("unexpected escape sequence");
+        }
+        cur++;
+    }
+    if (cur == end)
+    {
+        error("unterminated string");
+    }
+    length = cur - str;
+    cur++;
+}
+
+inline void readKey(const char *&cur, const char *end, const char *&key, size_t &length)
+{
+    readRawString(cur, end, key, length);
+    expect(cur, end, ':');
+}
+
+// Moves to the next member of an object or element of an array, returning
+// false at the end of it
+inline bool next(const char *&cur, const char *end, char close)
+{
+    if (consume(cur, end, ','))
+    {
+        return true;
+    }
+    expect(cur, end, close);
+    return false;
+}
+
+inline void skipString(const char *&cur, const char *end)
+{
+    expect(cur, end, '"');
+    while (cur != end && *cur != '"')
+    {
+        // An escape sequence needs the escaped character
+        if (*cur == '\\' && ++cur == end)
+        {
+            break;
+        }
+        cur++;
+    }
+    if (cur == end)
+    {
+        error("unterminated string");
+    }
+    cur++;
+}
+
+inline void skipValue(const char *&cur, const char *end)
+{
+    skipSpace(cur, end);
+    if (cur == end)
+    {
+        error("unexpected end of input");
+    }
+    switch (*cur)
+    {
+    case '"':
+        skipString(cur, end);
+        break;
+    case '{':
+        cur++;
+        if (!consume(cur, end, '}'))
+        {
+            do
+            {
+                skipString(cur, end);
+                expect(cur, end, ':');
+                skipValue(cur, end);
+            } while (next(cur, end, '}'));
+        }
+        break;
+    case '[':
+        cur++;
+        if (!consume(cur, end, ']'))
+        {
+            do
+            {
+                skipValue(cur, end);
+            } while (next(cur, end, ']'));
+        }
+        break;
+    default:
+        while (cur != end && *cur != ',' && *cur != '}' && *cur != ']' && *cur != ' ' && *cur != '\n' &&
+               *cur != '\t' && *cur != '\r')
+        {
+            cur++;
+        }
+    }
+}
+
+// Reads an integer, which must fit in the type of the value
+template <typename T>
+inline void readInteger(const char *&cur, const char *end, T &value)
+{
+    skipSpace(cur, end);
+    bool negative = cur != end && *cur == '-';
+    if (negative)
+    {
+        cur++;
+    }
+    if (cur == end || *cur < '0' || *cur > '9')
+    {
+        error("expected an integer");
+    }
+    uint64_t limit = negative ? 0 - static_cast<uint64_t>(std::numeric_limits<T>::min())
+                              : static_cast<uint64_t>(std::numeric_limits<T>::max());
+    uint64_t n = 0;
+    while (cur != end && *cur >= '0' && *cur <= '9')
+    {
+        unsigned digit = *cur++ - '0';
+        if (digit > limit || n > (limit - digit) / 10)
+        {
+            error("integer out of range");
+        }
+        n = n * 10 + digit;
+    }
+    value = static_cast<T>(negative ? 0 - n : n);
+}
+
+// Reads the 4 hex digits following \u
+inline unsigned long readHex4(const char *&cur, const char *end)
+{
+    if (end - cur < 4 || !std::isxdigit(static_cast<unsigned char>(cur[0])) ||
+        !std::isxdigit(static_cast<unsigned char>(cur[1])) || !std::isxdigit(static_cast<unsigned char>(cur[2])) ||
+        !std::isxdigit(static_cast<unsigned char>(cur[3])))
+    {
+        error("invalid escape sequence");
+    }
+    char hex[5] = {cur[0], cur[1], cur[2], cur[3], '\0'};
+    cur += 4;
+    return std::strtoul(hex, nullptr, 16);
+}
+
+// Reads the code point of a \u escape sequence, whose \u is already read.
+// Characters outside the basic plane are a pair of UTF-16 surrogates, each
+// written as an escape sequence.
+inline unsigned long readCodePoint(const char *&cur, const char *end)
+{
+    unsigned long code = readHex4(cur, end);
+    if (code >= 0xdc00 && code <= 0xdfff)
+    {
+        error("unpaired surrogate");
+    }
+    if (code < 0xd800 || code > 0xdbff)
+    {
+        return code;
+    }
+    if (end - cur < 2 || cur[0] != '\\' || cur[1] != 'u')
+    {
+        error("unpaired surrogate");
+    }
+    cur += 2;
+    unsigned long low = readHex4(cur, end);
+    if (low < 0xdc00 || low > 0xdfff)
+    {
+        error("unpaired surrogate");
+    }
+    return 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+}
+
+inline void appendUtf8(std::string &out, unsigned long code)
+{
+    if (code < 0x80)
+    {
+        out += static_cast<char>(code);
+    }
+    else if (code < 0x800)
+    {
+        out += static_cast<char>(0xc0 | (code >> 6));
+        out += static_cast<char>(0x80 | (code & 0x3f));
+    }
+    else if (code < 0x10000)
+    {
+        out += static_cast<char>(0xe0 | (code >> 12));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+        out += static_cast<char>(0x80 | (code & 0x3f));
+    }
+    else
+    {
+        out += static_cast<char>(0xf0 | (code >> 18));
+        out += static_cast<char>(0x80 | ((code >> 12) & 0x3f));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+        out += static_cast<char>(0x80 | (code & 0x3f));
+    }
+}
+
+} // namespace json
+
+inline void readJson(const char *&cur, const char *end, bool &value)
+{
+    if (json::consumeWord(cur, end, "true", 4))
+    {
+        value = true;
+    }
+    else if (json::consumeWord(cur, end, "false", 5))
+    {
+        value = false;
+    }
+    else
+    {
+        json::error("expected a boolean");
+    }
+}
+
+inline void readJson(const char *&cur, const char *end, int &value)
+{
+    json::readInteger(cur, end, value);
+}
+
+inline void readJson(const char *&cur, const char *end, unsigned int &value)
+{
+    json::readInteger(cur, end, value);
+}
+
+inline void readJson(const char *&cur, const char *end, int8_t &value)
+{
+    json::readInteger(cur, end, value);
+}
+
+inline void readJson(const char *&cur, const char *end, uint8_t &value)
+{
+    json::readInteger(cur, end, value);
+}
+
+inline void readJson(const char *&cur, const char *end, int16_t &value)
+{
+    json::readInteger(cur, end, value);
+}
+
+inline void readJson(const char *&cur, const char *end, uint16_t &value)
+{
+    json::readInteger(cur, end, value);
+}
+
+inline void readJson(const char *&cur, const char *end, int64_t &value)
+{
+    json::readInteger(cur, end, value);
+}
+
+inline void readJson(const char *&cur, const char *end, uint64_t &value)
+{
+    json::readInteger(cur, end, value);
+}
+
+inline void readJson(const char *&cur, const char *end, double &value)
+{
+    json::skipSpace(cur, end);
+    if (json::consumeNull(cur, end))
+    {
+        value = std::numeric_limits<double>::quiet_NaN();
+        return;
+    }
+    char buf[64];
+    size_t length = 0;
+    while (cur + length != end && length < sizeof(buf) - 1 && cur[length] != '\0' && std::strchr("+-.0123456789eE", cur[length]))
+    {
+        buf[length] = cur[length];
+        length++;
+    }
+    buf[length] = '\0';
+    char *last;
+    value = std::strtod(buf, &last);
+    if (last == buf)
+    {
+        json::error("expected a number");
+    }
+    cur += last - buf;
+}
+
+inline void readJson(const char *&cur, const char *end, float &value)
+{
+    double number;
+    readJson(cur, end, number);
+    value = static_cast<float>(number);
+}
+
+inline void readJson(const char *&cur, const char *end, std::string &value)
+{
+    json::expect(cur, end, '"');
+    value.clear();
+    while (cur != end && *cur != '"')
+    {
+        if (*cur != '\\')
+        {
+            value += *cur++;
+            continue;
+        }
+        if (++cur == end)
+        {
+            break;
+        }
+        switch (*cur++)
+        {
+        case 'n':
+            value += '\n';
+            break;
+        case 'r':
+            value += '\r';
+            break;
+        case 't':
+            value += '\t';
+            break;
+        case 'b':
+            value += '\b';
+            break;
+        case 'f':
+            value += '\f';
+            break;
+        case '"':
+        case '\\':
+        case '/':
+            value += cur[-1];
+            break;
+        case 'u':
+            json::appendUtf8(value, json::readCodePoint(cur, end));
+            break;
+        default:
+            json::error("invalid escape sequence");
+        }
+    }
+    if (cur == end)
+    {
+        json::error("unterminated string");
+    }
+    cur++;
+}
+
+inline void readJson(const char *&cur, const char *end, char &value)
+{
+    std::string str;
+    readJson(cur, end, str);
+    if (str.size() != 1)
+    {
+        json::error("expected a single character");
+    }
+    value = str[0];
+}
+
+// Reads a string without copying it when it has no escape sequence: the text
+// is then in the input, and otherwise decoded in the buffer
+inline void readJsonText(const char *&cur, const char *end, std::string &buffer, const char *&text, size_t &length)
+{
+    json::expect(cur, end, '"');
+    const char *start = cur;
+    while (cur != end && *cur != '"' && *cur != '\\')
+    {
+        cur++;
+    }
+    if (cur != end && *cur == '"')
+    {
+        text = start;
+        length = cur - start;
+        cur++;
+        return;
+    }
+    cur = start - 1;
+    readJson(cur, end, buffer);
+    text = buffer.data();
+    length = buffer.size();
+}
+
+} // namespace gm
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2017 Cyril Deguet <cyril.deguet@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "gamma/containers.hpp"
+#include "gamma/json.hpp"
+
+// Json trait support for the containers and fixed-size strings
+namespace gm
+{
+
+template <size_t N>
+inline void writeJson(std::string &out, const Str<N> &value)
+{
+    writeJsonString(out, value.data(), value.size());
+}
+
+template <size_t N>
+inline void readJson(const char *&cur, const char *end, Str<N> &value)
+{
+    std::string buffer;
+    const char *text;
+    size_t length;
+    readJsonText(cur, end, buffer, text, length);
+    if (length > N)
+    {
+        json::error("string too long");
+    }
+    value.assign(text, length);
+}
+
+// Containers are arrays
+template <typename Container>
+inline void writeJsonArray(std::string &out, const Container &value)
+{
+    out += '[';
+    bool first = true;
+    for (const auto &item : value)
+    {
+        if (!first)
+        {
+            out += ',';
+        }
+        first = false;
+        writeJson(out, item);
+    }
+    out += ']';
+}
+
+template <typename T, size_t N>
+inline void writeJson(std::string &out, const Array<T, N> &value)
+{
+    writeJsonArray(out, value);
+}
+
+template <typename T, size_t N>
+inline void writeJson(std::string &out, const SmallVec<T, N> &value)
+{
+    writeJsonArray(out, value);
+}
+
+template <typename T>
+inline void writeJson(std::string &out, const Vec<T> &value)
+{
+    writeJsonArray(out, value);
+}
+
+// Reads the values of an array at the end of a container, which must be
+// empty, calling add() to make room for each value
+template <typename Container, typename Add>
+inline void readJsonArray(const char *&cur, const char *end, Container &value, Add add)
+{
+    json::expect(cur, end, '[');
+    if (json::consume(cur, end, ']'))
+    {
+        return;
+    }
+    do
+    {
+        readJson(cur, end, add(value));
+    } while (json::next(cur, end, ']'));
+}
+
+template <typename T, size_t N>
+inline void readJson(const char *&cur, const char *end, Array<T, N> &value)
+{
+    size_t count = 0;
+    readJsonArray(cur, end, value, [&count](Array<T, N> &array) -> T & {
+        if (count == N)
+        {
+            json::error("too many values");
+        }
+        return array[count++];
+    });
+    if (count != N)
+    {
+        json::error("missing values");
+    }
+}
+
+template <typename T, size_t N>
+inline void readJson(const char *&cur, const char *end, SmallVec<T, N> &value)
+{
+    value.clear();
+    readJsonArray(cur, end, value, [](SmallVec<T, N> &vec) -> T & {
+        if (vec.size() == N)
+        {
+            json::error("too many values");
+        }
+        vec.resize(vec.size() + 1);
+        return vec[vec.size() - 1];
+    });
+}
+
+template <typename T>
+inline void readJson(const char *&cur, const char *end, Vec<T> &value)
+{
+    value.clear();
+    readJsonArray(cur, end, value, [](Vec<T> &vec) -> T & {
+        vec.emplace_back();
+        return vec.back();
+    });
+}
+
+} // namespace gm
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2017 Cyril Deguet <cyril.deguet@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "gamma/json.hpp"
+#include "gamma/optional.hpp"
+
+// Json trait support for the optionals
+namespace gm
+{
+
+// An empty optional is null
+template <typename T, typename Niche>
+inline void writeJson(std::string &out, const Optional<T, Niche> &value)
+{
+    if (value.has_value())
+    {
+        writeJson(out, *value);
+    }
+    else
+    {
+        out += "null";
+    }
+}
+
+template <typename T, typename Niche>
+inline void readJson(const char *&cur, const char *end, Optional<T, Niche> &value)
+{
+    if (json::consumeNull(cur, end))
+    {
+        value.reset();
+        return;
+    }
+    T item;
+    readJson(cur, end, item);
+    if (!Optional<T, Niche>::isValid(item))
+    {
+        json::error("invalid optional value");
+    }
+    value = item;
+}
+
+} // namespace gm
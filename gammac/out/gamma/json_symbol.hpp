@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2017 Cyril Deguet <cyril.deguet@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "gamma/json.hpp"
+#include "gamma/symbol.hpp"
+
+// Json trait support for the symbols
+namespace gm
+{
+
+inline void writeJson(std::string &out, const Sym &value)
+{
+    writeJson(out, value.str());
+}
+
+inline void readJson(const char *&cur, const char *end, Sym &value)
+{
+    std::string buffer;
+    const char *text;
+    size_t length;
+    readJsonText(cur, end, buffer, text, length);
+    value = Sym::intern(text, length);
+}
+
+} // namespace gm
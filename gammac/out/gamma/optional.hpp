@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2017 Cyril Deguet <cyril.deguet@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdexcept>
+
+// Optional values of the fields
+namespace gm
+{
+
+// A niche is a value that a type never holds, standing for the empty optional
+// so that it takes no more room than the type: a value past the variants of
+// an enum, or outside the range of an integer. The values from Min to Max are
+// the ones the type holds.
+template <typename T, T Empty, T Min, T Max>
+struct ValueNiche
+{
+    static constexpr T empty()
+    {
+        return Empty;
+    }
+
+    static constexpr bool isEmpty(const T &value)
+    {
+        return value == Empty;
+    }
+
+    static constexpr bool isValid(const T &value)
+    {
+        return !(value < Min) && !(Max < value);
+    }
+};
+
+// The Undef tag of a union
+template <typename T>
+struct UndefNiche
+{
+    static constexpr T empty()
+    {
+        return T();
+    }
+
+    static constexpr bool isEmpty(const T &value)
+    {
+        return value.type == T::Undef;
+    }
+
+    static constexpr bool isValid(const T &value)
+    {
+        return value.type != T::Undef;
+    }
+};
+
+// Without a niche, the value is followed by a flag. It is then reset to T()
+// when the optional is empty, so that equal optionals have the same bytes
+// when T is trivially copyable.
+// Constructing an optional from the niche, or from a value outside the values
+// of the type, throws std::out_of_range instead of making it empty.
+template <typename T, typename Niche = void>
+class Optional
+{
+  public:
+    constexpr Optional() : stored(Niche::empty()) {}
+
+    constexpr Optional(const T &value)
+        : stored(Niche::isValid(value) ? value : throw std::out_of_range("Invalid optional value")) {}
+
+    static constexpr bool isValid(const T &value)
+    {
+        return Niche::isValid(value);
+    }
+
+    bool has_value() const
+    {
+        return !Niche::isEmpty(stored);
+    }
+
+    explicit operator bool() const
+    {
+        return has_value();
+    }
+
+    const T &operator*() const
+    {
+        return stored;
+    }
+
+    T &operator*()
+    {
+        return stored;
+    }
+
+    const T *operator->() const
+    {
+        return &stored;
+    }
+
+    T *operator->()
+    {
+        return &stored;
+    }
+
+    T value_or(const T &other) const
+    {
+        return has_value() ? stored : other;
+    }
+
+    void reset()
+    {
+        stored = Niche::empty();
+    }
+
+    // Stored value, holding the niche when the optional is empty
+    const T &raw() const
+    {
+        return stored;
+    }
+
+    T &raw()
+    {
+        return stored;
+    }
+
+  private:
+    T stored;
+};
+
+template <typename T>
+class Optional<T, void>
+{
+  public:
+    constexpr Optional() : stored(), present(false) {}
+
+    constexpr Optional(const T &value) : stored(value), present(true) {}
+
+    static constexpr bool isValid(const T &)
+    {
+        return true;
+    }
+
+    bool has_value() const
+    {
+        return present;
+    }
+
+    explicit operator bool() const
+    {
+        return present;
+    }
+
+    const T &operator*() const
+    {
+        return stored;
+    }
+
+    T &operator*()
+    {
+        return stored;
+    }
+
+    const T *operator->() const
+    {
+        return &stored;
+    }
+
+    T *operator->()
+    {
+        return &stored;
+    }
+
+    T value_or(const T &other) const
+    {
+        return present ? stored : other;
+    }
+
+    void reset()
+    {
+        stored = T();
+        present = false;
+    }
+
+    // Stored value and flag, for the generated code
+    const T &raw() const
+    {
+        return stored;
+    }
+
+    T &raw()
+    {
+        return stored;
+    }
+
+    bool &flag()
+    {
+        return present;
+    }
+
+  private:
+    T stored;
+    bool present;
+};
+
+template <typename T, typename Niche>
+inline bool operator==(const Optional<T, Niche> &a, const Optional<T, Niche> &b)
+{
+    return a.has_value() == b.has_value() && (!a.has_value() || *a == *b);
+}
+
+template <typename T, typename Niche>
+inline bool operator!=(const Optional<T, Niche> &a, const Optional<T, Niche> &b)
+{
+    return !(a == b);
+}
+
+} // namespace gm
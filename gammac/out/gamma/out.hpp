@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2017 Cyril Deguet <cyril.deguet@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+
+// Runtime support for the Out trait: values are written to standard streams,
+// or to any output with the same operator<<. The overloads for the containers,
+// optionals and symbols are in the out_*.hpp headers.
+namespace gm
+{
+
+// Containers are written as their values separated by spaces, preceded by
+// their count unless their size is fixed
+template <typename Out, typename T>
+inline void writeItem(Out &out, const T &value)
+{
+    out << value;
+}
+
+template <typename Out>
+inline void writeItem(Out &out, int8_t value)
+{
+    out << static_cast<int>(value);
+}
+
+template <typename Out>
+inline void writeItem(Out &out, uint8_t value)
+{
+    out << static_cast<int>(value);
+}
+
+template <typename Out, typename Container>
+inline void writeItems(Out &out, const Container &value, bool counted)
+{
+    bool first = true;
+    if (counted)
+    {
+        out << static_cast<uint64_t>(value.size());
+        first = false;
+    }
+    for (const auto &item : value)
+    {
+        if (!first)
+        {
+            out << ' ';
+        }
+        first = false;
+        writeItem(out, item);
+    }
+}
+
+} // namespace gm
@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2017 Cyril Deguet <cyril.deguet@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+
+#include "gamma/containers.hpp"
+#include "gamma/out.hpp"
+
+// Out trait support for the containers and fixed-size strings
+namespace gm
+{
+
+template <size_t N>
+inline std::ostream &operator<<(std::ostream &os, const Str<N> &value)
+{
+    return os.write(value.data(), value.size());
+}
+
+template <typename T, size_t N>
+inline std::ostream &operator<<(std::ostream &os, const Array<T, N> &value)
+{
+    writeItems(os, value, false);
+    return os;
+}
+
+template <typename T, size_t N>
+inline std::ostream &operator<<(std::ostream &os, const SmallVec<T, N> &value)
+{
+    writeItems(os, value, true);
+    return os;
+}
+
+template <typename T>
+inline std::ostream &operator<<(std::ostream &os, const Vec<T> &value)
+{
+    writeItems(os, value, true);
+    return os;
+}
+
+} // namespace gm
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2017 Cyril Deguet <cyril.deguet@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <ostream>
+
+#include "gamma/optional.hpp"
+#include "gamma/out.hpp"
+
+// Out trait support for the optionals
+namespace gm
+{
+
+template <typename Out, typename T, typename Niche>
+inline void writeOptional(Out &out, const Optional<T, Niche> &value)
+{
+    if (value.has_value())
+    {
+        writeItem(out, *value);
+    }
+    else
+    {
+        out << '-';
+    }
+}
+
+template <typename T, typename Niche>
+inline std::ostream &operator<<(std::ostream &os, const Optional<T, Niche> &value)
+{
+    writeOptional(os, value);
+    return os;
+}
+
+} // namespace gm
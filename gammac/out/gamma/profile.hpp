@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2017 Cyril Deguet <cyril.deguet@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <ostream>
+#include <vector>
+
+#if defined(__GNUC__)
+#define GM_UNLIKELY(x) __builtin_expect(!!(x), 0)
+#else
+#define GM_UNLIKELY(x) (x)
+#endif
+
+// The generated readers count the variants they read when GAMMA_PROFILE
+// is defined
+#ifdef GAMMA_PROFILE
+#define GM_PROFILE_HIT(hits, i) ((hits)[i]++)
+#else
+#define GM_PROFILE_HIT(hits, i) ((void)0)
+#endif
+
+namespace gm
+{
+
+// Variant counts of an instrumented build, saved when the program exits
+// to the file named by GAMMA_PROFILE_FILE (gamma.profile by default), as
+// lines "Type Variant count" read back by gammac --profile
+class Profile
+{
+  public:
+    static Profile &instance()
+    {
+        static Profile profile;
+        return profile;
+    }
+
+    Profile(const Profile &) = delete;
+    Profile &operator=(const Profile &) = delete;
+
+    ~Profile()
+    {
+        save();
+    }
+
+    // Returns the counters of the variants of a type
+    uint64_t *add(const char *type, const char *const *variants, size_t count)
+    {
+        entries.push_back(Entry{type, variants, std::vector<uint64_t>(count)});
+        return entries.back().hits.data();
+    }
+
+    void write(std::ostream &os) const
+    {
+        for (const auto &entry : entries)
+        {
+            for (size_t i = 0; i < entry.hits.size(); i++)
+            {
+                os << entry.type << ' ' << entry.variants[i] << ' ' << entry.hits[i] << '\n';
+            }
+        }
+    }
+
+    // Can be called explicitly by programs that do not exit normally
+    void save() const
+    {
+        const char *path = std::getenv("GAMMA_PROFILE_FILE");
+        std::ofstream file(path ? path : "gamma.profile");
+        write(file);
+    }
+
+  private:
+    Profile() {}
+
+    struct Entry
+    {
+        const char *type;
+        const char *const *variants;
+        std::vector<uint64_t> hits;
+    };
+
+    std::vector<Entry> entries;
+};
+
+} // namespace gm
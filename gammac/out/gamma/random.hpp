@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2017 Cyril Deguet <cyril.deguet@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Runtime support for the Rand trait. The overloads for the containers,
+// optionals and symbols are in the random_*.hpp headers.
+namespace gm
+{
+
+// SplitMix64 generator: small, fast, and good enough for test inputs
+class Rng
+{
+  public:
+    explicit Rng(uint64_t seed = 0) : state(seed) {}
+
+    uint64_t next()
+    {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // Returns a number in [0, n)
+    uint32_t below(uint32_t n)
+    {
+        return static_cast<uint32_t>(((next() >> 32) * n) >> 32);
+    }
+
+  private:
+    uint64_t state;
+};
+
+inline void randomize(Rng &rng, bool &value)
+{
+    value = (rng.next() >> 63) != 0;
+}
+
+// Printable characters other than space, so that they can be read as text
+inline void randomize(Rng &rng, char &value)
+{
+    value = static_cast<char>('!' + rng.below('~' - '!' + 1));
+}
+
+// Integers take any value of their type
+template <typename T>
+inline void randomizeInteger(Rng &rng, T &value)
+{
+    value = static_cast<T>(rng.next() >> (64 - 8 * sizeof(T)));
+}
+
+inline void randomize(Rng &rng, int &value)
+{
+    randomizeInteger(rng, value);
+}
+
+inline void randomize(Rng &rng, unsigned int &value)
+{
+    randomizeInteger(rng, value);
+}
+
+inline void randomize(Rng &rng, int8_t &value)
+{
+    randomizeInteger(rng, value);
+}
+
+inline void randomize(Rng &rng, uint8_t &value)
+{
+    randomizeInteger(rng, value);
+}
+
+inline void randomize(Rng &rng, int16_t &value)
+{
+    randomizeInteger(rng, value);
+}
+
+inline void randomize(Rng &rng, uint16_t &value)
+{
+    randomizeInteger(rng, value);
+}
+
+inline void randomize(Rng &rng, int64_t &value)
+{
+    randomizeInteger(rng, value);
+}
+
+inline void randomize(Rng &rng, uint64_t &value)
+{
+    randomizeInteger(rng, value);
+}
+
+inline void randomize(Rng &rng, double &value)
+{
+    value = static_cast<double>(rng.next() >> 11) / (1ULL << 53) * 2000 - 1000;
+}
+
+inline void randomize(Rng &rng, float &value)
+{
+    double number;
+    randomize(rng, number);
+    value = static_cast<float>(number);
+}
+
+inline char randomAlnum(Rng &rng)
+{
+    static const char kChars[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+    return kChars[rng.below(sizeof(kChars) - 1)];
+}
+
+// Short alphanumeric strings, which fit in the inline buffer of std::string
+// in common implementations
+inline void randomize(Rng &rng, std::string &value)
+{
+    value.resize(1 + rng.below(15));
+    for (auto &c : value)
+    {
+        c = randomAlnum(rng);
+    }
+}
+
+} // namespace gm
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2017 Cyril Deguet <cyril.deguet@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "gamma/containers.hpp"
+#include "gamma/random.hpp"
+
+// Rand trait support for the containers and fixed-size strings
+namespace gm
+{
+
+template <size_t N>
+inline void randomize(Rng &rng, Str<N> &value)
+{
+    char chars[N];
+    size_t size = 1 + rng.below(N);
+    for (size_t i = 0; i < size; i++)
+    {
+        chars[i] = randomAlnum(rng);
+    }
+    value.assign(chars, size);
+}
+
+// Vectors get a random size, small for Vec<T>
+const size_t kMaxRandomVecSize = 8;
+
+template <typename T, size_t N>
+inline void randomize(Rng &rng, Array<T, N> &value)
+{
+    for (auto &item : value)
+    {
+        randomize(rng, item);
+    }
+}
+
+template <typename T, size_t N>
+inline void randomize(Rng &rng, SmallVec<T, N> &value)
+{
+    value.resize(rng.below(static_cast<uint32_t>(N + 1)));
+    for (auto &item : value)
+    {
+        randomize(rng, item);
+    }
+}
+
+template <typename T>
+inline void randomize(Rng &rng, Vec<T> &value)
+{
+    value.resize(rng.below(kMaxRandomVecSize + 1));
+    for (auto &item : value)
+    {
+        randomize(rng, item);
+    }
+}
+
+} // namespace gm
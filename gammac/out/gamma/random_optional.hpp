@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2017 Cyril Deguet <cyril.deguet@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "gamma/optional.hpp"
+#include "gamma/random.hpp"
+
+// Rand trait support for the optionals
+namespace gm
+{
+
+// Optionals are empty half of the time
+template <typename T, typename Niche>
+inline void randomize(Rng &rng, Optional<T, Niche> &value)
+{
+    if (rng.below(2))
+    {
+        T item;
+        randomize(rng, item);
+        value = item;
+    }
+    else
+    {
+        value.reset();
+    }
+}
+
+// The value of an optional with a niche is drawn from the values from Min to
+// Max, which may be a part of the values of T
+template <typename T, T Empty, T Min, T Max>
+inline void randomize(Rng &rng, Optional<T, ValueNiche<T, Empty, Min, Max>> &value)
+{
+    if (rng.below(2))
+    {
+        auto span = static_cast<uint64_t>(Max) - static_cast<uint64_t>(Min);
+        uint64_t offset = span < UINT32_MAX ? rng.below(static_cast<uint32_t>(span + 1))
+                                            : (span == UINT64_MAX ? rng.next() : rng.next() % (span + 1));
+        value = static_cast<T>(static_cast<uint64_t>(Min) + offset);
+    }
+    else
+    {
+        value.reset();
+    }
+}
+
+} // namespace gm
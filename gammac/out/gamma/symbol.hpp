@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2017 Cyril Deguet <cyril.deguet@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+// Interned symbols: each distinct text is stored once in a process-wide
+// table, and a symbol is the index of its text
+namespace gm
+{
+
+// The table has a fixed capacity, so that its slots never move: looking up a
+// symbol or its text only reads atomic slots, and interning a new text takes
+// a lock. Texts are never freed.
+class SymbolTable
+{
+  public:
+    static const uint32_t kMaxSymbols = 1 << 14;
+
+    static SymbolTable &instance()
+    {
+        static SymbolTable table;
+        return table;
+    }
+
+    SymbolTable(const SymbolTable &) = delete;
+    SymbolTable &operator=(const SymbolTable &) = delete;
+
+    uint32_t intern(const char *text, size_t length)
+    {
+        size_t slot;
+        uint32_t id = find(text, length, slot);
+        if (id != kNone)
+        {
+            return id;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        // Another thread may have added the text meanwhile
+        id = find(text, length, slot);
+        if (id != kNone)
+        {
+            return id;
+        }
+        id = count.load(std::memory_order_relaxed);
+        if (id == kMaxSymbols)
+        {
+            throw std::length_error("SymbolTable: capacity exceeded");
+        }
+        texts[id].store(new std::string(text, length), std::memory_order_release);
+        count.store(id + 1, std::memory_order_release);
+        slots[slot].store(id + 1, std::memory_order_release);
+        return id;
+    }
+
+    const std::string &text(uint32_t id) const
+    {
+        return *texts[id].load(std::memory_order_acquire);
+    }
+
+    size_t size() const
+    {
+        return count.load(std::memory_order_acquire);
+    }
+
+  private:
+    static const uint32_t kNone = UINT32_MAX;
+    static const size_t kSlotCount = 2 * kMaxSymbols;
+
+    SymbolTable() : slots(), texts(), count(0)
+    {
+        intern("", 0);
+    }
+
+    // FNV-1a
+    static uint64_t hash(const char *text, size_t length)
+    {
+        uint64_t h = 0xcbf29ce484222325ULL;
+        for (size_t i = 0; i < length; i++)
+        {
+            h = (h ^ static_cast<unsigned char>(text[i])) * 0x100000001b3ULL;
+        }
+        return h;
+    }
+
+    // Returns the symbol of a text, or kNone and the free slot where to add it
+    uint32_t find(const char *text, size_t length, size_t &slot) const
+    {
+        for (slot = hash(text, length) & (kSlotCount - 1);; slot = (slot + 1) & (kSlotCount - 1))
+        {
+            uint32_t entry = slots[slot].load(std::memory_order_acquire);
+            if (entry == 0)
+            {
+                return kNone;
+            }
+            const std::string &candidate = this->text(entry - 1);
+            if (candidate.size() == length && std::memcmp(candidate.data(), text, length) == 0)
+            {
+                return entry - 1;
+            }
+        }
+    }
+
+    // Symbol + 1 of each slot of the hash table, 0 when the slot is free
+    std::atomic<uint32_t> slots[kSlotCount];
+    std::atomic<const std::string *> texts[kMaxSymbols];
+    std::atomic<uint32_t> count;
+    std::mutex mutex;
+};
+
+// A symbol is trivially copyable, and compared and hashed as an integer. The
+// default symbol is the empty text.
+class Sym
+{
+  public:
+    constexpr Sym() : id(0) {}
+
+    explicit Sym(const char *text) : id(SymbolTable::instance().intern(text, std::strlen(text))) {}
+
+    explicit Sym(const std::string &text) : id(SymbolTable::instance().intern(text.data(), text.size())) {}
+
+    static Sym intern(const char *text, size_t length)
+    {
+        Sym sym;
+        sym.id = SymbolTable::instance().intern(text, length);
+        return sym;
+    }
+
+    uint32_t index() const
+    {
+        return id;
+    }
+
+    const std::string &str() const
+    {
+        return SymbolTable::instance().text(id);
+    }
+
+    size_t hash() const
+    {
+        return static_cast<size_t>(id * 0x9E3779B97F4A7C15ULL);
+    }
+
+    bool operator==(const Sym &other) const
+    {
+        return id == other.id;
+    }
+
+    bool operator!=(const Sym &other) const
+    {
+        return id != other.id;
+    }
+
+  private:
+    uint32_t id;
+};
+
+} // namespace gm
+
+namespace std
+{
+
+template <>
+struct hash<gm::Sym>
+{
+    size_t operator()(const gm::Sym &sym) const
+    {
+        return sym.hash();
+    }
+};
+
+} // namespace std
@@ -0,0 +1,256 @@
+/*
+ * Copyright (C) 2017 Cyril Deguet <cyril.deguet@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+// Runtime support for the In trait: values are parsed from a range of
+// characters, as whitespace-separated tokens. The overloads for the
+// containers, optionals and symbols are in the text_*.hpp headers.
+namespace gm
+{
+
+namespace text
+{
+
+inline void error(const char *message)
+{
+    throw std::runtime_error(std::string("Text: ") + message);
+}
+
+// Thrown when the input ends in the middle of a value, so that a caller
+// reading from a stream can retry once more input is available
+struct EndOfInput : std::runtime_error
+{
+    EndOfInput() : std::runtime_error("Text: unexpected end of input") {}
+};
+
+inline void endOfInput()
+{
+    throw EndOfInput();
+}
+
+inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+}
+
+inline void skipSpace(const char *&cur, const char *end)
+{
+    while (cur != end && isSpace(*cur))
+    {
+        cur++;
+    }
+}
+
+// Reads the next token, returning a pointer into the input
+inline void readToken(const char *&cur, const char *end, const char *&token, size_t &length)
+{
+    skipSpace(cur, end);
+    token = cur;
+    while (cur != end && !isSpace(*cur))
+    {
+        cur++;
+    }
+    length = cur - token;
+    if (length == 0)
+    {
+        endOfInput();
+    }
+}
+
+inline void expectWord(const char *&cur, const char *end, const char *word, size_t length)
+{
+    const char *token;
+    size_t tokenLength;
+    readToken(cur, end, token, tokenLength);
+    if (tokenLength != length || std::memcmp(token, word, length) != 0)
+    {
+        error("unexpected token");
+    }
+}
+
+// Reads a decimal integer, which must fit in the type of the value
+template <typename T>
+inline void readInteger(const char *&cur, const char *end, T &value)
+{
+    skipSpace(cur, end);
+    bool negative = cur != end && *cur == '-';
+    if (negative)
+    {
+        cur++;
+    }
+    if (cur == end)
+    {
+        endOfInput();
+    }
+    if (*cur < '0' || *cur > '9')
+    {
+        error("expected an integer");
+    }
+    uint64_t limit = negative ? 0 - static_cast<uint64_t>(std::numeric_limits<T>::min())
+                              : static_cast<uint64_t>(std::numeric_limits<T>::max());
+    uint64_t n = 0;
+    while (cur != end && *cur >= '0' && *cur <= '9')
+    {
+        unsigned digit = *cur++ - '0';
+        if (digit > limit || n > (limit - digit) / 10)
+        {
+            error("integer out of range");
+        }
+        n = n * 10 + digit;
+    }
+    value = static_cast<T>(negative ? 0 - n : n);
+}
+
+} // namespace text
+
+inline void readText(const char *&cur, const char *end, int &value)
+{
+    text::readInteger(cur, end, value);
+}
+
+inline void readText(const char *&cur, const char *end, unsigned int &value)
+{
+    text::readInteger(cur, end, value);
+}
+
+inline void readText(const char *&cur, const char *end, int8_t &value)
+{
+    text::readInteger(cur, end, value);
+}
+
+inline void readText(const char *&cur, const char *end, uint8_t &value)
+{
+    text::readInteger(cur, end, value);
+}
+
+inline void readText(const char *&cur, const char *end, int16_t &value)
+{
+    text::readInteger(cur, end, value);
+}
+
+inline void readText(const char *&cur, const char *end, uint16_t &value)
+{
+    text::readInteger(cur, end, value);
+}
+
+inline void readText(const char *&cur, const char *end, int64_t &value)
+{
+    text::readInteger(cur, end, value);
+}
+
+inline void readText(const char *&cur, const char *end, uint64_t &value)
+{
+    text::readInteger(cur, end, value);
+}
+
+// Standard streams read 8-bit integers as characters: the generated code
+// reads them as numbers with this function instead
+template <typename T>
+inline std::istream &readNumber(std::istream &is, T &value)
+{
+    int number;
+    if (is >> number)
+    {
+        if (number < std::numeric_limits<T>::min() || number > std::numeric_limits<T>::max())
+        {
+            is.setstate(std::ios::failbit);
+        }
+        else
+        {
+            value = static_cast<T>(number);
+        }
+    }
+    return is;
+}
+
+inline void readText(const char *&cur, const char *end, bool &value)
+{
+    int number;
+    readText(cur, end, number);
+    value = number != 0;
+}
+
+inline void readText(const char *&cur, const char *end, char &value)
+{
+    text::skipSpace(cur, end);
+    if (cur == end)
+    {
+        text::endOfInput();
+    }
+    value = *cur++;
+}
+
+inline void readText(const char *&cur, const char *end, double &value)
+{
+    const char *token;
+    size_t length;
+    text::readToken(cur, end, token, length);
+    char buf[64];
+    if (length >= sizeof(buf))
+    {
+        text::error("expected a number");
+    }
+    std::memcpy(buf, token, length);
+    buf[length] = '\0';
+    char *last;
+    value = std::strtod(buf, &last);
+    if (last != buf + length)
+    {
+        text::error("expected a number");
+    }
+}
+
+inline void readText(const char *&cur, const char *end, float &value)
+{
+    double number;
+    readText(cur, end, number);
+    value = static_cast<float>(number);
+}
+
+inline void readText(const char *&cur, const char *end, std::string &value)
+{
+    const char *token;
+    size_t length;
+    text::readToken(cur, end, token, length);
+    value.assign(token, length);
+}
+
+template <typename T>
+inline std::istream &readStream(std::istream &is, T &value)
+{
+    return is >> value;
+}
+
+inline std::istream &readStream(std::istream &is, int8_t &value)
+{
+    return readNumber(is, value);
+}
+
+inline std::istream &readStream(std::istream &is, uint8_t &value)
+{
+    return readNumber(is, value);
+}
+
+} // namespace gm
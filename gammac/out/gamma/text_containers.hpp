@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2017 Cyril Deguet <cyril.deguet@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <utility>
+
+#include "gamma/containers.hpp"
+#include "gamma/text.hpp"
+
+// In trait support for the containers and fixed-size strings
+namespace gm
+{
+
+template <size_t N>
+inline void readText(const char *&cur, const char *end, Str<N> &value)
+{
+    const char *token;
+    size_t length;
+    text::readToken(cur, end, token, length);
+    if (length > N)
+    {
+        text::error("string too long");
+    }
+    value.assign(token, length);
+}
+
+template <size_t N>
+inline std::istream &operator>>(std::istream &is, Str<N> &value)
+{
+    std::string token;
+    if (is >> token)
+    {
+        if (token.size() > N)
+        {
+            is.setstate(std::ios::failbit);
+        }
+        else
+        {
+            value.assign(token.data(), token.size());
+        }
+    }
+    return is;
+}
+
+// Containers are read as their values, preceded by their count unless their
+// size is fixed
+template <typename T, size_t N>
+inline void readText(const char *&cur, const char *end, Array<T, N> &value)
+{
+    for (auto &item : value)
+    {
+        readText(cur, end, item);
+    }
+}
+
+template <typename T, size_t N>
+inline void readText(const char *&cur, const char *end, SmallVec<T, N> &value)
+{
+    uint64_t count;
+    readText(cur, end, count);
+    if (count > N)
+    {
+        text::error("too many values");
+    }
+    value.resize(static_cast<size_t>(count));
+    for (auto &item : value)
+    {
+        readText(cur, end, item);
+    }
+}
+
+// The count of a Vec comes from the input, so the values are appended as they
+// are read rather than allocated upfront
+const size_t kMaxVecReserve = 1024;
+
+template <typename T>
+inline void readText(const char *&cur, const char *end, Vec<T> &value)
+{
+    uint64_t count;
+    readText(cur, end, count);
+    value.clear();
+    value.reserve(static_cast<size_t>(std::min<uint64_t>(count, kMaxVecReserve)));
+    for (uint64_t i = 0; i < count; i++)
+    {
+        T item = T();
+        readText(cur, end, item);
+        value.push_back(std::move(item));
+    }
+}
+
+template <typename T, size_t N>
+inline std::istream &operator>>(std::istream &is, Array<T, N> &value)
+{
+    for (auto &item : value)
+    {
+        readStream(is, item);
+    }
+    return is;
+}
+
+template <typename T, size_t N>
+inline std::istream &operator>>(std::istream &is, SmallVec<T, N> &value)
+{
+    uint64_t count;
+    if (!(is >> count) || count > N)
+    {
+        is.setstate(std::ios::failbit);
+        return is;
+    }
+    value.resize(static_cast<size_t>(count));
+    for (auto &item : value)
+    {
+        readStream(is, item);
+    }
+    return is;
+}
+
+template <typename T>
+inline std::istream &operator>>(std::istream &is, Vec<T> &value)
+{
+    uint64_t count;
+    if (!(is >> count))
+    {
+        return is;
+    }
+    value.clear();
+    value.reserve(static_cast<size_t>(std::min<uint64_t>(count, kMaxVecReserve)));
+    for (uint64_t i = 0; i < count; i++)
+    {
+        T item = T();
+        if (!readStream(is, item))
+        {
+            break;
+        }
+        value.push_back(std::move(item));
+    }
+    return is;
+}
+
+} // namespace gm
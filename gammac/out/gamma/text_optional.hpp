@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2017 Cyril Deguet <cyril.deguet@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <istream>
+#include <string>
+
+#include "gamma/optional.hpp"
+#include "gamma/text.hpp"
+
+// In trait support for the optionals
+namespace gm
+{
+
+// An empty optional is written "-"
+template <typename T, typename Niche>
+inline void readText(const char *&cur, const char *end, Optional<T, Niche> &value)
+{
+    text::skipSpace(cur, end);
+    if (cur != end && *cur == '-' && (cur + 1 == end || text::isSpace(cur[1])))
+    {
+        cur++;
+        value.reset();
+        return;
+    }
+    T item = T();
+    readText(cur, end, item);
+    if (!Optional<T, Niche>::isValid(item))
+    {
+        text::error("invalid optional value");
+    }
+    value = item;
+}
+
+template <typename T, typename Niche>
+inline std::istream &operator>>(std::istream &is, Optional<T, Niche> &value)
+{
+    if ((is >> std::ws).peek() == '-')
+    {
+        is.get();
+        auto next = is.peek();
+        if (next == std::char_traits<char>::eof() || text::isSpace(static_cast<char>(next)))
+        {
+            value.reset();
+            return is;
+        }
+        is.putback('-');
+    }
+    T item = T();
+    if (!readStream(is, item))
+    {
+        return is;
+    }
+    if (!Optional<T, Niche>::isValid(item))
+    {
+        is.setstate(std::ios::failbit);
+        return is;
+    }
+    value = item;
+    return is;
+}
+
+} // namespace gm
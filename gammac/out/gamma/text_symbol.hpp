@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2017 Cyril Deguet <cyril.deguet@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <istream>
+#include <string>
+
+#include "gamma/symbol.hpp"
+#include "gamma/text.hpp"
+
+// In trait support for the symbols
+namespace gm
+{
+
+// Symbols are interned as they are read
+inline void readText(const char *&cur, const char *end, Sym &value)
+{
+    const char *token;
+    size_t length;
+    text::readToken(cur, end, token, length);
+    value = Sym::intern(token, length);
+}
+
+inline std::istream &operator>>(std::istream &is, Sym &value)
+{
+    std::string token;
+    if (is >> token)
+    {
+        value = Sym(token);
+    }
+    return is;
+}
+
+} // namespace gm
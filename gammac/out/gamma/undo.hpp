@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2017 Cyril Deguet <cyril.deguet@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+
+// Runtime support for the Undo trait
+namespace gm
+{
+
+// Stack of the changes made by the setters of a struct, allocated once with
+// a fixed capacity. A search saves mark() before playing a move, and calls
+// rollback() with it to restore the state.
+template <typename Change>
+class UndoLog
+{
+  public:
+    explicit UndoLog(size_t capacity) : changes(new Change[capacity]), capacity(capacity), count(0) {}
+
+    size_t mark() const
+    {
+        return count;
+    }
+
+    void push(const Change &change)
+    {
+        if (count == capacity)
+        {
+            throw std::length_error("UndoLog: capacity exceeded");
+        }
+        changes[count++] = change;
+    }
+
+    const Change &pop()
+    {
+        return changes[--count];
+    }
+
+    void clear()
+    {
+        count = 0;
+    }
+
+  private:
+    std::unique_ptr<Change[]> changes;
+    size_t capacity;
+    size_t count;
+};
+
+} // namespace gm
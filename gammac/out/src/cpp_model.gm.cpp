@@ -4,7 +4,7 @@
 #include "src/cpp_model.gm.hpp"
 
 static const std::string kSTLHeaderToStr[] = {
-  "map", "istream", "ostream", "string", 
+  "chrono", "cstddef", "cstdint", "cstdio", "cstdlib", "cstring", "map", "istream", "ostream", "sstream", "stdexcept", "string", "type_traits", "utility", "vector", 
 };
 
 std::ostream &operator<<(std::ostream &os, const STLHeader &obj) {
@@ -2,9 +2,10 @@
 #define src_cpp_model_gm__
 
 #include <ostream>
+#include "gamma/out.hpp"
 
 enum class STLHeader {
-  map, istream, ostream, string, 
+  chrono, cstddef, cstdint, cstdio, cstdlib, cstring, map, istream, ostream, sstream, stdexcept, string, type_traits, utility, vector, 
 };
 
 std::ostream &operator<<(std::ostream &os, const STLHeader &obj);
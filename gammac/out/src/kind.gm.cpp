@@ -4,7 +4,7 @@
 #include "src/kind.gm.hpp"
 
 static const std::string kKindToStr[] = {
-  "Eof", "Id", "Comma", "Colon", "String", "LParen", "RParen", "LBrack", "RBrack", "LBrace", "RBrace", "EnumDecl", "EnumBody", "SourceFile", "TraitList", "UnionDecl", "UnionBody", "StructDecl", "StructBody", 
+  "Eof", "Id", "Comma", "Colon", "DotDot", "String", "Number", "LParen", "RParen", "LBrack", "RBrack", "LAngle", "RAngle", "LBrace", "RBrace", "EnumDecl", "EnumBody", "SourceFile", "TraitList", "UnionDecl", "UnionBody", "StructDecl", "StructBody", "Range", 
 };
 
 std::ostream &operator<<(std::ostream &os, const Kind &obj) {
@@ -2,9 +2,10 @@
 #define src_kind_gm__
 
 #include <ostream>
+#include "gamma/out.hpp"
 
 enum class Kind {
-  Eof, Id, Comma, Colon, String, LParen, RParen, LBrack, RBrack, LBrace, RBrace, EnumDecl, EnumBody, SourceFile, TraitList, UnionDecl, UnionBody, StructDecl, StructBody, 
+  Eof, Id, Comma, Colon, DotDot, String, Number, LParen, RParen, LBrack, RBrack, LAngle, RAngle, LBrace, RBrace, EnumDecl, EnumBody, SourceFile, TraitList, UnionDecl, UnionBody, StructDecl, StructBody, Range, 
 };
 
 std::ostream &operator<<(std::ostream &os, const Kind &obj);
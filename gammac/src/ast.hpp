@@ -54,6 +54,9 @@ struct EnumFieldDecl : public AST
 {
     EnumFieldDecl(const Token &token) : AST(token) {}
 
+    // Constants of the variant, one for each column of the enum: each one is
+    // a NumberLiteral or an Id
+    std::vector<std::shared_ptr<AST>> values;
     std::shared_ptr<StringLiteral> format;
 };
 
@@ -71,20 +74,31 @@ struct TraitList : public AST
     std::vector<std::shared_ptr<Id>> traits;
 };
 
-struct EnumDecl : public TypeDecl
+struct NumberLiteral : public AST
 {
-    EnumDecl(const Token &token,
-             std::shared_ptr<Id> name,
-             std::shared_ptr<TraitList> traitList,
-             std::shared_ptr<EnumBody> body) : TypeDecl(token, name), traitList(traitList), body(body) {}
+    NumberLiteral(const Token &token) : AST(token) {}
 
-    std::shared_ptr<EnumBody> body;
-    std::shared_ptr<TraitList> traitList;
+    long long getValue() const { return std::stoll(token.lexeme); }
+};
+
+// Range of the values of an integer type, such as int[0..127]
+struct Range : public AST
+{
+    Range(std::shared_ptr<NumberLiteral> min,
+          std::shared_ptr<NumberLiteral> max) : AST(Token(Kind::Range)), min(min), max(max) {}
+
+    std::shared_ptr<NumberLiteral> min;
+    std::shared_ptr<NumberLiteral> max;
 };
 
 struct TypeRef : public AST
 {
     TypeRef(const Token &token) : AST(token) {}
+
+    // Arguments of a generic type, such as Array<int, 8>: each one is a
+    // TypeRef or a NumberLiteral
+    std::vector<std::shared_ptr<AST>> args;
+    std::shared_ptr<Range> range;
 };
 
 struct Arg : public AST
@@ -94,6 +108,20 @@ struct Arg : public AST
     std::shared_ptr<TypeRef> type;
 };
 
+struct EnumDecl : public TypeDecl
+{
+    EnumDecl(const Token &token,
+             std::shared_ptr<Id> name,
+             std::shared_ptr<TraitList> traitList,
+             std::vector<std::shared_ptr<Arg>> columns,
+             std::shared_ptr<EnumBody> body) : TypeDecl(token, name), traitList(traitList), columns(columns), body(body) {}
+
+    std::shared_ptr<EnumBody> body;
+    std::shared_ptr<TraitList> traitList;
+    // Constant tables indexed by the enum, such as (dx: int, dy: int)
+    std::vector<std::shared_ptr<Arg>> columns;
+};
+
 struct UnionFieldDecl : public AST
 {
     UnionFieldDecl(const Token &token) : AST(token) {}
@@ -14,6 +14,9 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
 #include <stdexcept>
 
 #include "generator.hpp"
@@ -33,11 +36,423 @@ std::string normalizeName(const std::string &name)
     return result;
 }
 
+std::string indent(const std::string &code)
+{
+    std::string result;
+    bool lineStart = true;
+    for (char c : code)
+    {
+        if (lineStart && c != '\n')
+        {
+            result += "  ";
+        }
+        result += c;
+        lineStart = c == '\n';
+    }
+    return result;
+}
+
+std::string offsetPosition(const std::string &base, size_t offset)
+{
+    return offset ? base + " + " + std::to_string(offset) : base;
+}
+
+std::string quote(const std::string &text)
+{
+    std::string result = "\"";
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+        {
+            result += '\\';
+        }
+        result += c;
+    }
+    return result + "\"";
+}
+
+// Dispatches on the length of a key, then on its bytes; each case is given
+// the code to run when the key matches
+// The cases are tested in the given order, and those with a cold key are
+// marked as unlikely
+std::string genKeyDispatch(const std::vector<std::pair<std::string, std::string>> &cases,
+                           const std::set<std::string> &coldKeys = std::set<std::string>())
+{
+    std::map<size_t, std::vector<std::pair<std::string, std::string>>> byLength;
+    for (const auto &keyCase : cases)
+    {
+        byLength[keyCase.first.size()].push_back(keyCase);
+    }
+    std::string code = "switch (length) {\n";
+    for (const auto &lengthCases : byLength)
+    {
+        auto length = std::to_string(lengthCases.first);
+        code += "case " + length + ":\n";
+        for (const auto &keyCase : lengthCases.second)
+        {
+            auto condition = "std::memcmp(key, " + quote(keyCase.first) + ", " + length + ") == 0";
+            if (coldKeys.count(keyCase.first))
+            {
+                condition = "GM_UNLIKELY(" + condition + ")";
+            }
+            code += "  if (" + condition + ") {\n";
+            code += indent(indent(keyCase.second));
+            code += "  }\n";
+        }
+        code += "  break;\n";
+    }
+    code += "}\n";
+    return code;
+}
+
 std::string getEnumFieldFormat(const EnumFieldDecl &field)
 {
     return field.format ? field.format->getText() : field.getText();
 }
 
+// Returns true if the formats of all the variants are distinct integers,
+// written as they would be printed back
+bool getEnumNumbers(const EnumDecl &node, std::vector<int> &numbers)
+{
+    std::set<int> distinct;
+    for (auto field : node.body->fields)
+    {
+        auto format = getEnumFieldFormat(*field);
+        if (format.empty() || format.find_first_not_of("-0123456789") != std::string::npos)
+        {
+            return false;
+        }
+        int number;
+        try
+        {
+            number = std::stoi(format);
+        }
+        catch (const std::logic_error &)
+        {
+            return false;
+        }
+        if (std::to_string(number) != format || !distinct.insert(number).second)
+        {
+            return false;
+        }
+        numbers.push_back(number);
+    }
+    return !numbers.empty();
+}
+
+// Returns true if the numbers are consecutive, so that the value of each
+// variant is its index plus the first number
+bool isConsecutive(const std::vector<int> &numbers)
+{
+    for (size_t i = 1; i < numbers.size(); i++)
+    {
+        if (numbers[i] != numbers[0] + static_cast<int>(i))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string genOffset(const std::string &expr, long long offset)
+{
+    if (offset == 0)
+    {
+        return expr;
+    }
+    if (offset < 0)
+    {
+        return expr + " - " + std::to_string(0 - static_cast<unsigned long long>(offset));
+    }
+    return expr + " + " + std::to_string(offset);
+}
+
+std::string capitalize(const std::string &name)
+{
+    auto result = name;
+    if (!result.empty() && result[0] >= 'a' && result[0] <= 'z')
+    {
+        result[0] += 'A' - 'a';
+    }
+    return result;
+}
+
+// The default format of a variant is its name followed by its arguments
+std::string getUnionFieldFormat(const UnionFieldDecl &field)
+{
+    if (field.format)
+    {
+        return field.format->getText();
+    }
+    std::string format = field.getText();
+    for (auto arg : field.args)
+    {
+        format += " {" + arg->getText() + "}";
+    }
+    return format;
+}
+
+// Splits a format into whitespace-separated words, each being either a
+// literal or the name of an argument between braces
+std::vector<std::string> splitFormat(const std::string &format)
+{
+    std::vector<std::string> words;
+    std::istringstream stream(format);
+    std::string word;
+    while (stream >> word)
+    {
+        words.push_back(word);
+    }
+    return words;
+}
+
+bool isFormatArg(const std::string &word)
+{
+    return word.size() > 2 && word.front() == '{' && word.back() == '}';
+}
+
+struct BuiltinType
+{
+    size_t size;
+    bool bitwise;
+    std::string binType;
+    std::string cppType;
+    bool integer;
+    bool isSigned;
+};
+
+// Builtin scalar types, with their size (which is also their alignment),
+// whether two values are equal exactly when their bytes are equal, the
+// fixed-size type of their Bin encoding, their C++ type, and whether they
+// are signed or unsigned integers
+static const std::map<std::string, BuiltinType> kBuiltinTypes = {
+    {"bool", {1, true, "bool", "bool", false, false}},
+    {"char", {1, true, "char", "char", false, false}},
+    {"int", {4, true, "int32_t", "int", true, true}},
+    {"float", {4, false, "float", "float", false, false}},
+    {"double", {8, false, "double", "double", false, false}},
+    {"i8", {1, true, "int8_t", "int8_t", true, true}},
+    {"u8", {1, true, "uint8_t", "uint8_t", true, false}},
+    {"i16", {2, true, "int16_t", "int16_t", true, true}},
+    {"u16", {2, true, "uint16_t", "uint16_t", true, false}},
+    {"i32", {4, true, "int32_t", "int32_t", true, true}},
+    {"u32", {4, true, "uint32_t", "uint32_t", true, false}},
+    {"i64", {8, true, "int64_t", "int64_t", true, true}},
+    {"u64", {8, true, "uint64_t", "uint64_t", true, false}},
+    {"f32", {4, false, "float", "float", false, false}},
+    {"f64", {8, false, "double", "double", false, false}}};
+
+// Bounds of the values of an integer type; the bounds of a range must fit in
+// a long long
+bool getIntegerLimits(const std::string &typeName, long long &min, long long &max)
+{
+    auto builtin = kBuiltinTypes.find(typeName);
+    if (builtin == kBuiltinTypes.end() || !builtin->second.integer)
+    {
+        return false;
+    }
+    auto bits = 8 * builtin->second.size;
+    if (builtin->second.isSigned)
+    {
+        min = bits == 64 ? INT64_MIN : -(1LL << (bits - 1));
+        max = bits == 64 ? INT64_MAX : (1LL << (bits - 1)) - 1;
+    }
+    else
+    {
+        min = 0;
+        max = bits == 64 ? INT64_MAX : (1LL << bits) - 1;
+    }
+    return true;
+}
+
+// Difference between the bounds of a range, which is one less than its
+// number of values
+unsigned long long getRangeSpan(const Range &range)
+{
+    return static_cast<unsigned long long>(range.max->getValue()) -
+           static_cast<unsigned long long>(range.min->getValue());
+}
+
+std::string genIntegerLiteral(long long value)
+{
+    auto text = std::to_string(value);
+    return value < INT32_MIN || value > INT32_MAX ? text + "LL" : text;
+}
+
+// Condition under which the integer expr is outside the range of its type,
+// or "" if the type has no range. Bounds equal to the limits of the type are
+// always met and are not compared.
+std::string genOutOfRange(const TypeRef &type, const std::string &expr)
+{
+    long long typeMin, typeMax;
+    if (!type.range || !getIntegerLimits(type.getText(), typeMin, typeMax))
+    {
+        return "";
+    }
+    auto min = type.range->min->getValue();
+    auto max = type.range->max->getValue();
+    std::string condition;
+    if (min > typeMin)
+    {
+        condition = expr + " < " + genIntegerLiteral(min);
+    }
+    if (max < typeMax)
+    {
+        condition += (condition.empty() ? "" : " || ") + expr + " > " + genIntegerLiteral(max);
+    }
+    return condition;
+}
+
+// Statement running fail when the integer expr is outside the range of its
+// type, or "" if the type has no range
+std::string genRangeCheck(const TypeRef &type, const std::string &expr, const std::string &fail)
+{
+    auto condition = genOutOfRange(type, expr);
+    return condition.empty() ? "" : "if (" + condition + ") {\n  " + fail + ";\n}\n";
+}
+
+// Standard streams read and write 8-bit integers as characters
+bool isByteInteger(const std::string &typeName)
+{
+    auto builtin = kBuiltinTypes.find(typeName);
+    return builtin != kBuiltinTypes.end() && builtin->second.integer && builtin->second.size == 1;
+}
+
+std::string genStreamRead(const TypeRef &type, const std::string &expr)
+{
+    return isByteInteger(type.getText()) ? "gm::readNumber(is, " + expr + ")" : "is >> " + expr;
+}
+
+std::string genStreamValue(const TypeRef &type, const std::string &expr)
+{
+    return isByteInteger(type.getText()) ? "static_cast<int>(" + expr + ")" : expr;
+}
+
+// Generic containers of the fields: Array<T, N> and SmallVec<T, N> hold their
+// values inline, and Vec<T> on the heap
+bool isContainer(const TypeRef &type)
+{
+    auto typeName = type.getText();
+    return typeName == "Array" || typeName == "SmallVec" || typeName == "Vec";
+}
+
+std::shared_ptr<TypeRef> getElementType(const TypeRef &type)
+{
+    return std::static_pointer_cast<TypeRef>(type.args.at(0));
+}
+
+// Capacity of an Array, a SmallVec or a Str, given by their last argument
+size_t getCapacity(const TypeRef &type)
+{
+    return static_cast<size_t>(std::static_pointer_cast<NumberLiteral>(type.args.back())->getValue());
+}
+
+void checkContainer(const TypeRef &type)
+{
+    auto typeName = type.getText();
+    size_t argCount = typeName == "Vec" ? 1 : 2;
+    if (type.args.size() != argCount || !std::dynamic_pointer_cast<TypeRef>(type.args[0]) ||
+        (argCount == 2 && !std::dynamic_pointer_cast<NumberLiteral>(type.args[1])))
+    {
+        throw std::runtime_error("Invalid arguments for type " + typeName);
+    }
+    if (argCount == 2)
+    {
+        auto capacity = std::static_pointer_cast<NumberLiteral>(type.args[1])->getValue();
+        if (capacity < 1 || capacity > UINT32_MAX)
+        {
+            throw std::runtime_error("Invalid capacity " + std::to_string(capacity) + " for type " + typeName);
+        }
+    }
+    auto element = getElementType(type);
+    if (element->range)
+    {
+        throw std::runtime_error("Range on the element type of " + typeName);
+    }
+    // std::vector<bool> does not hold references to its values
+    if (typeName == "Vec" && element->getText() == "bool")
+    {
+        throw std::runtime_error("Invalid element type bool for type Vec");
+    }
+}
+
+// Types holding values of their first argument: the containers and Optional<T>
+bool hasElementType(const TypeRef &type)
+{
+    return isContainer(type) || type.getText() == "Optional";
+}
+
+// Type of the values held by a field, through its containers and optionals
+std::shared_ptr<TypeRef> getValueType(std::shared_ptr<TypeRef> type)
+{
+    while (hasElementType(*type))
+    {
+        type = getElementType(*type);
+    }
+    return type;
+}
+
+// Str<N> holds up to N characters inline, with a length byte
+void checkStr(const TypeRef &type)
+{
+    if (type.args.size() != 1 || !std::dynamic_pointer_cast<NumberLiteral>(type.args[0]))
+    {
+        throw std::runtime_error("Invalid arguments for type Str");
+    }
+    auto capacity = std::static_pointer_cast<NumberLiteral>(type.args[0])->getValue();
+    if (capacity < 1 || capacity > 255)
+    {
+        throw std::runtime_error("Invalid capacity " + std::to_string(capacity) + " for type Str");
+    }
+}
+
+// Strings and symbols are read and written by the runtime
+bool isRuntimeType(const std::string &typeName)
+{
+    return typeName == "string" || typeName == "Str" || typeName == "Sym";
+}
+
+// Size of the count of a SmallVec, the smallest integer holding its capacity
+size_t getCountBinSize(size_t capacity)
+{
+    return capacity < 256 ? 1 : capacity < 65536 ? 2 : 4;
+}
+
+// Loop variable over the values of a container, distinct from the variable of
+// an enclosing loop
+std::string genItemName(const std::string &expr)
+{
+    if (expr == "item")
+    {
+        return "item1";
+    }
+    if (expr.compare(0, 4, "item") == 0 && expr.find_first_not_of("0123456789", 4) == std::string::npos)
+    {
+        return "item" + std::to_string(std::stoi(expr.substr(4)) + 1);
+    }
+    return "item";
+}
+
+// Largest integer range hashed by the Zobrist trait, to keep its key tables
+// small
+static const unsigned long long kMaxZobristKeys = 1024;
+
+// Size of the Bin encoding of enums and union tags
+static const size_t kEnumBinSize = 4;
+static const size_t kUnionTagBinSize = 1;
+
+uint64_t fingerprint(const std::string &schema)
+{
+    // 64-bit FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    for (char c : schema)
+    {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
 CppBlock::CppBlock(const std::string &text) : text(text)
 {
 }
@@ -75,6 +490,11 @@ void CppFile::addInclude(STLHeader header)
     includes.insert(header);
 }
 
+void CppFile::addInclude(const std::string &path)
+{
+    localIncludes.insert(path);
+}
+
 void CppFile::setIncludeGuard(const std::string &name)
 {
     includeGuard = name;
@@ -93,7 +513,11 @@ void CppFile::emit()
     {
         os << "#include <" << include << ">\n";
     }
-    if (!includes.empty())
+    for (const auto &include : localIncludes)
+    {
+        os << "#include \"" << include << "\"\n";
+    }
+    if (!includes.empty() || !localIncludes.empty())
     {
         os << std::endl;
     }
@@ -106,8 +530,14 @@ void CppFile::emit()
 
 CppGenerator::CppGenerator(const std::string &fileName,
                            StreamWriter &sourceWriter,
-                           StreamWriter &headerWriter) : fileName(fileName), source(sourceWriter), header(headerWriter)
+                           StreamWriter &headerWriter) : fileName(fileName), source(sourceWriter), header(headerWriter),
+                                                         benchWriter(nullptr)
+{
+}
+
+void CppGenerator::setBenchWriter(StreamWriter &writer)
 {
+    benchWriter = &writer;
 }
 
 void CppGenerator::gen(const AST &node)
@@ -134,13 +564,23 @@ void CppGenerator::gen(const AST &node)
 void CppGenerator::gen(const SourceFile &node)
 {
     source.addBlock("#include \"" + fileName + ".hpp\"\n\n");
+    for (size_t i = 0; i < node.typeDecls.size(); i++)
+    {
+        typeDecls[node.typeDecls[i]->name->getText()] = node.typeDecls[i].get();
+        declOrder[node.typeDecls[i]->name->getText()] = i;
+    }
     for (auto typeDecl : node.typeDecls)
     {
         gen(*typeDecl);
     }
+    addRuntimeIncludes();
     source.emit();
     header.setIncludeGuard(normalizeName(fileName));
     header.emit();
+    if (benchWriter)
+    {
+        genBench(node);
+    }
 }
 
 void CppGenerator::gen(const EnumDecl &node)
@@ -156,6 +596,7 @@ void CppGenerator::gen(const EnumDecl &node)
     }
     block += "\n};\n\n";
     header.addBlock(block);
+    genEnumColumns(node);
     for (auto traitId : node.traitList->traits)
     {
         auto traitName = traitId->getText();
@@ -167,6 +608,22 @@ void CppGenerator::gen(const EnumDecl &node)
         {
             genEnumOutTrait(node);
         }
+        else if (traitName == "Buffered")
+        {
+            checkBufferedTrait(node.name->getText());
+        }
+        else if (traitName == "Bin")
+        {
+            genEnumBinTrait(node);
+        }
+        else if (traitName == "Json")
+        {
+            genEnumJsonTrait(node);
+        }
+        else if (traitName == "Rand")
+        {
+            genRandTrait(node);
+        }
         else
         {
             throw std::runtime_error("Invalid trait " + traitName);
@@ -174,11 +631,111 @@ void CppGenerator::gen(const EnumDecl &node)
     }
 }
 
+// Each column of an enum is a constexpr array indexed by the enum, read by an
+// accessor named after the column, such as dx(Direction::N)
+void CppGenerator::genEnumColumns(const EnumDecl &node)
+{
+    auto enumName = node.name->getText();
+    for (auto field : node.body->fields)
+    {
+        if (field->values.size() != node.columns.size())
+        {
+            throw std::runtime_error("Variant " + field->getText() + " of " + enumName + " has " +
+                                     std::to_string(field->values.size()) + " values instead of " +
+                                     std::to_string(node.columns.size()));
+        }
+    }
+    if (node.columns.empty())
+    {
+        return;
+    }
+    std::set<std::string> names;
+    std::string tables;
+    std::string accessors;
+    for (size_t i = 0; i < node.columns.size(); i++)
+    {
+        const auto &column = *node.columns[i];
+        if (!names.insert(column.getText()).second)
+        {
+            throw std::runtime_error("Duplicate column " + column.getText() + " in " + enumName);
+        }
+        auto valueType = cppType(*column.type);
+        auto table = "k" + enumName + capitalize(column.getText());
+        tables += "constexpr " + valueType + " " + table + "[] = {\n  ";
+        for (auto field : node.body->fields)
+        {
+            tables += genEnumConstant(node, column, *field->values[i]) + ", ";
+        }
+        tables += "\n};\n";
+        accessors += "constexpr " + valueType + " " + column.getText() + "(" + enumName + " value) {\n";
+        accessors += "  return " + table + "[static_cast<size_t>(value)];\n";
+        accessors += "}\n\n";
+    }
+    header.addInclude(STLHeader::cstddef);
+    header.addBlock(tables + "\n" + accessors);
+}
+
+// Columns hold integers, bools, or variants of an enum declared before
+std::string CppGenerator::genEnumConstant(const EnumDecl &node, const Arg &column, const AST &value) const
+{
+    const auto &type = *column.type;
+    auto typeName = type.getText();
+    auto text = value.getText();
+    auto invalid = "Invalid value " + text + " for column " + column.getText() + " of " + node.name->getText();
+    long long min, max;
+    if (type.range || !type.args.empty())
+    {
+        throw std::runtime_error("Invalid type " + typeName + " for column " + column.getText() + " of " +
+                                 node.name->getText());
+    }
+    if (getIntegerLimits(typeName, min, max))
+    {
+        if (value.token.kind != Kind::Number ||
+            static_cast<const NumberLiteral &>(value).getValue() < min ||
+            static_cast<const NumberLiteral &>(value).getValue() > max)
+        {
+            throw std::runtime_error(invalid);
+        }
+        return genIntegerLiteral(static_cast<const NumberLiteral &>(value).getValue());
+    }
+    if (typeName == "bool")
+    {
+        if (text != "true" && text != "false")
+        {
+            throw std::runtime_error(invalid);
+        }
+        return text;
+    }
+    auto decl = typeDecls.find(typeName);
+    if (decl == typeDecls.end() || decl->second->token.kind != Kind::EnumDecl ||
+        declOrder.at(typeName) > declOrder.at(node.name->getText()))
+    {
+        throw std::runtime_error("Invalid type " + typeName + " for column " + column.getText() + " of " +
+                                 node.name->getText());
+    }
+    for (auto field : static_cast<const EnumDecl *>(decl->second)->body->fields)
+    {
+        if (value.token.kind == Kind::Id && field->getText() == text)
+        {
+            return typeName + "::" + text;
+        }
+    }
+    throw std::runtime_error(invalid);
+}
+
 void CppGenerator::genEnumInTrait(const EnumDecl &node)
 {
     auto enumName = node.name->getText();
     header.addInclude(STLHeader::istream);
-    header.addBlock("std::istream &operator>>(std::istream &is, " + enumName + " &obj);\n\n");
+    header.addBlock("std::istream &operator>>(std::istream &is, " + enumName + " &obj);\n");
+    genProfileCounters(enumName, node.body->fields);
+    auto hits = "k" + enumName + "Hits";
+    std::vector<int> numbers;
+    if (getEnumNumbers(node, numbers))
+    {
+        genEnumNumberInput(node, numbers);
+        return;
+    }
     source.addInclude(STLHeader::map);
     source.addInclude(STLHeader::string);
     std::string block;
@@ -193,29 +750,184 @@ void CppGenerator::genEnumInTrait(const EnumDecl &node)
     block += "  std::string str;\n";
     block += "  is >> str;\n";
     block += "  obj = " + strToEnum + ".at(str);\n";
+    block += "  GM_PROFILE_HIT(" + hits + ", static_cast<size_t>(obj));\n";
     block += "  return is;\n";
     block += "}\n\n";
+    std::vector<std::pair<std::string, std::string>> cases;
+    std::set<std::string> coldKeys;
+    for (auto field : sortByProfile(enumName, node.body->fields))
+    {
+        auto value = enumName + "::" + field->getText();
+        cases.push_back(std::make_pair(getEnumFieldFormat(*field),
+                                       "obj = " + value + ";\n"
+                                       "GM_PROFILE_HIT(" + hits + ", static_cast<size_t>(" + value + "));\n"
+                                       "return;\n"));
+        if (isCold(enumName, field->getText()))
+        {
+            coldKeys.insert(getEnumFieldFormat(*field));
+        }
+    }
+    source.addInclude(STLHeader::cstring);
+    block += "void readText(const char *&cur, const char *end, " + enumName + " &obj) {\n";
+    block += "  const char *key;\n";
+    block += "  size_t length;\n";
+    block += "  gm::text::readToken(cur, end, key, length);\n";
+    block += indent(genKeyDispatch(cases, coldKeys));
+    block += "  gm::text::error(\"invalid " + enumName + "\");\n";
+    block += "}\n\n";
     source.addBlock(block);
+    genReadMany(enumName);
 }
 
-void CppGenerator::genEnumOutTrait(const EnumDecl &node)
+// Enums whose formats are all integers are read as an integer, converted
+// with an offset when the values are consecutive, or with a switch
+void CppGenerator::genEnumNumberInput(const EnumDecl &node, const std::vector<int> &numbers)
 {
     auto enumName = node.name->getText();
-    header.addInclude(STLHeader::ostream);
-    header.addBlock("std::ostream &operator<<(std::ostream &os, const " + enumName + " &obj);\n\n");
-    source.addInclude(STLHeader::map);
-    source.addInclude(STLHeader::string);
+    auto intToEnum = "intTo" + enumName;
+    auto hits = "k" + enumName + "Hits";
+    source.addInclude(STLHeader::stdexcept);
     std::string block;
-    auto enumToStr = "k" + enumName + "ToStr";
-    block += "static const std::string " + enumToStr + "[] = {\n  ";
-    for (auto field : node.body->fields)
+    block += "static bool " + intToEnum + "(int value, " + enumName + " &obj) {\n";
+    if (isConsecutive(numbers))
     {
-        block += "\"" + getEnumFieldFormat(*field) + "\", ";
+        block += "  if (value < " + std::to_string(numbers.front()) + " || value > " + std::to_string(numbers.back()) + ") {\n";
+        block += "    return false;\n";
+        block += "  }\n";
+        block += "  obj = static_cast<" + enumName + ">(" + genOffset("value", -numbers.front()) + ");\n";
+        block += "  return true;\n";
+    }
+    else
+    {
+        std::map<std::string, int> fieldNumbers;
+        for (size_t i = 0; i < numbers.size(); i++)
+        {
+            fieldNumbers[node.body->fields[i]->getText()] = numbers[i];
+        }
+        block += "  switch (value) {\n";
+        for (auto field : sortByProfile(enumName, node.body->fields))
+        {
+            block += "  case " + std::to_string(fieldNumbers[field->getText()]) + ":\n";
+            block += "    obj = " + enumName + "::" + field->getText() + ";\n";
+            block += "    return true;\n";
+        }
+        block += "  default:\n";
+        block += "    return false;\n";
+        block += "  }\n";
     }
-    block += "\n};\n\n";
-    block += "std::ostream &operator<<(std::ostream &os, const " + enumName + " &obj) {\n";
-    block += "  os << " + enumToStr + "[static_cast<size_t>(obj)];\n";
-    block += "  return os;\n";
+    block += "}\n\n";
+    block += "std::istream &operator>>(std::istream &is, " + enumName + " &obj) {\n";
+    block += "  int value;\n";
+    block += "  if (!(is >> value)) {\n";
+    block += "    return is;\n";
+    block += "  }\n";
+    block += "  if (!" + intToEnum + "(value, obj)) {\n";
+    block += "    throw std::out_of_range(\"Invalid " + enumName + "\");\n";
+    block += "  }\n";
+    block += "  GM_PROFILE_HIT(" + hits + ", static_cast<size_t>(obj));\n";
+    block += "  return is;\n";
+    block += "}\n\n";
+    block += "void readText(const char *&cur, const char *end, " + enumName + " &obj) {\n";
+    block += "  int value;\n";
+    block += "  gm::readText(cur, end, value);\n";
+    block += "  if (!" + intToEnum + "(value, obj)) {\n";
+    block += "    gm::text::error(\"invalid " + enumName + "\");\n";
+    block += "  }\n";
+    block += "  GM_PROFILE_HIT(" + hits + ", static_cast<size_t>(obj));\n";
+    block += "}\n\n";
+    source.addBlock(block);
+    genReadMany(enumName);
+}
+
+void CppGenerator::genEnumOutTrait(const EnumDecl &node)
+{
+    auto enumName = node.name->getText();
+    std::vector<int> numbers;
+    if (getEnumNumbers(node, numbers))
+    {
+        if (isConsecutive(numbers))
+        {
+            genTextOutput(enumName, "  os << " + genOffset("static_cast<int>(obj)", numbers.front()) + ";\n");
+            return;
+        }
+        auto enumToInt = "k" + enumName + "ToInt";
+        std::string block = "static const int " + enumToInt + "[] = {\n  ";
+        for (int number : numbers)
+        {
+            block += std::to_string(number) + ", ";
+        }
+        block += "\n};\n\n";
+        source.addBlock(block);
+        genTextOutput(enumName, "  os << " + enumToInt + "[static_cast<size_t>(obj)];\n");
+        return;
+    }
+    source.addInclude(STLHeader::map);
+    source.addInclude(STLHeader::string);
+    std::string block;
+    auto enumToStr = "k" + enumName + "ToStr";
+    block += "static const std::string " + enumToStr + "[] = {\n  ";
+    for (auto field : node.body->fields)
+    {
+        block += "\"" + getEnumFieldFormat(*field) + "\", ";
+    }
+    block += "\n};\n\n";
+    source.addBlock(block);
+    genTextOutput(enumName, "  os << " + enumToStr + "[static_cast<size_t>(obj)];\n");
+}
+
+void CppGenerator::genEnumBinTrait(const EnumDecl &node)
+{
+    auto enumName = node.name->getText();
+    genBinDecl(enumName);
+    std::string block;
+    block += "void encode(uint8_t *&out, const " + enumName + " &obj) {\n";
+    block += "  gm::store<int32_t>(out, static_cast<int32_t>(obj));\n";
+    block += "  out += " + std::to_string(kEnumBinSize) + ";\n";
+    block += "}\n\n";
+    block += "void decode(const uint8_t *&in, " + enumName + " &obj) {\n";
+    block += "  obj = static_cast<" + enumName + ">(gm::loadEnum(in, " +
+             std::to_string(node.body->fields.size()) + "));\n";
+    block += "  in += " + std::to_string(kEnumBinSize) + ";\n";
+    block += "}\n\n";
+    source.addBlock(block);
+}
+
+// Enums are JSON strings holding their format
+void CppGenerator::genEnumJsonTrait(const EnumDecl &node)
+{
+    auto enumName = node.name->getText();
+    addRuntimeTrait("json");
+    header.addBlock("void writeJson(std::string &out, const " + enumName + " &obj);\n"
+                    "void readJson(const char *&cur, const char *end, " + enumName + " &obj);\n\n");
+    source.addInclude(STLHeader::cstring);
+    std::string block;
+    auto enumToJson = "k" + enumName + "ToJson";
+    block += "static const char *const " + enumToJson + "[] = {\n  ";
+    for (auto field : node.body->fields)
+    {
+        block += quote(quote(getEnumFieldFormat(*field))) + ", ";
+    }
+    block += "\n};\n\n";
+    block += "void writeJson(std::string &out, const " + enumName + " &obj) {\n";
+    block += "  out += " + enumToJson + "[static_cast<size_t>(obj)];\n";
+    block += "}\n\n";
+    std::vector<std::pair<std::string, std::string>> cases;
+    std::set<std::string> coldKeys;
+    for (auto field : sortByProfile(enumName, node.body->fields))
+    {
+        cases.push_back(std::make_pair(getEnumFieldFormat(*field),
+                                       "obj = " + enumName + "::" + field->getText() + ";\nreturn;\n"));
+        if (isCold(enumName, field->getText()))
+        {
+            coldKeys.insert(getEnumFieldFormat(*field));
+        }
+    }
+    block += "void readJson(const char *&cur, const char *end, " + enumName + " &obj) {\n";
+    block += "  const char *key;\n";
+    block += "  size_t length;\n";
+    block += "  gm::json::readRawString(cur, end, key, length);\n";
+    block += indent(genKeyDispatch(cases, coldKeys));
+    block += "  gm::json::error(\"invalid " + enumName + "\");\n";
     block += "}\n\n";
     source.addBlock(block);
 }
@@ -223,6 +935,13 @@ void CppGenerator::genEnumOutTrait(const EnumDecl &node)
 void CppGenerator::gen(const StructDecl &node)
 {
     CppBlock &structBody = genStructBody(node);
+    genStructLayoutChecks(node);
+    bool hasSetters = hasTrait(node.name->getText(), "Undo") || hasTrait(node.name->getText(), "Zobrist") ||
+                      hasTrait(node.name->getText(), "Track");
+    if (hasSetters || hasTrait(node.name->getText(), "Diff"))
+    {
+        genStructFieldIds(node, structBody);
+    }
     for (auto traitId : node.traitList->traits)
     {
         auto traitName = traitId->getText();
@@ -230,15 +949,67 @@ void CppGenerator::gen(const StructDecl &node)
         {
             genStructEqTrait(node, structBody);
         }
+        else if (traitName == "In")
+        {
+            genStructInTrait(node);
+        }
         else if (traitName == "Out")
         {
             genStructOutTrait(node);
         }
+        else if (traitName == "Buffered")
+        {
+            checkBufferedTrait(node.name->getText());
+        }
+        else if (traitName == "Bin")
+        {
+            genStructBinTrait(node);
+        }
+        else if (traitName == "View")
+        {
+            genStructViewTrait(node);
+        }
+        else if (traitName == "Columns")
+        {
+            genStructColumnsTrait(node);
+        }
+        else if (traitName == "Json")
+        {
+            genStructJsonTrait(node);
+        }
+        else if (traitName == "Rand")
+        {
+            genRandTrait(node);
+        }
+        else if (traitName == "Undo")
+        {
+            genStructUndoTrait(node, structBody);
+        }
+        else if (traitName == "Zobrist")
+        {
+            genStructZobristTrait(node, structBody);
+        }
+        else if (traitName == "Diff")
+        {
+            genStructDiffTrait(node, structBody);
+        }
+        else if (traitName == "Track")
+        {
+            genStructTrackTrait(node, structBody);
+        }
+        else if (traitName == "Packed")
+        {
+            genStructPackedTrait(node);
+        }
         else
         {
             throw std::runtime_error("Invalid trait " + traitName);
         }
     }
+    if (hasSetters)
+    {
+        genStructSetters(node, structBody);
+    }
 }
 
 CppBlock &CppGenerator::genStructBody(const StructDecl &node)
@@ -247,245 +1018,2835 @@ CppBlock &CppGenerator::genStructBody(const StructDecl &node)
     CppBlock &block = header.addBlock();
     block.addBlock("struct " + structName + " {\n");
     CppBlock &structBody = block.addBlock();
-    structBody += "  " + structName + "() = default;\n";
     const auto &fields = node.body->fields;
+    bool bookkeeping = hasBookkeeping(structName);
+    bool zobrist = hasTrait(structName, "Zobrist");
+    if (zobrist)
+    {
+        // The hash needs defined fields: they get their default value, or
+        // the minimum of their range when it does not include 0
+        structBody += "  " + structName + "()";
+        std::string prefix = " : ";
+        for (auto field : fields)
+        {
+            std::string value;
+            auto range = field->type->range;
+            if (range && (range->min->getValue() > 0 || range->max->getValue() < 0))
+            {
+                value = genIntegerLiteral(range->min->getValue());
+            }
+            structBody += prefix + field->getText() + "(" + value + ")";
+            prefix = ", ";
+        }
+        structBody += " {\n" + genFieldsWritten(structName, "", "    ") + "  }\n";
+    }
+    else
+    {
+        structBody += "  " + structName + "() = default;\n";
+    }
     if (!fields.empty())
     {
-        structBody += "  " + structName + "(";
+        structBody += "  ";
+        if (isTriviallyCopyable(structName) && !bookkeeping)
+        {
+            structBody += "constexpr ";
+        }
+        structBody += structName + "(";
         int fieldCount = fields.size();
         for (auto field : fields)
         {
-            structBody += field->type->getText() + " " + field->getText();
+            structBody += cppType(*field->type) + " " + field->getText();
             if (--fieldCount > 0)
             {
                 structBody += ", ";
             }
         }
-        structBody += "): ";
+        // The hash of the Zobrist trait throws for a field outside its range
+        structBody += ")" + (zobrist ? std::string(" ") : genNoexcept(fields)) + ": ";
         fieldCount = fields.size();
         for (auto field : fields)
         {
-            structBody += field->getText() + "(" + field->getText() + ")";
+            structBody += field->getText() + "(" + genMove(*field->type, field->getText()) + ")";
             if (--fieldCount > 0)
             {
                 structBody += ", ";
             }
         }
-        structBody += " {}\n";
+        structBody += bookkeeping ? " {\n" + genFieldsWritten(structName, "", "    ") + "  }\n" : " {}\n";
     }
     for (auto field : fields)
     {
-        structBody += "  " + field->type->getText() + " " + field->getText() + ";\n";
+        structBody += "  " + cppType(*field->type) + " " + field->getText() + ";\n";
+    }
+    if (hasTrait(structName, "Zobrist"))
+    {
+        structBody += "  uint64_t hash;\n";
+    }
+    if (hasTrait(structName, "Track"))
+    {
+        // A new value has all its fields dirty, as after the constructor
+        // taking all the fields
+        structBody += "  uint64_t dirty = kAllFields;\n";
     }
     block.addBlock("};\n\n");
     return structBody;
 }
 
-void CppGenerator::genStructEqTrait(const StructDecl &node, CppBlock &structBody)
+// Identifiers of the fields, used by the traits generating setters and by
+// the Diff trait
+void CppGenerator::genStructFieldIds(const StructDecl &node, CppBlock &structBody)
 {
-    auto structName = node.name->getText();
-    structBody += "  bool operator==(const " + structName + " &other) const;\n";
-    std::string block;
-    block += "bool " + structName + "::operator==(const " + structName + " &other) const {\n";
-    block += "  return ";
-    int fieldCount = node.body->fields.size();
+    structBody += "  enum Field {\n";
     for (auto field : node.body->fields)
     {
-        std::string fieldName = field->getText();
-        block += fieldName + " == other." + fieldName;
-        if (--fieldCount > 0)
-        {
-            block += "\n      && ";
-        }
+        structBody += "    " + field->getText() + "_f,\n";
     }
-    block += ";\n";
-    block += "}\n\n";
-    source.addBlock(block);
+    structBody += "  };\n";
 }
 
-void CppGenerator::genStructOutTrait(const StructDecl &node)
+// The setters of a struct check the range of the value, record the old value
+// of the field for the Undo trait before assigning the new one, update the
+// hash of the Zobrist trait, and mark the field dirty for the Track trait
+void CppGenerator::genStructSetters(const StructDecl &node, CppBlock &structBody)
 {
-    auto structName = node.name->getText();
-    header.addInclude(STLHeader::ostream);
-    header.addBlock("std::ostream &operator<<(std::ostream &os, const " + structName + " &obj);\n\n");
-    std::string block;
-    block += "std::ostream &operator<<(std::ostream &os, const " + structName + " &obj) {\n";
-    block += "  os << \"{ \";\n";
-    int fieldCount = node.body->fields.size();
+    bool undo = hasTrait(node.name->getText(), "Undo");
     for (auto field : node.body->fields)
     {
-        block += "  os << \"" + field->getText() + "\" << \": \" << obj." + field->getText();
-        if (--fieldCount > 0)
+        auto fieldName = field->getText();
+        auto typeName = field->type->getText();
+        auto param = kBuiltinTypes.count(typeName) ? cppType(*field->type) + " value"
+                                                   : "const " + cppType(*field->type) + " &value";
+        structBody += "  void set" + capitalize(fieldName) + "(" + (undo ? "gm::UndoLog<Change> &log, " : "") +
+                      param + ") {\n";
+        auto check = genRangeCheck(*field->type, "value",
+                                   "throw std::out_of_range(\"" + node.name->getText() + "::set" +
+                                       capitalize(fieldName) + "\")");
+        if (!check.empty())
         {
-            block += " << \", \"";
+            header.addInclude(STLHeader::stdexcept);
+            structBody += indent(indent(check));
         }
-        block += ";\n";
+        if (undo)
+        {
+            structBody += "    Change change;\n";
+            structBody += "    change.field = " + fieldName + "_f;\n";
+            structBody += "    change.value." + fieldName + " = this->" + fieldName + ";\n";
+            structBody += "    log.push(change);\n";
+        }
+        structBody += genFieldUpdate(node, *field, "value", "    ");
+        structBody += "  }\n";
     }
-    block += "  os << \" }\";\n";
-    block += "  return os;\n";
-    block += "}\n\n";
-    source.addBlock(block);
 }
 
-void CppGenerator::gen(const UnionDecl &node)
+// Assigns a new value to a field, from a setter or when rolling back
+std::string CppGenerator::genFieldUpdate(const StructDecl &node, const StructFieldDecl &field,
+                                         const std::string &expr, const std::string &indentation)
 {
-    CppBlock &unionBody = genUnionBody(node);
-    for (auto traitId : node.traitList->traits)
+    auto fieldName = field.getText();
+    std::string code;
+    if (hasTrait(node.name->getText(), "Zobrist") && getZobristKeyCount(*field.type) > 0)
     {
-        auto traitName = traitId->getText();
-        if (traitName == "Eq")
-        {
-            genUnionEqTrait(node, unionBody);
-        }
-        else if (traitName == "Out")
+        auto keys = "k" + capitalize(fieldName) + "Keys";
+        code += indentation + "this->hash ^= " + keys + "[" + genZobristIndex(*field.type, "this->" + fieldName) +
+                "] ^ " + keys + "[" + genZobristIndex(*field.type, expr) + "];\n";
+    }
+    if (hasTrait(node.name->getText(), "Track"))
+    {
+        code += indentation + "this->dirty |= uint64_t(1) << " + fieldName + "_f;\n";
+    }
+    code += indentation + "this->" + fieldName + " = " + expr + ";\n";
+    return code;
+}
+
+// Generated code assigning all the fields of a value at once must then
+// update the members derived from them. The changed fields are all the fields
+// unless a mask of field ids is given.
+std::string CppGenerator::genFieldsWritten(const std::string &typeName, const std::string &prefix,
+                                           const std::string &indentation, const std::string &changed)
+{
+    std::string code;
+    if (hasTrait(typeName, "Zobrist"))
+    {
+        code += indentation + prefix + "rehash();\n";
+    }
+    if (hasTrait(typeName, "Track"))
+    {
+        code += indentation + prefix + "dirty" + (changed.empty() ? " = " + typeName + "::kAllFields" : " |= " + changed) + ";\n";
+    }
+    return code;
+}
+
+// The Zobrist trait maintains a hash of the fields with few values: each
+// value of each such field has a random key, and the hash is the XOR of the
+// keys of the current values. The keys are generated by gammac, from a seed
+// depending on the names of the struct and the field. A field outside its
+// range has no key: computing the hash then throws std::out_of_range.
+void CppGenerator::genStructZobristTrait(const StructDecl &node, CppBlock &structBody)
+{
+    auto structName = node.name->getText();
+    std::string computeHash, tables;
+    for (auto field : node.body->fields)
+    {
+        auto fieldName = field->getText();
+        size_t count = getZobristKeyCount(*field->type);
+        if (count == 0)
         {
-            genUnionOutTrait(node);
+            continue;
         }
-        else
+        auto keys = "k" + capitalize(fieldName) + "Keys";
+        structBody += "  static const uint64_t " + keys + "[" + std::to_string(count) + "];\n";
+        computeHash += indent(indent(genRangeCheck(*field->type, fieldName,
+                                                   "throw std::out_of_range(\"" + structName + "::" + fieldName + "\")")));
+        computeHash += "    hash ^= " + keys + "[" + genZobristIndex(*field->type, fieldName) + "];\n";
+        uint64_t state = fingerprint(structName + "." + fieldName);
+        tables += "const uint64_t " + structName + "::" + keys + "[" + std::to_string(count) + "] = {\n";
+        for (size_t i = 0; i < count; i++)
         {
-            throw std::runtime_error("Invalid trait " + traitName);
+            uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            z ^= z >> 31;
+            std::ostringstream key;
+            key << "0x" << std::hex << std::setw(16) << std::setfill('0') << z << "ULL";
+            tables += (i % 4 == 0 ? "  " : " ") + key.str() + "," + (i % 4 == 3 || i + 1 == count ? "\n" : "");
         }
+        tables += "};\n\n";
+    }
+    if (computeHash.empty())
+    {
+        throw std::runtime_error("Struct " + structName +
+                                 " has no enum, bool, char or integer range field for trait Zobrist");
     }
+    header.addInclude(STLHeader::cstdint);
+    header.addInclude(STLHeader::stdexcept);
+    structBody += "  uint64_t computeHash() const {\n";
+    structBody += "    uint64_t hash = 0;\n";
+    structBody += computeHash;
+    structBody += "    return hash;\n";
+    structBody += "  }\n";
+    structBody += "  void rehash() {\n";
+    structBody += "    hash = computeHash();\n";
+    structBody += "  }\n";
+    source.addBlock(tables);
 }
 
-CppBlock &CppGenerator::genUnionBody(const UnionDecl &node)
+// Number of keys of a field type for the Zobrist trait, or 0 if the field is
+// not hashed
+size_t CppGenerator::getZobristKeyCount(const TypeRef &type) const
 {
-    std::string unionName = node.name->getText();
-    CppBlock &block = header.addBlock();
-    block.addBlock("struct " + unionName + " {\n");
-    CppBlock &unionBody = block.addBlock();
-    unionBody += "  enum Type {\n";
-    unionBody += "    Undef,\n";
-    for (auto field : node.body->fields)
+    auto typeName = type.getText();
+    if (type.range)
     {
-        unionBody += "    " + field->getText() + "_t,\n";
+        auto span = getRangeSpan(*type.range);
+        return span < kMaxZobristKeys ? span + 1 : 0;
     }
-    unionBody += "  } type;\n";
-    for (auto field : node.body->fields)
+    if (typeName == "bool")
     {
-        if (!field->args.empty())
-        {
-            unionBody += "  struct " + field->getText() + "_d {\n";
-            for (auto arg : field->args)
-            {
-                unionBody += "    " + arg->type->getText() + " " + arg->getText() + ";\n";
-            }
-            unionBody += "  };\n";
-        }
+        return 2;
     }
-    unionBody += "  union {\n";
-    for (auto field : node.body->fields)
+    if (typeName == "char" || isByteInteger(typeName))
     {
-        if (!field->args.empty())
-        {
-            std::string fieldName = field->getText();
-            unionBody += "    " + fieldName + "_d " + fieldName + ";\n";
-        }
+        return 256;
     }
-    unionBody += "  } data;\n";
-    unionBody += "  " + unionName + "(Type type = Undef): type(type) {}\n";
-    for (auto field : node.body->fields)
+    auto decl = typeDecls.find(typeName);
+    if (decl != typeDecls.end() && decl->second->token.kind == Kind::EnumDecl)
     {
-        std::string fieldName = field->getText();
-        unionBody += "  static " + unionName + " " + fieldName + "(";
-        int argCount = field->args.size();
-        for (auto arg : field->args)
-        {
-            unionBody += arg->type->getText() + " " + arg->getText();
-            if (--argCount > 0)
-            {
-                unionBody += ", ";
-            }
-        }
-        unionBody += ") {\n";
-        unionBody += "    " + unionName + " obj(" + fieldName + "_t);\n";
-        for (auto arg : field->args)
-        {
-            unionBody += "    obj.data." + fieldName + "." + arg->getText() + " = " + arg->getText() + ";\n";
-        }
-        unionBody += "    return obj;\n";
-        unionBody += "  }\n";
+        return static_cast<const EnumDecl *>(decl->second)->body->fields.size();
     }
-    block.addBlock("};\n\n");
-    return unionBody;
+    return 0;
 }
 
-void CppGenerator::genUnionEqTrait(const UnionDecl &node, CppBlock &unionBody)
+std::string CppGenerator::genZobristIndex(const TypeRef &type, const std::string &expr) const
 {
-    auto unionName = node.name->getText();
-    unionBody += "  bool operator==(const " + unionName + " &other) const;\n";
-    std::string block;
-    block += "bool " + unionName + "::operator==(const " + unionName + " &other) const {\n";
-    block += "  if (type != other.type) return false;\n";
-    block += "  switch (type) {\n";
-    for (auto field : node.body->fields)
+    if (type.range)
     {
-        if (!field->args.empty())
-        {
-            std::string fieldName = field->getText();
-            block += "  case " + unionName + "::" + field->getText() + "_t:\n";
-            block += "    return ";
-            int argCount = field->args.size();
-            for (auto arg : field->args)
-            {
-                std::string argName = fieldName + "." + arg->getText();
-                block += "data." + argName + " == other.data." + argName;
-                if (--argCount > 0)
-                {
-                    block += "\n      && ";
-                }
-            }
-            block += ";\n";
-            block += "  break;\n";
-        }
+        return "static_cast<size_t>(" + genOffset(expr, -type.range->min->getValue()) + ")";
     }
-    block += "  default:\n";
-    block += "    return true;\n";
-    block += "  }\n";
-    block += "}\n\n";
-    source.addBlock(block);
+    if (type.getText() == "char" || isByteInteger(type.getText()))
+    {
+        return "static_cast<unsigned char>(" + expr + ")";
+    }
+    return "static_cast<size_t>(" + expr + ")";
 }
 
-void CppGenerator::genUnionOutTrait(const UnionDecl &node)
+// The Track trait keeps a bit per field changed since the last call to
+// clearDirty(), set by the setters, rollback and the generated readers
+void CppGenerator::genStructTrackTrait(const StructDecl &node, CppBlock &structBody)
 {
-    auto unionName = node.name->getText();
-    header.addInclude(STLHeader::ostream);
-    header.addBlock("std::ostream &operator<<(std::ostream &os, const " + unionName + " &obj);\n\n");
-    std::string block;
-    block += "std::ostream &operator<<(std::ostream &os, const " + unionName + " &obj) {\n";
-    block += "  switch (obj.type) {\n";
-    for (auto field : node.body->fields)
+    auto structName = node.name->getText();
+    size_t count = node.body->fields.size();
+    if (count > 64)
     {
-        block += "  case " + unionName + "::" + field->getText() + "_t:\n";
-        block += "    os << " + expandFormat(*field, field->format->getText()) + ";\n";
-        block += "  break;\n";
+        throw std::runtime_error("Struct " + structName + " has too many fields for trait Track");
     }
-    block += "  default:\n";
-    block += "    break;";
-    block += "  }\n";
-    block += "  return os;\n";
-    block += "}\n\n";
-    source.addBlock(block);
+    std::stringstream mask;
+    mask << "0x" << std::hex << (count == 64 ? ~uint64_t(0) : (uint64_t(1) << count) - 1) << "ULL";
+    header.addInclude(STLHeader::cstdint);
+    structBody += "  static constexpr uint64_t kAllFields = " + mask.str() + ";\n";
+    structBody += "  bool isDirty(Field field) const { return (dirty >> field) & 1; }\n";
+    structBody += "  uint64_t dirtyFields() const { return dirty; }\n";
+    structBody += "  void clearDirty() { dirty = 0; }\n";
+    source.addBlock("constexpr uint64_t " + structName + "::kAllFields;\n\n");
 }
 
-std::string CppGenerator::expandFormat(const UnionFieldDecl &scope, const std::string &format)
+bool CppGenerator::hasBookkeeping(const std::string &structName) const
 {
-    std::string out = "\"";
-    for (char c : format)
+    return hasTrait(structName, "Zobrist") || hasTrait(structName, "Track");
+}
+
+// The Undo trait logs the changes made by the setters, with the old value
+// of the field stored in a union
+void CppGenerator::genStructUndoTrait(const StructDecl &node, CppBlock &structBody)
+{
+    auto structName = node.name->getText();
+    for (auto field : node.body->fields)
     {
-        switch (c)
+        if (!isTriviallyCopyable(*field->type))
+        {
+            throw std::runtime_error("Field " + structName + "::" + field->getText() +
+                                     " must be trivially copyable for trait Undo");
+        }
+    }
+    header.addInclude("gamma/undo.hpp");
+    structBody += "  struct Change {\n";
+    structBody += "    Field field;\n";
+    structBody += "    union Value {\n";
+    structBody += "      Value() {}\n";
+    for (auto field : node.body->fields)
+    {
+        structBody += "      " + cppType(*field->type) + " " + field->getText() + ";\n";
+    }
+    structBody += "    } value;\n";
+    structBody += "  };\n";
+    structBody += "  void rollback(gm::UndoLog<Change> &log, size_t mark) {\n";
+    structBody += "    while (log.mark() > mark) {\n";
+    structBody += "      const Change &change = log.pop();\n";
+    structBody += "      switch (change.field) {\n";
+    for (auto field : node.body->fields)
+    {
+        auto fieldName = field->getText();
+        structBody += "      case " + fieldName + "_f:\n";
+        structBody += genFieldUpdate(node, *field, "change.value." + fieldName, "        ");
+        structBody += "        break;\n";
+    }
+    structBody += "      }\n";
+    structBody += "    }\n";
+    structBody += "  }\n";
+}
+
+// A patch holds the fields that differ between two values, with a bit per
+// changed field. Its binary encoding, generated when the struct also has the
+// Bin trait, is the bitmask followed by the Bin encoding of the changed
+// fields only.
+void CppGenerator::genStructDiffTrait(const StructDecl &node, CppBlock &structBody)
+{
+    auto structName = node.name->getText();
+    const auto &fields = node.body->fields;
+    if (fields.size() > 64)
+    {
+        throw std::runtime_error("Struct " + structName + " has too many fields for trait Diff");
+    }
+    for (auto field : fields)
+    {
+        auto typeName = getValueType(field->type)->getText();
+        if (typeDecls.count(typeName) && typeDecls.at(typeName)->token.kind != Kind::EnumDecl &&
+            !hasTrait(typeName, "Eq"))
+        {
+            throw std::runtime_error("Type " + typeName + " must have trait Eq");
+        }
+    }
+    header.addInclude(STLHeader::cstdint);
+    structBody += "  struct Patch {\n";
+    structBody += "    uint64_t changed = 0;\n";
+    for (auto field : fields)
+    {
+        structBody += "    " + cppType(*field->type) + " " + field->getText() + ";\n";
+    }
+    structBody += "    bool has(Field field) const { return (changed >> field) & 1; }\n";
+    structBody += "  };\n";
+
+    auto patchType = structName + "::Patch";
+    header.addBlock(patchType + " diff(const " + structName + " &a, const " + structName + " &b);\n" +
+                    "void apply(" + structName + " &state, const " + patchType + " &patch);\n\n");
+    std::string block;
+    block += patchType + " diff(const " + structName + " &" + (fields.empty() ? "" : "a") + ", const " +
+             structName + " &" + (fields.empty() ? "" : "b") + ") {\n";
+    block += "  " + patchType + " patch;\n";
+    for (auto field : fields)
+    {
+        auto fieldName = field->getText();
+        block += "  if (!(a." + fieldName + " == b." + fieldName + ")) {\n";
+        block += "    patch.changed |= uint64_t(1) << " + structName + "::" + fieldName + "_f;\n";
+        block += "    patch." + fieldName + " = b." + fieldName + ";\n";
+        block += "  }\n";
+    }
+    block += "  return patch;\n";
+    block += "}\n\n";
+    block += "void apply(" + structName + " &" + (fields.empty() ? "" : "state") + ", const " + patchType + " &" +
+             (fields.empty() ? "" : "patch") + ") {\n";
+    for (auto field : fields)
+    {
+        auto fieldName = field->getText();
+        block += "  if (patch.has(" + structName + "::" + fieldName + "_f)) {\n";
+        block += "    state." + fieldName + " = patch." + fieldName + ";\n";
+        block += "  }\n";
+    }
+    block += genFieldsWritten(structName, "state.", "  ", "patch.changed");
+    block += "}\n\n";
+    source.addBlock(block);
+
+    if (!hasTrait(structName, "Bin"))
+    {
+        return;
+    }
+    size_t maskSize = fields.size() <= 8 ? 1 : fields.size() <= 16 ? 2 : fields.size() <= 32 ? 4 : 8;
+    auto maskType = "uint" + std::to_string(maskSize * 8) + "_t";
+    header.addInclude("gamma/bin.hpp");
+    header.addBlock("constexpr size_t k" + structName + "PatchMaxBinSize = " +
+                    std::to_string(maskSize + getBinSize(structName)) + ";\n" +
+                    "void encode(uint8_t *&out, const " + patchType + " &patch);\n" +
+                    "void decode(const uint8_t *&in, " + patchType + " &patch);\n\n");
+    block = "void encode(uint8_t *&out, const " + patchType + " &patch) {\n";
+    block += "  gm::store<" + maskType + ">(out, static_cast<" + maskType + ">(patch.changed));\n";
+    block += "  out += " + std::to_string(maskSize) + ";\n";
+    for (auto field : fields)
+    {
+        auto fieldName = field->getText();
+        block += "  if (patch.has(" + structName + "::" + fieldName + "_f)) {\n";
+        block += indent(genFieldEncode(*field->type, "patch." + fieldName));
+        block += "  }\n";
+    }
+    block += "}\n\n";
+    block += "void decode(const uint8_t *&in, " + patchType + " &patch) {\n";
+    block += "  patch.changed = gm::load<" + maskType + ">(in);\n";
+    if (fields.size() < maskSize * 8)
+    {
+        // Bits past the last field do not stand for any field
+        std::stringstream unused;
+        unused << "0x" << std::hex << ~((uint64_t(1) << fields.size()) - 1) << "ULL";
+        source.addInclude(STLHeader::stdexcept);
+        block += "  if (patch.changed & " + unused.str() + ") {\n";
+        block += "    throw std::runtime_error(\"Invalid " + structName + " patch\");\n";
+        block += "  }\n";
+    }
+    block += "  in += " + std::to_string(maskSize) + ";\n";
+    for (auto field : fields)
+    {
+        auto fieldName = field->getText();
+        block += "  if (patch.has(" + structName + "::" + fieldName + "_f)) {\n";
+        block += indent(genFieldDecode(*field->type, "patch." + fieldName));
+        block += "  }\n";
+    }
+    block += "}\n\n";
+    source.addBlock(block);
+}
+
+// The Packed trait stores the fields in a few 64-bit words, each field taking
+// the bits needed for its values: integers with a range are stored as their
+// offset from the minimum, and their setters throw std::out_of_range for
+// values outside it. A field never straddles two words.
+void CppGenerator::genStructPackedTrait(const StructDecl &node)
+{
+    auto structName = node.name->getText();
+    auto packedName = structName + "Packed";
+    std::string accessors, packFields, unpackFields;
+    size_t word = 0, shift = 0;
+    for (auto field : node.body->fields)
+    {
+        auto fieldName = field->getText();
+        auto typeName = field->type->getText();
+        auto builtin = kBuiltinTypes.find(typeName);
+        unsigned long long span;
+        std::string type = cppType(*field->type), getter, raw;
+        if (field->type->range)
+        {
+            auto min = field->type->range->min->getValue();
+            span = getRangeSpan(*field->type->range);
+            if (type == "int")
+            {
+                getter = genOffset("static_cast<int>(bits)", min);
+            }
+            else
+            {
+                getter = "static_cast<" + type + ">(" + (min ? genOffset("static_cast<int64_t>(bits)", min) : "bits") + ")";
+            }
+            raw = min ? "(" + genOffset("static_cast<uint64_t>(value)", -min) + ")" : "static_cast<uint64_t>(value)";
+        }
+        else if (typeName == "bool")
+        {
+            span = 1;
+            getter = "(bits) != 0";
+            raw = "static_cast<uint64_t>(value)";
+        }
+        else if (typeName == "char")
+        {
+            span = 255;
+            getter = "static_cast<char>(bits)";
+            raw = "static_cast<unsigned char>(value)";
+        }
+        else if (builtin != kBuiltinTypes.end() && builtin->second.integer)
+        {
+            // Integers without a range are stored as their bits
+            auto bitsType = "uint" + std::to_string(8 * builtin->second.size) + "_t";
+            span = builtin->second.size == 8 ? ~0ULL : (1ULL << (8 * builtin->second.size)) - 1;
+            getter = type == bitsType ? "static_cast<" + type + ">(bits)"
+                                      : "static_cast<" + type + ">(static_cast<" + bitsType + ">(bits))";
+            raw = "static_cast<" + bitsType + ">(value)";
+        }
+        else if (typeDecls.count(typeName) && typeDecls.at(typeName)->token.kind == Kind::EnumDecl)
+        {
+            auto count = static_cast<const EnumDecl *>(typeDecls.at(typeName))->body->fields.size();
+            span = count > 0 ? count - 1 : 0;
+            getter = "static_cast<" + typeName + ">(bits)";
+            raw = "static_cast<uint64_t>(value)";
+        }
+        else
+        {
+            throw std::runtime_error("Field " + structName + "::" + fieldName +
+                                     " must be a bool, a char, an integer or an enum for trait Packed");
+        }
+        size_t bits = 1;
+        while (bits < 64 && (span >> bits) != 0)
+        {
+            bits++;
+        }
+        if (shift + bits > 64)
+        {
+            word++;
+            shift = 0;
+        }
+        uint64_t maskValue = bits == 64 ? ~uint64_t(0) : (uint64_t(1) << bits) - 1;
+        std::stringstream mask, fieldMask;
+        mask << "0x" << std::hex << maskValue << "ULL";
+        fieldMask << "0x" << std::hex << (maskValue << shift) << "ULL";
+        auto wordRef = "words[" + std::to_string(word) + "]";
+        auto bitsExpr = shift ? "(" + wordRef + " >> " + std::to_string(shift) + ")" : wordRef;
+        getter.replace(getter.find("(bits)"), 6, "(" + (bits == 64 ? wordRef : bitsExpr + " & " + mask.str()) + ")");
+        accessors += "  " + type + " " + fieldName + "() const { return " + getter + "; }\n";
+        accessors += "  void set" + capitalize(fieldName) + "(" + type + " value) {\n";
+        auto check = genRangeCheck(*field->type, "value",
+                                   "throw std::out_of_range(\"" + packedName + "::set" + capitalize(fieldName) + "\")");
+        if (!check.empty())
+        {
+            header.addInclude(STLHeader::stdexcept);
+            accessors += indent(indent(check));
+        }
+        auto bitsValue = raw + " & " + mask.str();
+        if (bits == 64)
+        {
+            accessors += "    " + wordRef + " = " + raw + ";\n";
+        }
+        else
+        {
+            accessors += "    " + wordRef + " = (" + wordRef + " & ~" + fieldMask.str() + ") | (" +
+                         (shift ? "(" + bitsValue + ") << " + std::to_string(shift) : bitsValue) + ");\n";
+        }
+        accessors += "  }\n";
+        packFields += "  packed.set" + capitalize(fieldName) + "(obj." + fieldName + ");\n";
+        unpackFields += "  obj." + fieldName + " = packed." + fieldName + "();\n";
+        shift += bits;
+    }
+    size_t wordCount = word + 1;
+    header.addInclude(STLHeader::cstdint);
+    std::string block;
+    block += "struct " + packedName + " {\n";
+    block += "  " + packedName + "() : words() {}\n";
+    block += accessors;
+    block += "  bool operator==(const " + packedName + " &other) const {\n";
+    block += "    return ";
+    for (size_t i = 0; i < wordCount; i++)
+    {
+        auto index = std::to_string(i);
+        block += (i > 0 ? " && " : "") + std::string("words[") + index + "] == other.words[" + index + "]";
+    }
+    block += ";\n";
+    block += "  }\n";
+    block += "  bool operator!=(const " + packedName + " &other) const { return !(*this == other); }\n";
+    block += "  uint64_t hash() const {\n";
+    block += "    uint64_t h = words[0] * 0x9E3779B97F4A7C15ULL;\n";
+    for (size_t i = 1; i < wordCount; i++)
+    {
+        block += "    h = (h ^ words[" + std::to_string(i) + "]) * 0x9E3779B97F4A7C15ULL;\n";
+    }
+    block += "    return h ^ (h >> 29);\n";
+    block += "  }\n";
+    block += "  uint64_t words[" + std::to_string(wordCount) + "];\n";
+    block += "};\n\n";
+    block += packedName + " pack(const " + structName + " &obj);\n";
+    block += "void unpack(const " + packedName + " &packed, " + structName + " &obj);\n\n";
+    header.addBlock(block);
+    block = packedName + " pack(const " + structName + " &" + (packFields.empty() ? "" : "obj") + ") {\n";
+    block += "  " + packedName + " packed;\n";
+    block += packFields;
+    block += "  return packed;\n";
+    block += "}\n\n";
+    unpackFields += genFieldsWritten(structName, "obj.", "  ");
+    block += "void unpack(const " + packedName + " &" + (packFields.empty() ? "" : "packed") + ", " + structName +
+             " &" + (unpackFields.empty() ? "" : "obj") + ") {\n";
+    block += unpackFields;
+    block += "}\n\n";
+    source.addBlock(block);
+}
+
+void CppGenerator::genStructLayoutChecks(const StructDecl &node)
+{
+    auto structName = node.name->getText();
+    if (!isTriviallyCopyable(structName))
+    {
+        return;
+    }
+    header.addInclude(STLHeader::type_traits);
+    std::string block;
+    block += "static_assert(std::is_trivially_copyable<" + structName + ">::value, \"" +
+             structName + " must be trivially copyable\");\n";
+    if (!hasBookkeeping(structName))
+    {
+        block += genPaddingCheck(structName, node.body->fields);
+    }
+    block += "\n";
+    header.addBlock(block);
+}
+
+void CppGenerator::genStructEqTrait(const StructDecl &node, CppBlock &structBody)
+{
+    auto structName = node.name->getText();
+    structBody += "  bool operator==(const " + structName + " &other) const;\n";
+    std::string block;
+    block += "bool " + structName + "::operator==(const " + structName + " &other) const {\n";
+    size_t size, align;
+    if (getBitwiseLayout(node.body->fields, size, align) && !hasBookkeeping(structName))
+    {
+        source.addInclude(STLHeader::cstring);
+        block += "  return std::memcmp(this, &other, sizeof(" + structName + ")) == 0;\n";
+        block += "}\n\n";
+        source.addBlock(block);
+        return;
+    }
+    if (node.body->fields.empty())
+    {
+        block += "  return true;\n";
+        block += "}\n\n";
+        source.addBlock(block);
+        return;
+    }
+    block += "  return ";
+    int fieldCount = node.body->fields.size();
+    for (auto field : node.body->fields)
+    {
+        std::string fieldName = field->getText();
+        block += fieldName + " == other." + fieldName;
+        if (--fieldCount > 0)
+        {
+            block += "\n      && ";
+        }
+    }
+    block += ";\n";
+    block += "}\n\n";
+    source.addBlock(block);
+}
+
+// Structs are read as the sequence of their fields
+void CppGenerator::genStructInTrait(const StructDecl &node)
+{
+    auto structName = node.name->getText();
+    header.addInclude(STLHeader::istream);
+    header.addBlock("std::istream &operator>>(std::istream &is, " + structName + " &obj);\n");
+    std::string block;
+    block += "std::istream &operator>>(std::istream &is, " + structName + " &obj) {\n";
+    for (auto field : node.body->fields)
+    {
+        checkInTrait(*field->type);
+        block += "  " + genStreamRead(*field->type, "obj." + field->getText()) + ";\n";
+        block += indent(genRangeCheck(*field->type, "obj." + field->getText(), "is.setstate(std::ios::failbit)"));
+    }
+    block += genFieldsWritten(structName, "obj.", "  ");
+    block += "  return is;\n";
+    block += "}\n\n";
+    block += "void readText(const char *&cur, const char *end, " + structName + " &" +
+             (node.body->fields.empty() ? "" : "obj") + ") {\n";
+    for (auto field : node.body->fields)
+    {
+        block += "  " + genTextCall(*field->type, "cur, end, obj." + field->getText()) + ";\n";
+        block += indent(genRangeCheck(*field->type, "obj." + field->getText(),
+                                      "gm::text::error(\"" + structName + "::" + field->getText() + " out of range\")"));
+    }
+    block += genFieldsWritten(structName, "obj.", "  ");
+    block += "}\n\n";
+    source.addBlock(block);
+    genReadMany(structName);
+}
+
+void CppGenerator::genStructOutTrait(const StructDecl &node)
+{
+    auto structName = node.name->getText();
+    std::string block;
+    block += "  os << \"{ \";\n";
+    int fieldCount = node.body->fields.size();
+    for (auto field : node.body->fields)
+    {
+        block += "  os << \"" + field->getText() + "\" << \": \" << " +
+                 genStreamValue(*field->type, "obj." + field->getText());
+        if (--fieldCount > 0)
+        {
+            block += " << \", \"";
+        }
+        block += ";\n";
+    }
+    block += "  os << \" }\";\n";
+    genTextOutput(structName, block);
+}
+
+void CppGenerator::genStructBinTrait(const StructDecl &node)
+{
+    auto structName = node.name->getText();
+    genBinDecl(structName);
+    std::string encodeFields, decodeFields;
+    for (auto field : node.body->fields)
+    {
+        encodeFields += genFieldEncode(*field->type, "obj." + field->getText());
+        decodeFields += genFieldDecode(*field->type, "obj." + field->getText());
+    }
+    std::string block;
+    size_t size, align;
+    bool bitwise = getBitwiseLayout(node.body->fields, size, align) && !hasBookkeeping(structName);
+    // Fields whose types do not hold every value of their bytes are decoded
+    // one by one, to check them
+    bool copyDecode = bitwise && std::all_of(node.body->fields.begin(), node.body->fields.end(),
+                                             [this](const std::shared_ptr<StructFieldDecl> &field) {
+                                                 return acceptsAnyBytes(*field->type);
+                                             });
+    auto sizeName = "k" + structName + "BinSize";
+    if (bitwise)
+    {
+        source.addInclude(STLHeader::cstring);
+    }
+    block += "void encode(uint8_t *&out, const " + structName + " &obj) {\n";
+    if (bitwise)
+    {
+        block += "  if (gm::kLittleEndian) {\n";
+        block += "    std::memcpy(out, &obj, " + sizeName + ");\n";
+        block += "    out += " + sizeName + ";\n";
+        block += "    return;\n";
+        block += "  }\n";
+    }
+    block += encodeFields;
+    block += "}\n\n";
+    block += "void decode(const uint8_t *&in, " + structName + " &obj) {\n";
+    if (copyDecode)
+    {
+        block += "  if (gm::kLittleEndian) {\n";
+        block += "    std::memcpy(&obj, in, " + sizeName + ");\n";
+        block += "    in += " + sizeName + ";\n";
+        block += "    return;\n";
+        block += "  }\n";
+    }
+    block += decodeFields;
+    block += genFieldsWritten(structName, "obj.", "  ");
+    block += "}\n\n";
+    source.addBlock(block);
+}
+
+// Views read the fields of a Bin-encoded struct in place, at offsets known
+// at compile time
+void CppGenerator::genStructViewTrait(const StructDecl &node)
+{
+    auto structName = node.name->getText();
+    getBinSize(structName);
+    header.addInclude("gamma/bin.hpp");
+    std::string block;
+    block += "struct " + structName + "View {\n";
+    block += "  explicit " + structName + "View(const uint8_t *data) noexcept: data(data) {}\n";
+    size_t offset = 0;
+    for (auto field : node.body->fields)
+    {
+        block += genViewAccessor(*field->type, field->getText(), "", offsetPosition("data", offset));
+        offset += getBinSize(*field->type);
+    }
+    block += "  const uint8_t *data;\n";
+    block += "};\n\n";
+    header.addBlock(block);
+}
+
+// Columns store each field of a sequence of structs contiguously, in chunks
+// appended to a file that is mapped in memory to be read
+void CppGenerator::genStructColumnsTrait(const StructDecl &node)
+{
+    auto structName = node.name->getText();
+    const auto &fields = node.body->fields;
+    header.addInclude("gamma/columns.hpp");
+    std::stringstream hash;
+    hash << "0x" << std::hex << std::setw(16) << std::setfill('0') << fingerprint(getSchema(structName)) << "ULL";
+    auto columnsName = structName + "Columns";
+    std::string block;
+    block += "struct " + columnsName + " {\n";
+    block += "  static constexpr uint64_t kFingerprint = " + hash.str() + ";\n";
+    block += "  static constexpr size_t kFieldCount = " + std::to_string(fields.size()) + ";\n";
+    block += "  explicit " + columnsName + "(gm::ColumnChunk chunk) noexcept: size(chunk.size()), columns{";
+    for (size_t i = 0; i < fields.size(); i++)
+    {
+        block += "chunk.column(" + std::to_string(i) + ")";
+        if (i + 1 < fields.size())
+        {
+            block += ", ";
+        }
+    }
+    block += "} {}\n";
+    std::string encodeColumns;
+    std::string fieldSizes;
+    for (size_t i = 0; i < fields.size(); i++)
+    {
+        auto fieldSize = std::to_string(getBinSize(*fields[i]->type));
+        auto column = "columns[" + std::to_string(i) + "]";
+        block += genViewAccessor(*fields[i]->type, fields[i]->getText(), "size_t i",
+                                 fieldSize == "1" ? column + " + i" : column + " + " + fieldSize + " * i");
+        encodeColumns += "  out = writer.column(" + std::to_string(i) + ");\n";
+        encodeColumns += "  for (size_t i = 0; i < count; i++) {\n";
+        encodeColumns += indent(genFieldEncode(*fields[i]->type, "records[i]." + fields[i]->getText()));
+        encodeColumns += "  }\n";
+        fieldSizes += (i > 0 ? ", " : "") + fieldSize;
+    }
+    auto arraySize = std::to_string(std::max<size_t>(fields.size(), 1));
+    block += "  // Encoded size of each field, to check the columns of a mapped file\n";
+    block += "  static const size_t kFieldSizes[" + arraySize + "];\n";
+    block += "  size_t size;\n";
+    block += "  const uint8_t *columns[" + arraySize + "];\n";
+    block += "};\n\n";
+    block += "void appendColumns(gm::ColumnWriter &writer, const " + structName + " *records, size_t count);\n\n";
+    header.addBlock(block);
+
+    block = "constexpr uint64_t " + columnsName + "::kFingerprint;\n";
+    block += "constexpr size_t " + columnsName + "::kFieldCount;\n";
+    block += "const size_t " + columnsName + "::kFieldSizes[" + arraySize + "] = {" +
+             (fields.empty() ? "0" : fieldSizes) + "};\n\n";
+    block += "void appendColumns(gm::ColumnWriter &writer, const " + structName + " *records, size_t count) {\n";
+    block += "  writer.beginChunk(count, " + columnsName + "::kFieldSizes);\n";
+    if (!fields.empty())
+    {
+        block += "  uint8_t *out;\n";
+    }
+    block += encodeColumns;
+    block += "  writer.endChunk();\n";
+    block += "}\n\n";
+    source.addBlock(block);
+}
+
+void CppGenerator::genStructJsonTrait(const StructDecl &node)
+{
+    auto structName = node.name->getText();
+    addRuntimeTrait("json");
+    header.addBlock("void writeJson(std::string &out, const " + structName + " &obj);\n"
+                    "void readJson(const char *&cur, const char *end, " + structName + " &obj);\n\n");
+    genJsonObject(structName, node.body->fields, "");
+}
+
+// Objects are written with their constant keys fused, and read in one pass
+// with a generated dispatch on their keys; unknown keys are skipped
+template <typename Field>
+void CppGenerator::genJsonObject(const std::string &typeName, const std::vector<std::shared_ptr<Field>> &fields,
+                                 const std::string &linkage)
+{
+    std::string block;
+    if (fields.empty())
+    {
+        block += linkage + "void writeJson(std::string &out, const " + typeName + " &) {\n";
+        block += "  out += \"{}\";\n";
+        block += "}\n\n";
+        block += linkage + "void readJson(const char *&cur, const char *end, " + typeName + " &) {\n";
+        block += "  gm::json::skipValue(cur, end);\n";
+        block += "}\n\n";
+        source.addBlock(block);
+        return;
+    }
+    block += linkage + "void writeJson(std::string &out, const " + typeName + " &obj) {\n";
+    std::string prefix = "{";
+    for (auto field : fields)
+    {
+        block += "  out += " + quote(prefix + quote(field->getText()) + ":") + ";\n";
+        block += "  " + genJsonCall("writeJson", *field->type, "out, obj." + field->getText()) + ";\n";
+        prefix = ",";
+    }
+    block += "  out += '}';\n";
+    block += "}\n\n";
+    block += linkage + "void readJson(const char *&cur, const char *end, " + typeName + " &obj) {\n";
+    block += "  gm::json::expect(cur, end, '{');\n";
+    block += "  if (gm::json::consume(cur, end, '}')) {\n";
+    block += "    return;\n";
+    block += "  }\n";
+    block += "  const char *key;\n";
+    block += "  size_t length;\n";
+    block += "  do {\n";
+    block += "    gm::json::readKey(cur, end, key, length);\n";
+    std::vector<std::pair<std::string, std::string>> cases;
+    for (auto field : fields)
+    {
+        cases.push_back(std::make_pair(field->getText(),
+                                       genJsonCall("readJson", *field->type, "cur, end, obj." + field->getText()) +
+                                           ";\n" +
+                                           genRangeCheck(*field->type, "obj." + field->getText(),
+                                                         "gm::json::error(\"" + typeName + "::" + field->getText() +
+                                                             " out of range\")") +
+                                           "continue;\n"));
+    }
+    source.addInclude(STLHeader::cstring);
+    block += indent(indent(genKeyDispatch(cases)));
+    block += "    gm::json::skipValue(cur, end);\n";
+    block += "  } while (gm::json::next(cur, end, '}'));\n";
+    block += genFieldsWritten(typeName, "obj.", "  ");
+    block += "}\n\n";
+    source.addBlock(block);
+}
+
+std::string CppGenerator::genJsonCall(const std::string &function, const TypeRef &type, const std::string &args)
+{
+    auto typeName = type.getText();
+    if (hasElementType(type))
+    {
+        // Checks the element type
+        genJsonCall(function, *getElementType(type), args);
+        return "gm::" + function + "(" + args + ")";
+    }
+    if (kBuiltinTypes.count(typeName) || isRuntimeType(typeName))
+    {
+        return "gm::" + function + "(" + args + ")";
+    }
+    if (!hasTrait(typeName, "Json"))
+    {
+        throw std::runtime_error("Type " + typeName + " must have trait Json");
+    }
+    return function + "(" + args + ")";
+}
+
+void CppGenerator::gen(const UnionDecl &node)
+{
+    CppBlock &unionBody = genUnionBody(node);
+    genUnionLayoutChecks(node);
+    for (auto traitId : node.traitList->traits)
+    {
+        auto traitName = traitId->getText();
+        if (traitName == "Eq")
+        {
+            genUnionEqTrait(node, unionBody);
+        }
+        else if (traitName == "In")
+        {
+            genUnionInTrait(node);
+        }
+        else if (traitName == "Out")
+        {
+            genUnionOutTrait(node);
+        }
+        else if (traitName == "Buffered")
+        {
+            checkBufferedTrait(node.name->getText());
+        }
+        else if (traitName == "Bin")
+        {
+            genUnionBinTrait(node);
+        }
+        else if (traitName == "View")
+        {
+            genUnionViewTrait(node);
+        }
+        else if (traitName == "Json")
+        {
+            genUnionJsonTrait(node);
+        }
+        else if (traitName == "Rand")
+        {
+            genRandTrait(node);
+        }
+        else
+        {
+            throw std::runtime_error("Invalid trait " + traitName);
+        }
+    }
+}
+
+CppBlock &CppGenerator::genUnionBody(const UnionDecl &node)
+{
+    std::string unionName = node.name->getText();
+    CppBlock &block = header.addBlock();
+    block.addBlock("struct " + unionName + " {\n");
+    CppBlock &unionBody = block.addBlock();
+    unionBody += "  enum Type {\n";
+    unionBody += "    Undef,\n";
+    for (auto field : node.body->fields)
+    {
+        unionBody += "    " + field->getText() + "_t,\n";
+    }
+    unionBody += "  } type;\n";
+    for (auto field : node.body->fields)
+    {
+        unionBody += "  struct " + field->getText() + "_d {\n";
+        for (auto arg : field->args)
+        {
+            unionBody += "    " + cppType(*arg->type) + " " + arg->getText() + ";\n";
+        }
+        unionBody += "  };\n";
+    }
+    std::string constexprSpec = isTriviallyCopyable(unionName) ? "constexpr " : "";
+    unionBody += "  union Data {\n";
+    if (!node.body->fields.empty())
+    {
+        unionBody += "    " + constexprSpec + "Data() noexcept: " + node.body->fields.front()->getText() + "() {}\n";
+    }
+    for (auto field : node.body->fields)
+    {
+        std::string fieldName = field->getText();
+        unionBody += "    " + constexprSpec + "Data(" + fieldName + "_d " + fieldName + ") noexcept: " +
+                     fieldName + "(" + fieldName + ") {}\n";
+    }
+    for (auto field : node.body->fields)
+    {
+        std::string fieldName = field->getText();
+        unionBody += "    " + fieldName + "_d " + fieldName + ";\n";
+    }
+    unionBody += "  } data;\n";
+    unionBody += "  " + constexprSpec + unionName + "(Type type = Undef) noexcept: type(type), data() {}\n";
+    unionBody += "  " + constexprSpec + unionName + "(Type type, Data data) noexcept: type(type), data(data) {}\n";
+    for (auto field : node.body->fields)
+    {
+        std::string fieldName = field->getText();
+        unionBody += "  static " + constexprSpec + unionName + " " + fieldName + "(";
+        int argCount = field->args.size();
+        for (auto arg : field->args)
+        {
+            unionBody += cppType(*arg->type) + " " + arg->getText();
+            if (--argCount > 0)
+            {
+                unionBody += ", ";
+            }
+        }
+        unionBody += ")" + genNoexcept(field->args) + " {\n";
+        unionBody += "    return " + unionName + "(" + fieldName + "_t, " + fieldName + "_d{";
+        argCount = field->args.size();
+        for (auto arg : field->args)
+        {
+            unionBody += genMove(*arg->type, arg->getText());
+            if (--argCount > 0)
+            {
+                unionBody += ", ";
+            }
+        }
+        unionBody += "});\n";
+        unionBody += "  }\n";
+    }
+    block.addBlock("};\n\n");
+    genUnionVisit(node, "const ");
+    genUnionVisit(node, "");
+    return unionBody;
+}
+
+// Dispatch on the active variant with a single switch, passing the payload
+// by reference; a visitor missing an overload for a variant does not compile
+void CppGenerator::genUnionVisit(const UnionDecl &node, const std::string &qualifier)
+{
+    const auto &fields = node.body->fields;
+    if (fields.empty())
+    {
+        return;
+    }
+    auto unionName = node.name->getText();
+    header.addInclude(STLHeader::stdexcept);
+    std::string block;
+    block += "template <typename Visitor>\n";
+    block += "auto visit(" + qualifier + unionName + " &obj, Visitor &&vis) -> decltype(vis(obj.data." +
+             fields.front()->getText() + ")) {\n";
+    block += "  switch (obj.type) {\n";
+    for (auto field : fields)
+    {
+        block += "  case " + unionName + "::" + field->getText() + "_t:\n";
+        block += "    return vis(obj.data." + field->getText() + ");\n";
+    }
+    block += "  default:\n";
+    block += "    throw std::invalid_argument(\"visit: undefined " + unionName + "\");\n";
+    block += "  }\n";
+    block += "}\n\n";
+    header.addBlock(block);
+}
+
+void CppGenerator::genUnionLayoutChecks(const UnionDecl &node)
+{
+    auto unionName = node.name->getText();
+    if (!isTriviallyCopyable(unionName))
+    {
+        return;
+    }
+    header.addInclude(STLHeader::type_traits);
+    std::string block;
+    block += "static_assert(std::is_trivially_copyable<" + unionName + ">::value, \"" +
+             unionName + " must be trivially copyable\");\n";
+    for (auto field : node.body->fields)
+    {
+        block += genPaddingCheck(unionName + "::" + field->getText() + "_d", field->args);
+    }
+    block += "\n";
+    header.addBlock(block);
+}
+
+void CppGenerator::genUnionEqTrait(const UnionDecl &node, CppBlock &unionBody)
+{
+    auto unionName = node.name->getText();
+    unionBody += "  bool operator==(const " + unionName + " &other) const;\n";
+    std::string block;
+    block += "bool " + unionName + "::operator==(const " + unionName + " &other) const {\n";
+    block += "  if (type != other.type) return false;\n";
+    block += "  switch (type) {\n";
+    for (auto field : node.body->fields)
+    {
+        if (!field->args.empty())
+        {
+            std::string fieldName = field->getText();
+            block += "  case " + unionName + "::" + field->getText() + "_t:\n";
+            size_t size, align;
+            if (getBitwiseLayout(field->args, size, align))
+            {
+                source.addInclude(STLHeader::cstring);
+                block += "    return std::memcmp(&data." + fieldName + ", &other.data." + fieldName +
+                         ", sizeof(" + fieldName + "_d)) == 0;\n";
+                continue;
+            }
+            block += "    return ";
+            int argCount = field->args.size();
+            for (auto arg : field->args)
+            {
+                std::string argName = fieldName + "." + arg->getText();
+                block += "data." + argName + " == other.data." + argName;
+                if (--argCount > 0)
+                {
+                    block += "\n      && ";
+                }
+            }
+            block += ";\n";
+            block += "  break;\n";
+        }
+    }
+    block += "  default:\n";
+    block += "    return true;\n";
+    block += "  }\n";
+    block += "}\n\n";
+    source.addBlock(block);
+}
+
+// Unions are read with the format of their variants, which must start with
+// a distinct keyword
+void CppGenerator::genUnionInTrait(const UnionDecl &node)
+{
+    auto unionName = node.name->getText();
+    header.addInclude(STLHeader::istream);
+    header.addBlock("std::istream &operator>>(std::istream &is, " + unionName + " &obj);\n");
+    source.addInclude(STLHeader::cstring);
+    source.addInclude(STLHeader::stdexcept);
+    source.addInclude(STLHeader::string);
+    genProfileCounters(unionName, node.body->fields);
+    auto hits = "k" + unionName + "Hits";
+    std::string streamCode, keyword;
+    std::vector<std::pair<std::string, std::string>> cases;
+    std::set<std::string> keywords, coldKeys;
+    for (auto field : sortByProfile(unionName, node.body->fields))
+    {
+        auto fieldName = field->getText();
+        auto words = splitFormat(getUnionFieldFormat(*field));
+        if (words.empty() || isFormatArg(words.front()) || !keywords.insert(words.front()).second)
+        {
+            throw std::runtime_error("Format of " + unionName + "::" + fieldName +
+                                     " must start with a distinct keyword for trait In");
+        }
+        auto condition = "str == " + quote(words.front());
+        if (isCold(unionName, fieldName))
+        {
+            condition = "GM_UNLIKELY(" + condition + ")";
+            coldKeys.insert(words.front());
+        }
+        auto typeTag = unionName + "::" + fieldName + "_t";
+        streamCode += "  " + keyword + "if (" + condition + ") {\n";
+        streamCode += "    obj.type = " + typeTag + ";\n";
+        streamCode += "    GM_PROFILE_HIT(" + hits + ", " + typeTag + " - 1);\n";
+        std::string caseCode = "obj.type = " + typeTag + ";\n";
+        caseCode += "GM_PROFILE_HIT(" + hits + ", " + typeTag + " - 1);\n";
+        for (size_t i = 1; i < words.size(); i++)
+        {
+            const auto &word = words[i];
+            if (!isFormatArg(word))
+            {
+                streamCode += "    is >> str;\n";
+                streamCode += "    if (str != " + quote(word) + ") {\n";
+                streamCode += "      throw std::runtime_error(\"Invalid " + unionName + "\");\n";
+                streamCode += "    }\n";
+                caseCode += "gm::text::expectWord(cur, end, " + quote(word) + ", " + std::to_string(word.size()) + ");\n";
+                continue;
+            }
+            auto argName = word.substr(1, word.size() - 2);
+            auto arg = std::find_if(field->args.begin(), field->args.end(),
+                                    [&argName](std::shared_ptr<Arg> arg) { return arg->getText() == argName; });
+            if (arg == field->args.end())
+            {
+                throw std::runtime_error("Unknown argument " + argName + " in format of " + unionName + "::" + fieldName);
+            }
+            auto expr = "obj.data." + fieldName + "." + argName;
+            checkInTrait(*(*arg)->type);
+            auto outOfRange = unionName + "::" + fieldName + "::" + argName + " out of range";
+            streamCode += "    " + genStreamRead(*(*arg)->type, expr) + ";\n";
+            streamCode += indent(indent(
+                genRangeCheck(*(*arg)->type, expr, "throw std::runtime_error(\"Invalid " + unionName + "\")")));
+            caseCode += genTextCall(*(*arg)->type, "cur, end, " + expr) + ";\n";
+            caseCode += genRangeCheck(*(*arg)->type, expr, "gm::text::error(" + quote(outOfRange) + ")");
+        }
+        streamCode += "  }\n";
+        caseCode += "return;\n";
+        cases.push_back(std::make_pair(words.front(), caseCode));
+        keyword = "else ";
+    }
+    std::string block;
+    block += "std::istream &operator>>(std::istream &is, " + unionName + " &obj) {\n";
+    block += "  std::string str;\n";
+    block += "  if (!(is >> str)) {\n";
+    block += "    return is;\n";
+    block += "  }\n";
+    block += streamCode;
+    block += "  " + keyword + "{\n";
+    block += "    throw std::runtime_error(\"Invalid " + unionName + "\");\n";
+    block += "  }\n";
+    block += "  return is;\n";
+    block += "}\n\n";
+    block += "void readText(const char *&cur, const char *end, " + unionName + " &obj) {\n";
+    block += "  const char *key;\n";
+    block += "  size_t length;\n";
+    block += "  gm::text::readToken(cur, end, key, length);\n";
+    block += indent(genKeyDispatch(cases, coldKeys));
+    block += "  gm::text::error(\"invalid " + unionName + "\");\n";
+    block += "}\n\n";
+    source.addBlock(block);
+    genReadMany(unionName);
+}
+
+void CppGenerator::genUnionOutTrait(const UnionDecl &node)
+{
+    auto unionName = node.name->getText();
+    std::string block;
+    block += "  switch (obj.type) {\n";
+    for (auto field : sortByProfile(unionName, node.body->fields))
+    {
+        block += "  case " + unionName + "::" + field->getText() + "_t:\n";
+        block += "    os << " + expandFormat(*field, getUnionFieldFormat(*field)) + ";\n";
+        block += "  break;\n";
+    }
+    block += "  default:\n";
+    block += "    break;\n";
+    block += "  }\n";
+    genTextOutput(unionName, block);
+}
+
+void CppGenerator::genUnionBinTrait(const UnionDecl &node)
+{
+    auto unionName = node.name->getText();
+    if (node.body->fields.size() > 255)
+    {
+        throw std::runtime_error("Too many variants in " + unionName + " for trait Bin");
+    }
+    genBinDecl(unionName);
+    auto payloadSize = std::to_string(getBinSize(unionName) - kUnionTagBinSize);
+    std::string block;
+    block += "void encode(uint8_t *&out, const " + unionName + " &obj) {\n";
+    block += "  gm::store<uint8_t>(out, obj.type);\n";
+    block += "  out += " + std::to_string(kUnionTagBinSize) + ";\n";
+    block += "  uint8_t *end = out + " + payloadSize + ";\n";
+    block += "  switch (obj.type) {\n";
+    for (auto field : node.body->fields)
+    {
+        if (!field->args.empty())
+        {
+            block += "  case " + unionName + "::" + field->getText() + "_t:\n";
+            for (auto arg : field->args)
+            {
+                auto argCode = genFieldEncode(*arg->type, "obj.data." + field->getText() + "." + arg->getText());
+                block += indent(argCode);
+            }
+            block += "    break;\n";
+        }
+    }
+    block += "  default:\n";
+    block += "    break;\n";
+    block += "  }\n";
+    block += "  std::memset(out, 0, end - out);\n";
+    block += "  out = end;\n";
+    block += "}\n\n";
+    block += "void decode(const uint8_t *&in, " + unionName + " &obj) {\n";
+    block += "  auto type = static_cast<" + unionName + "::Type>(gm::load<uint8_t>(in));\n";
+    block += "  in += " + std::to_string(kUnionTagBinSize) + ";\n";
+    block += "  const uint8_t *end = in + " + payloadSize + ";\n";
+    block += "  switch (type) {\n";
+    block += "  case " + unionName + "::Undef:\n";
+    for (auto field : node.body->fields)
+    {
+        if (field->args.empty())
+        {
+            block += "  case " + unionName + "::" + field->getText() + "_t:\n";
+        }
+    }
+    block += "    break;\n";
+    for (auto field : node.body->fields)
+    {
+        if (!field->args.empty())
+        {
+            block += "  case " + unionName + "::" + field->getText() + "_t:\n";
+            for (auto arg : field->args)
+            {
+                auto argCode = genFieldDecode(*arg->type, "obj.data." + field->getText() + "." + arg->getText());
+                block += indent(argCode);
+            }
+            block += "    break;\n";
+        }
+    }
+    block += "  default:\n";
+    block += "    throw std::runtime_error(\"Invalid " + unionName + " type\");\n";
+    block += "  }\n";
+    block += "  obj.type = type;\n";
+    block += "  in = end;\n";
+    block += "}\n\n";
+    source.addInclude(STLHeader::cstring);
+    source.addInclude(STLHeader::stdexcept);
+    source.addBlock(block);
+}
+
+void CppGenerator::genUnionViewTrait(const UnionDecl &node)
+{
+    auto unionName = node.name->getText();
+    getBinSize(unionName);
+    header.addInclude("gamma/bin.hpp");
+    std::string block;
+    block += "struct " + unionName + "View {\n";
+    block += "  explicit " + unionName + "View(const uint8_t *data) noexcept: data(data) {}\n";
+    block += "  " + unionName + "::Type type() const {\n";
+    block += "    if (gm::load<uint8_t>(data) > " + std::to_string(node.body->fields.size()) + ") {\n";
+    block += "      throw std::runtime_error(\"Invalid " + unionName + " type\");\n";
+    block += "    }\n";
+    block += "    return static_cast<" + unionName + "::Type>(gm::load<uint8_t>(data));\n";
+    block += "  }\n";
+    for (auto field : node.body->fields)
+    {
+        if (field->args.empty())
+        {
+            continue;
+        }
+        auto fieldName = field->getText();
+        block += "  struct " + fieldName + "_v {\n";
+        block += "    explicit " + fieldName + "_v(const uint8_t *data) noexcept: data(data) {}\n";
+        size_t offset = 0;
+        for (auto arg : field->args)
+        {
+            block += indent(genViewAccessor(*arg->type, arg->getText(), "", offsetPosition("data", offset)));
+            offset += getBinSize(*arg->type);
+        }
+        block += "    const uint8_t *data;\n";
+        block += "  };\n";
+        block += "  " + fieldName + "_v " + fieldName + "() const noexcept { return " + fieldName + "_v(data + " +
+                 std::to_string(kUnionTagBinSize) + "); }\n";
+    }
+    block += "  const uint8_t *data;\n";
+    block += "};\n\n";
+    header.addBlock(block);
+}
+
+// Unions are objects with a single key naming the variant, and the
+// arguments of the variant as value; undefined unions are null
+void CppGenerator::genUnionJsonTrait(const UnionDecl &node)
+{
+    auto unionName = node.name->getText();
+    addRuntimeTrait("json");
+    header.addBlock("void writeJson(std::string &out, const " + unionName + " &obj);\n"
+                    "void readJson(const char *&cur, const char *end, " + unionName + " &obj);\n\n");
+    for (auto field : node.body->fields)
+    {
+        genJsonObject(unionName + "::" + field->getText() + "_d", field->args, "static ");
+    }
+    source.addInclude(STLHeader::cstring);
+    std::string block;
+    block += "void writeJson(std::string &out, const " + unionName + " &obj) {\n";
+    block += "  switch (obj.type) {\n";
+    for (auto field : node.body->fields)
+    {
+        auto fieldName = field->getText();
+        block += "  case " + unionName + "::" + fieldName + "_t:\n";
+        block += "    out += " + quote("{" + quote(fieldName) + ":") + ";\n";
+        block += "    writeJson(out, obj.data." + fieldName + ");\n";
+        block += "    out += '}';\n";
+        block += "    break;\n";
+    }
+    block += "  default:\n";
+    block += "    out += \"null\";\n";
+    block += "    break;\n";
+    block += "  }\n";
+    block += "}\n\n";
+    std::vector<std::pair<std::string, std::string>> cases;
+    std::set<std::string> coldKeys;
+    for (auto field : sortByProfile(unionName, node.body->fields))
+    {
+        auto fieldName = field->getText();
+        if (isCold(unionName, fieldName))
+        {
+            coldKeys.insert(fieldName);
+        }
+        cases.push_back(std::make_pair(fieldName,
+                                       "obj.type = " + unionName + "::" + fieldName + "_t;\n"
+                                       "readJson(cur, end, obj.data." + fieldName + ");\n"
+                                       "gm::json::expect(cur, end, '}');\n"
+                                       "return;\n"));
+    }
+    block += "void readJson(const char *&cur, const char *end, " + unionName + " &obj) {\n";
+    block += "  if (gm::json::consumeNull(cur, end)) {\n";
+    block += "    obj.type = " + unionName + "::Undef;\n";
+    block += "    return;\n";
+    block += "  }\n";
+    block += "  gm::json::expect(cur, end, '{');\n";
+    block += "  const char *key;\n";
+    block += "  size_t length;\n";
+    block += "  gm::json::readKey(cur, end, key, length);\n";
+    if (!cases.empty())
+    {
+        block += indent(genKeyDispatch(cases, coldKeys));
+    }
+    block += "  gm::json::error(\"invalid " + unionName + "\");\n";
+    block += "}\n\n";
+    source.addBlock(block);
+}
+
+void CppGenerator::genBinDecl(const std::string &typeName)
+{
+    header.addInclude("gamma/bin.hpp");
+    std::stringstream hash;
+    hash << "0x" << std::hex << std::setw(16) << std::setfill('0') << fingerprint(getSchema(typeName)) << "ULL";
+    std::string block;
+    block += "constexpr size_t k" + typeName + "BinSize = " + std::to_string(getBinSize(typeName)) + ";\n";
+    block += "constexpr uint64_t k" + typeName + "Fingerprint = " + hash.str() + ";\n";
+    block += "void encode(uint8_t *&out, const " + typeName + " &obj);\n";
+    block += "void decode(const uint8_t *&in, " + typeName + " &obj);\n\n";
+    header.addBlock(block);
+}
+
+std::string CppGenerator::genViewAccessor(const TypeRef &type, const std::string &name,
+                                          const std::string &params, const std::string &position)
+{
+    auto typeName = type.getText();
+    if (typeName == "Optional")
+    {
+        // The value is read after checking hasX()
+        bool undef;
+        long long value;
+        auto element = getElementType(type);
+        std::string present;
+        if (!getNiche(*element, undef, value))
+        {
+            present = "gm::load<uint8_t>(" + position + " + " + std::to_string(getBinSize(*element)) + ") != 0";
+        }
+        else if (undef)
+        {
+            present = "gm::load<uint8_t>(" + position + ") != 0";
+        }
+        else
+        {
+            auto builtin = kBuiltinTypes.find(element->getText());
+            auto binType = builtin != kBuiltinTypes.end() ? builtin->second.binType : "int32_t";
+            present = "gm::load<" + binType + ">(" + position + ") != " + std::to_string(value);
+        }
+        return "  bool has" + capitalize(name) + "(" + params + ") const noexcept { return " + present + "; }\n" +
+               genViewAccessor(*element, name, params, position);
+    }
+    if (typeName == "Str")
+    {
+        // Throws if the length is corrupted
+        return "  " + cppType(type) + " " + name + "(" + params + ") const { return " + cppType(type) +
+               "(reinterpret_cast<const char *>(" + position + " + 1), gm::load<uint8_t>(" + position + ")); }\n";
+    }
+    if (isContainer(type))
+    {
+        // The values are read with an index, named after those of the
+        // enclosing accessors, and a SmallVec has a second accessor for its
+        // count
+        auto element = getElementType(type);
+        std::string index(1, static_cast<char>('i' + std::count(params.begin(), params.end(), ',') +
+                                               (params.empty() ? 0 : 1)));
+        std::string accessors, start = position;
+        if (typeName == "SmallVec")
+        {
+            auto countSize = getCountBinSize(getCapacity(type));
+            accessors += "  size_t " + name + "Count(" + params + ") const noexcept { return gm::load<uint" +
+                         std::to_string(8 * countSize) + "_t>(" + position + "); }\n";
+            start += " + " + std::to_string(countSize);
+        }
+        auto elementSize = getBinSize(*element);
+        accessors += genViewAccessor(*element, name, (params.empty() ? "" : params + ", ") + "size_t " + index,
+                                     start + " + " + (elementSize == 1 ? "" : std::to_string(elementSize) + " * ") +
+                                         index);
+        return accessors;
+    }
+    // Bools and enums throw if their value is corrupted, as when decoding
+    if (typeName == "bool")
+    {
+        return "  bool " + name + "(" + params + ") const { return gm::loadBool(" + position + "); }\n";
+    }
+    auto builtin = kBuiltinTypes.find(typeName);
+    if (builtin != kBuiltinTypes.end())
+    {
+        return "  " + cppType(type) + " " + name + "(" + params + ") const noexcept { return gm::load<" +
+               builtin->second.binType + ">(" + position + "); }\n";
+    }
+    if (typeDecls.at(typeName)->token.kind == Kind::EnumDecl)
+    {
+        auto count = static_cast<const EnumDecl *>(typeDecls.at(typeName))->body->fields.size();
+        return "  " + typeName + " " + name + "(" + params + ") const { return static_cast<" + typeName +
+               ">(gm::loadEnum(" + position + ", " + std::to_string(count) + ")); }\n";
+    }
+    if (!hasTrait(typeName, "View"))
+    {
+        throw std::runtime_error("Type " + typeName + " must have trait View");
+    }
+    return "  " + typeName + "View " + name + "(" + params + ") const noexcept { return " + typeName + "View(" +
+           position + "); }\n";
+}
+
+// Each field is encoded at the current position, which is then moved past it
+std::string CppGenerator::genFieldEncode(const TypeRef &type, const std::string &expr)
+{
+    auto typeName = type.getText();
+    if (typeName == "Optional")
+    {
+        bool undef;
+        long long value;
+        auto element = getElementType(type);
+        auto code = genFieldEncode(*element, expr + ".raw()");
+        if (!getNiche(*element, undef, value))
+        {
+            code += "  gm::store<uint8_t>(out, " + expr + ".has_value());\n";
+            code += "  out += 1;\n";
+        }
+        return code;
+    }
+    if (typeName == "Str")
+    {
+        auto capacity = std::to_string(getCapacity(type));
+        source.addInclude(STLHeader::cstring);
+        return "  gm::store<uint8_t>(out, static_cast<uint8_t>(" + expr + ".size()));\n" +
+               "  std::memcpy(out + 1, " + expr + ".data(), " + capacity + ");\n" +
+               "  out += " + std::to_string(getBinSize(type)) + ";\n";
+    }
+    if (isContainer(type))
+    {
+        getBinSize(type);
+        auto element = getElementType(type);
+        auto item = genItemName(expr);
+        std::string code;
+        if (typeName == "SmallVec")
+        {
+            auto countSize = getCountBinSize(getCapacity(type));
+            auto countType = "uint" + std::to_string(8 * countSize) + "_t";
+            code += "  gm::store<" + countType + ">(out, static_cast<" + countType + ">(" + expr + ".size()));\n";
+            code += "  out += " + std::to_string(countSize) + ";\n";
+        }
+        code += "  for (const auto &" + item + " : " + expr + ") {\n";
+        code += indent(genFieldEncode(*element, item));
+        code += "  }\n";
+        if (typeName == "SmallVec")
+        {
+            auto padding = "(" + std::to_string(getCapacity(type)) + " - " + expr + ".size()) * " +
+                           std::to_string(getBinSize(*element));
+            source.addInclude(STLHeader::cstring);
+            code += "  std::memset(out, 0, " + padding + ");\n";
+            code += "  out += " + padding + ";\n";
+        }
+        return code;
+    }
+    auto builtin = kBuiltinTypes.find(typeName);
+    if (builtin != kBuiltinTypes.end())
+    {
+        return "  gm::store<" + builtin->second.binType + ">(out, " + expr + ");\n" +
+               "  out += " + std::to_string(builtin->second.size) + ";\n";
+    }
+    getBinSize(typeName);
+    if (typeDecls.at(typeName)->token.kind == Kind::EnumDecl)
+    {
+        return "  gm::store<int32_t>(out, static_cast<int32_t>(" + expr + "));\n" +
+               "  out += " + std::to_string(kEnumBinSize) + ";\n";
+    }
+    return "  encode(out, " + expr + ");\n";
+}
+
+std::string CppGenerator::genFieldDecode(const TypeRef &type, const std::string &expr)
+{
+    auto typeName = type.getText();
+    if (typeName == "Optional")
+    {
+        bool undef;
+        long long value;
+        auto element = getElementType(type);
+        if (getNiche(*element, undef, value) && !undef && typeDecls.count(element->getText()))
+        {
+            return genEnumDecode(element->getText(), expr + ".raw()", 1);
+        }
+        // The niche of a range is outside it, so the raw value is only checked
+        // against the range when it is not the niche
+        TypeRef raw = *element;
+        raw.range = nullptr;
+        auto code = genFieldDecode(raw, expr + ".raw()");
+        auto outOfRange = genOutOfRange(*element, expr + ".raw()");
+        if (!outOfRange.empty())
+        {
+            source.addInclude(STLHeader::stdexcept);
+            code += "  if (" + expr + ".has_value() && (" + outOfRange + ")) {\n";
+            code += "    throw std::runtime_error(\"Value out of range\");\n";
+            code += "  }\n";
+        }
+        if (!getNiche(*element, undef, value))
+        {
+            code += "  " + expr + ".flag() = gm::loadBool(in);\n";
+            code += "  in += 1;\n";
+        }
+        return code;
+    }
+    if (typeName == "Str")
+    {
+        source.addInclude(STLHeader::stdexcept);
+        return "  if (gm::load<uint8_t>(in) > " + std::to_string(getCapacity(type)) + ") {\n" +
+               "    throw std::runtime_error(\"Invalid Str length\");\n" +
+               "  }\n" +
+               "  " + expr + ".assign(reinterpret_cast<const char *>(in + 1), gm::load<uint8_t>(in));\n" +
+               "  in += " + std::to_string(getBinSize(type)) + ";\n";
+    }
+    if (isContainer(type))
+    {
+        getBinSize(type);
+        auto element = getElementType(type);
+        auto item = genItemName(expr);
+        std::string code;
+        if (typeName == "SmallVec")
+        {
+            auto countSize = getCountBinSize(getCapacity(type));
+            code += "  " + expr + ".resize(gm::load<uint" + std::to_string(8 * countSize) + "_t>(in));\n";
+            code += "  in += " + std::to_string(countSize) + ";\n";
+        }
+        code += "  for (auto &" + item + " : " + expr + ") {\n";
+        code += indent(genFieldDecode(*element, item));
+        code += "  }\n";
+        if (typeName == "SmallVec")
+        {
+            code += "  in += (" + std::to_string(getCapacity(type)) + " - " + expr + ".size()) * " +
+                    std::to_string(getBinSize(*element)) + ";\n";
+        }
+        return code;
+    }
+    auto builtin = kBuiltinTypes.find(typeName);
+    if (builtin != kBuiltinTypes.end())
+    {
+        auto value = typeName == "bool" ? "gm::loadBool(in)" : "gm::load<" + builtin->second.binType + ">(in)";
+        auto check = genRangeCheck(type, expr, "throw std::runtime_error(\"Value out of range\")");
+        if (!check.empty())
+        {
+            source.addInclude(STLHeader::stdexcept);
+        }
+        return "  " + expr + " = " + value + ";\n" + indent(check) +
+               "  in += " + std::to_string(builtin->second.size) + ";\n";
+    }
+    getBinSize(typeName);
+    if (typeDecls.at(typeName)->token.kind == Kind::EnumDecl)
+    {
+        return genEnumDecode(typeName, expr, 0);
+    }
+    return "  decode(in, " + expr + ");\n";
+}
+
+// The niche of an optional enum is one more value
+std::string CppGenerator::genEnumDecode(const std::string &typeName, const std::string &expr, int niches) const
+{
+    auto count = static_cast<const EnumDecl *>(typeDecls.at(typeName))->body->fields.size() + niches;
+    return "  " + expr + " = static_cast<" + typeName + ">(gm::loadEnum(in, " + std::to_string(count) + "));\n" +
+           "  in += " + std::to_string(kEnumBinSize) + ";\n";
+}
+
+// The Out trait writes the text to a standard stream, from a body writing to
+// "os". With the Buffered trait, the same body also writes to the buffered
+// output of the runtime, whose header depends on POSIX file descriptors.
+void CppGenerator::genTextOutput(const std::string &typeName, const std::string &body)
+{
+    bool buffered = hasTrait(typeName, "Buffered");
+    header.addInclude(STLHeader::ostream);
+    addRuntimeTrait("out");
+    if (buffered)
+    {
+        addRuntimeTrait("io");
+    }
+    std::string block;
+    block += "std::ostream &operator<<(std::ostream &os, const " + typeName + " &obj);\n";
+    if (buffered)
+    {
+        block += "void writeText(gm::OutputBuffer &os, const " + typeName + " &obj);\n";
+    }
+    header.addBlock(block + "\n");
+    block = "std::ostream &operator<<(std::ostream &os, const " + typeName + " &obj) {\n";
+    block += body;
+    block += "  return os;\n";
+    block += "}\n\n";
+    if (buffered)
+    {
+        block += "void writeText(gm::OutputBuffer &os, const " + typeName + " &obj) {\n";
+        block += body;
+        block += "}\n\n";
+    }
+    source.addBlock(block);
+}
+
+// The Buffered trait is generated with the Out trait
+void CppGenerator::checkBufferedTrait(const std::string &typeName) const
+{
+    if (!hasTrait(typeName, "Out"))
+    {
+        throw std::runtime_error("Type " + typeName + " must have trait Out");
+    }
+}
+
+// Reading a batch of values keeps the current position in a local variable,
+// and a vector is resized only once
+void CppGenerator::genReadMany(const std::string &typeName)
+{
+    header.addInclude(STLHeader::vector);
+    addRuntimeTrait("text");
+    std::string block;
+    block += "void readText(const char *&cur, const char *end, " + typeName + " &obj);\n";
+    block += "void readMany(const char *&cur, const char *end, size_t n, " + typeName + " *out);\n";
+    block += "void readMany(const char *&cur, const char *end, size_t n, std::vector<" + typeName + "> &out);\n\n";
+    header.addBlock(block);
+    block = "void readMany(const char *&cur, const char *end, size_t n, " + typeName + " *out) {\n";
+    block += "  const char *p = cur;\n";
+    block += "  for (size_t i = 0; i < n; i++) {\n";
+    block += "    readText(p, end, out[i]);\n";
+    block += "  }\n";
+    block += "  cur = p;\n";
+    block += "}\n\n";
+    // Values are appended as they are read, and removed on error
+    source.addInclude(STLHeader::utility);
+    block += "void readMany(const char *&cur, const char *end, size_t n, std::vector<" + typeName + "> &out) {\n";
+    block += "  const char *p = cur;\n";
+    block += "  size_t size = out.size();\n";
+    block += "  out.reserve(size + n);\n";
+    block += "  try {\n";
+    block += "    for (size_t i = 0; i < n; i++) {\n";
+    block += "      " + typeName + " item;\n";
+    block += "      readText(p, end, item);\n";
+    block += "      out.push_back(std::move(item));\n";
+    block += "    }\n";
+    block += "  }\n";
+    block += "  catch (...) {\n";
+    block += "    out.erase(out.begin() + size, out.end());\n";
+    block += "    throw;\n";
+    block += "  }\n";
+    block += "  cur = p;\n";
+    block += "}\n\n";
+    source.addBlock(block);
+}
+
+// Field types must be builtin, or have the In trait, down to the values of
+// their containers
+void CppGenerator::checkInTrait(const TypeRef &type) const
+{
+    const TypeRef *valueType = &type;
+    while (hasElementType(*valueType))
+    {
+        valueType = getElementType(*valueType).get();
+    }
+    auto typeName = valueType->getText();
+    if (!kBuiltinTypes.count(typeName) && !isRuntimeType(typeName) && !hasTrait(typeName, "In"))
+    {
+        throw std::runtime_error("Type " + typeName + " must have trait In");
+    }
+}
+
+std::string CppGenerator::genTextCall(const TypeRef &type, const std::string &args)
+{
+    auto typeName = type.getText();
+    checkInTrait(type);
+    if (hasElementType(type) || kBuiltinTypes.count(typeName) || isRuntimeType(typeName))
+    {
+        return "gm::readText(" + args + ")";
+    }
+    return "readText(" + args + ")";
+}
+
+std::string CppGenerator::expandFormat(const UnionFieldDecl &scope, const std::string &format)
+{
+    std::string out = "\"";
+    std::string argName;
+    bool inArg = false;
+    for (char c : format)
+    {
+        switch (c)
+        {
+        case '{':
+            out += "\" << ";
+            inArg = true;
+            break;
+        case '}':
+        {
+            auto expr = "obj.data." + scope.getText() + "." + argName;
+            auto arg = std::find_if(scope.args.begin(), scope.args.end(),
+                                    [&](const std::shared_ptr<Arg> &arg) { return arg->getText() == argName; });
+            out += (arg != scope.args.end() ? genStreamValue(*(*arg)->type, expr) : expr) + " << \"";
+            argName.clear();
+            inArg = false;
+            break;
+        }
+        default:
+            if (inArg)
+            {
+                argName += c;
+            }
+            else
+            {
+                out += c;
+            }
+        }
+    }
+    out += "\"";
+    return out;
+}
+
+static const char *const kBenchPrelude =
+    "template <typename T>\n"
+    "static inline void writeInput(std::ostream &os, const T &value) { os << value; }\n"
+    "static inline void writeInput(std::ostream &os, int8_t value) { os << static_cast<int>(value); }\n"
+    "static inline void writeInput(std::ostream &os, uint8_t value) { os << static_cast<int>(value); }\n"
+    "template <typename T, size_t N>\n"
+    "static inline void writeInput(std::ostream &os, const gm::Array<T, N> &value);\n"
+    "template <typename T, size_t N>\n"
+    "static inline void writeInput(std::ostream &os, const gm::SmallVec<T, N> &value);\n"
+    "template <typename T>\n"
+    "static inline void writeInput(std::ostream &os, const gm::Vec<T> &value);\n"
+    "template <typename T, typename Niche>\n"
+    "static inline void writeInput(std::ostream &os, const gm::Optional<T, Niche> &value);\n\n"
+    "template <typename Container>\n"
+    "static inline void writeInputItems(std::ostream &os, const Container &value) {\n"
+    "  for (const auto &item : value) {\n"
+    "    os << ' ';\n"
+    "    writeInput(os, item);\n"
+    "  }\n"
+    "}\n\n"
+    "template <typename T, size_t N>\n"
+    "static inline void writeInput(std::ostream &os, const gm::Array<T, N> &value) {\n"
+    "  writeInput(os, value[0]);\n"
+    "  for (size_t i = 1; i < N; i++) {\n"
+    "    os << ' ';\n"
+    "    writeInput(os, value[i]);\n"
+    "  }\n"
+    "}\n\n"
+    "template <typename T, size_t N>\n"
+    "static inline void writeInput(std::ostream &os, const gm::SmallVec<T, N> &value) {\n"
+    "  os << value.size();\n"
+    "  writeInputItems(os, value);\n"
+    "}\n\n"
+    "template <typename T>\n"
+    "static inline void writeInput(std::ostream &os, const gm::Vec<T> &value) {\n"
+    "  os << value.size();\n"
+    "  writeInputItems(os, value);\n"
+    "}\n\n"
+    "template <typename T, typename Niche>\n"
+    "static inline void writeInput(std::ostream &os, const gm::Optional<T, Niche> &value) {\n"
+    "  if (value.has_value()) {\n"
+    "    writeInput(os, *value);\n"
+    "  }\n"
+    "  else {\n"
+    "    os << '-';\n"
+    "  }\n"
+    "}\n\n"
+    "typedef std::chrono::steady_clock BenchClock;\n\n"
+    "static void report(const char *type, const char *trait, BenchClock::time_point start, size_t count, size_t bytes) {\n"
+    "  double ns = std::chrono::duration<double, std::nano>(BenchClock::now() - start).count();\n"
+    "  if (bytes > 0) {\n"
+    "    std::printf(\"%-20s %-8s %10.1f ns/op %10.1f MB/s\\n\", type, trait, ns / count, bytes * 1e3 / ns);\n"
+    "  }\n"
+    "  else {\n"
+    "    std::printf(\"%-20s %-8s %10.1f ns/op\\n\", type, trait, ns / count);\n"
+    "  }\n"
+    "}\n\n";
+
+// The benchmark of a .gm file times the traits of each of its types on a
+// batch of random values; helpers are generated for all the types since
+// they may be used by the fields of others
+void CppGenerator::genBench(const SourceFile &node)
+{
+    CppFile bench(*benchWriter);
+    bench.addInclude(STLHeader::chrono);
+    bench.addInclude(STLHeader::cstdint);
+    bench.addInclude(STLHeader::cstdio);
+    bench.addInclude(STLHeader::cstdlib);
+    bench.addInclude(STLHeader::sstream);
+    bench.addInclude(STLHeader::string);
+    bench.addInclude(STLHeader::vector);
+    bench.addInclude("gamma/containers.hpp");
+    bench.addInclude("gamma/optional.hpp");
+    bench.addInclude("gamma/random.hpp");
+    for (const auto &type : runtimeTypes)
+    {
+        bench.addInclude("gamma/random_" + type + ".hpp");
+    }
+    bench.addBlock("#include \"" + fileName + ".hpp\"\n\n");
+    bench.addBlock("// Generated by gammac --emit-bench; usage: <program> [count]\n\n");
+    bench.addBlock(kBenchPrelude);
+    std::string mainCode;
+    mainCode += "int main(int argc, char *argv[]) {\n";
+    mainCode += "  size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;\n";
+    for (auto typeDecl : node.typeDecls)
+    {
+        auto typeName = typeDecl->name->getText();
+        bench.addBlock(genBenchHelpers(*typeDecl));
+        auto traits = genBenchTraits(typeName);
+        if (!traits.empty())
+        {
+            std::string block;
+            block += "static void bench" + typeName + "(size_t count) {\n";
+            block += "  gm::Rng rng(" + std::to_string(fingerprint(typeName)) + "ULL);\n";
+            block += "  std::vector<" + typeName + "> values(count);\n";
+            block += "  for (auto &value : values) {\n";
+            block += "    randomize(rng, value);\n";
+            block += "  }\n";
+            block += traits;
+            block += "}\n\n";
+            bench.addBlock(block);
+            mainCode += "  bench" + typeName + "(count);\n";
+        }
+    }
+    mainCode += "  return 0;\n";
+    mainCode += "}\n";
+    bench.addBlock(mainCode);
+    bench.emit();
+}
+
+// Generates writeInput() for a type with the In trait, which writes a value
+// in the format it reads, and randomize() if the type has no Rand trait
+std::string CppGenerator::genBenchHelpers(const TypeDecl &node)
+{
+    auto typeName = node.name->getText();
+    std::string block;
+    if (!hasTrait(typeName, "Rand"))
+    {
+        block += genRandomize(node, "static inline ");
+    }
+    if (!hasTrait(typeName, "In"))
+    {
+        return block;
+    }
+    std::string input;
+    switch (node.token.kind)
+    {
+    case Kind::EnumDecl:
+    {
+        const auto &enumDecl = static_cast<const EnumDecl &>(node);
+        input += "  static const char *const formats[] = {\n    ";
+        for (auto field : enumDecl.body->fields)
+        {
+            input += quote(getEnumFieldFormat(*field)) + ", ";
+        }
+        input += "\n  };\n";
+        input += "  os << formats[static_cast<size_t>(obj)];\n";
+        break;
+    }
+    case Kind::StructDecl:
+    {
+        const auto &fields = static_cast<const StructDecl &>(node).body->fields;
+        for (size_t i = 0; i < fields.size(); i++)
+        {
+            input += "  writeInput(os, obj." + fields[i]->getText() + ");\n";
+            if (i + 1 < fields.size())
+            {
+                input += "  os << ' ';\n";
+            }
+        }
+        break;
+    }
+    case Kind::UnionDecl:
+    {
+        input += "  switch (obj.type) {\n";
+        for (auto field : static_cast<const UnionDecl &>(node).body->fields)
+        {
+            auto fieldName = field->getText();
+            input += "  case " + typeName + "::" + fieldName + "_t:\n";
+            auto words = splitFormat(getUnionFieldFormat(*field));
+            for (size_t j = 0; j < words.size(); j++)
+            {
+                if (isFormatArg(words[j]))
+                {
+                    input += "    writeInput(os, obj.data." + fieldName + "." + words[j].substr(1, words[j].size() - 2) + ");\n";
+                }
+                else
+                {
+                    input += "    os << " + quote(words[j]) + ";\n";
+                }
+                if (j + 1 < words.size())
+                {
+                    input += "    os << ' ';\n";
+                }
+            }
+            input += "    break;\n";
+        }
+        input += "  default:\n";
+        input += "    break;\n";
+        input += "  }\n";
+        break;
+    }
+    default:
+        break;
+    }
+    block += "static inline void writeInput(std::ostream &os, const " + typeName + " &" + (input.empty() ? "" : "obj") + ") {\n";
+    block += input;
+    block += "}\n\n";
+    return block;
+}
+
+// Times each trait of a type on the random values of the benchmark
+std::string CppGenerator::genBenchTraits(const std::string &typeName)
+{
+    auto name = quote(typeName);
+    std::string block;
+    if (hasTrait(typeName, "Out"))
+    {
+        block += "  {\n";
+        block += "    std::ostringstream os;\n";
+        block += "    auto start = BenchClock::now();\n";
+        block += "    for (const auto &value : values) {\n";
+        block += "      os << value << '\\n';\n";
+        block += "    }\n";
+        block += "    report(" + name + ", \"Out\", start, count, os.str().size());\n";
+        block += "  }\n";
+    }
+    if (hasTrait(typeName, "In"))
+    {
+        block += "  {\n";
+        block += "    std::ostringstream os;\n";
+        block += "    for (const auto &value : values) {\n";
+        block += "      writeInput(os, value);\n";
+        block += "      os << '\\n';\n";
+        block += "    }\n";
+        block += "    std::string text = os.str();\n";
+        block += "    std::vector<" + typeName + "> parsed;\n";
+        block += "    const char *cur = text.data();\n";
+        block += "    auto start = BenchClock::now();\n";
+        block += "    readMany(cur, text.data() + text.size(), count, parsed);\n";
+        block += "    report(" + name + ", \"In\", start, count, text.size());\n";
+        block += "  }\n";
+    }
+    if (hasTrait(typeName, "Eq"))
+    {
+        block += "  {\n";
+        block += "    std::vector<" + typeName + "> copies(values);\n";
+        block += "    size_t equal = 0;\n";
+        block += "    auto start = BenchClock::now();\n";
+        block += "    for (size_t i = 0; i < count; i++) {\n";
+        block += "      equal += values[i] == copies[i];\n";
+        block += "    }\n";
+        block += "    report(" + name + ", \"Eq\", start, count, 0);\n";
+        block += "    if (equal != count) {\n";
+        block += "      std::printf(\"%s: copies differ\\n\", " + name + ");\n";
+        block += "    }\n";
+        block += "  }\n";
+    }
+    if (hasTrait(typeName, "Bin"))
+    {
+        auto binSize = "k" + typeName + "BinSize";
+        block += "  {\n";
+        block += "    std::vector<uint8_t> buffer(count * " + binSize + ");\n";
+        block += "    uint8_t *out = buffer.data();\n";
+        block += "    auto start = BenchClock::now();\n";
+        block += "    for (const auto &value : values) {\n";
+        block += "      encode(out, value);\n";
+        block += "    }\n";
+        block += "    report(" + name + ", \"Bin out\", start, count, buffer.size());\n";
+        block += "    std::vector<" + typeName + "> decoded(count);\n";
+        block += "    const uint8_t *in = buffer.data();\n";
+        block += "    start = BenchClock::now();\n";
+        block += "    for (auto &value : decoded) {\n";
+        block += "      decode(in, value);\n";
+        block += "    }\n";
+        block += "    report(" + name + ", \"Bin in\", start, count, buffer.size());\n";
+        block += "  }\n";
+    }
+    if (hasTrait(typeName, "Json"))
+    {
+        block += "  {\n";
+        block += "    std::string text;\n";
+        block += "    auto start = BenchClock::now();\n";
+        block += "    for (const auto &value : values) {\n";
+        block += "      writeJson(text, value);\n";
+        block += "      text += '\\n';\n";
+        block += "    }\n";
+        block += "    report(" + name + ", \"Json out\", start, count, text.size());\n";
+        block += "    std::vector<" + typeName + "> parsed(count);\n";
+        block += "    const char *cur = text.data();\n";
+        block += "    start = BenchClock::now();\n";
+        block += "    for (auto &value : parsed) {\n";
+        block += "      readJson(cur, text.data() + text.size(), value);\n";
+        block += "    }\n";
+        block += "    report(" + name + ", \"Json in\", start, count, text.size());\n";
+        block += "  }\n";
+    }
+    return block;
+}
+
+// Random values are generated by the same function for all the kinds of
+// types: a random enum value, a random variant of a union, and random fields
+void CppGenerator::genRandTrait(const TypeDecl &node)
+{
+    auto typeName = node.name->getText();
+    std::vector<std::shared_ptr<TypeRef>> types;
+    if (node.token.kind == Kind::StructDecl)
+    {
+        for (auto field : static_cast<const StructDecl &>(node).body->fields)
+        {
+            types.push_back(field->type);
+        }
+    }
+    else if (node.token.kind == Kind::UnionDecl)
+    {
+        for (auto field : static_cast<const UnionDecl &>(node).body->fields)
+        {
+            for (auto arg : field->args)
+            {
+                types.push_back(arg->type);
+            }
+        }
+    }
+    for (auto type : types)
+    {
+        auto name = getValueType(type)->getText();
+        if (!kBuiltinTypes.count(name) && !isRuntimeType(name) && !hasTrait(name, "Rand"))
+        {
+            throw std::runtime_error("Type " + name + " must have trait Rand");
+        }
+    }
+    addRuntimeTrait("random");
+    header.addBlock("void randomize(gm::Rng &rng, " + typeName + " &obj);\n\n");
+    source.addBlock(genRandomize(node, ""));
+}
+
+std::string CppGenerator::genRandomize(const TypeDecl &node, const std::string &linkage)
+{
+    auto typeName = node.name->getText();
+    std::string body;
+    switch (node.token.kind)
+    {
+    case Kind::EnumDecl:
+    {
+        auto count = static_cast<const EnumDecl &>(node).body->fields.size();
+        if (count > 0)
+        {
+            body += "  obj = static_cast<" + typeName + ">(rng.below(" + std::to_string(count) + "));\n";
+        }
+        break;
+    }
+    case Kind::StructDecl:
+        for (auto field : static_cast<const StructDecl &>(node).body->fields)
+        {
+            body += "  " + genRandomizeCall(*field->type, "obj." + field->getText()) + ";\n";
+        }
+        body += genFieldsWritten(typeName, "obj.", "  ");
+        break;
+    case Kind::UnionDecl:
+    {
+        const auto &fields = static_cast<const UnionDecl &>(node).body->fields;
+        if (fields.empty())
         {
-        case '{':
-            out += "\" << ";
-            out += "obj.data." + scope.getText() + ".";
-            break;
-        case '}':
-            out += " << \"";
             break;
+        }
+        body += "  switch (rng.below(" + std::to_string(fields.size()) + ")) {\n";
+        for (size_t i = 0; i < fields.size(); i++)
+        {
+            auto fieldName = fields[i]->getText();
+            body += "  case " + std::to_string(i) + ":\n";
+            body += "    obj.type = " + typeName + "::" + fieldName + "_t;\n";
+            for (auto arg : fields[i]->args)
+            {
+                body += "    " + genRandomizeCall(*arg->type, "obj.data." + fieldName + "." + arg->getText()) + ";\n";
+            }
+            body += "    break;\n";
+        }
+        body += "  }\n";
+        break;
+    }
+    default:
+        break;
+    }
+    auto params = body.empty() ? "gm::Rng &, " + typeName + " &" : "gm::Rng &rng, " + typeName + " &obj";
+    return linkage + "void randomize(" + params + ") {\n" + body + "}\n\n";
+}
+
+// Integers with a range get a random value in the range, also when they are
+// optional
+std::string CppGenerator::genRandomizeCall(const TypeRef &type, const std::string &expr)
+{
+    if (type.getText() == "Optional")
+    {
+        auto value = genRandomValue(*getElementType(type));
+        if (!value.empty())
+        {
+            auto optionalType = cppType(type);
+            return expr + " = rng.below(2) ? " + optionalType + "(" + value + ") : " + optionalType + "()";
+        }
+    }
+    auto value = genRandomValue(type);
+    if (!value.empty())
+    {
+        return expr + " = " + value;
+    }
+    return "randomize(rng, " + expr + ")";
+}
+
+std::string CppGenerator::genRandomValue(const TypeRef &type)
+{
+    if (!type.range || getRangeSpan(*type.range) >= UINT32_MAX)
+    {
+        return "";
+    }
+    auto min = type.range->min->getValue();
+    auto value = "rng.below(" + std::to_string(getRangeSpan(*type.range) + 1) + "U)";
+    if (cppType(type) == "int")
+    {
+        return genOffset("static_cast<int>(" + value + ")", min);
+    }
+    return "static_cast<" + cppType(type) + ">(" + (min ? genOffset("static_cast<int64_t>(" + value + ")", min) : value) +
+           ")";
+}
+
+void CppGenerator::setProfile(const Profile &profile)
+{
+    this->profile = profile;
+}
+
+// Counters of the variants read by the In trait, defined only in
+// instrumented builds
+template <typename Field>
+void CppGenerator::genProfileCounters(const std::string &typeName, const std::vector<std::shared_ptr<Field>> &fields)
+{
+    source.addInclude("gamma/profile.hpp");
+    std::string block;
+    block += "#ifdef GAMMA_PROFILE\n";
+    block += "static const char *const k" + typeName + "Variants[] = {\n  ";
+    for (auto field : fields)
+    {
+        block += quote(field->getText()) + ", ";
+    }
+    block += "\n};\n";
+    block += "static uint64_t *const k" + typeName + "Hits = gm::Profile::instance().add(" + quote(typeName) +
+             ", k" + typeName + "Variants, " + std::to_string(fields.size()) + ");\n";
+    block += "#endif\n\n";
+    source.addBlock(block);
+}
+
+// Orders the variants of a type from the most to the least frequent in the
+// profile, keeping the declaration order for variants with the same count
+template <typename Field>
+std::vector<std::shared_ptr<Field>> CppGenerator::sortByProfile(const std::string &typeName,
+                                                               const std::vector<std::shared_ptr<Field>> &fields) const
+{
+    auto sorted = fields;
+    auto typeProfile = profile.find(typeName);
+    if (typeProfile != profile.end())
+    {
+        const auto &hits = typeProfile->second;
+        auto getHits = [&hits](const std::shared_ptr<Field> &field) {
+            auto found = hits.find(field->getText());
+            return found != hits.end() ? found->second : 0;
+        };
+        std::stable_sort(sorted.begin(), sorted.end(),
+                         [&getHits](const std::shared_ptr<Field> &a, const std::shared_ptr<Field> &b) {
+                             return getHits(a) > getHits(b);
+                         });
+    }
+    return sorted;
+}
+
+// A variant is cold if it accounts for less than 1% of the reads of its type
+// in the profile; the dispatch code then marks it as unlikely
+bool CppGenerator::isCold(const std::string &typeName, const std::string &variant)
+{
+    auto typeProfile = profile.find(typeName);
+    if (typeProfile == profile.end())
+    {
+        return false;
+    }
+    uint64_t total = 0;
+    for (const auto &hits : typeProfile->second)
+    {
+        total += hits.second;
+    }
+    auto hits = typeProfile->second.find(variant);
+    bool cold = (hits != typeProfile->second.end() ? hits->second : 0) * 100 < total;
+    if (cold)
+    {
+        source.addInclude("gamma/profile.hpp");
+    }
+    return cold;
+}
+
+bool CppGenerator::isTriviallyCopyable(const std::string &typeName) const
+{
+    if (kBuiltinTypes.count(typeName) || typeName == "Sym")
+    {
+        return true;
+    }
+    auto decl = typeDecls.find(typeName);
+    if (decl == typeDecls.end())
+    {
+        return false;
+    }
+    switch (decl->second->token.kind)
+    {
+    case Kind::EnumDecl:
+        return true;
+    case Kind::StructDecl:
+        for (auto field : static_cast<const StructDecl *>(decl->second)->body->fields)
+        {
+            if (!isTriviallyCopyable(*field->type))
+            {
+                return false;
+            }
+        }
+        return true;
+    case Kind::UnionDecl:
+        for (auto field : static_cast<const UnionDecl *>(decl->second)->body->fields)
+        {
+            for (auto arg : field->args)
+            {
+                if (!isTriviallyCopyable(*arg->type))
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Array, SmallVec and Optional are trivially copyable when their values are,
+// and Str always is
+bool CppGenerator::isTriviallyCopyable(const TypeRef &type) const
+{
+    if (hasElementType(type))
+    {
+        return type.getText() != "Vec" && isTriviallyCopyable(*getElementType(type));
+    }
+    return type.getText() == "Str" || isTriviallyCopyable(type.getText());
+}
+
+// A type has a bitwise layout when it is trivially copyable, has no padding
+// and its equality is the equality of its bytes
+bool CppGenerator::getBitwiseLayout(const std::string &typeName, size_t &size, size_t &align) const
+{
+    auto builtin = kBuiltinTypes.find(typeName);
+    if (builtin != kBuiltinTypes.end())
+    {
+        size = align = builtin->second.size;
+        return builtin->second.bitwise;
+    }
+    // A symbol is its index in the table of the process
+    if (typeName == "Sym")
+    {
+        size = align = sizeof(uint32_t);
+        return true;
+    }
+    auto decl = typeDecls.find(typeName);
+    if (decl == typeDecls.end())
+    {
+        return false;
+    }
+    switch (decl->second->token.kind)
+    {
+    case Kind::EnumDecl:
+        size = align = sizeof(int);
+        return true;
+    case Kind::StructDecl:
+        return !hasBookkeeping(typeName) &&
+               getBitwiseLayout(static_cast<const StructDecl *>(decl->second)->body->fields, size, align);
+    default:
+        return false;
+    }
+}
+
+// The unused values of a SmallVec make it differ from its bytes, but the
+// unused characters of a Str are zero: its layout is its encoding
+bool CppGenerator::getBitwiseLayout(const TypeRef &type, size_t &size, size_t &align) const
+{
+    if (type.getText() == "Str")
+    {
+        size = getBinSize(type);
+        align = 1;
+        return true;
+    }
+    if (type.getText() == "Array")
+    {
+        if (!getBitwiseLayout(*getElementType(type), size, align))
+        {
+            return false;
+        }
+        size *= getCapacity(type);
+        return true;
+    }
+    // An empty optional holds its niche, or T() followed by a false flag
+    if (type.getText() == "Optional")
+    {
+        bool undef;
+        long long value;
+        if (!getBitwiseLayout(*getElementType(type), size, align))
+        {
+            return false;
+        }
+        if (getNiche(*getElementType(type), undef, value))
+        {
+            return true;
+        }
+        size += 1;
+        return align == 1;
+    }
+    if (isContainer(type))
+    {
+        return false;
+    }
+    return getBitwiseLayout(type.getText(), size, align);
+}
+
+// True if every value of the bytes of a type is a valid value, so that it
+// can be decoded with a copy: not for bools, enums, ranges, optionals, or Str
+// whose length must fit and whose unused characters must be zero
+bool CppGenerator::acceptsAnyBytes(const TypeRef &type) const
+{
+    auto typeName = type.getText();
+    if (typeName == "Array")
+    {
+        return acceptsAnyBytes(*getElementType(type));
+    }
+    if (hasElementType(type) || type.range || typeName == "Str" || typeName == "bool" || typeName == "Sym")
+    {
+        return false;
+    }
+    if (kBuiltinTypes.count(typeName))
+    {
+        return true;
+    }
+    auto decl = typeDecls.find(typeName);
+    if (decl == typeDecls.end() || decl->second->token.kind != Kind::StructDecl)
+    {
+        return false;
+    }
+    const auto &fields = static_cast<const StructDecl *>(decl->second)->body->fields;
+    return std::all_of(fields.begin(), fields.end(), [this](const std::shared_ptr<StructFieldDecl> &field) {
+        return acceptsAnyBytes(*field->type);
+    });
+}
+
+template <typename Field>
+bool CppGenerator::getBitwiseLayout(const std::vector<std::shared_ptr<Field>> &fields, size_t &size, size_t &align) const
+{
+    if (fields.empty())
+    {
+        return false;
+    }
+    size = 0;
+    align = 1;
+    for (auto field : fields)
+    {
+        size_t fieldSize, fieldAlign;
+        if (!getBitwiseLayout(*field->type, fieldSize, fieldAlign) || size % fieldAlign != 0)
+        {
+            return false;
+        }
+        size += fieldSize;
+        align = std::max(align, fieldAlign);
+    }
+    return size % align == 0;
+}
+
+template <typename Field>
+std::string CppGenerator::genPaddingCheck(const std::string &typeName, const std::vector<std::shared_ptr<Field>> &fields)
+{
+    size_t size, align;
+    if (!getBitwiseLayout(fields, size, align))
+    {
+        return "";
+    }
+    std::string check = "static_assert(sizeof(" + typeName + ") == ";
+    int fieldCount = fields.size();
+    for (auto field : fields)
+    {
+        check += "sizeof(" + cppType(*field->type) + ")";
+        if (--fieldCount > 0)
+        {
+            check += " + ";
+        }
+    }
+    check += ", \"" + typeName + " must have no padding\");\n";
+    return check;
+}
+
+std::string CppGenerator::cppType(const TypeRef &type)
+{
+    auto typeName = type.getText();
+    if (type.range)
+    {
+        auto min = type.range->min->getValue();
+        auto max = type.range->max->getValue();
+        long long typeMin, typeMax;
+        if (!getIntegerLimits(typeName, typeMin, typeMax))
+        {
+            throw std::runtime_error("Range on non-integer type " + typeName);
+        }
+        if (min > max || min < typeMin || max > typeMax)
+        {
+            throw std::runtime_error("Invalid range " + std::to_string(min) + ".." + std::to_string(max) +
+                                     " for type " + typeName);
+        }
+    }
+    if (isContainer(type))
+    {
+        checkContainer(type);
+        addRuntimeType("containers");
+        auto elementType = cppType(*getElementType(type));
+        if (typeName == "Vec")
+        {
+            return "gm::Vec<" + elementType + ">";
+        }
+        return "gm::" + typeName + "<" + elementType + ", " + std::to_string(getCapacity(type)) + ">";
+    }
+    if (typeName == "Optional")
+    {
+        if (type.args.size() != 1 || !std::dynamic_pointer_cast<TypeRef>(type.args[0]))
+        {
+            throw std::runtime_error("Invalid arguments for type Optional");
+        }
+        addRuntimeType("optional");
+        auto element = getElementType(type);
+        auto valueType = cppType(*element);
+        bool undef;
+        long long value;
+        if (!getNiche(*element, undef, value))
+        {
+            return "gm::Optional<" + valueType + ">";
+        }
+        if (undef)
+        {
+            return "gm::Optional<" + valueType + ", gm::UndefNiche<" + valueType + ">>";
+        }
+        // The niche is followed by the bounds of the values of the element
+        std::vector<std::string> nicheArgs;
+        if (typeDecls.count(element->getText()))
+        {
+            for (auto bound : {value, 0LL, value - 1})
+            {
+                nicheArgs.push_back("static_cast<" + valueType + ">(" + std::to_string(bound) + ")");
+            }
+        }
+        else
+        {
+            nicheArgs = {genIntegerLiteral(value), genIntegerLiteral(element->range->min->getValue()),
+                         genIntegerLiteral(element->range->max->getValue())};
+        }
+        return "gm::Optional<" + valueType + ", gm::ValueNiche<" + valueType + ", " + nicheArgs[0] + ", " +
+               nicheArgs[1] + ", " + nicheArgs[2] + ">>";
+    }
+    if (typeName == "Str")
+    {
+        checkStr(type);
+        addRuntimeType("containers");
+        return "gm::Str<" + std::to_string(getCapacity(type)) + ">";
+    }
+    if (!type.args.empty())
+    {
+        throw std::runtime_error("Type " + typeName + " has no arguments");
+    }
+    if (typeName == "string")
+    {
+        header.addInclude(STLHeader::string);
+        return "std::string";
+    }
+    if (typeName == "Sym")
+    {
+        addRuntimeType("symbol");
+        return "gm::Sym";
+    }
+    auto builtin = kBuiltinTypes.find(typeName);
+    if (builtin != kBuiltinTypes.end())
+    {
+        if (builtin->second.integer && builtin->second.cppType != "int")
+        {
+            header.addInclude(STLHeader::cstdint);
+        }
+        return builtin->second.cppType;
+    }
+    return typeName;
+}
+
+// The runtime headers of the traits support the builtin types only: their
+// overloads for the runtime types of the fields are in separate headers, such
+// as gamma/out_symbol.hpp, included only when both are used in the file
+void CppGenerator::addRuntimeTrait(const std::string &module)
+{
+    header.addInclude("gamma/" + module + ".hpp");
+    runtimeTraits.insert(module);
+}
+
+void CppGenerator::addRuntimeType(const std::string &module)
+{
+    header.addInclude("gamma/" + module + ".hpp");
+    runtimeTypes.insert(module);
+}
+
+void CppGenerator::addRuntimeIncludes()
+{
+    for (const auto &trait : runtimeTraits)
+    {
+        for (const auto &type : runtimeTypes)
+        {
+            header.addInclude("gamma/" + trait + "_" + type + ".hpp");
+        }
+    }
+}
+
+// Constructor arguments are taken by value, and moved into place unless
+// they are trivially copyable
+std::string CppGenerator::genMove(const TypeRef &type, const std::string &name)
+{
+    if (isTriviallyCopyable(type))
+    {
+        return name;
+    }
+    header.addInclude(STLHeader::utility);
+    return "std::move(" + name + ")";
+}
+
+template <typename Field>
+std::string CppGenerator::genNoexcept(const std::vector<std::shared_ptr<Field>> &fields)
+{
+    std::string condition;
+    for (auto field : fields)
+    {
+        if (!isTriviallyCopyable(*field->type))
+        {
+            if (!condition.empty())
+            {
+                condition += " && ";
+            }
+            condition += "std::is_nothrow_move_constructible<" + cppType(*field->type) + ">::value";
+        }
+    }
+    if (condition.empty())
+    {
+        return " noexcept";
+    }
+    header.addInclude(STLHeader::type_traits);
+    return " noexcept(" + condition + ")";
+}
+
+const TraitList &CppGenerator::getTraits(const std::string &typeName) const
+{
+    const TypeDecl *decl = typeDecls.at(typeName);
+    switch (decl->token.kind)
+    {
+    case Kind::EnumDecl:
+        return *static_cast<const EnumDecl *>(decl)->traitList;
+    case Kind::StructDecl:
+        return *static_cast<const StructDecl *>(decl)->traitList;
+    default:
+        return *static_cast<const UnionDecl *>(decl)->traitList;
+    }
+}
+
+bool CppGenerator::hasTrait(const std::string &typeName, const std::string &trait) const
+{
+    if (!typeDecls.count(typeName))
+    {
+        return false;
+    }
+    for (auto traitId : getTraits(typeName).traits)
+    {
+        if (traitId->getText() == trait)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Size of the Bin encoding of a type, which is fixed: enums are encoded as
+// 32-bit integers, structs as the sequence of their fields, and unions as a
+// one-byte tag followed by the payload of the largest variant
+size_t CppGenerator::getBinSize(const std::string &typeName) const
+{
+    auto builtin = kBuiltinTypes.find(typeName);
+    if (builtin != kBuiltinTypes.end())
+    {
+        return builtin->second.size;
+    }
+    auto decl = typeDecls.find(typeName);
+    if (decl == typeDecls.end())
+    {
+        throw std::runtime_error("Type " + typeName + " does not support trait Bin");
+    }
+    size_t size = 0;
+    switch (decl->second->token.kind)
+    {
+    case Kind::EnumDecl:
+        return kEnumBinSize;
+    case Kind::StructDecl:
+        for (auto field : static_cast<const StructDecl *>(decl->second)->body->fields)
+        {
+            size += getBinSize(*field->type);
+        }
+        break;
+    default:
+        for (auto field : static_cast<const UnionDecl *>(decl->second)->body->fields)
+        {
+            size = std::max(size, getBinSize(*field));
+        }
+        size += kUnionTagBinSize;
+        break;
+    }
+    if (!hasTrait(typeName, "Bin"))
+    {
+        throw std::runtime_error("Type " + typeName + " must have trait Bin");
+    }
+    return size;
+}
+
+// An Array is the sequence of its values, a SmallVec its count followed by
+// its values, padded with zeros to its capacity, and a Str its length byte
+// followed by its characters, padded the same way. An Optional is its stored
+// value, followed by a flag byte if its type has no niche.
+size_t CppGenerator::getBinSize(const TypeRef &type) const
+{
+    auto typeName = type.getText();
+    if (typeName == "Str")
+    {
+        return 1 + getCapacity(type);
+    }
+    if (typeName == "Array")
+    {
+        return getCapacity(type) * getBinSize(*getElementType(type));
+    }
+    if (typeName == "SmallVec")
+    {
+        return getCountBinSize(getCapacity(type)) + getCapacity(type) * getBinSize(*getElementType(type));
+    }
+    if (typeName == "Optional")
+    {
+        bool undef;
+        long long value;
+        auto element = getElementType(type);
+        return getBinSize(*element) + (getNiche(*element, undef, value) ? 0 : 1);
+    }
+    return getBinSize(typeName);
+}
+
+size_t CppGenerator::getBinSize(const UnionFieldDecl &field) const
+{
+    size_t size = 0;
+    for (auto arg : field.args)
+    {
+        size += getBinSize(*arg->type);
+    }
+    return size;
+}
+
+// Canonical description of a type, from which its fingerprint is computed
+std::string CppGenerator::getSchema(const std::string &typeName) const
+{
+    auto decl = typeDecls.find(typeName);
+    if (decl == typeDecls.end())
+    {
+        return typeName;
+    }
+    std::string schema;
+    switch (decl->second->token.kind)
+    {
+    case Kind::EnumDecl:
+        schema += "enum " + typeName + "{";
+        for (auto field : static_cast<const EnumDecl *>(decl->second)->body->fields)
+        {
+            schema += field->getText() + ";";
+        }
+        break;
+    case Kind::StructDecl:
+        schema += "struct " + typeName + "{";
+        for (auto field : static_cast<const StructDecl *>(decl->second)->body->fields)
+        {
+            schema += field->getText() + ":" + getSchema(*field->type) + ";";
+        }
+        break;
+    default:
+        schema += "union " + typeName + "{";
+        for (auto field : static_cast<const UnionDecl *>(decl->second)->body->fields)
+        {
+            schema += field->getText() + "(";
+            for (auto arg : field->args)
+            {
+                schema += arg->getText() + ":" + getSchema(*arg->type) + ";";
+            }
+            schema += ");";
+        }
+        break;
+    }
+    return schema + "}";
+}
+
+std::string CppGenerator::getSchema(const TypeRef &type) const
+{
+    if (type.getText() == "Str")
+    {
+        return "Str<" + std::to_string(getCapacity(type)) + ">";
+    }
+    if (!hasElementType(type))
+    {
+        return getSchema(type.getText());
+    }
+    auto schema = type.getText() + "<" + getSchema(*getElementType(type));
+    if (isContainer(type) && type.getText() != "Vec")
+    {
+        schema += "," + std::to_string(getCapacity(type));
+    }
+    return schema + ">";
+}
+
+// Optional values use a niche of their type when it has one: a value that it
+// never holds, standing for the empty optional. It is the Undef tag of a
+// union, the value past the variants of an enum, or a value next to the range
+// of an integer.
+bool CppGenerator::getNiche(const TypeRef &type, bool &undef, long long &value) const
+{
+    undef = false;
+    auto decl = typeDecls.find(type.getText());
+    if (decl != typeDecls.end())
+    {
+        switch (decl->second->token.kind)
+        {
+        case Kind::UnionDecl:
+            undef = true;
+            return true;
+        case Kind::EnumDecl:
+            value = static_cast<const EnumDecl *>(decl->second)->body->fields.size();
+            return true;
         default:
-            out += c;
+            return false;
         }
     }
-    out += "\"";
-    return out;
+    long long typeMin, typeMax;
+    if (!type.range || !getIntegerLimits(type.getText(), typeMin, typeMax))
+    {
+        return false;
+    }
+    if (type.range->max->getValue() < typeMax)
+    {
+        value = type.range->max->getValue() + 1;
+        return true;
+    }
+    if (type.range->min->getValue() > typeMin)
+    {
+        value = type.range->min->getValue() - 1;
+        return true;
+    }
+    return false;
 }
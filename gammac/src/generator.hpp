@@ -16,7 +16,9 @@
 
 #pragma once
 
+#include <cstdint>
 #include <list>
+#include <map>
 #include <set>
 #include <string>
 #include <vector>
@@ -26,6 +28,9 @@
 
 class StreamWriter;
 
+// Number of reads of each variant of each type, from an instrumented build
+typedef std::map<std::string, std::map<std::string, uint64_t>> Profile;
+
 class CppBlock
 {
 public:
@@ -48,6 +53,7 @@ public:
   CppFile(StreamWriter &writer) : writer(writer) {}
   CppBlock &addBlock(const std::string &text = "");
   void addInclude(STLHeader header);
+  void addInclude(const std::string &path);
   void setIncludeGuard(const std::string &name);
   void emit();
 
@@ -55,6 +61,7 @@ private:
   StreamWriter &writer;
   std::string includeGuard;
   std::set<STLHeader> includes;
+  std::set<std::string> localIncludes;
   CppBlock block;
 };
 
@@ -62,24 +69,117 @@ class CppGenerator
 {
 public:
   CppGenerator(const std::string &fileName, StreamWriter &sourceWriter, StreamWriter &headerWriter);
+  void setProfile(const Profile &profile);
+  void setBenchWriter(StreamWriter &writer);
   void gen(const SourceFile &node);
 
 private:
   void gen(const AST &node);
   void gen(const EnumDecl &node);
   void genEnumInTrait(const EnumDecl &node);
+  void genEnumNumberInput(const EnumDecl &node, const std::vector<int> &numbers);
   void genEnumOutTrait(const EnumDecl &node);
+  void genEnumBinTrait(const EnumDecl &node);
+  void genEnumJsonTrait(const EnumDecl &node);
+  void genEnumColumns(const EnumDecl &node);
+  std::string genEnumConstant(const EnumDecl &node, const Arg &column, const AST &value) const;
   void gen(const StructDecl &node);
   CppBlock &genStructBody(const StructDecl &node);
+  void genStructLayoutChecks(const StructDecl &node);
+  void genStructFieldIds(const StructDecl &node, CppBlock &structBody);
+  void genStructSetters(const StructDecl &node, CppBlock &structBody);
+  std::string genFieldUpdate(const StructDecl &node, const StructFieldDecl &field,
+                             const std::string &expr, const std::string &indentation);
+  std::string genFieldsWritten(const std::string &typeName, const std::string &prefix,
+                               const std::string &indentation, const std::string &changed = "");
+  void genStructUndoTrait(const StructDecl &node, CppBlock &structBody);
+  void genStructZobristTrait(const StructDecl &node, CppBlock &structBody);
+  void genStructDiffTrait(const StructDecl &node, CppBlock &structBody);
+  void genStructTrackTrait(const StructDecl &node, CppBlock &structBody);
+  void genStructPackedTrait(const StructDecl &node);
+  size_t getZobristKeyCount(const TypeRef &type) const;
+  std::string genZobristIndex(const TypeRef &type, const std::string &expr) const;
+  bool hasBookkeeping(const std::string &structName) const;
   void genStructEqTrait(const StructDecl &node, CppBlock &structBody);
+  void genStructInTrait(const StructDecl &node);
   void genStructOutTrait(const StructDecl &node);
+  void genStructBinTrait(const StructDecl &node);
+  void genStructViewTrait(const StructDecl &node);
+  void genStructColumnsTrait(const StructDecl &node);
+  void genStructJsonTrait(const StructDecl &node);
   void gen(const UnionDecl &node);
   CppBlock &genUnionBody(const UnionDecl &node);
+  void genUnionLayoutChecks(const UnionDecl &node);
+  void genUnionVisit(const UnionDecl &node, const std::string &qualifier);
   void genUnionEqTrait(const UnionDecl &node, CppBlock &unionBody);
+  void genUnionInTrait(const UnionDecl &node);
   void genUnionOutTrait(const UnionDecl &node);
+  void genUnionBinTrait(const UnionDecl &node);
+  void genUnionViewTrait(const UnionDecl &node);
+  void genUnionJsonTrait(const UnionDecl &node);
+  template <typename Field>
+  void genJsonObject(const std::string &typeName, const std::vector<std::shared_ptr<Field>> &fields,
+                     const std::string &linkage);
+  std::string genJsonCall(const std::string &function, const TypeRef &type, const std::string &args);
+  void genBinDecl(const std::string &typeName);
+  std::string genFieldEncode(const TypeRef &type, const std::string &expr);
+  std::string genFieldDecode(const TypeRef &type, const std::string &expr);
+  std::string genEnumDecode(const std::string &typeName, const std::string &expr, int niches) const;
+  std::string genViewAccessor(const TypeRef &type, const std::string &name,
+                              const std::string &params, const std::string &position);
+  void genTextOutput(const std::string &typeName, const std::string &body);
+  void checkBufferedTrait(const std::string &typeName) const;
+  void genReadMany(const std::string &typeName);
+  std::string genTextCall(const TypeRef &type, const std::string &args);
+  void checkInTrait(const TypeRef &type) const;
   std::string expandFormat(const UnionFieldDecl &scope, const std::string &format);
+  void genRandTrait(const TypeDecl &node);
+  std::string genRandomize(const TypeDecl &node, const std::string &linkage);
+  std::string genRandomizeCall(const TypeRef &type, const std::string &expr);
+  std::string genRandomValue(const TypeRef &type);
+  void genBench(const SourceFile &node);
+  std::string genBenchHelpers(const TypeDecl &node);
+  std::string genBenchTraits(const std::string &typeName);
+  template <typename Field>
+  void genProfileCounters(const std::string &typeName, const std::vector<std::shared_ptr<Field>> &fields);
+  template <typename Field>
+  std::vector<std::shared_ptr<Field>> sortByProfile(const std::string &typeName,
+                                                    const std::vector<std::shared_ptr<Field>> &fields) const;
+  bool isCold(const std::string &typeName, const std::string &variant);
+  const TraitList &getTraits(const std::string &typeName) const;
+  bool hasTrait(const std::string &typeName, const std::string &trait) const;
+  bool isTriviallyCopyable(const std::string &typeName) const;
+  bool isTriviallyCopyable(const TypeRef &type) const;
+  bool getBitwiseLayout(const std::string &typeName, size_t &size, size_t &align) const;
+  bool getBitwiseLayout(const TypeRef &type, size_t &size, size_t &align) const;
+  bool acceptsAnyBytes(const TypeRef &type) const;
+  template <typename Field>
+  bool getBitwiseLayout(const std::vector<std::shared_ptr<Field>> &fields, size_t &size, size_t &align) const;
+  size_t getBinSize(const std::string &typeName) const;
+  size_t getBinSize(const TypeRef &type) const;
+  size_t getBinSize(const UnionFieldDecl &field) const;
+  std::string getSchema(const std::string &typeName) const;
+  std::string getSchema(const TypeRef &type) const;
+  bool getNiche(const TypeRef &type, bool &undef, long long &value) const;
+  std::string cppType(const TypeRef &type);
+  void addRuntimeTrait(const std::string &module);
+  void addRuntimeType(const std::string &module);
+  void addRuntimeIncludes();
+  std::string genMove(const TypeRef &type, const std::string &name);
+  template <typename Field>
+  std::string genNoexcept(const std::vector<std::shared_ptr<Field>> &fields);
+  template <typename Field>
+  std::string genPaddingCheck(const std::string &typeName, const std::vector<std::shared_ptr<Field>> &fields);
 
   std::string fileName;
+  std::map<std::string, const TypeDecl *> typeDecls;
+  // Position of each type in the declarations of the file
+  std::map<std::string, size_t> declOrder;
+  Profile profile;
+  // Runtime headers of the traits and of the field types used in the file
+  std::set<std::string> runtimeTraits;
+  std::set<std::string> runtimeTypes;
   CppFile source;
   CppFile header;
+  StreamWriter *benchWriter;
 };
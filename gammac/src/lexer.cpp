@@ -70,19 +70,39 @@ Token Lexer::nextToken(int n)
         case ']':
             consume();
             return Token(Kind::RBrack, startPos, "]");
+        case '<':
+            consume();
+            return Token(Kind::LAngle, startPos, "<");
+        case '>':
+            consume();
+            return Token(Kind::RAngle, startPos, ">");
         case '{':
             consume();
             return Token(Kind::LBrace, startPos, "{");
         case '}':
             consume();
             return Token(Kind::RBrace, startPos, "}");
+        case '.':
+            consume();
+            if (peek != '.')
+            {
+                throw std::runtime_error("Invalid character .");
+            }
+            consume();
+            return Token(Kind::DotDot, startPos, "..");
         case '"':
             return getString(startPos);
+        case '-':
+            return getNumber(startPos);
         default:
             if (isLetter())
             {
                 return getName(startPos);
             }
+            else if (isDigit())
+            {
+                return getNumber(startPos);
+            }
             else
             {
                 std::string error = "Invalid character ";
@@ -101,7 +121,7 @@ Token Lexer::getName(const Pos &startPos)
     {
         buf += peek;
         consume();
-    } while (isLetter());
+    } while (isLetter() || isDigit());
     auto word = WORDS.find(buf);
     if (word != WORDS.end())
     {
@@ -123,6 +143,26 @@ Token Lexer::getString(const Pos &startPos)
     return Token(Kind::String, startPos, buf);
 }
 
+Token Lexer::getNumber(const Pos &startPos)
+{
+    std::string buf;
+    if (peek == '-')
+    {
+        buf += peek;
+        consume();
+    }
+    if (!isDigit())
+    {
+        throw std::runtime_error("Invalid number " + buf);
+    }
+    do
+    {
+        buf += peek;
+        consume();
+    } while (isDigit());
+    return Token(Kind::Number, startPos, buf);
+}
+
 void Lexer::consume()
 {
     peek = is.get();
@@ -153,5 +193,10 @@ bool Lexer::isSpace() const
 
 bool Lexer::isLetter() const
 {
-    return (peek >= 'a' && peek <= 'z') || (peek >= 'A' && peek <= 'Z');
+    return (peek >= 'a' && peek <= 'z') || (peek >= 'A' && peek <= 'Z') || peek == '_';
+}
+
+bool Lexer::isDigit() const
+{
+    return peek >= '0' && peek <= '9';
 }
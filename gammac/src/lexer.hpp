@@ -32,8 +32,10 @@ private:
   void consume();
   bool isSpace() const;
   bool isLetter() const;
+  bool isDigit() const;
   Token getName(const Pos& startPos);
   Token getString(const Pos& startPos);
+  Token getNumber(const Pos& startPos);
   void skipComment();
 
   std::istream &is;
@@ -16,6 +16,8 @@
 
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <stdexcept>
 
 #include "generator.hpp"
 #include "lexer.hpp"
@@ -35,7 +37,29 @@ void dumpFile(const std::string &fileName)
     }
 }
 
-void compileFile(const std::string &fileName, bool debug)
+// Reads the lines "Type Variant count" written by an instrumented build
+Profile readProfile(const std::string &fileName)
+{
+    std::ifstream inStream(fileName);
+    if (!inStream)
+    {
+        throw std::runtime_error("Cannot open profile " + fileName);
+    }
+    Profile profile;
+    std::string type, variant;
+    uint64_t count;
+    while (inStream >> type >> variant >> count)
+    {
+        profile[type][variant] += count;
+    }
+    if (!inStream.eof())
+    {
+        throw std::runtime_error("Invalid profile " + fileName);
+    }
+    return profile;
+}
+
+void compileFile(const std::string &fileName, bool debug, bool emitBench, const Profile &profile)
 {
     try
     {
@@ -49,7 +73,13 @@ void compileFile(const std::string &fileName, bool debug)
             dumpFile(fileName);
             DebugWriter sourceWriter(fileName + ".cpp");
             DebugWriter headerWriter(fileName + ".hpp");
+            DebugWriter benchWriter(fileName + ".bench.cpp");
             CppGenerator generator(fileName, sourceWriter, headerWriter);
+            generator.setProfile(profile);
+            if (emitBench)
+            {
+                generator.setBenchWriter(benchWriter);
+            }
             generator.gen(*ast);
         }
         else
@@ -58,6 +88,13 @@ void compileFile(const std::string &fileName, bool debug)
             FileWriter sourceWriter(outDir + "/" + fileName + ".cpp");
             FileWriter headerWriter(outDir + "/" + fileName + ".hpp");
             CppGenerator generator(fileName, sourceWriter, headerWriter);
+            generator.setProfile(profile);
+            std::unique_ptr<FileWriter> benchWriter;
+            if (emitBench)
+            {
+                benchWriter.reset(new FileWriter(outDir + "/" + fileName + ".bench.cpp"));
+                generator.setBenchWriter(*benchWriter);
+            }
             generator.gen(*ast);
         }
     }
@@ -67,17 +104,58 @@ void compileFile(const std::string &fileName, bool debug)
     }
 }
 
+void usage()
+{
+    std::cout << "Usage: gammac [-d] [--emit-bench] [--profile <profileFile>] <fileName>" << std::endl;
+}
+
 int main(int argc, char **argv)
 {
-    switch (argc)
+    bool debug = false;
+    bool emitBench = false;
+    std::string fileName, profileName;
+    for (int i = 1; i < argc; i++)
     {
-    case 2:
-        compileFile(argv[1], false);
-        break;
-    case 3:
-        compileFile(argv[2], true);
-        break;
-    default:
-        std::cout << "Usage: gammac <fileName> [-d]" << std::endl;
+        std::string arg = argv[i];
+        if (arg == "-d")
+        {
+            debug = true;
+        }
+        else if (arg == "--emit-bench")
+        {
+            emitBench = true;
+        }
+        else if (arg == "--profile" && i + 1 < argc)
+        {
+            profileName = argv[++i];
+        }
+        else if (fileName.empty() && arg[0] != '-')
+        {
+            fileName = arg;
+        }
+        else
+        {
+            usage();
+            return 1;
+        }
+    }
+    if (fileName.empty())
+    {
+        usage();
+        return 1;
+    }
+    Profile profile;
+    if (!profileName.empty())
+    {
+        try
+        {
+            profile = readProfile(profileName);
+        }
+        catch (std::exception &e)
+        {
+            std::cerr << "Fatal error: " << e.what() << std::endl;
+            return 1;
+        }
     }
+    compileFile(fileName, debug, emitBench, profile);
 }
@@ -19,6 +19,8 @@
 
 #include <iostream>
 #include <sstream>
+#include <stdexcept>
+#include <string>
 
 Parser::Parser(Lexer &lexer) : lexer(lexer)
 {
@@ -69,10 +71,15 @@ std::shared_ptr<EnumDecl> Parser::parseEnumDecl()
         }
         match(Kind::RBrack);
     }
+    std::vector<std::shared_ptr<Arg>> columns;
+    if (nextKind() == Kind::LParen)
+    {
+        columns = parseArgList();
+    }
     match(Kind::LBrace);
     auto body = parseEnumBody();
     match(Kind::RBrace);
-    return std::make_shared<EnumDecl>(tok, name, traitList, body);
+    return std::make_shared<EnumDecl>(tok, name, traitList, columns, body);
 }
 
 std::shared_ptr<EnumBody> Parser::parseEnumBody()
@@ -83,6 +90,30 @@ std::shared_ptr<EnumBody> Parser::parseEnumBody()
         Token tok = nextToken();
         match(Kind::Id);
         auto field = std::make_shared<EnumFieldDecl>(tok);
+        if (nextKind() == Kind::LParen)
+        {
+            match(Kind::LParen);
+            for (;;)
+            {
+                if (nextKind() == Kind::Number)
+                {
+                    field->values.push_back(parseNumber());
+                }
+                else
+                {
+                    field->values.push_back(parseId());
+                }
+                if (nextKind() == Kind::Comma)
+                {
+                    match(Kind::Comma);
+                }
+                else
+                {
+                    break;
+                }
+            }
+            match(Kind::RParen);
+        }
         if (nextKind() == Kind::String)
         {
             Token stringTok = nextToken();
@@ -138,9 +169,7 @@ std::shared_ptr<StructFieldDecl> Parser::parseStructField()
     Token fieldId = nextToken();
     match(Kind::Id);
     match(Kind::Colon);
-    Token typeId = nextToken();
-    match(Kind::Id);
-    auto typeRef = std::make_shared<TypeRef>(typeId);
+    auto typeRef = parseTypeRef();
     return std::make_shared<StructFieldDecl>(fieldId, typeRef);
 }
 
@@ -182,17 +211,59 @@ std::shared_ptr<UnionFieldDecl> Parser::parseUnionField()
     auto field = std::make_shared<UnionFieldDecl>(fieldId);
     if (nextKind() == Kind::LParen)
     {
-        match(Kind::LParen);
-        while (nextKind() == Kind::Id)
+        field->args = parseArgList();
+    }
+    if (nextKind() == Kind::String)
+    {
+        Token stringTok = nextToken();
+        match(Kind::String);
+        field->format = std::make_shared<StringLiteral>(stringTok);
+    }
+    return field;
+}
+
+std::vector<std::shared_ptr<Arg>> Parser::parseArgList()
+{
+    std::vector<std::shared_ptr<Arg>> args;
+    match(Kind::LParen);
+    while (nextKind() == Kind::Id)
+    {
+        Token argId = nextToken();
+        match(Kind::Id);
+        match(Kind::Colon);
+        auto typeRef = parseTypeRef();
+        args.push_back(std::make_shared<Arg>(argId, typeRef));
+        if (nextKind() == Kind::Comma)
         {
-            Token argId = nextToken();
-            match(Kind::Id);
-            match(Kind::Colon);
-            Token typeId = nextToken();
-            match(Kind::Id);
-            auto typeRef = std::make_shared<TypeRef>(typeId);
-            auto arg = std::make_shared<Arg>(argId, typeRef);
-            field->args.push_back(arg);
+            match(Kind::Comma);
+        }
+        else
+        {
+            break;
+        }
+    }
+    match(Kind::RParen);
+    return args;
+}
+
+std::shared_ptr<TypeRef> Parser::parseTypeRef()
+{
+    Token typeId = nextToken();
+    match(Kind::Id);
+    auto typeRef = std::make_shared<TypeRef>(typeId);
+    if (nextKind() == Kind::LAngle)
+    {
+        match(Kind::LAngle);
+        for (;;)
+        {
+            if (nextKind() == Kind::Number)
+            {
+                typeRef->args.push_back(parseNumber());
+            }
+            else
+            {
+                typeRef->args.push_back(parseTypeRef());
+            }
             if (nextKind() == Kind::Comma)
             {
                 match(Kind::Comma);
@@ -202,15 +273,36 @@ std::shared_ptr<UnionFieldDecl> Parser::parseUnionField()
                 break;
             }
         }
-        match(Kind::RParen);
+        match(Kind::RAngle);
     }
-    if (nextKind() == Kind::String)
+    if (nextKind() == Kind::LBrack)
     {
-        Token stringTok = nextToken();
-        match(Kind::String);
-        field->format = std::make_shared<StringLiteral>(stringTok);
+        match(Kind::LBrack);
+        auto min = parseNumber();
+        match(Kind::DotDot);
+        auto max = parseNumber();
+        match(Kind::RBrack);
+        typeRef->range = std::make_shared<Range>(min, max);
     }
-    return field;
+    return typeRef;
+}
+
+std::shared_ptr<NumberLiteral> Parser::parseNumber()
+{
+    Token tok = nextToken();
+    match(Kind::Number);
+    // Every later use of the literal assumes it fits in a long long
+    try
+    {
+        std::stoll(tok.lexeme);
+    }
+    catch (const std::out_of_range &)
+    {
+        std::stringstream ss;
+        ss << "Number out of range: " << tok;
+        throw std::runtime_error(ss.str());
+    }
+    return std::make_shared<NumberLiteral>(tok);
 }
 
 std::shared_ptr<Id> Parser::parseId()
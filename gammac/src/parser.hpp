@@ -37,6 +37,9 @@ class Parser
     std::shared_ptr<UnionDecl> parseUnionDecl();
     std::shared_ptr<UnionBody> parseUnionBody();
     std::shared_ptr<UnionFieldDecl> parseUnionField();
+    std::vector<std::shared_ptr<Arg>> parseArgList();
+    std::shared_ptr<TypeRef> parseTypeRef();
+    std::shared_ptr<NumberLiteral> parseNumber();
     std::shared_ptr<Id> parseId();
     std::vector<std::shared_ptr<Id>> parseIdList();
     std::shared_ptr<TraitList> parseTraitList();
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2017 Cyril Deguet <cyril.deguet@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Compares the standard streams with the buffers of gamma/io.hpp on a bot
+// protocol: each turn reads a count and as many actions, then echoes them
+// and flushes the output.
+//
+// Usage: io_bench gen > input.txt
+//        io_bench std|gamma < input.txt > /dev/null
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "gamma/io.hpp"
+#include "src/enum_and_union.gm.hpp"
+
+static const int kTurns = 2000;
+static const int kActionsPerTurn = 200;
+
+static void generate()
+{
+    const char *dirs[] = {"N", "E", "S", "W"};
+    for (int turn = 0; turn < kTurns; turn++)
+    {
+        std::cout << kActionsPerTurn << "\n";
+        for (int i = 0; i < kActionsPerTurn; i++)
+        {
+            const char *dir = dirs[(turn + i) % 4];
+            switch (i % 3)
+            {
+            case 0:
+                std::cout << "MOVE " << dir << "\n";
+                break;
+            case 1:
+                std::cout << "SHOOT " << dir << " " << turn * i << "\n";
+                break;
+            default:
+                std::cout << "WAIT\n";
+            }
+        }
+    }
+}
+
+static void runStd()
+{
+    std::vector<Action> actions;
+    int count;
+    while (std::cin >> count)
+    {
+        actions.resize(count);
+        for (auto &action : actions)
+        {
+            std::cin >> action;
+        }
+        for (const auto &action : actions)
+        {
+            std::cout << action << "\n";
+        }
+        std::cout << std::endl;
+    }
+}
+
+static void runGamma()
+{
+    gm::InputBuffer input;
+    gm::OutputBuffer output;
+    std::vector<Action> actions;
+    while (input.more())
+    {
+        int count;
+        input >> count;
+        actions.resize(count);
+        for (auto &action : actions)
+        {
+            input >> action;
+        }
+        for (const auto &action : actions)
+        {
+            output << action << "\n";
+        }
+        output << "\n";
+        output.flush();
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc != 2)
+    {
+        std::cerr << "usage: " << argv[0] << " gen|std|gamma" << std::endl;
+        return 1;
+    }
+    if (std::strcmp(argv[1], "gen") == 0)
+    {
+        generate();
+        return 0;
+    }
+    auto start = std::chrono::steady_clock::now();
+    if (std::strcmp(argv[1], "std") == 0)
+    {
+        runStd();
+    }
+    else
+    {
+        runGamma();
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    std::cerr << argv[1] << ": " << elapsed.count() << " ms" << std::endl;
+    return 0;
+}
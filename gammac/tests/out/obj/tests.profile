@@ -0,0 +1,6 @@
+Terrain GRASS 1
+Terrain WATER 1
+Terrain ROCK 1
+Event Spawn 2
+Event Tick 2
+Event Quit 3
@@ -0,0 +1,253 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "gamma/containers.hpp"
+#include "gamma/optional.hpp"
+#include "gamma/random.hpp"
+
+#include "src/bin.gm.hpp"
+
+// Generated by gammac --emit-bench; usage: <program> [count]
+
+template <typename T>
+static inline void writeInput(std::ostream &os, const T &value) { os << value; }
+static inline void writeInput(std::ostream &os, int8_t value) { os << static_cast<int>(value); }
+static inline void writeInput(std::ostream &os, uint8_t value) { os << static_cast<int>(value); }
+template <typename T, size_t N>
+static inline void writeInput(std::ostream &os, const gm::Array<T, N> &value);
+template <typename T, size_t N>
+static inline void writeInput(std::ostream &os, const gm::SmallVec<T, N> &value);
+template <typename T>
+static inline void writeInput(std::ostream &os, const gm::Vec<T> &value);
+template <typename T, typename Niche>
+static inline void writeInput(std::ostream &os, const gm::Optional<T, Niche> &value);
+
+template <typename Container>
+static inline void writeInputItems(std::ostream &os, const Container &value) {
+  for (const auto &item : value) {
+    os << ' ';
+    writeInput(os, item);
+  }
+}
+
+template <typename T, size_t N>
+static inline void writeInput(std::ostream &os, const gm::Array<T, N> &value) {
+  writeInput(os, value[0]);
+  for (size_t i = 1; i < N; i++) {
+    os << ' ';
+    writeInput(os, value[i]);
+  }
+}
+
+template <typename T, size_t N>
+static inline void writeInput(std::ostream &os, const gm::SmallVec<T, N> &value) {
+  os << value.size();
+  writeInputItems(os, value);
+}
+
+template <typename T>
+static inline void writeInput(std::ostream &os, const gm::Vec<T> &value) {
+  os << value.size();
+  writeInputItems(os, value);
+}
+
+template <typename T, typename Niche>
+static inline void writeInput(std::ostream &os, const gm::Optional<T, Niche> &value) {
+  if (value.has_value()) {
+    writeInput(os, *value);
+  }
+  else {
+    os << '-';
+  }
+}
+
+typedef std::chrono::steady_clock BenchClock;
+
+static void report(const char *type, const char *trait, BenchClock::time_point start, size_t count, size_t bytes) {
+  double ns = std::chrono::duration<double, std::nano>(BenchClock::now() - start).count();
+  if (bytes > 0) {
+    std::printf("%-20s %-8s %10.1f ns/op %10.1f MB/s\n", type, trait, ns / count, bytes * 1e3 / ns);
+  }
+  else {
+    std::printf("%-20s %-8s %10.1f ns/op\n", type, trait, ns / count);
+  }
+}
+
+static inline void randomize(gm::Rng &rng, Cell &obj) {
+  obj = static_cast<Cell>(rng.below(3));
+}
+
+static void benchCell(size_t count) {
+  gm::Rng rng(50137304956718101ULL);
+  std::vector<Cell> values(count);
+  for (auto &value : values) {
+    randomize(rng, value);
+  }
+  {
+    std::vector<uint8_t> buffer(count * kCellBinSize);
+    uint8_t *out = buffer.data();
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      encode(out, value);
+    }
+    report("Cell", "Bin out", start, count, buffer.size());
+    std::vector<Cell> decoded(count);
+    const uint8_t *in = buffer.data();
+    start = BenchClock::now();
+    for (auto &value : decoded) {
+      decode(in, value);
+    }
+    report("Cell", "Bin in", start, count, buffer.size());
+  }
+}
+
+static inline void randomize(gm::Rng &rng, Pos &obj) {
+  randomize(rng, obj.x);
+  randomize(rng, obj.y);
+}
+
+static void benchPos(size_t count) {
+  gm::Rng rng(10206136531950144969ULL);
+  std::vector<Pos> values(count);
+  for (auto &value : values) {
+    randomize(rng, value);
+  }
+  {
+    std::vector<Pos> copies(values);
+    size_t equal = 0;
+    auto start = BenchClock::now();
+    for (size_t i = 0; i < count; i++) {
+      equal += values[i] == copies[i];
+    }
+    report("Pos", "Eq", start, count, 0);
+    if (equal != count) {
+      std::printf("%s: copies differ\n", "Pos");
+    }
+  }
+  {
+    std::vector<uint8_t> buffer(count * kPosBinSize);
+    uint8_t *out = buffer.data();
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      encode(out, value);
+    }
+    report("Pos", "Bin out", start, count, buffer.size());
+    std::vector<Pos> decoded(count);
+    const uint8_t *in = buffer.data();
+    start = BenchClock::now();
+    for (auto &value : decoded) {
+      decode(in, value);
+    }
+    report("Pos", "Bin in", start, count, buffer.size());
+  }
+}
+
+static inline void randomize(gm::Rng &rng, Order &obj) {
+  switch (rng.below(3)) {
+  case 0:
+    obj.type = Order::Go_t;
+    randomize(rng, obj.data.Go.to);
+    break;
+  case 1:
+    obj.type = Order::Drop_t;
+    randomize(rng, obj.data.Drop.cell);
+    randomize(rng, obj.data.Drop.count);
+    break;
+  case 2:
+    obj.type = Order::Idle_t;
+    break;
+  }
+}
+
+static void benchOrder(size_t count) {
+  gm::Rng rng(3145189127427554391ULL);
+  std::vector<Order> values(count);
+  for (auto &value : values) {
+    randomize(rng, value);
+  }
+  {
+    std::vector<Order> copies(values);
+    size_t equal = 0;
+    auto start = BenchClock::now();
+    for (size_t i = 0; i < count; i++) {
+      equal += values[i] == copies[i];
+    }
+    report("Order", "Eq", start, count, 0);
+    if (equal != count) {
+      std::printf("%s: copies differ\n", "Order");
+    }
+  }
+  {
+    std::vector<uint8_t> buffer(count * kOrderBinSize);
+    uint8_t *out = buffer.data();
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      encode(out, value);
+    }
+    report("Order", "Bin out", start, count, buffer.size());
+    std::vector<Order> decoded(count);
+    const uint8_t *in = buffer.data();
+    start = BenchClock::now();
+    for (auto &value : decoded) {
+      decode(in, value);
+    }
+    report("Order", "Bin in", start, count, buffer.size());
+  }
+}
+
+static inline void randomize(gm::Rng &rng, Bot &obj) {
+  randomize(rng, obj.pos);
+  randomize(rng, obj.cell);
+  randomize(rng, obj.alive);
+  randomize(rng, obj.energy);
+  randomize(rng, obj.order);
+}
+
+static void benchBot(size_t count) {
+  gm::Rng rng(1609564187128952862ULL);
+  std::vector<Bot> values(count);
+  for (auto &value : values) {
+    randomize(rng, value);
+  }
+  {
+    std::vector<Bot> copies(values);
+    size_t equal = 0;
+    auto start = BenchClock::now();
+    for (size_t i = 0; i < count; i++) {
+      equal += values[i] == copies[i];
+    }
+    report("Bot", "Eq", start, count, 0);
+    if (equal != count) {
+      std::printf("%s: copies differ\n", "Bot");
+    }
+  }
+  {
+    std::vector<uint8_t> buffer(count * kBotBinSize);
+    uint8_t *out = buffer.data();
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      encode(out, value);
+    }
+    report("Bot", "Bin out", start, count, buffer.size());
+    std::vector<Bot> decoded(count);
+    const uint8_t *in = buffer.data();
+    start = BenchClock::now();
+    for (auto &value : decoded) {
+      decode(in, value);
+    }
+    report("Bot", "Bin in", start, count, buffer.size());
+  }
+}
+
+int main(int argc, char *argv[]) {
+  size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+  benchCell(count);
+  benchPos(count);
+  benchOrder(count);
+  benchBot(count);
+  return 0;
+}
@@ -0,0 +1,163 @@
+#include <cstring>
+#include <stdexcept>
+
+#include "src/bin.gm.hpp"
+
+void encode(uint8_t *&out, const Cell &obj) {
+  gm::store<int32_t>(out, static_cast<int32_t>(obj));
+  out += 4;
+}
+
+void decode(const uint8_t *&in, Cell &obj) {
+  obj = static_cast<Cell>(gm::loadEnum(in, 3));
+  in += 4;
+}
+
+bool Pos::operator==(const Pos &other) const {
+  return std::memcmp(this, &other, sizeof(Pos)) == 0;
+}
+
+void encode(uint8_t *&out, const Pos &obj) {
+  if (gm::kLittleEndian) {
+    std::memcpy(out, &obj, kPosBinSize);
+    out += kPosBinSize;
+    return;
+  }
+  gm::store<int32_t>(out, obj.x);
+  out += 4;
+  gm::store<int32_t>(out, obj.y);
+  out += 4;
+}
+
+void decode(const uint8_t *&in, Pos &obj) {
+  if (gm::kLittleEndian) {
+    std::memcpy(&obj, in, kPosBinSize);
+    in += kPosBinSize;
+    return;
+  }
+  obj.x = gm::load<int32_t>(in);
+  in += 4;
+  obj.y = gm::load<int32_t>(in);
+  in += 4;
+}
+
+bool Order::operator==(const Order &other) const {
+  if (type != other.type) return false;
+  switch (type) {
+  case Order::Go_t:
+    return std::memcmp(&data.Go, &other.data.Go, sizeof(Go_d)) == 0;
+  case Order::Drop_t:
+    return std::memcmp(&data.Drop, &other.data.Drop, sizeof(Drop_d)) == 0;
+  default:
+    return true;
+  }
+}
+
+void encode(uint8_t *&out, const Order &obj) {
+  gm::store<uint8_t>(out, obj.type);
+  out += 1;
+  uint8_t *end = out + 8;
+  switch (obj.type) {
+  case Order::Go_t:
+    encode(out, obj.data.Go.to);
+    break;
+  case Order::Drop_t:
+    gm::store<int32_t>(out, static_cast<int32_t>(obj.data.Drop.cell));
+    out += 4;
+    gm::store<int32_t>(out, obj.data.Drop.count);
+    out += 4;
+    break;
+  default:
+    break;
+  }
+  std::memset(out, 0, end - out);
+  out = end;
+}
+
+void decode(const uint8_t *&in, Order &obj) {
+  auto type = static_cast<Order::Type>(gm::load<uint8_t>(in));
+  in += 1;
+  const uint8_t *end = in + 8;
+  switch (type) {
+  case Order::Undef:
+  case Order::Idle_t:
+    break;
+  case Order::Go_t:
+    decode(in, obj.data.Go.to);
+    break;
+  case Order::Drop_t:
+    obj.data.Drop.cell = static_cast<Cell>(gm::loadEnum(in, 3));
+    in += 4;
+    obj.data.Drop.count = gm::load<int32_t>(in);
+    in += 4;
+    break;
+  default:
+    throw std::runtime_error("Invalid Order type");
+  }
+  obj.type = type;
+  in = end;
+}
+
+bool Bot::operator==(const Bot &other) const {
+  return pos == other.pos
+      && cell == other.cell
+      && alive == other.alive
+      && energy == other.energy
+      && order == other.order;
+}
+
+void encode(uint8_t *&out, const Bot &obj) {
+  encode(out, obj.pos);
+  gm::store<int32_t>(out, static_cast<int32_t>(obj.cell));
+  out += 4;
+  gm::store<bool>(out, obj.alive);
+  out += 1;
+  gm::store<double>(out, obj.energy);
+  out += 8;
+  encode(out, obj.order);
+}
+
+void decode(const uint8_t *&in, Bot &obj) {
+  decode(in, obj.pos);
+  obj.cell = static_cast<Cell>(gm::loadEnum(in, 3));
+  in += 4;
+  obj.alive = gm::loadBool(in);
+  in += 1;
+  obj.energy = gm::load<double>(in);
+  in += 8;
+  decode(in, obj.order);
+}
+
+constexpr uint64_t BotColumns::kFingerprint;
+constexpr size_t BotColumns::kFieldCount;
+const size_t BotColumns::kFieldSizes[5] = {8, 4, 1, 8, 9};
+
+void appendColumns(gm::ColumnWriter &writer, const Bot *records, size_t count) {
+  writer.beginChunk(count, BotColumns::kFieldSizes);
+  uint8_t *out;
+  out = writer.column(0);
+  for (size_t i = 0; i < count; i++) {
+    encode(out, records[i].pos);
+  }
+  out = writer.column(1);
+  for (size_t i = 0; i < count; i++) {
+    gm::store<int32_t>(out, static_cast<int32_t>(records[i].cell));
+    out += 4;
+  }
+  out = writer.column(2);
+  for (size_t i = 0; i < count; i++) {
+    gm::store<bool>(out, records[i].alive);
+    out += 1;
+  }
+  out = writer.column(3);
+  for (size_t i = 0; i < count; i++) {
+    gm::store<double>(out, records[i].energy);
+    out += 8;
+  }
+  out = writer.column(4);
+  for (size_t i = 0; i < count; i++) {
+    encode(out, records[i].order);
+  }
+  writer.endChunk();
+}
+
@@ -0,0 +1,187 @@
+#ifndef src_bin_gm__
+#define src_bin_gm__
+
+#include <stdexcept>
+#include <type_traits>
+#include "gamma/bin.hpp"
+#include "gamma/columns.hpp"
+
+enum class Cell {
+  EMPTY, WALL, BOX, 
+};
+
+constexpr size_t kCellBinSize = 4;
+constexpr uint64_t kCellFingerprint = 0x1684775cbf3b2d71ULL;
+void encode(uint8_t *&out, const Cell &obj);
+void decode(const uint8_t *&in, Cell &obj);
+
+struct Pos {
+  Pos() = default;
+  constexpr Pos(int x, int y) noexcept: x(x), y(y) {}
+  int x;
+  int y;
+  bool operator==(const Pos &other) const;
+};
+
+static_assert(std::is_trivially_copyable<Pos>::value, "Pos must be trivially copyable");
+static_assert(sizeof(Pos) == sizeof(int) + sizeof(int), "Pos must have no padding");
+
+constexpr size_t kPosBinSize = 8;
+constexpr uint64_t kPosFingerprint = 0xbca138ba78800abdULL;
+void encode(uint8_t *&out, const Pos &obj);
+void decode(const uint8_t *&in, Pos &obj);
+
+struct PosView {
+  explicit PosView(const uint8_t *data) noexcept: data(data) {}
+  int x() const noexcept { return gm::load<int32_t>(data); }
+  int y() const noexcept { return gm::load<int32_t>(data + 4); }
+  const uint8_t *data;
+};
+
+struct Order {
+  enum Type {
+    Undef,
+    Go_t,
+    Drop_t,
+    Idle_t,
+  } type;
+  struct Go_d {
+    Pos to;
+  };
+  struct Drop_d {
+    Cell cell;
+    int count;
+  };
+  struct Idle_d {
+  };
+  union Data {
+    constexpr Data() noexcept: Go() {}
+    constexpr Data(Go_d Go) noexcept: Go(Go) {}
+    constexpr Data(Drop_d Drop) noexcept: Drop(Drop) {}
+    constexpr Data(Idle_d Idle) noexcept: Idle(Idle) {}
+    Go_d Go;
+    Drop_d Drop;
+    Idle_d Idle;
+  } data;
+  constexpr Order(Type type = Undef) noexcept: type(type), data() {}
+  constexpr Order(Type type, Data data) noexcept: type(type), data(data) {}
+  static constexpr Order Go(Pos to) noexcept {
+    return Order(Go_t, Go_d{to});
+  }
+  static constexpr Order Drop(Cell cell, int count) noexcept {
+    return Order(Drop_t, Drop_d{cell, count});
+  }
+  static constexpr Order Idle() noexcept {
+    return Order(Idle_t, Idle_d{});
+  }
+  bool operator==(const Order &other) const;
+};
+
+template <typename Visitor>
+auto visit(const Order &obj, Visitor &&vis) -> decltype(vis(obj.data.Go)) {
+  switch (obj.type) {
+  case Order::Go_t:
+    return vis(obj.data.Go);
+  case Order::Drop_t:
+    return vis(obj.data.Drop);
+  case Order::Idle_t:
+    return vis(obj.data.Idle);
+  default:
+    throw std::invalid_argument("visit: undefined Order");
+  }
+}
+
+template <typename Visitor>
+auto visit(Order &obj, Visitor &&vis) -> decltype(vis(obj.data.Go)) {
+  switch (obj.type) {
+  case Order::Go_t:
+    return vis(obj.data.Go);
+  case Order::Drop_t:
+    return vis(obj.data.Drop);
+  case Order::Idle_t:
+    return vis(obj.data.Idle);
+  default:
+    throw std::invalid_argument("visit: undefined Order");
+  }
+}
+
+static_assert(std::is_trivially_copyable<Order>::value, "Order must be trivially copyable");
+static_assert(sizeof(Order::Go_d) == sizeof(Pos), "Order::Go_d must have no padding");
+static_assert(sizeof(Order::Drop_d) == sizeof(Cell) + sizeof(int), "Order::Drop_d must have no padding");
+
+constexpr size_t kOrderBinSize = 9;
+constexpr uint64_t kOrderFingerprint = 0xf557fc14efa8c05dULL;
+void encode(uint8_t *&out, const Order &obj);
+void decode(const uint8_t *&in, Order &obj);
+
+struct OrderView {
+  explicit OrderView(const uint8_t *data) noexcept: data(data) {}
+  Order::Type type() const {
+    if (gm::load<uint8_t>(data) > 3) {
+      throw std::runtime_error("Invalid Order type");
+    }
+    return static_cast<Order::Type>(gm::load<uint8_t>(data));
+  }
+  struct Go_v {
+    explicit Go_v(const uint8_t *data) noexcept: data(data) {}
+    PosView to() const noexcept { return PosView(data); }
+    const uint8_t *data;
+  };
+  Go_v Go() const noexcept { return Go_v(data + 1); }
+  struct Drop_v {
+    explicit Drop_v(const uint8_t *data) noexcept: data(data) {}
+    Cell cell() const { return static_cast<Cell>(gm::loadEnum(data, 3)); }
+    int count() const noexcept { return gm::load<int32_t>(data + 4); }
+    const uint8_t *data;
+  };
+  Drop_v Drop() const noexcept { return Drop_v(data + 1); }
+  const uint8_t *data;
+};
+
+struct Bot {
+  Bot() = default;
+  constexpr Bot(Pos pos, Cell cell, bool alive, double energy, Order order) noexcept: pos(pos), cell(cell), alive(alive), energy(energy), order(order) {}
+  Pos pos;
+  Cell cell;
+  bool alive;
+  double energy;
+  Order order;
+  bool operator==(const Bot &other) const;
+};
+
+static_assert(std::is_trivially_copyable<Bot>::value, "Bot must be trivially copyable");
+
+constexpr size_t kBotBinSize = 30;
+constexpr uint64_t kBotFingerprint = 0xc2cef06577caa544ULL;
+void encode(uint8_t *&out, const Bot &obj);
+void decode(const uint8_t *&in, Bot &obj);
+
+struct BotView {
+  explicit BotView(const uint8_t *data) noexcept: data(data) {}
+  PosView pos() const noexcept { return PosView(data); }
+  Cell cell() const { return static_cast<Cell>(gm::loadEnum(data + 8, 3)); }
+  bool alive() const { return gm::loadBool(data + 12); }
+  double energy() const noexcept { return gm::load<double>(data + 13); }
+  OrderView order() const noexcept { return OrderView(data + 21); }
+  const uint8_t *data;
+};
+
+struct BotColumns {
+  static constexpr uint64_t kFingerprint = 0xc2cef06577caa544ULL;
+  static constexpr size_t kFieldCount = 5;
+  explicit BotColumns(gm::ColumnChunk chunk) noexcept: size(chunk.size()), columns{chunk.column(0), chunk.column(1), chunk.column(2), chunk.column(3), chunk.column(4)} {}
+  PosView pos(size_t i) const noexcept { return PosView(columns[0] + 8 * i); }
+  Cell cell(size_t i) const { return static_cast<Cell>(gm::loadEnum(columns[1] + 4 * i, 3)); }
+  bool alive(size_t i) const { return gm::loadBool(columns[2] + i); }
+  double energy(size_t i) const noexcept { return gm::load<double>(columns[3] + 8 * i); }
+  OrderView order(size_t i) const noexcept { return OrderView(columns[4] + 9 * i); }
+  // Encoded size of each field, to check the columns of a mapped file
+  static const size_t kFieldSizes[5];
+  size_t size;
+  const uint8_t *columns[5];
+};
+
+void appendColumns(gm::ColumnWriter &writer, const Bot *records, size_t count);
+
+
+#endif
@@ -0,0 +1,632 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "gamma/containers.hpp"
+#include "gamma/optional.hpp"
+#include "gamma/random.hpp"
+#include "gamma/random_containers.hpp"
+
+#include "src/containers.gm.hpp"
+
+// Generated by gammac --emit-bench; usage: <program> [count]
+
+template <typename T>
+static inline void writeInput(std::ostream &os, const T &value) { os << value; }
+static inline void writeInput(std::ostream &os, int8_t value) { os << static_cast<int>(value); }
+static inline void writeInput(std::ostream &os, uint8_t value) { os << static_cast<int>(value); }
+template <typename T, size_t N>
+static inline void writeInput(std::ostream &os, const gm::Array<T, N> &value);
+template <typename T, size_t N>
+static inline void writeInput(std::ostream &os, const gm::SmallVec<T, N> &value);
+template <typename T>
+static inline void writeInput(std::ostream &os, const gm::Vec<T> &value);
+template <typename T, typename Niche>
+static inline void writeInput(std::ostream &os, const gm::Optional<T, Niche> &value);
+
+template <typename Container>
+static inline void writeInputItems(std::ostream &os, const Container &value) {
+  for (const auto &item : value) {
+    os << ' ';
+    writeInput(os, item);
+  }
+}
+
+template <typename T, size_t N>
+static inline void writeInput(std::ostream &os, const gm::Array<T, N> &value) {
+  writeInput(os, value[0]);
+  for (size_t i = 1; i < N; i++) {
+    os << ' ';
+    writeInput(os, value[i]);
+  }
+}
+
+template <typename T, size_t N>
+static inline void writeInput(std::ostream &os, const gm::SmallVec<T, N> &value) {
+  os << value.size();
+  writeInputItems(os, value);
+}
+
+template <typename T>
+static inline void writeInput(std::ostream &os, const gm::Vec<T> &value) {
+  os << value.size();
+  writeInputItems(os, value);
+}
+
+template <typename T, typename Niche>
+static inline void writeInput(std::ostream &os, const gm::Optional<T, Niche> &value) {
+  if (value.has_value()) {
+    writeInput(os, *value);
+  }
+  else {
+    os << '-';
+  }
+}
+
+typedef std::chrono::steady_clock BenchClock;
+
+static void report(const char *type, const char *trait, BenchClock::time_point start, size_t count, size_t bytes) {
+  double ns = std::chrono::duration<double, std::nano>(BenchClock::now() - start).count();
+  if (bytes > 0) {
+    std::printf("%-20s %-8s %10.1f ns/op %10.1f MB/s\n", type, trait, ns / count, bytes * 1e3 / ns);
+  }
+  else {
+    std::printf("%-20s %-8s %10.1f ns/op\n", type, trait, ns / count);
+  }
+}
+
+static inline void writeInput(std::ostream &os, const Ground &obj) {
+  static const char *const formats[] = {
+    "GRASS", "WATER", "ROCK", 
+  };
+  os << formats[static_cast<size_t>(obj)];
+}
+
+static void benchGround(size_t count) {
+  gm::Rng rng(11489088586242532446ULL);
+  std::vector<Ground> values(count);
+  for (auto &value : values) {
+    randomize(rng, value);
+  }
+  {
+    std::ostringstream os;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      os << value << '\n';
+    }
+    report("Ground", "Out", start, count, os.str().size());
+  }
+  {
+    std::ostringstream os;
+    for (const auto &value : values) {
+      writeInput(os, value);
+      os << '\n';
+    }
+    std::string text = os.str();
+    std::vector<Ground> parsed;
+    const char *cur = text.data();
+    auto start = BenchClock::now();
+    readMany(cur, text.data() + text.size(), count, parsed);
+    report("Ground", "In", start, count, text.size());
+  }
+  {
+    std::vector<uint8_t> buffer(count * kGroundBinSize);
+    uint8_t *out = buffer.data();
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      encode(out, value);
+    }
+    report("Ground", "Bin out", start, count, buffer.size());
+    std::vector<Ground> decoded(count);
+    const uint8_t *in = buffer.data();
+    start = BenchClock::now();
+    for (auto &value : decoded) {
+      decode(in, value);
+    }
+    report("Ground", "Bin in", start, count, buffer.size());
+  }
+  {
+    std::string text;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      writeJson(text, value);
+      text += '\n';
+    }
+    report("Ground", "Json out", start, count, text.size());
+    std::vector<Ground> parsed(count);
+    const char *cur = text.data();
+    start = BenchClock::now();
+    for (auto &value : parsed) {
+      readJson(cur, text.data() + text.size(), value);
+    }
+    report("Ground", "Json in", start, count, text.size());
+  }
+}
+
+static inline void writeInput(std::ostream &os, const Step &obj) {
+  writeInput(os, obj.x);
+  os << ' ';
+  writeInput(os, obj.y);
+}
+
+static void benchStep(size_t count) {
+  gm::Rng rng(15679650598520783055ULL);
+  std::vector<Step> values(count);
+  for (auto &value : values) {
+    randomize(rng, value);
+  }
+  {
+    std::ostringstream os;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      os << value << '\n';
+    }
+    report("Step", "Out", start, count, os.str().size());
+  }
+  {
+    std::ostringstream os;
+    for (const auto &value : values) {
+      writeInput(os, value);
+      os << '\n';
+    }
+    std::string text = os.str();
+    std::vector<Step> parsed;
+    const char *cur = text.data();
+    auto start = BenchClock::now();
+    readMany(cur, text.data() + text.size(), count, parsed);
+    report("Step", "In", start, count, text.size());
+  }
+  {
+    std::vector<Step> copies(values);
+    size_t equal = 0;
+    auto start = BenchClock::now();
+    for (size_t i = 0; i < count; i++) {
+      equal += values[i] == copies[i];
+    }
+    report("Step", "Eq", start, count, 0);
+    if (equal != count) {
+      std::printf("%s: copies differ\n", "Step");
+    }
+  }
+  {
+    std::vector<uint8_t> buffer(count * kStepBinSize);
+    uint8_t *out = buffer.data();
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      encode(out, value);
+    }
+    report("Step", "Bin out", start, count, buffer.size());
+    std::vector<Step> decoded(count);
+    const uint8_t *in = buffer.data();
+    start = BenchClock::now();
+    for (auto &value : decoded) {
+      decode(in, value);
+    }
+    report("Step", "Bin in", start, count, buffer.size());
+  }
+  {
+    std::string text;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      writeJson(text, value);
+      text += '\n';
+    }
+    report("Step", "Json out", start, count, text.size());
+    std::vector<Step> parsed(count);
+    const char *cur = text.data();
+    start = BenchClock::now();
+    for (auto &value : parsed) {
+      readJson(cur, text.data() + text.size(), value);
+    }
+    report("Step", "Json in", start, count, text.size());
+  }
+}
+
+static inline void writeInput(std::ostream &os, const Board &obj) {
+  writeInput(os, obj.tiles);
+  os << ' ';
+  writeInput(os, obj.path);
+  os << ' ';
+  writeInput(os, obj.heights);
+  os << ' ';
+  writeInput(os, obj.marks);
+}
+
+static void benchBoard(size_t count) {
+  gm::Rng rng(10358599209595726571ULL);
+  std::vector<Board> values(count);
+  for (auto &value : values) {
+    randomize(rng, value);
+  }
+  {
+    std::ostringstream os;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      os << value << '\n';
+    }
+    report("Board", "Out", start, count, os.str().size());
+  }
+  {
+    std::ostringstream os;
+    for (const auto &value : values) {
+      writeInput(os, value);
+      os << '\n';
+    }
+    std::string text = os.str();
+    std::vector<Board> parsed;
+    const char *cur = text.data();
+    auto start = BenchClock::now();
+    readMany(cur, text.data() + text.size(), count, parsed);
+    report("Board", "In", start, count, text.size());
+  }
+  {
+    std::vector<Board> copies(values);
+    size_t equal = 0;
+    auto start = BenchClock::now();
+    for (size_t i = 0; i < count; i++) {
+      equal += values[i] == copies[i];
+    }
+    report("Board", "Eq", start, count, 0);
+    if (equal != count) {
+      std::printf("%s: copies differ\n", "Board");
+    }
+  }
+  {
+    std::vector<uint8_t> buffer(count * kBoardBinSize);
+    uint8_t *out = buffer.data();
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      encode(out, value);
+    }
+    report("Board", "Bin out", start, count, buffer.size());
+    std::vector<Board> decoded(count);
+    const uint8_t *in = buffer.data();
+    start = BenchClock::now();
+    for (auto &value : decoded) {
+      decode(in, value);
+    }
+    report("Board", "Bin in", start, count, buffer.size());
+  }
+  {
+    std::string text;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      writeJson(text, value);
+      text += '\n';
+    }
+    report("Board", "Json out", start, count, text.size());
+    std::vector<Board> parsed(count);
+    const char *cur = text.data();
+    start = BenchClock::now();
+    for (auto &value : parsed) {
+      readJson(cur, text.data() + text.size(), value);
+    }
+    report("Board", "Json in", start, count, text.size());
+  }
+}
+
+static inline void writeInput(std::ostream &os, const History &obj) {
+  writeInput(os, obj.moves);
+  os << ' ';
+  writeInput(os, obj.names);
+  os << ' ';
+  writeInput(os, obj.turns);
+}
+
+static void benchHistory(size_t count) {
+  gm::Rng rng(6397174161370020703ULL);
+  std::vector<History> values(count);
+  for (auto &value : values) {
+    randomize(rng, value);
+  }
+  {
+    std::ostringstream os;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      os << value << '\n';
+    }
+    report("History", "Out", start, count, os.str().size());
+  }
+  {
+    std::ostringstream os;
+    for (const auto &value : values) {
+      writeInput(os, value);
+      os << '\n';
+    }
+    std::string text = os.str();
+    std::vector<History> parsed;
+    const char *cur = text.data();
+    auto start = BenchClock::now();
+    readMany(cur, text.data() + text.size(), count, parsed);
+    report("History", "In", start, count, text.size());
+  }
+  {
+    std::vector<History> copies(values);
+    size_t equal = 0;
+    auto start = BenchClock::now();
+    for (size_t i = 0; i < count; i++) {
+      equal += values[i] == copies[i];
+    }
+    report("History", "Eq", start, count, 0);
+    if (equal != count) {
+      std::printf("%s: copies differ\n", "History");
+    }
+  }
+  {
+    std::string text;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      writeJson(text, value);
+      text += '\n';
+    }
+    report("History", "Json out", start, count, text.size());
+    std::vector<History> parsed(count);
+    const char *cur = text.data();
+    start = BenchClock::now();
+    for (auto &value : parsed) {
+      readJson(cur, text.data() + text.size(), value);
+    }
+    report("History", "Json in", start, count, text.size());
+  }
+}
+
+static inline void writeInput(std::ostream &os, const Plan &obj) {
+  switch (obj.type) {
+  case Plan::Build_t:
+    os << "Build";
+    os << ' ';
+    writeInput(os, obj.data.Build.cells);
+    break;
+  case Plan::Wait_t:
+    os << "Wait";
+    break;
+  default:
+    break;
+  }
+}
+
+static void benchPlan(size_t count) {
+  gm::Rng rng(14776395150219341714ULL);
+  std::vector<Plan> values(count);
+  for (auto &value : values) {
+    randomize(rng, value);
+  }
+  {
+    std::ostringstream os;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      os << value << '\n';
+    }
+    report("Plan", "Out", start, count, os.str().size());
+  }
+  {
+    std::ostringstream os;
+    for (const auto &value : values) {
+      writeInput(os, value);
+      os << '\n';
+    }
+    std::string text = os.str();
+    std::vector<Plan> parsed;
+    const char *cur = text.data();
+    auto start = BenchClock::now();
+    readMany(cur, text.data() + text.size(), count, parsed);
+    report("Plan", "In", start, count, text.size());
+  }
+  {
+    std::vector<Plan> copies(values);
+    size_t equal = 0;
+    auto start = BenchClock::now();
+    for (size_t i = 0; i < count; i++) {
+      equal += values[i] == copies[i];
+    }
+    report("Plan", "Eq", start, count, 0);
+    if (equal != count) {
+      std::printf("%s: copies differ\n", "Plan");
+    }
+  }
+  {
+    std::vector<uint8_t> buffer(count * kPlanBinSize);
+    uint8_t *out = buffer.data();
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      encode(out, value);
+    }
+    report("Plan", "Bin out", start, count, buffer.size());
+    std::vector<Plan> decoded(count);
+    const uint8_t *in = buffer.data();
+    start = BenchClock::now();
+    for (auto &value : decoded) {
+      decode(in, value);
+    }
+    report("Plan", "Bin in", start, count, buffer.size());
+  }
+  {
+    std::string text;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      writeJson(text, value);
+      text += '\n';
+    }
+    report("Plan", "Json out", start, count, text.size());
+    std::vector<Plan> parsed(count);
+    const char *cur = text.data();
+    start = BenchClock::now();
+    for (auto &value : parsed) {
+      readJson(cur, text.data() + text.size(), value);
+    }
+    report("Plan", "Json in", start, count, text.size());
+  }
+}
+
+static inline void writeInput(std::ostream &os, const Hero &obj) {
+  writeInput(os, obj.name);
+  os << ' ';
+  writeInput(os, obj.hp);
+}
+
+static void benchHero(size_t count) {
+  gm::Rng rng(3808915916139446745ULL);
+  std::vector<Hero> values(count);
+  for (auto &value : values) {
+    randomize(rng, value);
+  }
+  {
+    std::ostringstream os;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      os << value << '\n';
+    }
+    report("Hero", "Out", start, count, os.str().size());
+  }
+  {
+    std::ostringstream os;
+    for (const auto &value : values) {
+      writeInput(os, value);
+      os << '\n';
+    }
+    std::string text = os.str();
+    std::vector<Hero> parsed;
+    const char *cur = text.data();
+    auto start = BenchClock::now();
+    readMany(cur, text.data() + text.size(), count, parsed);
+    report("Hero", "In", start, count, text.size());
+  }
+  {
+    std::vector<Hero> copies(values);
+    size_t equal = 0;
+    auto start = BenchClock::now();
+    for (size_t i = 0; i < count; i++) {
+      equal += values[i] == copies[i];
+    }
+    report("Hero", "Eq", start, count, 0);
+    if (equal != count) {
+      std::printf("%s: copies differ\n", "Hero");
+    }
+  }
+  {
+    std::vector<uint8_t> buffer(count * kHeroBinSize);
+    uint8_t *out = buffer.data();
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      encode(out, value);
+    }
+    report("Hero", "Bin out", start, count, buffer.size());
+    std::vector<Hero> decoded(count);
+    const uint8_t *in = buffer.data();
+    start = BenchClock::now();
+    for (auto &value : decoded) {
+      decode(in, value);
+    }
+    report("Hero", "Bin in", start, count, buffer.size());
+  }
+  {
+    std::string text;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      writeJson(text, value);
+      text += '\n';
+    }
+    report("Hero", "Json out", start, count, text.size());
+    std::vector<Hero> parsed(count);
+    const char *cur = text.data();
+    start = BenchClock::now();
+    for (auto &value : parsed) {
+      readJson(cur, text.data() + text.size(), value);
+    }
+    report("Hero", "Json in", start, count, text.size());
+  }
+}
+
+static inline void writeInput(std::ostream &os, const Squad &obj) {
+  writeInput(os, obj.heroes);
+  os << ' ';
+  writeInput(os, obj.tags);
+}
+
+static void benchSquad(size_t count) {
+  gm::Rng rng(17007741701144775313ULL);
+  std::vector<Squad> values(count);
+  for (auto &value : values) {
+    randomize(rng, value);
+  }
+  {
+    std::ostringstream os;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      os << value << '\n';
+    }
+    report("Squad", "Out", start, count, os.str().size());
+  }
+  {
+    std::ostringstream os;
+    for (const auto &value : values) {
+      writeInput(os, value);
+      os << '\n';
+    }
+    std::string text = os.str();
+    std::vector<Squad> parsed;
+    const char *cur = text.data();
+    auto start = BenchClock::now();
+    readMany(cur, text.data() + text.size(), count, parsed);
+    report("Squad", "In", start, count, text.size());
+  }
+  {
+    std::vector<Squad> copies(values);
+    size_t equal = 0;
+    auto start = BenchClock::now();
+    for (size_t i = 0; i < count; i++) {
+      equal += values[i] == copies[i];
+    }
+    report("Squad", "Eq", start, count, 0);
+    if (equal != count) {
+      std::printf("%s: copies differ\n", "Squad");
+    }
+  }
+  {
+    std::vector<uint8_t> buffer(count * kSquadBinSize);
+    uint8_t *out = buffer.data();
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      encode(out, value);
+    }
+    report("Squad", "Bin out", start, count, buffer.size());
+    std::vector<Squad> decoded(count);
+    const uint8_t *in = buffer.data();
+    start = BenchClock::now();
+    for (auto &value : decoded) {
+      decode(in, value);
+    }
+    report("Squad", "Bin in", start, count, buffer.size());
+  }
+  {
+    std::string text;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      writeJson(text, value);
+      text += '\n';
+    }
+    report("Squad", "Json out", start, count, text.size());
+    std::vector<Squad> parsed(count);
+    const char *cur = text.data();
+    start = BenchClock::now();
+    for (auto &value : parsed) {
+      readJson(cur, text.data() + text.size(), value);
+    }
+    report("Squad", "Json in", start, count, text.size());
+  }
+}
+
+int main(int argc, char *argv[]) {
+  size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+  benchGround(count);
+  benchStep(count);
+  benchBoard(count);
+  benchHistory(count);
+  benchPlan(count);
+  benchHero(count);
+  benchSquad(count);
+  return 0;
+}
@@ -0,0 +1,1168 @@
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include "gamma/profile.hpp"
+
+#include "src/containers.gm.hpp"
+
+#ifdef GAMMA_PROFILE
+static const char *const kGroundVariants[] = {
+  "GRASS", "WATER", "ROCK", 
+};
+static uint64_t *const kGroundHits = gm::Profile::instance().add("Ground", kGroundVariants, 3);
+#endif
+
+static const std::map<std::string, Ground> kStrToGround {
+  {"GRASS", Ground::GRASS},
+  {"WATER", Ground::WATER},
+  {"ROCK", Ground::ROCK},
+};
+
+std::istream &operator>>(std::istream &is, Ground &obj) {
+  std::string str;
+  is >> str;
+  obj = kStrToGround.at(str);
+  GM_PROFILE_HIT(kGroundHits, static_cast<size_t>(obj));
+  return is;
+}
+
+void readText(const char *&cur, const char *end, Ground &obj) {
+  const char *key;
+  size_t length;
+  gm::text::readToken(cur, end, key, length);
+  switch (length) {
+  case 4:
+    if (std::memcmp(key, "ROCK", 4) == 0) {
+      obj = Ground::ROCK;
+      GM_PROFILE_HIT(kGroundHits, static_cast<size_t>(Ground::ROCK));
+      return;
+    }
+    break;
+  case 5:
+    if (std::memcmp(key, "GRASS", 5) == 0) {
+      obj = Ground::GRASS;
+      GM_PROFILE_HIT(kGroundHits, static_cast<size_t>(Ground::GRASS));
+      return;
+    }
+    if (std::memcmp(key, "WATER", 5) == 0) {
+      obj = Ground::WATER;
+      GM_PROFILE_HIT(kGroundHits, static_cast<size_t>(Ground::WATER));
+      return;
+    }
+    break;
+  }
+  gm::text::error("invalid Ground");
+}
+
+void readMany(const char *&cur, const char *end, size_t n, Ground *out) {
+  const char *p = cur;
+  for (size_t i = 0; i < n; i++) {
+    readText(p, end, out[i]);
+  }
+  cur = p;
+}
+
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Ground> &out) {
+  const char *p = cur;
+  size_t size = out.size();
+  out.reserve(size + n);
+  try {
+    for (size_t i = 0; i < n; i++) {
+      Ground item;
+      readText(p, end, item);
+      out.push_back(std::move(item));
+    }
+  }
+  catch (...) {
+    out.erase(out.begin() + size, out.end());
+    throw;
+  }
+  cur = p;
+}
+
+static const std::string kGroundToStr[] = {
+  "GRASS", "WATER", "ROCK", 
+};
+
+std::ostream &operator<<(std::ostream &os, const Ground &obj) {
+  os << kGroundToStr[static_cast<size_t>(obj)];
+  return os;
+}
+
+void writeText(gm::OutputBuffer &os, const Ground &obj) {
+  os << kGroundToStr[static_cast<size_t>(obj)];
+}
+
+void encode(uint8_t *&out, const Ground &obj) {
+  gm::store<int32_t>(out, static_cast<int32_t>(obj));
+  out += 4;
+}
+
+void decode(const uint8_t *&in, Ground &obj) {
+  obj = static_cast<Ground>(gm::loadEnum(in, 3));
+  in += 4;
+}
+
+static const char *const kGroundToJson[] = {
+  "\"GRASS\"", "\"WATER\"", "\"ROCK\"", 
+};
+
+void writeJson(std::string &out, const Ground &obj) {
+  out += kGroundToJson[static_cast<size_t>(obj)];
+}
+
+void readJson(const char *&cur, const char *end, Ground &obj) {
+  const char *key;
+  size_t length;
+  gm::json::readRawString(cur, end, key, length);
+  switch (length) {
+  case 4:
+    if (std::memcmp(key, "ROCK", 4) == 0) {
+      obj = Ground::ROCK;
+      return;
+    }
+    break;
+  case 5:
+    if (std::memcmp(key, "GRASS", 5) == 0) {
+      obj = Ground::GRASS;
+      return;
+    }
+    if (std::memcmp(key, "WATER", 5) == 0) {
+      obj = Ground::WATER;
+      return;
+    }
+    break;
+  }
+  gm::json::error("invalid Ground");
+}
+
+void randomize(gm::Rng &rng, Ground &obj) {
+  obj = static_cast<Ground>(rng.below(3));
+}
+
+bool Step::operator==(const Step &other) const {
+  return std::memcmp(this, &other, sizeof(Step)) == 0;
+}
+
+std::istream &operator>>(std::istream &is, Step &obj) {
+  is >> obj.x;
+  is >> obj.y;
+  return is;
+}
+
+void readText(const char *&cur, const char *end, Step &obj) {
+  gm::readText(cur, end, obj.x);
+  gm::readText(cur, end, obj.y);
+}
+
+void readMany(const char *&cur, const char *end, size_t n, Step *out) {
+  const char *p = cur;
+  for (size_t i = 0; i < n; i++) {
+    readText(p, end, out[i]);
+  }
+  cur = p;
+}
+
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Step> &out) {
+  const char *p = cur;
+  size_t size = out.size();
+  out.reserve(size + n);
+  try {
+    for (size_t i = 0; i < n; i++) {
+      Step item;
+      readText(p, end, item);
+      out.push_back(std::move(item));
+    }
+  }
+  catch (...) {
+    out.erase(out.begin() + size, out.end());
+    throw;
+  }
+  cur = p;
+}
+
+std::ostream &operator<<(std::ostream &os, const Step &obj) {
+  os << "{ ";
+  os << "x" << ": " << obj.x << ", ";
+  os << "y" << ": " << obj.y;
+  os << " }";
+  return os;
+}
+
+void writeText(gm::OutputBuffer &os, const Step &obj) {
+  os << "{ ";
+  os << "x" << ": " << obj.x << ", ";
+  os << "y" << ": " << obj.y;
+  os << " }";
+}
+
+void encode(uint8_t *&out, const Step &obj) {
+  if (gm::kLittleEndian) {
+    std::memcpy(out, &obj, kStepBinSize);
+    out += kStepBinSize;
+    return;
+  }
+  gm::store<int32_t>(out, obj.x);
+  out += 4;
+  gm::store<int32_t>(out, obj.y);
+  out += 4;
+}
+
+void decode(const uint8_t *&in, Step &obj) {
+  if (gm::kLittleEndian) {
+    std::memcpy(&obj, in, kStepBinSize);
+    in += kStepBinSize;
+    return;
+  }
+  obj.x = gm::load<int32_t>(in);
+  in += 4;
+  obj.y = gm::load<int32_t>(in);
+  in += 4;
+}
+
+void writeJson(std::string &out, const Step &obj) {
+  out += "{\"x\":";
+  gm::writeJson(out, obj.x);
+  out += ",\"y\":";
+  gm::writeJson(out, obj.y);
+  out += '}';
+}
+
+void readJson(const char *&cur, const char *end, Step &obj) {
+  gm::json::expect(cur, end, '{');
+  if (gm::json::consume(cur, end, '}')) {
+    return;
+  }
+  const char *key;
+  size_t length;
+  do {
+    gm::json::readKey(cur, end, key, length);
+    switch (length) {
+    case 1:
+      if (std::memcmp(key, "x", 1) == 0) {
+        gm::readJson(cur, end, obj.x);
+        continue;
+      }
+      if (std::memcmp(key, "y", 1) == 0) {
+        gm::readJson(cur, end, obj.y);
+        continue;
+      }
+      break;
+    }
+    gm::json::skipValue(cur, end);
+  } while (gm::json::next(cur, end, '}'));
+}
+
+void randomize(gm::Rng &rng, Step &obj) {
+  randomize(rng, obj.x);
+  randomize(rng, obj.y);
+}
+
+bool Board::operator==(const Board &other) const {
+  return tiles == other.tiles
+      && path == other.path
+      && heights == other.heights
+      && marks == other.marks;
+}
+
+std::istream &operator>>(std::istream &is, Board &obj) {
+  is >> obj.tiles;
+  is >> obj.path;
+  is >> obj.heights;
+  is >> obj.marks;
+  return is;
+}
+
+void readText(const char *&cur, const char *end, Board &obj) {
+  gm::readText(cur, end, obj.tiles);
+  gm::readText(cur, end, obj.path);
+  gm::readText(cur, end, obj.heights);
+  gm::readText(cur, end, obj.marks);
+}
+
+void readMany(const char *&cur, const char *end, size_t n, Board *out) {
+  const char *p = cur;
+  for (size_t i = 0; i < n; i++) {
+    readText(p, end, out[i]);
+  }
+  cur = p;
+}
+
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Board> &out) {
+  const char *p = cur;
+  size_t size = out.size();
+  out.reserve(size + n);
+  try {
+    for (size_t i = 0; i < n; i++) {
+      Board item;
+      readText(p, end, item);
+      out.push_back(std::move(item));
+    }
+  }
+  catch (...) {
+    out.erase(out.begin() + size, out.end());
+    throw;
+  }
+  cur = p;
+}
+
+std::ostream &operator<<(std::ostream &os, const Board &obj) {
+  os << "{ ";
+  os << "tiles" << ": " << obj.tiles << ", ";
+  os << "path" << ": " << obj.path << ", ";
+  os << "heights" << ": " << obj.heights << ", ";
+  os << "marks" << ": " << obj.marks;
+  os << " }";
+  return os;
+}
+
+void writeText(gm::OutputBuffer &os, const Board &obj) {
+  os << "{ ";
+  os << "tiles" << ": " << obj.tiles << ", ";
+  os << "path" << ": " << obj.path << ", ";
+  os << "heights" << ": " << obj.heights << ", ";
+  os << "marks" << ": " << obj.marks;
+  os << " }";
+}
+
+void encode(uint8_t *&out, const Board &obj) {
+  for (const auto &item : obj.tiles) {
+    gm::store<int32_t>(out, static_cast<int32_t>(item));
+    out += 4;
+  }
+  gm::store<uint8_t>(out, static_cast<uint8_t>(obj.path.size()));
+  out += 1;
+  for (const auto &item : obj.path) {
+    encode(out, item);
+  }
+  std::memset(out, 0, (3 - obj.path.size()) * 8);
+  out += (3 - obj.path.size()) * 8;
+  for (const auto &item : obj.heights) {
+    for (const auto &item1 : item) {
+      gm::store<int8_t>(out, item1);
+      out += 1;
+    }
+  }
+  gm::store<uint8_t>(out, static_cast<uint8_t>(obj.marks.size()));
+  out += 1;
+  for (const auto &item : obj.marks) {
+    gm::store<uint8_t>(out, item);
+    out += 1;
+  }
+  std::memset(out, 0, (5 - obj.marks.size()) * 1);
+  out += (5 - obj.marks.size()) * 1;
+}
+
+void decode(const uint8_t *&in, Board &obj) {
+  for (auto &item : obj.tiles) {
+    item = static_cast<Ground>(gm::loadEnum(in, 3));
+    in += 4;
+  }
+  obj.path.resize(gm::load<uint8_t>(in));
+  in += 1;
+  for (auto &item : obj.path) {
+    decode(in, item);
+  }
+  in += (3 - obj.path.size()) * 8;
+  for (auto &item : obj.heights) {
+    for (auto &item1 : item) {
+      item1 = gm::load<int8_t>(in);
+      in += 1;
+    }
+  }
+  obj.marks.resize(gm::load<uint8_t>(in));
+  in += 1;
+  for (auto &item : obj.marks) {
+    item = gm::load<uint8_t>(in);
+    in += 1;
+  }
+  in += (5 - obj.marks.size()) * 1;
+}
+
+void writeJson(std::string &out, const Board &obj) {
+  out += "{\"tiles\":";
+  gm::writeJson(out, obj.tiles);
+  out += ",\"path\":";
+  gm::writeJson(out, obj.path);
+  out += ",\"heights\":";
+  gm::writeJson(out, obj.heights);
+  out += ",\"marks\":";
+  gm::writeJson(out, obj.marks);
+  out += '}';
+}
+
+void readJson(const char *&cur, const char *end, Board &obj) {
+  gm::json::expect(cur, end, '{');
+  if (gm::json::consume(cur, end, '}')) {
+    return;
+  }
+  const char *key;
+  size_t length;
+  do {
+    gm::json::readKey(cur, end, key, length);
+    switch (length) {
+    case 4:
+      if (std::memcmp(key, "path", 4) == 0) {
+        gm::readJson(cur, end, obj.path);
+        continue;
+      }
+      break;
+    case 5:
+      if (std::memcmp(key, "tiles", 5) == 0) {
+        gm::readJson(cur, end, obj.tiles);
+        continue;
+      }
+      if (std::memcmp(key, "marks", 5) == 0) {
+        gm::readJson(cur, end, obj.marks);
+        continue;
+      }
+      break;
+    case 7:
+      if (std::memcmp(key, "heights", 7) == 0) {
+        gm::readJson(cur, end, obj.heights);
+        continue;
+      }
+      break;
+    }
+    gm::json::skipValue(cur, end);
+  } while (gm::json::next(cur, end, '}'));
+}
+
+void randomize(gm::Rng &rng, Board &obj) {
+  randomize(rng, obj.tiles);
+  randomize(rng, obj.path);
+  randomize(rng, obj.heights);
+  randomize(rng, obj.marks);
+}
+
+Board::Patch diff(const Board &a, const Board &b) {
+  Board::Patch patch;
+  if (!(a.tiles == b.tiles)) {
+    patch.changed |= uint64_t(1) << Board::tiles_f;
+    patch.tiles = b.tiles;
+  }
+  if (!(a.path == b.path)) {
+    patch.changed |= uint64_t(1) << Board::path_f;
+    patch.path = b.path;
+  }
+  if (!(a.heights == b.heights)) {
+    patch.changed |= uint64_t(1) << Board::heights_f;
+    patch.heights = b.heights;
+  }
+  if (!(a.marks == b.marks)) {
+    patch.changed |= uint64_t(1) << Board::marks_f;
+    patch.marks = b.marks;
+  }
+  return patch;
+}
+
+void apply(Board &state, const Board::Patch &patch) {
+  if (patch.has(Board::tiles_f)) {
+    state.tiles = patch.tiles;
+  }
+  if (patch.has(Board::path_f)) {
+    state.path = patch.path;
+  }
+  if (patch.has(Board::heights_f)) {
+    state.heights = patch.heights;
+  }
+  if (patch.has(Board::marks_f)) {
+    state.marks = patch.marks;
+  }
+}
+
+void encode(uint8_t *&out, const Board::Patch &patch) {
+  gm::store<uint8_t>(out, static_cast<uint8_t>(patch.changed));
+  out += 1;
+  if (patch.has(Board::tiles_f)) {
+    for (const auto &item : patch.tiles) {
+      gm::store<int32_t>(out, static_cast<int32_t>(item));
+      out += 4;
+    }
+  }
+  if (patch.has(Board::path_f)) {
+    gm::store<uint8_t>(out, static_cast<uint8_t>(patch.path.size()));
+    out += 1;
+    for (const auto &item : patch.path) {
+      encode(out, item);
+    }
+    std::memset(out, 0, (3 - patch.path.size()) * 8);
+    out += (3 - patch.path.size()) * 8;
+  }
+  if (patch.has(Board::heights_f)) {
+    for (const auto &item : patch.heights) {
+      for (const auto &item1 : item) {
+        gm::store<int8_t>(out, item1);
+        out += 1;
+      }
+    }
+  }
+  if (patch.has(Board::marks_f)) {
+    gm::store<uint8_t>(out, static_cast<uint8_t>(patch.marks.size()));
+    out += 1;
+    for (const auto &item : patch.marks) {
+      gm::store<uint8_t>(out, item);
+      out += 1;
+    }
+    std::memset(out, 0, (5 - patch.marks.size()) * 1);
+    out += (5 - patch.marks.size()) * 1;
+  }
+}
+
+void decode(const uint8_t *&in, Board::Patch &patch) {
+  patch.changed = gm::load<uint8_t>(in);
+  if (patch.changed & 0xfffffffffffffff0ULL) {
+    throw std::runtime_error("Invalid Board patch");
+  }
+  in += 1;
+  if (patch.has(Board::tiles_f)) {
+    for (auto &item : patch.tiles) {
+      item = static_cast<Ground>(gm::loadEnum(in, 3));
+      in += 4;
+    }
+  }
+  if (patch.has(Board::path_f)) {
+    patch.path.resize(gm::load<uint8_t>(in));
+    in += 1;
+    for (auto &item : patch.path) {
+      decode(in, item);
+    }
+    in += (3 - patch.path.size()) * 8;
+  }
+  if (patch.has(Board::heights_f)) {
+    for (auto &item : patch.heights) {
+      for (auto &item1 : item) {
+        item1 = gm::load<int8_t>(in);
+        in += 1;
+      }
+    }
+  }
+  if (patch.has(Board::marks_f)) {
+    patch.marks.resize(gm::load<uint8_t>(in));
+    in += 1;
+    for (auto &item : patch.marks) {
+      item = gm::load<uint8_t>(in);
+      in += 1;
+    }
+    in += (5 - patch.marks.size()) * 1;
+  }
+}
+
+bool History::operator==(const History &other) const {
+  return moves == other.moves
+      && names == other.names
+      && turns == other.turns;
+}
+
+std::istream &operator>>(std::istream &is, History &obj) {
+  is >> obj.moves;
+  is >> obj.names;
+  is >> obj.turns;
+  obj.dirty = History::kAllFields;
+  return is;
+}
+
+void readText(const char *&cur, const char *end, History &obj) {
+  gm::readText(cur, end, obj.moves);
+  gm::readText(cur, end, obj.names);
+  gm::readText(cur, end, obj.turns);
+  obj.dirty = History::kAllFields;
+}
+
+void readMany(const char *&cur, const char *end, size_t n, History *out) {
+  const char *p = cur;
+  for (size_t i = 0; i < n; i++) {
+    readText(p, end, out[i]);
+  }
+  cur = p;
+}
+
+void readMany(const char *&cur, const char *end, size_t n, std::vector<History> &out) {
+  const char *p = cur;
+  size_t size = out.size();
+  out.reserve(size + n);
+  try {
+    for (size_t i = 0; i < n; i++) {
+      History item;
+      readText(p, end, item);
+      out.push_back(std::move(item));
+    }
+  }
+  catch (...) {
+    out.erase(out.begin() + size, out.end());
+    throw;
+  }
+  cur = p;
+}
+
+std::ostream &operator<<(std::ostream &os, const History &obj) {
+  os << "{ ";
+  os << "moves" << ": " << obj.moves << ", ";
+  os << "names" << ": " << obj.names << ", ";
+  os << "turns" << ": " << obj.turns;
+  os << " }";
+  return os;
+}
+
+void writeJson(std::string &out, const History &obj) {
+  out += "{\"moves\":";
+  gm::writeJson(out, obj.moves);
+  out += ",\"names\":";
+  gm::writeJson(out, obj.names);
+  out += ",\"turns\":";
+  gm::writeJson(out, obj.turns);
+  out += '}';
+}
+
+void readJson(const char *&cur, const char *end, History &obj) {
+  gm::json::expect(cur, end, '{');
+  if (gm::json::consume(cur, end, '}')) {
+    return;
+  }
+  const char *key;
+  size_t length;
+  do {
+    gm::json::readKey(cur, end, key, length);
+    switch (length) {
+    case 5:
+      if (std::memcmp(key, "moves", 5) == 0) {
+        gm::readJson(cur, end, obj.moves);
+        continue;
+      }
+      if (std::memcmp(key, "names", 5) == 0) {
+        gm::readJson(cur, end, obj.names);
+        continue;
+      }
+      if (std::memcmp(key, "turns", 5) == 0) {
+        gm::readJson(cur, end, obj.turns);
+        continue;
+      }
+      break;
+    }
+    gm::json::skipValue(cur, end);
+  } while (gm::json::next(cur, end, '}'));
+  obj.dirty = History::kAllFields;
+}
+
+void randomize(gm::Rng &rng, History &obj) {
+  randomize(rng, obj.moves);
+  randomize(rng, obj.names);
+  randomize(rng, obj.turns);
+  obj.dirty = History::kAllFields;
+}
+
+constexpr uint64_t History::kAllFields;
+
+History::Patch diff(const History &a, const History &b) {
+  History::Patch patch;
+  if (!(a.moves == b.moves)) {
+    patch.changed |= uint64_t(1) << History::moves_f;
+    patch.moves = b.moves;
+  }
+  if (!(a.names == b.names)) {
+    patch.changed |= uint64_t(1) << History::names_f;
+    patch.names = b.names;
+  }
+  if (!(a.turns == b.turns)) {
+    patch.changed |= uint64_t(1) << History::turns_f;
+    patch.turns = b.turns;
+  }
+  return patch;
+}
+
+void apply(History &state, const History::Patch &patch) {
+  if (patch.has(History::moves_f)) {
+    state.moves = patch.moves;
+  }
+  if (patch.has(History::names_f)) {
+    state.names = patch.names;
+  }
+  if (patch.has(History::turns_f)) {
+    state.turns = patch.turns;
+  }
+  state.dirty |= patch.changed;
+}
+
+bool Plan::operator==(const Plan &other) const {
+  if (type != other.type) return false;
+  switch (type) {
+  case Plan::Build_t:
+    return data.Build.cells == other.data.Build.cells;
+  break;
+  default:
+    return true;
+  }
+}
+
+#ifdef GAMMA_PROFILE
+static const char *const kPlanVariants[] = {
+  "Build", "Wait", 
+};
+static uint64_t *const kPlanHits = gm::Profile::instance().add("Plan", kPlanVariants, 2);
+#endif
+
+std::istream &operator>>(std::istream &is, Plan &obj) {
+  std::string str;
+  if (!(is >> str)) {
+    return is;
+  }
+  if (str == "Build") {
+    obj.type = Plan::Build_t;
+    GM_PROFILE_HIT(kPlanHits, Plan::Build_t - 1);
+    is >> obj.data.Build.cells;
+  }
+  else if (str == "Wait") {
+    obj.type = Plan::Wait_t;
+    GM_PROFILE_HIT(kPlanHits, Plan::Wait_t - 1);
+  }
+  else {
+    throw std::runtime_error("Invalid Plan");
+  }
+  return is;
+}
+
+void readText(const char *&cur, const char *end, Plan &obj) {
+  const char *key;
+  size_t length;
+  gm::text::readToken(cur, end, key, length);
+  switch (length) {
+  case 4:
+    if (std::memcmp(key, "Wait", 4) == 0) {
+      obj.type = Plan::Wait_t;
+      GM_PROFILE_HIT(kPlanHits, Plan::Wait_t - 1);
+      return;
+    }
+    break;
+  case 5:
+    if (std::memcmp(key, "Build", 5) == 0) {
+      obj.type = Plan::Build_t;
+      GM_PROFILE_HIT(kPlanHits, Plan::Build_t - 1);
+      gm::readText(cur, end, obj.data.Build.cells);
+      return;
+    }
+    break;
+  }
+  gm::text::error("invalid Plan");
+}
+
+void readMany(const char *&cur, const char *end, size_t n, Plan *out) {
+  const char *p = cur;
+  for (size_t i = 0; i < n; i++) {
+    readText(p, end, out[i]);
+  }
+  cur = p;
+}
+
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Plan> &out) {
+  const char *p = cur;
+  size_t size = out.size();
+  out.reserve(size + n);
+  try {
+    for (size_t i = 0; i < n; i++) {
+      Plan item;
+      readText(p, end, item);
+      out.push_back(std::move(item));
+    }
+  }
+  catch (...) {
+    out.erase(out.begin() + size, out.end());
+    throw;
+  }
+  cur = p;
+}
+
+std::ostream &operator<<(std::ostream &os, const Plan &obj) {
+  switch (obj.type) {
+  case Plan::Build_t:
+    os << "Build " << obj.data.Build.cells << "";
+  break;
+  case Plan::Wait_t:
+    os << "Wait";
+  break;
+  default:
+    break;
+  }
+  return os;
+}
+
+void encode(uint8_t *&out, const Plan &obj) {
+  gm::store<uint8_t>(out, obj.type);
+  out += 1;
+  uint8_t *end = out + 17;
+  switch (obj.type) {
+  case Plan::Build_t:
+    gm::store<uint8_t>(out, static_cast<uint8_t>(obj.data.Build.cells.size()));
+    out += 1;
+    for (const auto &item : obj.data.Build.cells) {
+      encode(out, item);
+    }
+    std::memset(out, 0, (2 - obj.data.Build.cells.size()) * 8);
+    out += (2 - obj.data.Build.cells.size()) * 8;
+    break;
+  default:
+    break;
+  }
+  std::memset(out, 0, end - out);
+  out = end;
+}
+
+void decode(const uint8_t *&in, Plan &obj) {
+  auto type = static_cast<Plan::Type>(gm::load<uint8_t>(in));
+  in += 1;
+  const uint8_t *end = in + 17;
+  switch (type) {
+  case Plan::Undef:
+  case Plan::Wait_t:
+    break;
+  case Plan::Build_t:
+    obj.data.Build.cells.resize(gm::load<uint8_t>(in));
+    in += 1;
+    for (auto &item : obj.data.Build.cells) {
+      decode(in, item);
+    }
+    in += (2 - obj.data.Build.cells.size()) * 8;
+    break;
+  default:
+    throw std::runtime_error("Invalid Plan type");
+  }
+  obj.type = type;
+  in = end;
+}
+
+static void writeJson(std::string &out, const Plan::Build_d &obj) {
+  out += "{\"cells\":";
+  gm::writeJson(out, obj.cells);
+  out += '}';
+}
+
+static void readJson(const char *&cur, const char *end, Plan::Build_d &obj) {
+  gm::json::expect(cur, end, '{');
+  if (gm::json::consume(cur, end, '}')) {
+    return;
+  }
+  const char *key;
+  size_t length;
+  do {
+    gm::json::readKey(cur, end, key, length);
+    switch (length) {
+    case 5:
+      if (std::memcmp(key, "cells", 5) == 0) {
+        gm::readJson(cur, end, obj.cells);
+        continue;
+      }
+      break;
+    }
+    gm::json::skipValue(cur, end);
+  } while (gm::json::next(cur, end, '}'));
+}
+
+static void writeJson(std::string &out, const Plan::Wait_d &) {
+  out += "{}";
+}
+
+static void readJson(const char *&cur, const char *end, Plan::Wait_d &) {
+  gm::json::skipValue(cur, end);
+}
+
+void writeJson(std::string &out, const Plan &obj) {
+  switch (obj.type) {
+  case Plan::Build_t:
+    out += "{\"Build\":";
+    writeJson(out, obj.data.Build);
+    out += '}';
+    break;
+  case Plan::Wait_t:
+    out += "{\"Wait\":";
+    writeJson(out, obj.data.Wait);
+    out += '}';
+    break;
+  default:
+    out += "null";
+    break;
+  }
+}
+
+void readJson(const char *&cur, const char *end, Plan &obj) {
+  if (gm::json::consumeNull(cur, end)) {
+    obj.type = Plan::Undef;
+    return;
+  }
+  gm::json::expect(cur, end, '{');
+  const char *key;
+  size_t length;
+  gm::json::readKey(cur, end, key, length);
+  switch (length) {
+  case 4:
+    if (std::memcmp(key, "Wait", 4) == 0) {
+      obj.type = Plan::Wait_t;
+      readJson(cur, end, obj.data.Wait);
+      gm::json::expect(cur, end, '}');
+      return;
+    }
+    break;
+  case 5:
+    if (std::memcmp(key, "Build", 5) == 0) {
+      obj.type = Plan::Build_t;
+      readJson(cur, end, obj.data.Build);
+      gm::json::expect(cur, end, '}');
+      return;
+    }
+    break;
+  }
+  gm::json::error("invalid Plan");
+}
+
+void randomize(gm::Rng &rng, Plan &obj) {
+  switch (rng.below(2)) {
+  case 0:
+    obj.type = Plan::Build_t;
+    randomize(rng, obj.data.Build.cells);
+    break;
+  case 1:
+    obj.type = Plan::Wait_t;
+    break;
+  }
+}
+
+bool Hero::operator==(const Hero &other) const {
+  return std::memcmp(this, &other, sizeof(Hero)) == 0;
+}
+
+std::istream &operator>>(std::istream &is, Hero &obj) {
+  is >> obj.name;
+  is >> obj.hp;
+  return is;
+}
+
+void readText(const char *&cur, const char *end, Hero &obj) {
+  gm::readText(cur, end, obj.name);
+  gm::readText(cur, end, obj.hp);
+}
+
+void readMany(const char *&cur, const char *end, size_t n, Hero *out) {
+  const char *p = cur;
+  for (size_t i = 0; i < n; i++) {
+    readText(p, end, out[i]);
+  }
+  cur = p;
+}
+
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Hero> &out) {
+  const char *p = cur;
+  size_t size = out.size();
+  out.reserve(size + n);
+  try {
+    for (size_t i = 0; i < n; i++) {
+      Hero item;
+      readText(p, end, item);
+      out.push_back(std::move(item));
+    }
+  }
+  catch (...) {
+    out.erase(out.begin() + size, out.end());
+    throw;
+  }
+  cur = p;
+}
+
+std::ostream &operator<<(std::ostream &os, const Hero &obj) {
+  os << "{ ";
+  os << "name" << ": " << obj.name << ", ";
+  os << "hp" << ": " << obj.hp;
+  os << " }";
+  return os;
+}
+
+void writeText(gm::OutputBuffer &os, const Hero &obj) {
+  os << "{ ";
+  os << "name" << ": " << obj.name << ", ";
+  os << "hp" << ": " << obj.hp;
+  os << " }";
+}
+
+void encode(uint8_t *&out, const Hero &obj) {
+  if (gm::kLittleEndian) {
+    std::memcpy(out, &obj, kHeroBinSize);
+    out += kHeroBinSize;
+    return;
+  }
+  gm::store<uint8_t>(out, static_cast<uint8_t>(obj.name.size()));
+  std::memcpy(out + 1, obj.name.data(), 11);
+  out += 12;
+  gm::store<int32_t>(out, obj.hp);
+  out += 4;
+}
+
+void decode(const uint8_t *&in, Hero &obj) {
+  if (gm::load<uint8_t>(in) > 11) {
+    throw std::runtime_error("Invalid Str length");
+  }
+  obj.name.assign(reinterpret_cast<const char *>(in + 1), gm::load<uint8_t>(in));
+  in += 12;
+  obj.hp = gm::load<int32_t>(in);
+  in += 4;
+}
+
+void writeJson(std::string &out, const Hero &obj) {
+  out += "{\"name\":";
+  gm::writeJson(out, obj.name);
+  out += ",\"hp\":";
+  gm::writeJson(out, obj.hp);
+  out += '}';
+}
+
+void readJson(const char *&cur, const char *end, Hero &obj) {
+  gm::json::expect(cur, end, '{');
+  if (gm::json::consume(cur, end, '}')) {
+    return;
+  }
+  const char *key;
+  size_t length;
+  do {
+    gm::json::readKey(cur, end, key, length);
+    switch (length) {
+    case 2:
+      if (std::memcmp(key, "hp", 2) == 0) {
+        gm::readJson(cur, end, obj.hp);
+        continue;
+      }
+      break;
+    case 4:
+      if (std::memcmp(key, "name", 4) == 0) {
+        gm::readJson(cur, end, obj.name);
+        continue;
+      }
+      break;
+    }
+    gm::json::skipValue(cur, end);
+  } while (gm::json::next(cur, end, '}'));
+}
+
+void randomize(gm::Rng &rng, Hero &obj) {
+  randomize(rng, obj.name);
+  randomize(rng, obj.hp);
+}
+
+bool Squad::operator==(const Squad &other) const {
+  return heroes == other.heroes
+      && tags == other.tags;
+}
+
+std::istream &operator>>(std::istream &is, Squad &obj) {
+  is >> obj.heroes;
+  is >> obj.tags;
+  return is;
+}
+
+void readText(const char *&cur, const char *end, Squad &obj) {
+  gm::readText(cur, end, obj.heroes);
+  gm::readText(cur, end, obj.tags);
+}
+
+void readMany(const char *&cur, const char *end, size_t n, Squad *out) {
+  const char *p = cur;
+  for (size_t i = 0; i < n; i++) {
+    readText(p, end, out[i]);
+  }
+  cur = p;
+}
+
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Squad> &out) {
+  const char *p = cur;
+  size_t size = out.size();
+  out.reserve(size + n);
+  try {
+    for (size_t i = 0; i < n; i++) {
+      Squad item;
+      readText(p, end, item);
+      out.push_back(std::move(item));
+    }
+  }
+  catch (...) {
+    out.erase(out.begin() + size, out.end());
+    throw;
+  }
+  cur = p;
+}
+
+std::ostream &operator<<(std::ostream &os, const Squad &obj) {
+  os << "{ ";
+  os << "heroes" << ": " << obj.heroes << ", ";
+  os << "tags" << ": " << obj.tags;
+  os << " }";
+  return os;
+}
+
+void encode(uint8_t *&out, const Squad &obj) {
+  gm::store<uint8_t>(out, static_cast<uint8_t>(obj.heroes.size()));
+  out += 1;
+  for (const auto &item : obj.heroes) {
+    encode(out, item);
+  }
+  std::memset(out, 0, (4 - obj.heroes.size()) * 16);
+  out += (4 - obj.heroes.size()) * 16;
+  for (const auto &item : obj.tags) {
+    gm::store<uint8_t>(out, static_cast<uint8_t>(item.size()));
+    std::memcpy(out + 1, item.data(), 3);
+    out += 4;
+  }
+}
+
+void decode(const uint8_t *&in, Squad &obj) {
+  obj.heroes.resize(gm::load<uint8_t>(in));
+  in += 1;
+  for (auto &item : obj.heroes) {
+    decode(in, item);
+  }
+  in += (4 - obj.heroes.size()) * 16;
+  for (auto &item : obj.tags) {
+    if (gm::load<uint8_t>(in) > 3) {
+      throw std::runtime_error("Invalid Str length");
+    }
+    item.assign(reinterpret_cast<const char *>(in + 1), gm::load<uint8_t>(in));
+    in += 4;
+  }
+}
+
+void writeJson(std::string &out, const Squad &obj) {
+  out += "{\"heroes\":";
+  gm::writeJson(out, obj.heroes);
+  out += ",\"tags\":";
+  gm::writeJson(out, obj.tags);
+  out += '}';
+}
+
+void readJson(const char *&cur, const char *end, Squad &obj) {
+  gm::json::expect(cur, end, '{');
+  if (gm::json::consume(cur, end, '}')) {
+    return;
+  }
+  const char *key;
+  size_t length;
+  do {
+    gm::json::readKey(cur, end, key, length);
+    switch (length) {
+    case 4:
+      if (std::memcmp(key, "tags", 4) == 0) {
+        gm::readJson(cur, end, obj.tags);
+        continue;
+      }
+      break;
+    case 6:
+      if (std::memcmp(key, "heroes", 6) == 0) {
+        gm::readJson(cur, end, obj.heroes);
+        continue;
+      }
+      break;
+    }
+    gm::json::skipValue(cur, end);
+  } while (gm::json::next(cur, end, '}'));
+}
+
+void randomize(gm::Rng &rng, Squad &obj) {
+  randomize(rng, obj.heroes);
+  randomize(rng, obj.tags);
+}
+
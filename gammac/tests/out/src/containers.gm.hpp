@@ -0,0 +1,433 @@
+#ifndef src_containers_gm__
+#define src_containers_gm__
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "gamma/bin.hpp"
+#include "gamma/containers.hpp"
+#include "gamma/io.hpp"
+#include "gamma/io_containers.hpp"
+#include "gamma/json.hpp"
+#include "gamma/json_containers.hpp"
+#include "gamma/out.hpp"
+#include "gamma/out_containers.hpp"
+#include "gamma/random.hpp"
+#include "gamma/random_containers.hpp"
+#include "gamma/text.hpp"
+#include "gamma/text_containers.hpp"
+#include "gamma/undo.hpp"
+
+enum class Ground {
+  GRASS, WATER, ROCK, 
+};
+
+std::istream &operator>>(std::istream &is, Ground &obj);
+void readText(const char *&cur, const char *end, Ground &obj);
+void readMany(const char *&cur, const char *end, size_t n, Ground *out);
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Ground> &out);
+
+std::ostream &operator<<(std::ostream &os, const Ground &obj);
+void writeText(gm::OutputBuffer &os, const Ground &obj);
+
+constexpr size_t kGroundBinSize = 4;
+constexpr uint64_t kGroundFingerprint = 0x2c032a5c8b081f92ULL;
+void encode(uint8_t *&out, const Ground &obj);
+void decode(const uint8_t *&in, Ground &obj);
+
+void writeJson(std::string &out, const Ground &obj);
+void readJson(const char *&cur, const char *end, Ground &obj);
+
+void randomize(gm::Rng &rng, Ground &obj);
+
+struct Step {
+  Step() = default;
+  constexpr Step(int x, int y) noexcept: x(x), y(y) {}
+  int x;
+  int y;
+  bool operator==(const Step &other) const;
+};
+
+static_assert(std::is_trivially_copyable<Step>::value, "Step must be trivially copyable");
+static_assert(sizeof(Step) == sizeof(int) + sizeof(int), "Step must have no padding");
+
+std::istream &operator>>(std::istream &is, Step &obj);
+void readText(const char *&cur, const char *end, Step &obj);
+void readMany(const char *&cur, const char *end, size_t n, Step *out);
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Step> &out);
+
+std::ostream &operator<<(std::ostream &os, const Step &obj);
+void writeText(gm::OutputBuffer &os, const Step &obj);
+
+constexpr size_t kStepBinSize = 8;
+constexpr uint64_t kStepFingerprint = 0x8c7d57bc43a4a605ULL;
+void encode(uint8_t *&out, const Step &obj);
+void decode(const uint8_t *&in, Step &obj);
+
+struct StepView {
+  explicit StepView(const uint8_t *data) noexcept: data(data) {}
+  int x() const noexcept { return gm::load<int32_t>(data); }
+  int y() const noexcept { return gm::load<int32_t>(data + 4); }
+  const uint8_t *data;
+};
+
+void writeJson(std::string &out, const Step &obj);
+void readJson(const char *&cur, const char *end, Step &obj);
+
+void randomize(gm::Rng &rng, Step &obj);
+
+struct Board {
+  Board() = default;
+  constexpr Board(gm::Array<Ground, 4> tiles, gm::SmallVec<Step, 3> path, gm::Array<gm::Array<int8_t, 2>, 2> heights, gm::SmallVec<uint8_t, 5> marks) noexcept: tiles(tiles), path(path), heights(heights), marks(marks) {}
+  gm::Array<Ground, 4> tiles;
+  gm::SmallVec<Step, 3> path;
+  gm::Array<gm::Array<int8_t, 2>, 2> heights;
+  gm::SmallVec<uint8_t, 5> marks;
+  enum Field {
+    tiles_f,
+    path_f,
+    heights_f,
+    marks_f,
+  };
+  bool operator==(const Board &other) const;
+  struct Change {
+    Field field;
+    union Value {
+      Value() {}
+      gm::Array<Ground, 4> tiles;
+      gm::SmallVec<Step, 3> path;
+      gm::Array<gm::Array<int8_t, 2>, 2> heights;
+      gm::SmallVec<uint8_t, 5> marks;
+    } value;
+  };
+  void rollback(gm::UndoLog<Change> &log, size_t mark) {
+    while (log.mark() > mark) {
+      const Change &change = log.pop();
+      switch (change.field) {
+      case tiles_f:
+        this->tiles = change.value.tiles;
+        break;
+      case path_f:
+        this->path = change.value.path;
+        break;
+      case heights_f:
+        this->heights = change.value.heights;
+        break;
+      case marks_f:
+        this->marks = change.value.marks;
+        break;
+      }
+    }
+  }
+  struct Patch {
+    uint64_t changed = 0;
+    gm::Array<Ground, 4> tiles;
+    gm::SmallVec<Step, 3> path;
+    gm::Array<gm::Array<int8_t, 2>, 2> heights;
+    gm::SmallVec<uint8_t, 5> marks;
+    bool has(Field field) const { return (changed >> field) & 1; }
+  };
+  void setTiles(gm::UndoLog<Change> &log, const gm::Array<Ground, 4> &value) {
+    Change change;
+    change.field = tiles_f;
+    change.value.tiles = this->tiles;
+    log.push(change);
+    this->tiles = value;
+  }
+  void setPath(gm::UndoLog<Change> &log, const gm::SmallVec<Step, 3> &value) {
+    Change change;
+    change.field = path_f;
+    change.value.path = this->path;
+    log.push(change);
+    this->path = value;
+  }
+  void setHeights(gm::UndoLog<Change> &log, const gm::Array<gm::Array<int8_t, 2>, 2> &value) {
+    Change change;
+    change.field = heights_f;
+    change.value.heights = this->heights;
+    log.push(change);
+    this->heights = value;
+  }
+  void setMarks(gm::UndoLog<Change> &log, const gm::SmallVec<uint8_t, 5> &value) {
+    Change change;
+    change.field = marks_f;
+    change.value.marks = this->marks;
+    log.push(change);
+    this->marks = value;
+  }
+};
+
+static_assert(std::is_trivially_copyable<Board>::value, "Board must be trivially copyable");
+
+std::istream &operator>>(std::istream &is, Board &obj);
+void readText(const char *&cur, const char *end, Board &obj);
+void readMany(const char *&cur, const char *end, size_t n, Board *out);
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Board> &out);
+
+std::ostream &operator<<(std::ostream &os, const Board &obj);
+void writeText(gm::OutputBuffer &os, const Board &obj);
+
+constexpr size_t kBoardBinSize = 51;
+constexpr uint64_t kBoardFingerprint = 0xdec8bcaf9e365db4ULL;
+void encode(uint8_t *&out, const Board &obj);
+void decode(const uint8_t *&in, Board &obj);
+
+struct BoardView {
+  explicit BoardView(const uint8_t *data) noexcept: data(data) {}
+  Ground tiles(size_t i) const { return static_cast<Ground>(gm::loadEnum(data + 4 * i, 3)); }
+  size_t pathCount() const noexcept { return gm::load<uint8_t>(data + 16); }
+  StepView path(size_t i) const noexcept { return StepView(data + 16 + 1 + 8 * i); }
+  int8_t heights(size_t i, size_t j) const noexcept { return gm::load<int8_t>(data + 41 + 2 * i + j); }
+  size_t marksCount() const noexcept { return gm::load<uint8_t>(data + 45); }
+  uint8_t marks(size_t i) const noexcept { return gm::load<uint8_t>(data + 45 + 1 + i); }
+  const uint8_t *data;
+};
+
+void writeJson(std::string &out, const Board &obj);
+void readJson(const char *&cur, const char *end, Board &obj);
+
+void randomize(gm::Rng &rng, Board &obj);
+
+Board::Patch diff(const Board &a, const Board &b);
+void apply(Board &state, const Board::Patch &patch);
+
+constexpr size_t kBoardPatchMaxBinSize = 52;
+void encode(uint8_t *&out, const Board::Patch &patch);
+void decode(const uint8_t *&in, Board::Patch &patch);
+
+struct History {
+  History() = default;
+  History(gm::Vec<Step> moves, gm::Vec<std::string> names, gm::SmallVec<gm::Vec<int>, 2> turns) noexcept(std::is_nothrow_move_constructible<gm::Vec<Step>>::value && std::is_nothrow_move_constructible<gm::Vec<std::string>>::value && std::is_nothrow_move_constructible<gm::SmallVec<gm::Vec<int>, 2>>::value): moves(std::move(moves)), names(std::move(names)), turns(std::move(turns)) {
+    dirty = History::kAllFields;
+  }
+  gm::Vec<Step> moves;
+  gm::Vec<std::string> names;
+  gm::SmallVec<gm::Vec<int>, 2> turns;
+  uint64_t dirty = kAllFields;
+  enum Field {
+    moves_f,
+    names_f,
+    turns_f,
+  };
+  bool operator==(const History &other) const;
+  static constexpr uint64_t kAllFields = 0x7ULL;
+  bool isDirty(Field field) const { return (dirty >> field) & 1; }
+  uint64_t dirtyFields() const { return dirty; }
+  void clearDirty() { dirty = 0; }
+  struct Patch {
+    uint64_t changed = 0;
+    gm::Vec<Step> moves;
+    gm::Vec<std::string> names;
+    gm::SmallVec<gm::Vec<int>, 2> turns;
+    bool has(Field field) const { return (changed >> field) & 1; }
+  };
+  void setMoves(const gm::Vec<Step> &value) {
+    this->dirty |= uint64_t(1) << moves_f;
+    this->moves = value;
+  }
+  void setNames(const gm::Vec<std::string> &value) {
+    this->dirty |= uint64_t(1) << names_f;
+    this->names = value;
+  }
+  void setTurns(const gm::SmallVec<gm::Vec<int>, 2> &value) {
+    this->dirty |= uint64_t(1) << turns_f;
+    this->turns = value;
+  }
+};
+
+std::istream &operator>>(std::istream &is, History &obj);
+void readText(const char *&cur, const char *end, History &obj);
+void readMany(const char *&cur, const char *end, size_t n, History *out);
+void readMany(const char *&cur, const char *end, size_t n, std::vector<History> &out);
+
+std::ostream &operator<<(std::ostream &os, const History &obj);
+
+void writeJson(std::string &out, const History &obj);
+void readJson(const char *&cur, const char *end, History &obj);
+
+void randomize(gm::Rng &rng, History &obj);
+
+History::Patch diff(const History &a, const History &b);
+void apply(History &state, const History::Patch &patch);
+
+struct Plan {
+  enum Type {
+    Undef,
+    Build_t,
+    Wait_t,
+  } type;
+  struct Build_d {
+    gm::SmallVec<Step, 2> cells;
+  };
+  struct Wait_d {
+  };
+  union Data {
+    constexpr Data() noexcept: Build() {}
+    constexpr Data(Build_d Build) noexcept: Build(Build) {}
+    constexpr Data(Wait_d Wait) noexcept: Wait(Wait) {}
+    Build_d Build;
+    Wait_d Wait;
+  } data;
+  constexpr Plan(Type type = Undef) noexcept: type(type), data() {}
+  constexpr Plan(Type type, Data data) noexcept: type(type), data(data) {}
+  static constexpr Plan Build(gm::SmallVec<Step, 2> cells) noexcept {
+    return Plan(Build_t, Build_d{cells});
+  }
+  static constexpr Plan Wait() noexcept {
+    return Plan(Wait_t, Wait_d{});
+  }
+  bool operator==(const Plan &other) const;
+};
+
+template <typename Visitor>
+auto visit(const Plan &obj, Visitor &&vis) -> decltype(vis(obj.data.Build)) {
+  switch (obj.type) {
+  case Plan::Build_t:
+    return vis(obj.data.Build);
+  case Plan::Wait_t:
+    return vis(obj.data.Wait);
+  default:
+    throw std::invalid_argument("visit: undefined Plan");
+  }
+}
+
+template <typename Visitor>
+auto visit(Plan &obj, Visitor &&vis) -> decltype(vis(obj.data.Build)) {
+  switch (obj.type) {
+  case Plan::Build_t:
+    return vis(obj.data.Build);
+  case Plan::Wait_t:
+    return vis(obj.data.Wait);
+  default:
+    throw std::invalid_argument("visit: undefined Plan");
+  }
+}
+
+static_assert(std::is_trivially_copyable<Plan>::value, "Plan must be trivially copyable");
+
+std::istream &operator>>(std::istream &is, Plan &obj);
+void readText(const char *&cur, const char *end, Plan &obj);
+void readMany(const char *&cur, const char *end, size_t n, Plan *out);
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Plan> &out);
+
+std::ostream &operator<<(std::ostream &os, const Plan &obj);
+
+constexpr size_t kPlanBinSize = 18;
+constexpr uint64_t kPlanFingerprint = 0xae5e66fc17ad245fULL;
+void encode(uint8_t *&out, const Plan &obj);
+void decode(const uint8_t *&in, Plan &obj);
+
+void writeJson(std::string &out, const Plan &obj);
+void readJson(const char *&cur, const char *end, Plan &obj);
+
+void randomize(gm::Rng &rng, Plan &obj);
+
+struct Hero {
+  Hero() = default;
+  constexpr Hero(gm::Str<11> name, int hp) noexcept: name(name), hp(hp) {}
+  gm::Str<11> name;
+  int hp;
+  enum Field {
+    name_f,
+    hp_f,
+  };
+  bool operator==(const Hero &other) const;
+  struct Change {
+    Field field;
+    union Value {
+      Value() {}
+      gm::Str<11> name;
+      int hp;
+    } value;
+  };
+  void rollback(gm::UndoLog<Change> &log, size_t mark) {
+    while (log.mark() > mark) {
+      const Change &change = log.pop();
+      switch (change.field) {
+      case name_f:
+        this->name = change.value.name;
+        break;
+      case hp_f:
+        this->hp = change.value.hp;
+        break;
+      }
+    }
+  }
+  void setName(gm::UndoLog<Change> &log, const gm::Str<11> &value) {
+    Change change;
+    change.field = name_f;
+    change.value.name = this->name;
+    log.push(change);
+    this->name = value;
+  }
+  void setHp(gm::UndoLog<Change> &log, int value) {
+    Change change;
+    change.field = hp_f;
+    change.value.hp = this->hp;
+    log.push(change);
+    this->hp = value;
+  }
+};
+
+static_assert(std::is_trivially_copyable<Hero>::value, "Hero must be trivially copyable");
+static_assert(sizeof(Hero) == sizeof(gm::Str<11>) + sizeof(int), "Hero must have no padding");
+
+std::istream &operator>>(std::istream &is, Hero &obj);
+void readText(const char *&cur, const char *end, Hero &obj);
+void readMany(const char *&cur, const char *end, size_t n, Hero *out);
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Hero> &out);
+
+std::ostream &operator<<(std::ostream &os, const Hero &obj);
+void writeText(gm::OutputBuffer &os, const Hero &obj);
+
+constexpr size_t kHeroBinSize = 16;
+constexpr uint64_t kHeroFingerprint = 0x2bf8d0ba6e95e19fULL;
+void encode(uint8_t *&out, const Hero &obj);
+void decode(const uint8_t *&in, Hero &obj);
+
+struct HeroView {
+  explicit HeroView(const uint8_t *data) noexcept: data(data) {}
+  gm::Str<11> name() const { return gm::Str<11>(reinterpret_cast<const char *>(data + 1), gm::load<uint8_t>(data)); }
+  int hp() const noexcept { return gm::load<int32_t>(data + 12); }
+  const uint8_t *data;
+};
+
+void writeJson(std::string &out, const Hero &obj);
+void readJson(const char *&cur, const char *end, Hero &obj);
+
+void randomize(gm::Rng &rng, Hero &obj);
+
+struct Squad {
+  Squad() = default;
+  constexpr Squad(gm::SmallVec<Hero, 4> heroes, gm::Array<gm::Str<3>, 2> tags) noexcept: heroes(heroes), tags(tags) {}
+  gm::SmallVec<Hero, 4> heroes;
+  gm::Array<gm::Str<3>, 2> tags;
+  bool operator==(const Squad &other) const;
+};
+
+static_assert(std::is_trivially_copyable<Squad>::value, "Squad must be trivially copyable");
+
+std::istream &operator>>(std::istream &is, Squad &obj);
+void readText(const char *&cur, const char *end, Squad &obj);
+void readMany(const char *&cur, const char *end, size_t n, Squad *out);
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Squad> &out);
+
+std::ostream &operator<<(std::ostream &os, const Squad &obj);
+
+constexpr size_t kSquadBinSize = 73;
+constexpr uint64_t kSquadFingerprint = 0xbc43dd637d84517dULL;
+void encode(uint8_t *&out, const Squad &obj);
+void decode(const uint8_t *&in, Squad &obj);
+
+void writeJson(std::string &out, const Squad &obj);
+void readJson(const char *&cur, const char *end, Squad &obj);
+
+void randomize(gm::Rng &rng, Squad &obj);
+
+
+#endif
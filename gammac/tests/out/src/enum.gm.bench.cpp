@@ -0,0 +1,206 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "gamma/containers.hpp"
+#include "gamma/optional.hpp"
+#include "gamma/random.hpp"
+
+#include "src/enum.gm.hpp"
+
+// Generated by gammac --emit-bench; usage: <program> [count]
+
+template <typename T>
+static inline void writeInput(std::ostream &os, const T &value) { os << value; }
+static inline void writeInput(std::ostream &os, int8_t value) { os << static_cast<int>(value); }
+static inline void writeInput(std::ostream &os, uint8_t value) { os << static_cast<int>(value); }
+template <typename T, size_t N>
+static inline void writeInput(std::ostream &os, const gm::Array<T, N> &value);
+template <typename T, size_t N>
+static inline void writeInput(std::ostream &os, const gm::SmallVec<T, N> &value);
+template <typename T>
+static inline void writeInput(std::ostream &os, const gm::Vec<T> &value);
+template <typename T, typename Niche>
+static inline void writeInput(std::ostream &os, const gm::Optional<T, Niche> &value);
+
+template <typename Container>
+static inline void writeInputItems(std::ostream &os, const Container &value) {
+  for (const auto &item : value) {
+    os << ' ';
+    writeInput(os, item);
+  }
+}
+
+template <typename T, size_t N>
+static inline void writeInput(std::ostream &os, const gm::Array<T, N> &value) {
+  writeInput(os, value[0]);
+  for (size_t i = 1; i < N; i++) {
+    os << ' ';
+    writeInput(os, value[i]);
+  }
+}
+
+template <typename T, size_t N>
+static inline void writeInput(std::ostream &os, const gm::SmallVec<T, N> &value) {
+  os << value.size();
+  writeInputItems(os, value);
+}
+
+template <typename T>
+static inline void writeInput(std::ostream &os, const gm::Vec<T> &value) {
+  os << value.size();
+  writeInputItems(os, value);
+}
+
+template <typename T, typename Niche>
+static inline void writeInput(std::ostream &os, const gm::Optional<T, Niche> &value) {
+  if (value.has_value()) {
+    writeInput(os, *value);
+  }
+  else {
+    os << '-';
+  }
+}
+
+typedef std::chrono::steady_clock BenchClock;
+
+static void report(const char *type, const char *trait, BenchClock::time_point start, size_t count, size_t bytes) {
+  double ns = std::chrono::duration<double, std::nano>(BenchClock::now() - start).count();
+  if (bytes > 0) {
+    std::printf("%-20s %-8s %10.1f ns/op %10.1f MB/s\n", type, trait, ns / count, bytes * 1e3 / ns);
+  }
+  else {
+    std::printf("%-20s %-8s %10.1f ns/op\n", type, trait, ns / count);
+  }
+}
+
+static inline void randomize(gm::Rng &rng, Owner &obj) {
+  obj = static_cast<Owner>(rng.below(3));
+}
+
+static inline void writeInput(std::ostream &os, const Owner &obj) {
+  static const char *const formats[] = {
+    "-1", "0", "1", 
+  };
+  os << formats[static_cast<size_t>(obj)];
+}
+
+static void benchOwner(size_t count) {
+  gm::Rng rng(13362706469355457364ULL);
+  std::vector<Owner> values(count);
+  for (auto &value : values) {
+    randomize(rng, value);
+  }
+  {
+    std::ostringstream os;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      os << value << '\n';
+    }
+    report("Owner", "Out", start, count, os.str().size());
+  }
+  {
+    std::ostringstream os;
+    for (const auto &value : values) {
+      writeInput(os, value);
+      os << '\n';
+    }
+    std::string text = os.str();
+    std::vector<Owner> parsed;
+    const char *cur = text.data();
+    auto start = BenchClock::now();
+    readMany(cur, text.data() + text.size(), count, parsed);
+    report("Owner", "In", start, count, text.size());
+  }
+}
+
+static inline void randomize(gm::Rng &rng, Reward &obj) {
+  obj = static_cast<Reward>(rng.below(3));
+}
+
+static inline void writeInput(std::ostream &os, const Reward &obj) {
+  static const char *const formats[] = {
+    "10", "50", "-20", 
+  };
+  os << formats[static_cast<size_t>(obj)];
+}
+
+static void benchReward(size_t count) {
+  gm::Rng rng(17314986348487423450ULL);
+  std::vector<Reward> values(count);
+  for (auto &value : values) {
+    randomize(rng, value);
+  }
+  {
+    std::ostringstream os;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      os << value << '\n';
+    }
+    report("Reward", "Out", start, count, os.str().size());
+  }
+  {
+    std::ostringstream os;
+    for (const auto &value : values) {
+      writeInput(os, value);
+      os << '\n';
+    }
+    std::string text = os.str();
+    std::vector<Reward> parsed;
+    const char *cur = text.data();
+    auto start = BenchClock::now();
+    readMany(cur, text.data() + text.size(), count, parsed);
+    report("Reward", "In", start, count, text.size());
+  }
+}
+
+static inline void randomize(gm::Rng &rng, Heading &obj) {
+  obj = static_cast<Heading>(rng.below(4));
+}
+
+static inline void writeInput(std::ostream &os, const Heading &obj) {
+  static const char *const formats[] = {
+    "N", "E", "S", "W", 
+  };
+  os << formats[static_cast<size_t>(obj)];
+}
+
+static void benchHeading(size_t count) {
+  gm::Rng rng(3395789926335918805ULL);
+  std::vector<Heading> values(count);
+  for (auto &value : values) {
+    randomize(rng, value);
+  }
+  {
+    std::ostringstream os;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      os << value << '\n';
+    }
+    report("Heading", "Out", start, count, os.str().size());
+  }
+  {
+    std::ostringstream os;
+    for (const auto &value : values) {
+      writeInput(os, value);
+      os << '\n';
+    }
+    std::string text = os.str();
+    std::vector<Heading> parsed;
+    const char *cur = text.data();
+    auto start = BenchClock::now();
+    readMany(cur, text.data() + text.size(), count, parsed);
+    report("Heading", "In", start, count, text.size());
+  }
+}
+
+int main(int argc, char *argv[]) {
+  size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+  benchOwner(count);
+  benchReward(count);
+  benchHeading(count);
+  return 0;
+}
@@ -1,27 +1,243 @@
+#include <cstring>
 #include <map>
+#include <stdexcept>
 #include <string>
+#include <utility>
+#include "gamma/profile.hpp"
 
 #include "src/enum.gm.hpp"
 
-static const std::map<std::string, Owner> kStrToOwner {
-  {"-1", Owner::OTHER},
-  {"0", Owner::NONE},
-  {"1", Owner::SELF},
+#ifdef GAMMA_PROFILE
+static const char *const kOwnerVariants[] = {
+  "OTHER", "NONE", "SELF", 
 };
+static uint64_t *const kOwnerHits = gm::Profile::instance().add("Owner", kOwnerVariants, 3);
+#endif
+
+static bool intToOwner(int value, Owner &obj) {
+  if (value < -1 || value > 1) {
+    return false;
+  }
+  obj = static_cast<Owner>(value + 1);
+  return true;
+}
 
 std::istream &operator>>(std::istream &is, Owner &obj) {
+  int value;
+  if (!(is >> value)) {
+    return is;
+  }
+  if (!intToOwner(value, obj)) {
+    throw std::out_of_range("Invalid Owner");
+  }
+  GM_PROFILE_HIT(kOwnerHits, static_cast<size_t>(obj));
+  return is;
+}
+
+void readText(const char *&cur, const char *end, Owner &obj) {
+  int value;
+  gm::readText(cur, end, value);
+  if (!intToOwner(value, obj)) {
+    gm::text::error("invalid Owner");
+  }
+  GM_PROFILE_HIT(kOwnerHits, static_cast<size_t>(obj));
+}
+
+void readMany(const char *&cur, const char *end, size_t n, Owner *out) {
+  const char *p = cur;
+  for (size_t i = 0; i < n; i++) {
+    readText(p, end, out[i]);
+  }
+  cur = p;
+}
+
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Owner> &out) {
+  const char *p = cur;
+  size_t size = out.size();
+  out.reserve(size + n);
+  try {
+    for (size_t i = 0; i < n; i++) {
+      Owner item;
+      readText(p, end, item);
+      out.push_back(std::move(item));
+    }
+  }
+  catch (...) {
+    out.erase(out.begin() + size, out.end());
+    throw;
+  }
+  cur = p;
+}
+
+std::ostream &operator<<(std::ostream &os, const Owner &obj) {
+  os << static_cast<int>(obj) - 1;
+  return os;
+}
+
+#ifdef GAMMA_PROFILE
+static const char *const kRewardVariants[] = {
+  "SMALL", "BIG", "PENALTY", 
+};
+static uint64_t *const kRewardHits = gm::Profile::instance().add("Reward", kRewardVariants, 3);
+#endif
+
+static bool intToReward(int value, Reward &obj) {
+  switch (value) {
+  case 10:
+    obj = Reward::SMALL;
+    return true;
+  case 50:
+    obj = Reward::BIG;
+    return true;
+  case -20:
+    obj = Reward::PENALTY;
+    return true;
+  default:
+    return false;
+  }
+}
+
+std::istream &operator>>(std::istream &is, Reward &obj) {
+  int value;
+  if (!(is >> value)) {
+    return is;
+  }
+  if (!intToReward(value, obj)) {
+    throw std::out_of_range("Invalid Reward");
+  }
+  GM_PROFILE_HIT(kRewardHits, static_cast<size_t>(obj));
+  return is;
+}
+
+void readText(const char *&cur, const char *end, Reward &obj) {
+  int value;
+  gm::readText(cur, end, value);
+  if (!intToReward(value, obj)) {
+    gm::text::error("invalid Reward");
+  }
+  GM_PROFILE_HIT(kRewardHits, static_cast<size_t>(obj));
+}
+
+void readMany(const char *&cur, const char *end, size_t n, Reward *out) {
+  const char *p = cur;
+  for (size_t i = 0; i < n; i++) {
+    readText(p, end, out[i]);
+  }
+  cur = p;
+}
+
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Reward> &out) {
+  const char *p = cur;
+  size_t size = out.size();
+  out.reserve(size + n);
+  try {
+    for (size_t i = 0; i < n; i++) {
+      Reward item;
+      readText(p, end, item);
+      out.push_back(std::move(item));
+    }
+  }
+  catch (...) {
+    out.erase(out.begin() + size, out.end());
+    throw;
+  }
+  cur = p;
+}
+
+static const int kRewardToInt[] = {
+  10, 50, -20, 
+};
+
+std::ostream &operator<<(std::ostream &os, const Reward &obj) {
+  os << kRewardToInt[static_cast<size_t>(obj)];
+  return os;
+}
+
+#ifdef GAMMA_PROFILE
+static const char *const kHeadingVariants[] = {
+  "NORTH", "EAST", "SOUTH", "WEST", 
+};
+static uint64_t *const kHeadingHits = gm::Profile::instance().add("Heading", kHeadingVariants, 4);
+#endif
+
+static const std::map<std::string, Heading> kStrToHeading {
+  {"N", Heading::NORTH},
+  {"E", Heading::EAST},
+  {"S", Heading::SOUTH},
+  {"W", Heading::WEST},
+};
+
+std::istream &operator>>(std::istream &is, Heading &obj) {
   std::string str;
   is >> str;
-  obj = kStrToOwner.at(str);
+  obj = kStrToHeading.at(str);
+  GM_PROFILE_HIT(kHeadingHits, static_cast<size_t>(obj));
   return is;
 }
 
-static const std::string kOwnerToStr[] = {
-  "-1", "0", "1", 
+void readText(const char *&cur, const char *end, Heading &obj) {
+  const char *key;
+  size_t length;
+  gm::text::readToken(cur, end, key, length);
+  switch (length) {
+  case 1:
+    if (std::memcmp(key, "N", 1) == 0) {
+      obj = Heading::NORTH;
+      GM_PROFILE_HIT(kHeadingHits, static_cast<size_t>(Heading::NORTH));
+      return;
+    }
+    if (std::memcmp(key, "E", 1) == 0) {
+      obj = Heading::EAST;
+      GM_PROFILE_HIT(kHeadingHits, static_cast<size_t>(Heading::EAST));
+      return;
+    }
+    if (std::memcmp(key, "S", 1) == 0) {
+      obj = Heading::SOUTH;
+      GM_PROFILE_HIT(kHeadingHits, static_cast<size_t>(Heading::SOUTH));
+      return;
+    }
+    if (std::memcmp(key, "W", 1) == 0) {
+      obj = Heading::WEST;
+      GM_PROFILE_HIT(kHeadingHits, static_cast<size_t>(Heading::WEST));
+      return;
+    }
+    break;
+  }
+  gm::text::error("invalid Heading");
+}
+
+void readMany(const char *&cur, const char *end, size_t n, Heading *out) {
+  const char *p = cur;
+  for (size_t i = 0; i < n; i++) {
+    readText(p, end, out[i]);
+  }
+  cur = p;
+}
+
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Heading> &out) {
+  const char *p = cur;
+  size_t size = out.size();
+  out.reserve(size + n);
+  try {
+    for (size_t i = 0; i < n; i++) {
+      Heading item;
+      readText(p, end, item);
+      out.push_back(std::move(item));
+    }
+  }
+  catch (...) {
+    out.erase(out.begin() + size, out.end());
+    throw;
+  }
+  cur = p;
+}
+
+static const std::string kHeadingToStr[] = {
+  "N", "E", "S", "W", 
 };
 
-std::ostream &operator<<(std::ostream &os, const Owner &obj) {
-  os << kOwnerToStr[static_cast<size_t>(obj)];
+std::ostream &operator<<(std::ostream &os, const Heading &obj) {
+  os << kHeadingToStr[static_cast<size_t>(obj)];
   return os;
 }
 
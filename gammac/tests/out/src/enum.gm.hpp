@@ -1,16 +1,75 @@
 #ifndef src_enum_gm__
 #define src_enum_gm__
 
+#include <cstddef>
+#include <cstdint>
 #include <istream>
 #include <ostream>
+#include <vector>
+#include "gamma/out.hpp"
+#include "gamma/text.hpp"
 
 enum class Owner {
   OTHER, NONE, SELF, 
 };
 
 std::istream &operator>>(std::istream &is, Owner &obj);
+void readText(const char *&cur, const char *end, Owner &obj);
+void readMany(const char *&cur, const char *end, size_t n, Owner *out);
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Owner> &out);
 
 std::ostream &operator<<(std::ostream &os, const Owner &obj);
 
+enum class Reward {
+  SMALL, BIG, PENALTY, 
+};
+
+std::istream &operator>>(std::istream &is, Reward &obj);
+void readText(const char *&cur, const char *end, Reward &obj);
+void readMany(const char *&cur, const char *end, size_t n, Reward *out);
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Reward> &out);
+
+std::ostream &operator<<(std::ostream &os, const Reward &obj);
+
+enum class Heading {
+  NORTH, EAST, SOUTH, WEST, 
+};
+
+constexpr int8_t kHeadingDx[] = {
+  0, 1, 0, -1, 
+};
+constexpr int8_t kHeadingDy[] = {
+  -1, 0, 1, 0, 
+};
+constexpr Heading kHeadingOpposite[] = {
+  Heading::SOUTH, Heading::WEST, Heading::NORTH, Heading::EAST, 
+};
+constexpr bool kHeadingVertical[] = {
+  true, false, true, false, 
+};
+
+constexpr int8_t dx(Heading value) {
+  return kHeadingDx[static_cast<size_t>(value)];
+}
+
+constexpr int8_t dy(Heading value) {
+  return kHeadingDy[static_cast<size_t>(value)];
+}
+
+constexpr Heading opposite(Heading value) {
+  return kHeadingOpposite[static_cast<size_t>(value)];
+}
+
+constexpr bool vertical(Heading value) {
+  return kHeadingVertical[static_cast<size_t>(value)];
+}
+
+std::istream &operator>>(std::istream &is, Heading &obj);
+void readText(const char *&cur, const char *end, Heading &obj);
+void readMany(const char *&cur, const char *end, size_t n, Heading *out);
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Heading> &out);
+
+std::ostream &operator<<(std::ostream &os, const Heading &obj);
+
 
 #endif
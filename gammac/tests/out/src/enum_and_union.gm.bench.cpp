@@ -0,0 +1,184 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "gamma/containers.hpp"
+#include "gamma/optional.hpp"
+#include "gamma/random.hpp"
+
+#include "src/enum_and_union.gm.hpp"
+
+// Generated by gammac --emit-bench; usage: <program> [count]
+
+template <typename T>
+static inline void writeInput(std::ostream &os, const T &value) { os << value; }
+static inline void writeInput(std::ostream &os, int8_t value) { os << static_cast<int>(value); }
+static inline void writeInput(std::ostream &os, uint8_t value) { os << static_cast<int>(value); }
+template <typename T, size_t N>
+static inline void writeInput(std::ostream &os, const gm::Array<T, N> &value);
+template <typename T, size_t N>
+static inline void writeInput(std::ostream &os, const gm::SmallVec<T, N> &value);
+template <typename T>
+static inline void writeInput(std::ostream &os, const gm::Vec<T> &value);
+template <typename T, typename Niche>
+static inline void writeInput(std::ostream &os, const gm::Optional<T, Niche> &value);
+
+template <typename Container>
+static inline void writeInputItems(std::ostream &os, const Container &value) {
+  for (const auto &item : value) {
+    os << ' ';
+    writeInput(os, item);
+  }
+}
+
+template <typename T, size_t N>
+static inline void writeInput(std::ostream &os, const gm::Array<T, N> &value) {
+  writeInput(os, value[0]);
+  for (size_t i = 1; i < N; i++) {
+    os << ' ';
+    writeInput(os, value[i]);
+  }
+}
+
+template <typename T, size_t N>
+static inline void writeInput(std::ostream &os, const gm::SmallVec<T, N> &value) {
+  os << value.size();
+  writeInputItems(os, value);
+}
+
+template <typename T>
+static inline void writeInput(std::ostream &os, const gm::Vec<T> &value) {
+  os << value.size();
+  writeInputItems(os, value);
+}
+
+template <typename T, typename Niche>
+static inline void writeInput(std::ostream &os, const gm::Optional<T, Niche> &value) {
+  if (value.has_value()) {
+    writeInput(os, *value);
+  }
+  else {
+    os << '-';
+  }
+}
+
+typedef std::chrono::steady_clock BenchClock;
+
+static void report(const char *type, const char *trait, BenchClock::time_point start, size_t count, size_t bytes) {
+  double ns = std::chrono::duration<double, std::nano>(BenchClock::now() - start).count();
+  if (bytes > 0) {
+    std::printf("%-20s %-8s %10.1f ns/op %10.1f MB/s\n", type, trait, ns / count, bytes * 1e3 / ns);
+  }
+  else {
+    std::printf("%-20s %-8s %10.1f ns/op\n", type, trait, ns / count);
+  }
+}
+
+static inline void writeInput(std::ostream &os, const Direction &obj) {
+  static const char *const formats[] = {
+    "N", "E", "S", "W", 
+  };
+  os << formats[static_cast<size_t>(obj)];
+}
+
+static void benchDirection(size_t count) {
+  gm::Rng rng(15149798974371151882ULL);
+  std::vector<Direction> values(count);
+  for (auto &value : values) {
+    randomize(rng, value);
+  }
+  {
+    std::ostringstream os;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      os << value << '\n';
+    }
+    report("Direction", "Out", start, count, os.str().size());
+  }
+  {
+    std::ostringstream os;
+    for (const auto &value : values) {
+      writeInput(os, value);
+      os << '\n';
+    }
+    std::string text = os.str();
+    std::vector<Direction> parsed;
+    const char *cur = text.data();
+    auto start = BenchClock::now();
+    readMany(cur, text.data() + text.size(), count, parsed);
+    report("Direction", "In", start, count, text.size());
+  }
+}
+
+static inline void writeInput(std::ostream &os, const Action &obj) {
+  switch (obj.type) {
+  case Action::Move_t:
+    os << "MOVE";
+    os << ' ';
+    writeInput(os, obj.data.Move.dir);
+    break;
+  case Action::Shoot_t:
+    os << "SHOOT";
+    os << ' ';
+    writeInput(os, obj.data.Shoot.dir);
+    os << ' ';
+    writeInput(os, obj.data.Shoot.strength);
+    break;
+  case Action::Wait_t:
+    os << "WAIT";
+    break;
+  default:
+    break;
+  }
+}
+
+static void benchAction(size_t count) {
+  gm::Rng rng(11836027492335798463ULL);
+  std::vector<Action> values(count);
+  for (auto &value : values) {
+    randomize(rng, value);
+  }
+  {
+    std::ostringstream os;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      os << value << '\n';
+    }
+    report("Action", "Out", start, count, os.str().size());
+  }
+  {
+    std::ostringstream os;
+    for (const auto &value : values) {
+      writeInput(os, value);
+      os << '\n';
+    }
+    std::string text = os.str();
+    std::vector<Action> parsed;
+    const char *cur = text.data();
+    auto start = BenchClock::now();
+    readMany(cur, text.data() + text.size(), count, parsed);
+    report("Action", "In", start, count, text.size());
+  }
+  {
+    std::vector<Action> copies(values);
+    size_t equal = 0;
+    auto start = BenchClock::now();
+    for (size_t i = 0; i < count; i++) {
+      equal += values[i] == copies[i];
+    }
+    report("Action", "Eq", start, count, 0);
+    if (equal != count) {
+      std::printf("%s: copies differ\n", "Action");
+    }
+  }
+}
+
+int main(int argc, char *argv[]) {
+  size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+  benchDirection(count);
+  benchAction(count);
+  return 0;
+}
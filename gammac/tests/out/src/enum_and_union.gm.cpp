@@ -1,8 +1,19 @@
+#include <cstring>
 #include <map>
+#include <stdexcept>
 #include <string>
+#include <utility>
+#include "gamma/profile.hpp"
 
 #include "src/enum_and_union.gm.hpp"
 
+#ifdef GAMMA_PROFILE
+static const char *const kDirectionVariants[] = {
+  "N", "E", "S", "W", 
+};
+static uint64_t *const kDirectionHits = gm::Profile::instance().add("Direction", kDirectionVariants, 4);
+#endif
+
 static const std::map<std::string, Direction> kStrToDirection {
   {"N", Direction::N},
   {"E", Direction::E},
@@ -14,9 +25,67 @@ std::istream &operator>>(std::istream &is, Direction &obj) {
   std::string str;
   is >> str;
   obj = kStrToDirection.at(str);
+  GM_PROFILE_HIT(kDirectionHits, static_cast<size_t>(obj));
   return is;
 }
 
+void readText(const char *&cur, const char *end, Direction &obj) {
+  const char *key;
+  size_t length;
+  gm::text::readToken(cur, end, key, length);
+  switch (length) {
+  case 1:
+    if (std::memcmp(key, "N", 1) == 0) {
+      obj = Direction::N;
+      GM_PROFILE_HIT(kDirectionHits, static_cast<size_t>(Direction::N));
+      return;
+    }
+    if (std::memcmp(key, "E", 1) == 0) {
+      obj = Direction::E;
+      GM_PROFILE_HIT(kDirectionHits, static_cast<size_t>(Direction::E));
+      return;
+    }
+    if (std::memcmp(key, "S", 1) == 0) {
+      obj = Direction::S;
+      GM_PROFILE_HIT(kDirectionHits, static_cast<size_t>(Direction::S));
+      return;
+    }
+    if (std::memcmp(key, "W", 1) == 0) {
+      obj = Direction::W;
+      GM_PROFILE_HIT(kDirectionHits, static_cast<size_t>(Direction::W));
+      return;
+    }
+    break;
+  }
+  gm::text::error("invalid Direction");
+}
+
+void readMany(const char *&cur, const char *end, size_t n, Direction *out) {
+  const char *p = cur;
+  for (size_t i = 0; i < n; i++) {
+    readText(p, end, out[i]);
+  }
+  cur = p;
+}
+
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Direction> &out) {
+  const char *p = cur;
+  size_t size = out.size();
+  out.reserve(size + n);
+  try {
+    for (size_t i = 0; i < n; i++) {
+      Direction item;
+      readText(p, end, item);
+      out.push_back(std::move(item));
+    }
+  }
+  catch (...) {
+    out.erase(out.begin() + size, out.end());
+    throw;
+  }
+  cur = p;
+}
+
 static const std::string kDirectionToStr[] = {
   "N", "E", "S", "W", 
 };
@@ -26,21 +95,116 @@ std::ostream &operator<<(std::ostream &os, const Direction &obj) {
   return os;
 }
 
+void writeText(gm::OutputBuffer &os, const Direction &obj) {
+  os << kDirectionToStr[static_cast<size_t>(obj)];
+}
+
+void randomize(gm::Rng &rng, Direction &obj) {
+  obj = static_cast<Direction>(rng.below(4));
+}
+
 bool Action::operator==(const Action &other) const {
   if (type != other.type) return false;
   switch (type) {
   case Action::Move_t:
-    return data.Move.dir == other.data.Move.dir;
-  break;
+    return std::memcmp(&data.Move, &other.data.Move, sizeof(Move_d)) == 0;
   case Action::Shoot_t:
-    return data.Shoot.dir == other.data.Shoot.dir
-      && data.Shoot.strength == other.data.Shoot.strength;
-  break;
+    return std::memcmp(&data.Shoot, &other.data.Shoot, sizeof(Shoot_d)) == 0;
   default:
     return true;
   }
 }
 
+#ifdef GAMMA_PROFILE
+static const char *const kActionVariants[] = {
+  "Move", "Shoot", "Wait", 
+};
+static uint64_t *const kActionHits = gm::Profile::instance().add("Action", kActionVariants, 3);
+#endif
+
+std::istream &operator>>(std::istream &is, Action &obj) {
+  std::string str;
+  if (!(is >> str)) {
+    return is;
+  }
+  if (str == "MOVE") {
+    obj.type = Action::Move_t;
+    GM_PROFILE_HIT(kActionHits, Action::Move_t - 1);
+    is >> obj.data.Move.dir;
+  }
+  else if (str == "SHOOT") {
+    obj.type = Action::Shoot_t;
+    GM_PROFILE_HIT(kActionHits, Action::Shoot_t - 1);
+    is >> obj.data.Shoot.dir;
+    is >> obj.data.Shoot.strength;
+  }
+  else if (str == "WAIT") {
+    obj.type = Action::Wait_t;
+    GM_PROFILE_HIT(kActionHits, Action::Wait_t - 1);
+  }
+  else {
+    throw std::runtime_error("Invalid Action");
+  }
+  return is;
+}
+
+void readText(const char *&cur, const char *end, Action &obj) {
+  const char *key;
+  size_t length;
+  gm::text::readToken(cur, end, key, length);
+  switch (length) {
+  case 4:
+    if (std::memcmp(key, "MOVE", 4) == 0) {
+      obj.type = Action::Move_t;
+      GM_PROFILE_HIT(kActionHits, Action::Move_t - 1);
+      readText(cur, end, obj.data.Move.dir);
+      return;
+    }
+    if (std::memcmp(key, "WAIT", 4) == 0) {
+      obj.type = Action::Wait_t;
+      GM_PROFILE_HIT(kActionHits, Action::Wait_t - 1);
+      return;
+    }
+    break;
+  case 5:
+    if (std::memcmp(key, "SHOOT", 5) == 0) {
+      obj.type = Action::Shoot_t;
+      GM_PROFILE_HIT(kActionHits, Action::Shoot_t - 1);
+      readText(cur, end, obj.data.Shoot.dir);
+      gm::readText(cur, end, obj.data.Shoot.strength);
+      return;
+    }
+    break;
+  }
+  gm::text::error("invalid Action");
+}
+
+void readMany(const char *&cur, const char *end, size_t n, Action *out) {
+  const char *p = cur;
+  for (size_t i = 0; i < n; i++) {
+    readText(p, end, out[i]);
+  }
+  cur = p;
+}
+
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Action> &out) {
+  const char *p = cur;
+  size_t size = out.size();
+  out.reserve(size + n);
+  try {
+    for (size_t i = 0; i < n; i++) {
+      Action item;
+      readText(p, end, item);
+      out.push_back(std::move(item));
+    }
+  }
+  catch (...) {
+    out.erase(out.begin() + size, out.end());
+    throw;
+  }
+  cur = p;
+}
+
 std::ostream &operator<<(std::ostream &os, const Action &obj) {
   switch (obj.type) {
   case Action::Move_t:
@@ -53,7 +217,41 @@ std::ostream &operator<<(std::ostream &os, const Action &obj) {
     os << "WAIT";
   break;
   default:
-    break;  }
+    break;
+  }
   return os;
 }
 
+void writeText(gm::OutputBuffer &os, const Action &obj) {
+  switch (obj.type) {
+  case Action::Move_t:
+    os << "MOVE " << obj.data.Move.dir << "";
+  break;
+  case Action::Shoot_t:
+    os << "SHOOT " << obj.data.Shoot.dir << " " << obj.data.Shoot.strength << "";
+  break;
+  case Action::Wait_t:
+    os << "WAIT";
+  break;
+  default:
+    break;
+  }
+}
+
+void randomize(gm::Rng &rng, Action &obj) {
+  switch (rng.below(3)) {
+  case 0:
+    obj.type = Action::Move_t;
+    randomize(rng, obj.data.Move.dir);
+    break;
+  case 1:
+    obj.type = Action::Shoot_t;
+    randomize(rng, obj.data.Shoot.dir);
+    randomize(rng, obj.data.Shoot.strength);
+    break;
+  case 2:
+    obj.type = Action::Wait_t;
+    break;
+  }
+}
+
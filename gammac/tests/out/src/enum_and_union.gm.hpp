@@ -3,14 +3,27 @@
 
 #include <istream>
 #include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "gamma/io.hpp"
+#include "gamma/out.hpp"
+#include "gamma/random.hpp"
+#include "gamma/text.hpp"
 
 enum class Direction {
   N, E, S, W, 
 };
 
 std::istream &operator>>(std::istream &is, Direction &obj);
+void readText(const char *&cur, const char *end, Direction &obj);
+void readMany(const char *&cur, const char *end, size_t n, Direction *out);
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Direction> &out);
 
 std::ostream &operator<<(std::ostream &os, const Direction &obj);
+void writeText(gm::OutputBuffer &os, const Direction &obj);
+
+void randomize(gm::Rng &rng, Direction &obj);
 
 struct Action {
   enum Type {
@@ -26,30 +39,72 @@ struct Action {
     Direction dir;
     int strength;
   };
-  union {
+  struct Wait_d {
+  };
+  union Data {
+    constexpr Data() noexcept: Move() {}
+    constexpr Data(Move_d Move) noexcept: Move(Move) {}
+    constexpr Data(Shoot_d Shoot) noexcept: Shoot(Shoot) {}
+    constexpr Data(Wait_d Wait) noexcept: Wait(Wait) {}
     Move_d Move;
     Shoot_d Shoot;
+    Wait_d Wait;
   } data;
-  Action(Type type = Undef): type(type) {}
-  static Action Move(Direction dir) {
-    Action obj(Move_t);
-    obj.data.Move.dir = dir;
-    return obj;
+  constexpr Action(Type type = Undef) noexcept: type(type), data() {}
+  constexpr Action(Type type, Data data) noexcept: type(type), data(data) {}
+  static constexpr Action Move(Direction dir) noexcept {
+    return Action(Move_t, Move_d{dir});
   }
-  static Action Shoot(Direction dir, int strength) {
-    Action obj(Shoot_t);
-    obj.data.Shoot.dir = dir;
-    obj.data.Shoot.strength = strength;
-    return obj;
+  static constexpr Action Shoot(Direction dir, int strength) noexcept {
+    return Action(Shoot_t, Shoot_d{dir, strength});
   }
-  static Action Wait() {
-    Action obj(Wait_t);
-    return obj;
+  static constexpr Action Wait() noexcept {
+    return Action(Wait_t, Wait_d{});
   }
   bool operator==(const Action &other) const;
 };
 
+template <typename Visitor>
+auto visit(const Action &obj, Visitor &&vis) -> decltype(vis(obj.data.Move)) {
+  switch (obj.type) {
+  case Action::Move_t:
+    return vis(obj.data.Move);
+  case Action::Shoot_t:
+    return vis(obj.data.Shoot);
+  case Action::Wait_t:
+    return vis(obj.data.Wait);
+  default:
+    throw std::invalid_argument("visit: undefined Action");
+  }
+}
+
+template <typename Visitor>
+auto visit(Action &obj, Visitor &&vis) -> decltype(vis(obj.data.Move)) {
+  switch (obj.type) {
+  case Action::Move_t:
+    return vis(obj.data.Move);
+  case Action::Shoot_t:
+    return vis(obj.data.Shoot);
+  case Action::Wait_t:
+    return vis(obj.data.Wait);
+  default:
+    throw std::invalid_argument("visit: undefined Action");
+  }
+}
+
+static_assert(std::is_trivially_copyable<Action>::value, "Action must be trivially copyable");
+static_assert(sizeof(Action::Move_d) == sizeof(Direction), "Action::Move_d must have no padding");
+static_assert(sizeof(Action::Shoot_d) == sizeof(Direction) + sizeof(int), "Action::Shoot_d must have no padding");
+
+std::istream &operator>>(std::istream &is, Action &obj);
+void readText(const char *&cur, const char *end, Action &obj);
+void readMany(const char *&cur, const char *end, size_t n, Action *out);
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Action> &out);
+
 std::ostream &operator<<(std::ostream &os, const Action &obj);
+void writeText(gm::OutputBuffer &os, const Action &obj);
+
+void randomize(gm::Rng &rng, Action &obj);
 
 
 #endif
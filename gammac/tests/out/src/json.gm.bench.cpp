@@ -0,0 +1,242 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "gamma/containers.hpp"
+#include "gamma/optional.hpp"
+#include "gamma/random.hpp"
+
+#include "src/json.gm.hpp"
+
+// Generated by gammac --emit-bench; usage: <program> [count]
+
+template <typename T>
+static inline void writeInput(std::ostream &os, const T &value) { os << value; }
+static inline void writeInput(std::ostream &os, int8_t value) { os << static_cast<int>(value); }
+static inline void writeInput(std::ostream &os, uint8_t value) { os << static_cast<int>(value); }
+template <typename T, size_t N>
+static inline void writeInput(std::ostream &os, const gm::Array<T, N> &value);
+template <typename T, size_t N>
+static inline void writeInput(std::ostream &os, const gm::SmallVec<T, N> &value);
+template <typename T>
+static inline void writeInput(std::ostream &os, const gm::Vec<T> &value);
+template <typename T, typename Niche>
+static inline void writeInput(std::ostream &os, const gm::Optional<T, Niche> &value);
+
+template <typename Container>
+static inline void writeInputItems(std::ostream &os, const Container &value) {
+  for (const auto &item : value) {
+    os << ' ';
+    writeInput(os, item);
+  }
+}
+
+template <typename T, size_t N>
+static inline void writeInput(std::ostream &os, const gm::Array<T, N> &value) {
+  writeInput(os, value[0]);
+  for (size_t i = 1; i < N; i++) {
+    os << ' ';
+    writeInput(os, value[i]);
+  }
+}
+
+template <typename T, size_t N>
+static inline void writeInput(std::ostream &os, const gm::SmallVec<T, N> &value) {
+  os << value.size();
+  writeInputItems(os, value);
+}
+
+template <typename T>
+static inline void writeInput(std::ostream &os, const gm::Vec<T> &value) {
+  os << value.size();
+  writeInputItems(os, value);
+}
+
+template <typename T, typename Niche>
+static inline void writeInput(std::ostream &os, const gm::Optional<T, Niche> &value) {
+  if (value.has_value()) {
+    writeInput(os, *value);
+  }
+  else {
+    os << '-';
+  }
+}
+
+typedef std::chrono::steady_clock BenchClock;
+
+static void report(const char *type, const char *trait, BenchClock::time_point start, size_t count, size_t bytes) {
+  double ns = std::chrono::duration<double, std::nano>(BenchClock::now() - start).count();
+  if (bytes > 0) {
+    std::printf("%-20s %-8s %10.1f ns/op %10.1f MB/s\n", type, trait, ns / count, bytes * 1e3 / ns);
+  }
+  else {
+    std::printf("%-20s %-8s %10.1f ns/op\n", type, trait, ns / count);
+  }
+}
+
+static inline void randomize(gm::Rng &rng, Team &obj) {
+  obj = static_cast<Team>(rng.below(3));
+}
+
+static void benchTeam(size_t count) {
+  gm::Rng rng(2644135228269934348ULL);
+  std::vector<Team> values(count);
+  for (auto &value : values) {
+    randomize(rng, value);
+  }
+  {
+    std::string text;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      writeJson(text, value);
+      text += '\n';
+    }
+    report("Team", "Json out", start, count, text.size());
+    std::vector<Team> parsed(count);
+    const char *cur = text.data();
+    start = BenchClock::now();
+    for (auto &value : parsed) {
+      readJson(cur, text.data() + text.size(), value);
+    }
+    report("Team", "Json in", start, count, text.size());
+  }
+}
+
+static inline void randomize(gm::Rng &rng, Point &obj) {
+  randomize(rng, obj.x);
+  randomize(rng, obj.y);
+}
+
+static void benchPoint(size_t count) {
+  gm::Rng rng(9962967977086807313ULL);
+  std::vector<Point> values(count);
+  for (auto &value : values) {
+    randomize(rng, value);
+  }
+  {
+    std::vector<Point> copies(values);
+    size_t equal = 0;
+    auto start = BenchClock::now();
+    for (size_t i = 0; i < count; i++) {
+      equal += values[i] == copies[i];
+    }
+    report("Point", "Eq", start, count, 0);
+    if (equal != count) {
+      std::printf("%s: copies differ\n", "Point");
+    }
+  }
+  {
+    std::string text;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      writeJson(text, value);
+      text += '\n';
+    }
+    report("Point", "Json out", start, count, text.size());
+    std::vector<Point> parsed(count);
+    const char *cur = text.data();
+    start = BenchClock::now();
+    for (auto &value : parsed) {
+      readJson(cur, text.data() + text.size(), value);
+    }
+    report("Point", "Json in", start, count, text.size());
+  }
+}
+
+static inline void randomize(gm::Rng &rng, Command &obj) {
+  switch (rng.below(3)) {
+  case 0:
+    obj.type = Command::Goto_t;
+    randomize(rng, obj.data.Goto.target);
+    randomize(rng, obj.data.Goto.speed);
+    break;
+  case 1:
+    obj.type = Command::Say_t;
+    randomize(rng, obj.data.Say.team);
+    break;
+  case 2:
+    obj.type = Command::Stop_t;
+    break;
+  }
+}
+
+static void benchCommand(size_t count) {
+  gm::Rng rng(10081915271799181938ULL);
+  std::vector<Command> values(count);
+  for (auto &value : values) {
+    randomize(rng, value);
+  }
+  {
+    std::vector<Command> copies(values);
+    size_t equal = 0;
+    auto start = BenchClock::now();
+    for (size_t i = 0; i < count; i++) {
+      equal += values[i] == copies[i];
+    }
+    report("Command", "Eq", start, count, 0);
+    if (equal != count) {
+      std::printf("%s: copies differ\n", "Command");
+    }
+  }
+  {
+    std::string text;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      writeJson(text, value);
+      text += '\n';
+    }
+    report("Command", "Json out", start, count, text.size());
+    std::vector<Command> parsed(count);
+    const char *cur = text.data();
+    start = BenchClock::now();
+    for (auto &value : parsed) {
+      readJson(cur, text.data() + text.size(), value);
+    }
+    report("Command", "Json in", start, count, text.size());
+  }
+}
+
+static inline void randomize(gm::Rng &rng, Soldier &obj) {
+  randomize(rng, obj.name);
+  randomize(rng, obj.team);
+  randomize(rng, obj.alive);
+  randomize(rng, obj.hp);
+  randomize(rng, obj.ratio);
+  randomize(rng, obj.command);
+}
+
+static void benchSoldier(size_t count) {
+  gm::Rng rng(2958920241051566421ULL);
+  std::vector<Soldier> values(count);
+  for (auto &value : values) {
+    randomize(rng, value);
+  }
+  {
+    std::string text;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      writeJson(text, value);
+      text += '\n';
+    }
+    report("Soldier", "Json out", start, count, text.size());
+    std::vector<Soldier> parsed(count);
+    const char *cur = text.data();
+    start = BenchClock::now();
+    for (auto &value : parsed) {
+      readJson(cur, text.data() + text.size(), value);
+    }
+    report("Soldier", "Json in", start, count, text.size());
+  }
+}
+
+int main(int argc, char *argv[]) {
+  size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+  benchTeam(count);
+  benchPoint(count);
+  benchCommand(count);
+  benchSoldier(count);
+  return 0;
+}
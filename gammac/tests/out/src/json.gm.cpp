@@ -0,0 +1,282 @@
+#include <cstring>
+
+#include "src/json.gm.hpp"
+
+static const char *const kTeamToJson[] = {
+  "\"red\"", "\"blue\"", "\"-\"", 
+};
+
+void writeJson(std::string &out, const Team &obj) {
+  out += kTeamToJson[static_cast<size_t>(obj)];
+}
+
+void readJson(const char *&cur, const char *end, Team &obj) {
+  const char *key;
+  size_t length;
+  gm::json::readRawString(cur, end, key, length);
+  switch (length) {
+  case 1:
+    if (std::memcmp(key, "-", 1) == 0) {
+      obj = Team::NONE;
+      return;
+    }
+    break;
+  case 3:
+    if (std::memcmp(key, "red", 3) == 0) {
+      obj = Team::RED;
+      return;
+    }
+    break;
+  case 4:
+    if (std::memcmp(key, "blue", 4) == 0) {
+      obj = Team::BLUE;
+      return;
+    }
+    break;
+  }
+  gm::json::error("invalid Team");
+}
+
+bool Point::operator==(const Point &other) const {
+  return std::memcmp(this, &other, sizeof(Point)) == 0;
+}
+
+void writeJson(std::string &out, const Point &obj) {
+  out += "{\"x\":";
+  gm::writeJson(out, obj.x);
+  out += ",\"y\":";
+  gm::writeJson(out, obj.y);
+  out += '}';
+}
+
+void readJson(const char *&cur, const char *end, Point &obj) {
+  gm::json::expect(cur, end, '{');
+  if (gm::json::consume(cur, end, '}')) {
+    return;
+  }
+  const char *key;
+  size_t length;
+  do {
+    gm::json::readKey(cur, end, key, length);
+    switch (length) {
+    case 1:
+      if (std::memcmp(key, "x", 1) == 0) {
+        gm::readJson(cur, end, obj.x);
+        continue;
+      }
+      if (std::memcmp(key, "y", 1) == 0) {
+        gm::readJson(cur, end, obj.y);
+        continue;
+      }
+      break;
+    }
+    gm::json::skipValue(cur, end);
+  } while (gm::json::next(cur, end, '}'));
+}
+
+bool Command::operator==(const Command &other) const {
+  if (type != other.type) return false;
+  switch (type) {
+  case Command::Goto_t:
+    return data.Goto.target == other.data.Goto.target
+      && data.Goto.speed == other.data.Goto.speed;
+  break;
+  case Command::Say_t:
+    return std::memcmp(&data.Say, &other.data.Say, sizeof(Say_d)) == 0;
+  default:
+    return true;
+  }
+}
+
+static void writeJson(std::string &out, const Command::Goto_d &obj) {
+  out += "{\"target\":";
+  writeJson(out, obj.target);
+  out += ",\"speed\":";
+  gm::writeJson(out, obj.speed);
+  out += '}';
+}
+
+static void readJson(const char *&cur, const char *end, Command::Goto_d &obj) {
+  gm::json::expect(cur, end, '{');
+  if (gm::json::consume(cur, end, '}')) {
+    return;
+  }
+  const char *key;
+  size_t length;
+  do {
+    gm::json::readKey(cur, end, key, length);
+    switch (length) {
+    case 5:
+      if (std::memcmp(key, "speed", 5) == 0) {
+        gm::readJson(cur, end, obj.speed);
+        continue;
+      }
+      break;
+    case 6:
+      if (std::memcmp(key, "target", 6) == 0) {
+        readJson(cur, end, obj.target);
+        continue;
+      }
+      break;
+    }
+    gm::json::skipValue(cur, end);
+  } while (gm::json::next(cur, end, '}'));
+}
+
+static void writeJson(std::string &out, const Command::Say_d &obj) {
+  out += "{\"team\":";
+  writeJson(out, obj.team);
+  out += '}';
+}
+
+static void readJson(const char *&cur, const char *end, Command::Say_d &obj) {
+  gm::json::expect(cur, end, '{');
+  if (gm::json::consume(cur, end, '}')) {
+    return;
+  }
+  const char *key;
+  size_t length;
+  do {
+    gm::json::readKey(cur, end, key, length);
+    switch (length) {
+    case 4:
+      if (std::memcmp(key, "team", 4) == 0) {
+        readJson(cur, end, obj.team);
+        continue;
+      }
+      break;
+    }
+    gm::json::skipValue(cur, end);
+  } while (gm::json::next(cur, end, '}'));
+}
+
+static void writeJson(std::string &out, const Command::Stop_d &) {
+  out += "{}";
+}
+
+static void readJson(const char *&cur, const char *end, Command::Stop_d &) {
+  gm::json::skipValue(cur, end);
+}
+
+void writeJson(std::string &out, const Command &obj) {
+  switch (obj.type) {
+  case Command::Goto_t:
+    out += "{\"Goto\":";
+    writeJson(out, obj.data.Goto);
+    out += '}';
+    break;
+  case Command::Say_t:
+    out += "{\"Say\":";
+    writeJson(out, obj.data.Say);
+    out += '}';
+    break;
+  case Command::Stop_t:
+    out += "{\"Stop\":";
+    writeJson(out, obj.data.Stop);
+    out += '}';
+    break;
+  default:
+    out += "null";
+    break;
+  }
+}
+
+void readJson(const char *&cur, const char *end, Command &obj) {
+  if (gm::json::consumeNull(cur, end)) {
+    obj.type = Command::Undef;
+    return;
+  }
+  gm::json::expect(cur, end, '{');
+  const char *key;
+  size_t length;
+  gm::json::readKey(cur, end, key, length);
+  switch (length) {
+  case 3:
+    if (std::memcmp(key, "Say", 3) == 0) {
+      obj.type = Command::Say_t;
+      readJson(cur, end, obj.data.Say);
+      gm::json::expect(cur, end, '}');
+      return;
+    }
+    break;
+  case 4:
+    if (std::memcmp(key, "Goto", 4) == 0) {
+      obj.type = Command::Goto_t;
+      readJson(cur, end, obj.data.Goto);
+      gm::json::expect(cur, end, '}');
+      return;
+    }
+    if (std::memcmp(key, "Stop", 4) == 0) {
+      obj.type = Command::Stop_t;
+      readJson(cur, end, obj.data.Stop);
+      gm::json::expect(cur, end, '}');
+      return;
+    }
+    break;
+  }
+  gm::json::error("invalid Command");
+}
+
+void writeJson(std::string &out, const Soldier &obj) {
+  out += "{\"name\":";
+  gm::writeJson(out, obj.name);
+  out += ",\"team\":";
+  writeJson(out, obj.team);
+  out += ",\"alive\":";
+  gm::writeJson(out, obj.alive);
+  out += ",\"hp\":";
+  gm::writeJson(out, obj.hp);
+  out += ",\"ratio\":";
+  gm::writeJson(out, obj.ratio);
+  out += ",\"command\":";
+  writeJson(out, obj.command);
+  out += '}';
+}
+
+void readJson(const char *&cur, const char *end, Soldier &obj) {
+  gm::json::expect(cur, end, '{');
+  if (gm::json::consume(cur, end, '}')) {
+    return;
+  }
+  const char *key;
+  size_t length;
+  do {
+    gm::json::readKey(cur, end, key, length);
+    switch (length) {
+    case 2:
+      if (std::memcmp(key, "hp", 2) == 0) {
+        gm::readJson(cur, end, obj.hp);
+        continue;
+      }
+      break;
+    case 4:
+      if (std::memcmp(key, "name", 4) == 0) {
+        gm::readJson(cur, end, obj.name);
+        continue;
+      }
+      if (std::memcmp(key, "team", 4) == 0) {
+        readJson(cur, end, obj.team);
+        continue;
+      }
+      break;
+    case 5:
+      if (std::memcmp(key, "alive", 5) == 0) {
+        gm::readJson(cur, end, obj.alive);
+        continue;
+      }
+      if (std::memcmp(key, "ratio", 5) == 0) {
+        gm::readJson(cur, end, obj.ratio);
+        continue;
+      }
+      break;
+    case 7:
+      if (std::memcmp(key, "command", 7) == 0) {
+        readJson(cur, end, obj.command);
+        continue;
+      }
+      break;
+    }
+    gm::json::skipValue(cur, end);
+  } while (gm::json::next(cur, end, '}'));
+}
+
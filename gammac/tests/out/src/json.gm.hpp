@@ -0,0 +1,119 @@
+#ifndef src_json_gm__
+#define src_json_gm__
+
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "gamma/json.hpp"
+
+enum class Team {
+  RED, BLUE, NONE, 
+};
+
+void writeJson(std::string &out, const Team &obj);
+void readJson(const char *&cur, const char *end, Team &obj);
+
+struct Point {
+  Point() = default;
+  constexpr Point(int x, int y) noexcept: x(x), y(y) {}
+  int x;
+  int y;
+  bool operator==(const Point &other) const;
+};
+
+static_assert(std::is_trivially_copyable<Point>::value, "Point must be trivially copyable");
+static_assert(sizeof(Point) == sizeof(int) + sizeof(int), "Point must have no padding");
+
+void writeJson(std::string &out, const Point &obj);
+void readJson(const char *&cur, const char *end, Point &obj);
+
+struct Command {
+  enum Type {
+    Undef,
+    Goto_t,
+    Say_t,
+    Stop_t,
+  } type;
+  struct Goto_d {
+    Point target;
+    double speed;
+  };
+  struct Say_d {
+    Team team;
+  };
+  struct Stop_d {
+  };
+  union Data {
+    constexpr Data() noexcept: Goto() {}
+    constexpr Data(Goto_d Goto) noexcept: Goto(Goto) {}
+    constexpr Data(Say_d Say) noexcept: Say(Say) {}
+    constexpr Data(Stop_d Stop) noexcept: Stop(Stop) {}
+    Goto_d Goto;
+    Say_d Say;
+    Stop_d Stop;
+  } data;
+  constexpr Command(Type type = Undef) noexcept: type(type), data() {}
+  constexpr Command(Type type, Data data) noexcept: type(type), data(data) {}
+  static constexpr Command Goto(Point target, double speed) noexcept {
+    return Command(Goto_t, Goto_d{target, speed});
+  }
+  static constexpr Command Say(Team team) noexcept {
+    return Command(Say_t, Say_d{team});
+  }
+  static constexpr Command Stop() noexcept {
+    return Command(Stop_t, Stop_d{});
+  }
+  bool operator==(const Command &other) const;
+};
+
+template <typename Visitor>
+auto visit(const Command &obj, Visitor &&vis) -> decltype(vis(obj.data.Goto)) {
+  switch (obj.type) {
+  case Command::Goto_t:
+    return vis(obj.data.Goto);
+  case Command::Say_t:
+    return vis(obj.data.Say);
+  case Command::Stop_t:
+    return vis(obj.data.Stop);
+  default:
+    throw std::invalid_argument("visit: undefined Command");
+  }
+}
+
+template <typename Visitor>
+auto visit(Command &obj, Visitor &&vis) -> decltype(vis(obj.data.Goto)) {
+  switch (obj.type) {
+  case Command::Goto_t:
+    return vis(obj.data.Goto);
+  case Command::Say_t:
+    return vis(obj.data.Say);
+  case Command::Stop_t:
+    return vis(obj.data.Stop);
+  default:
+    throw std::invalid_argument("visit: undefined Command");
+  }
+}
+
+static_assert(std::is_trivially_copyable<Command>::value, "Command must be trivially copyable");
+static_assert(sizeof(Command::Say_d) == sizeof(Team), "Command::Say_d must have no padding");
+
+void writeJson(std::string &out, const Command &obj);
+void readJson(const char *&cur, const char *end, Command &obj);
+
+struct Soldier {
+  Soldier() = default;
+  Soldier(std::string name, Team team, bool alive, int hp, double ratio, Command command) noexcept(std::is_nothrow_move_constructible<std::string>::value): name(std::move(name)), team(team), alive(alive), hp(hp), ratio(ratio), command(command) {}
+  std::string name;
+  Team team;
+  bool alive;
+  int hp;
+  double ratio;
+  Command command;
+};
+
+void writeJson(std::string &out, const Soldier &obj);
+void readJson(const char *&cur, const char *end, Soldier &obj);
+
+
+#endif
@@ -0,0 +1,409 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "gamma/containers.hpp"
+#include "gamma/optional.hpp"
+#include "gamma/random.hpp"
+#include "gamma/random_containers.hpp"
+#include "gamma/random_optional.hpp"
+
+#include "src/optional.gm.hpp"
+
+// Generated by gammac --emit-bench; usage: <program> [count]
+
+template <typename T>
+static inline void writeInput(std::ostream &os, const T &value) { os << value; }
+static inline void writeInput(std::ostream &os, int8_t value) { os << static_cast<int>(value); }
+static inline void writeInput(std::ostream &os, uint8_t value) { os << static_cast<int>(value); }
+template <typename T, size_t N>
+static inline void writeInput(std::ostream &os, const gm::Array<T, N> &value);
+template <typename T, size_t N>
+static inline void writeInput(std::ostream &os, const gm::SmallVec<T, N> &value);
+template <typename T>
+static inline void writeInput(std::ostream &os, const gm::Vec<T> &value);
+template <typename T, typename Niche>
+static inline void writeInput(std::ostream &os, const gm::Optional<T, Niche> &value);
+
+template <typename Container>
+static inline void writeInputItems(std::ostream &os, const Container &value) {
+  for (const auto &item : value) {
+    os << ' ';
+    writeInput(os, item);
+  }
+}
+
+template <typename T, size_t N>
+static inline void writeInput(std::ostream &os, const gm::Array<T, N> &value) {
+  writeInput(os, value[0]);
+  for (size_t i = 1; i < N; i++) {
+    os << ' ';
+    writeInput(os, value[i]);
+  }
+}
+
+template <typename T, size_t N>
+static inline void writeInput(std::ostream &os, const gm::SmallVec<T, N> &value) {
+  os << value.size();
+  writeInputItems(os, value);
+}
+
+template <typename T>
+static inline void writeInput(std::ostream &os, const gm::Vec<T> &value) {
+  os << value.size();
+  writeInputItems(os, value);
+}
+
+template <typename T, typename Niche>
+static inline void writeInput(std::ostream &os, const gm::Optional<T, Niche> &value) {
+  if (value.has_value()) {
+    writeInput(os, *value);
+  }
+  else {
+    os << '-';
+  }
+}
+
+typedef std::chrono::steady_clock BenchClock;
+
+static void report(const char *type, const char *trait, BenchClock::time_point start, size_t count, size_t bytes) {
+  double ns = std::chrono::duration<double, std::nano>(BenchClock::now() - start).count();
+  if (bytes > 0) {
+    std::printf("%-20s %-8s %10.1f ns/op %10.1f MB/s\n", type, trait, ns / count, bytes * 1e3 / ns);
+  }
+  else {
+    std::printf("%-20s %-8s %10.1f ns/op\n", type, trait, ns / count);
+  }
+}
+
+static inline void writeInput(std::ostream &os, const Mood &obj) {
+  static const char *const formats[] = {
+    "CALM", "ANGRY", 
+  };
+  os << formats[static_cast<size_t>(obj)];
+}
+
+static void benchMood(size_t count) {
+  gm::Rng rng(4029309544695393182ULL);
+  std::vector<Mood> values(count);
+  for (auto &value : values) {
+    randomize(rng, value);
+  }
+  {
+    std::ostringstream os;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      os << value << '\n';
+    }
+    report("Mood", "Out", start, count, os.str().size());
+  }
+  {
+    std::ostringstream os;
+    for (const auto &value : values) {
+      writeInput(os, value);
+      os << '\n';
+    }
+    std::string text = os.str();
+    std::vector<Mood> parsed;
+    const char *cur = text.data();
+    auto start = BenchClock::now();
+    readMany(cur, text.data() + text.size(), count, parsed);
+    report("Mood", "In", start, count, text.size());
+  }
+  {
+    std::vector<uint8_t> buffer(count * kMoodBinSize);
+    uint8_t *out = buffer.data();
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      encode(out, value);
+    }
+    report("Mood", "Bin out", start, count, buffer.size());
+    std::vector<Mood> decoded(count);
+    const uint8_t *in = buffer.data();
+    start = BenchClock::now();
+    for (auto &value : decoded) {
+      decode(in, value);
+    }
+    report("Mood", "Bin in", start, count, buffer.size());
+  }
+  {
+    std::string text;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      writeJson(text, value);
+      text += '\n';
+    }
+    report("Mood", "Json out", start, count, text.size());
+    std::vector<Mood> parsed(count);
+    const char *cur = text.data();
+    start = BenchClock::now();
+    for (auto &value : parsed) {
+      readJson(cur, text.data() + text.size(), value);
+    }
+    report("Mood", "Json in", start, count, text.size());
+  }
+}
+
+static inline void writeInput(std::ostream &os, const Pet &obj) {
+  writeInput(os, obj.mood);
+  os << ' ';
+  writeInput(os, obj.age);
+  os << ' ';
+  writeInput(os, obj.weight);
+  os << ' ';
+  writeInput(os, obj.tag);
+}
+
+static void benchPet(size_t count) {
+  gm::Rng rng(10215729770904393694ULL);
+  std::vector<Pet> values(count);
+  for (auto &value : values) {
+    randomize(rng, value);
+  }
+  {
+    std::ostringstream os;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      os << value << '\n';
+    }
+    report("Pet", "Out", start, count, os.str().size());
+  }
+  {
+    std::ostringstream os;
+    for (const auto &value : values) {
+      writeInput(os, value);
+      os << '\n';
+    }
+    std::string text = os.str();
+    std::vector<Pet> parsed;
+    const char *cur = text.data();
+    auto start = BenchClock::now();
+    readMany(cur, text.data() + text.size(), count, parsed);
+    report("Pet", "In", start, count, text.size());
+  }
+  {
+    std::vector<Pet> copies(values);
+    size_t equal = 0;
+    auto start = BenchClock::now();
+    for (size_t i = 0; i < count; i++) {
+      equal += values[i] == copies[i];
+    }
+    report("Pet", "Eq", start, count, 0);
+    if (equal != count) {
+      std::printf("%s: copies differ\n", "Pet");
+    }
+  }
+  {
+    std::vector<uint8_t> buffer(count * kPetBinSize);
+    uint8_t *out = buffer.data();
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      encode(out, value);
+    }
+    report("Pet", "Bin out", start, count, buffer.size());
+    std::vector<Pet> decoded(count);
+    const uint8_t *in = buffer.data();
+    start = BenchClock::now();
+    for (auto &value : decoded) {
+      decode(in, value);
+    }
+    report("Pet", "Bin in", start, count, buffer.size());
+  }
+  {
+    std::string text;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      writeJson(text, value);
+      text += '\n';
+    }
+    report("Pet", "Json out", start, count, text.size());
+    std::vector<Pet> parsed(count);
+    const char *cur = text.data();
+    start = BenchClock::now();
+    for (auto &value : parsed) {
+      readJson(cur, text.data() + text.size(), value);
+    }
+    report("Pet", "Json in", start, count, text.size());
+  }
+}
+
+static inline void writeInput(std::ostream &os, const Trick &obj) {
+  switch (obj.type) {
+  case Trick::Walk_t:
+    os << "Walk";
+    os << ' ';
+    writeInput(os, obj.data.Walk.steps);
+    break;
+  case Trick::Sit_t:
+    os << "Sit";
+    break;
+  default:
+    break;
+  }
+}
+
+static void benchTrick(size_t count) {
+  gm::Rng rng(16415805417134730596ULL);
+  std::vector<Trick> values(count);
+  for (auto &value : values) {
+    randomize(rng, value);
+  }
+  {
+    std::ostringstream os;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      os << value << '\n';
+    }
+    report("Trick", "Out", start, count, os.str().size());
+  }
+  {
+    std::ostringstream os;
+    for (const auto &value : values) {
+      writeInput(os, value);
+      os << '\n';
+    }
+    std::string text = os.str();
+    std::vector<Trick> parsed;
+    const char *cur = text.data();
+    auto start = BenchClock::now();
+    readMany(cur, text.data() + text.size(), count, parsed);
+    report("Trick", "In", start, count, text.size());
+  }
+  {
+    std::vector<Trick> copies(values);
+    size_t equal = 0;
+    auto start = BenchClock::now();
+    for (size_t i = 0; i < count; i++) {
+      equal += values[i] == copies[i];
+    }
+    report("Trick", "Eq", start, count, 0);
+    if (equal != count) {
+      std::printf("%s: copies differ\n", "Trick");
+    }
+  }
+  {
+    std::vector<uint8_t> buffer(count * kTrickBinSize);
+    uint8_t *out = buffer.data();
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      encode(out, value);
+    }
+    report("Trick", "Bin out", start, count, buffer.size());
+    std::vector<Trick> decoded(count);
+    const uint8_t *in = buffer.data();
+    start = BenchClock::now();
+    for (auto &value : decoded) {
+      decode(in, value);
+    }
+    report("Trick", "Bin in", start, count, buffer.size());
+  }
+  {
+    std::string text;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      writeJson(text, value);
+      text += '\n';
+    }
+    report("Trick", "Json out", start, count, text.size());
+    std::vector<Trick> parsed(count);
+    const char *cur = text.data();
+    start = BenchClock::now();
+    for (auto &value : parsed) {
+      readJson(cur, text.data() + text.size(), value);
+    }
+    report("Trick", "Json in", start, count, text.size());
+  }
+}
+
+static inline void writeInput(std::ostream &os, const Leash &obj) {
+  writeInput(os, obj.next);
+  os << ' ';
+  writeInput(os, obj.length);
+  os << ' ';
+  writeInput(os, obj.knots);
+}
+
+static void benchLeash(size_t count) {
+  gm::Rng rng(1850400118131483882ULL);
+  std::vector<Leash> values(count);
+  for (auto &value : values) {
+    randomize(rng, value);
+  }
+  {
+    std::ostringstream os;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      os << value << '\n';
+    }
+    report("Leash", "Out", start, count, os.str().size());
+  }
+  {
+    std::ostringstream os;
+    for (const auto &value : values) {
+      writeInput(os, value);
+      os << '\n';
+    }
+    std::string text = os.str();
+    std::vector<Leash> parsed;
+    const char *cur = text.data();
+    auto start = BenchClock::now();
+    readMany(cur, text.data() + text.size(), count, parsed);
+    report("Leash", "In", start, count, text.size());
+  }
+  {
+    std::vector<Leash> copies(values);
+    size_t equal = 0;
+    auto start = BenchClock::now();
+    for (size_t i = 0; i < count; i++) {
+      equal += values[i] == copies[i];
+    }
+    report("Leash", "Eq", start, count, 0);
+    if (equal != count) {
+      std::printf("%s: copies differ\n", "Leash");
+    }
+  }
+  {
+    std::vector<uint8_t> buffer(count * kLeashBinSize);
+    uint8_t *out = buffer.data();
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      encode(out, value);
+    }
+    report("Leash", "Bin out", start, count, buffer.size());
+    std::vector<Leash> decoded(count);
+    const uint8_t *in = buffer.data();
+    start = BenchClock::now();
+    for (auto &value : decoded) {
+      decode(in, value);
+    }
+    report("Leash", "Bin in", start, count, buffer.size());
+  }
+  {
+    std::string text;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      writeJson(text, value);
+      text += '\n';
+    }
+    report("Leash", "Json out", start, count, text.size());
+    std::vector<Leash> parsed(count);
+    const char *cur = text.data();
+    start = BenchClock::now();
+    for (auto &value : parsed) {
+      readJson(cur, text.data() + text.size(), value);
+    }
+    report("Leash", "Json in", start, count, text.size());
+  }
+}
+
+int main(int argc, char *argv[]) {
+  size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+  benchMood(count);
+  benchPet(count);
+  benchTrick(count);
+  benchLeash(count);
+  return 0;
+}
@@ -0,0 +1,758 @@
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include "gamma/profile.hpp"
+
+#include "src/optional.gm.hpp"
+
+#ifdef GAMMA_PROFILE
+static const char *const kMoodVariants[] = {
+  "CALM", "ANGRY", 
+};
+static uint64_t *const kMoodHits = gm::Profile::instance().add("Mood", kMoodVariants, 2);
+#endif
+
+static const std::map<std::string, Mood> kStrToMood {
+  {"CALM", Mood::CALM},
+  {"ANGRY", Mood::ANGRY},
+};
+
+std::istream &operator>>(std::istream &is, Mood &obj) {
+  std::string str;
+  is >> str;
+  obj = kStrToMood.at(str);
+  GM_PROFILE_HIT(kMoodHits, static_cast<size_t>(obj));
+  return is;
+}
+
+void readText(const char *&cur, const char *end, Mood &obj) {
+  const char *key;
+  size_t length;
+  gm::text::readToken(cur, end, key, length);
+  switch (length) {
+  case 4:
+    if (std::memcmp(key, "CALM", 4) == 0) {
+      obj = Mood::CALM;
+      GM_PROFILE_HIT(kMoodHits, static_cast<size_t>(Mood::CALM));
+      return;
+    }
+    break;
+  case 5:
+    if (std::memcmp(key, "ANGRY", 5) == 0) {
+      obj = Mood::ANGRY;
+      GM_PROFILE_HIT(kMoodHits, static_cast<size_t>(Mood::ANGRY));
+      return;
+    }
+    break;
+  }
+  gm::text::error("invalid Mood");
+}
+
+void readMany(const char *&cur, const char *end, size_t n, Mood *out) {
+  const char *p = cur;
+  for (size_t i = 0; i < n; i++) {
+    readText(p, end, out[i]);
+  }
+  cur = p;
+}
+
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Mood> &out) {
+  const char *p = cur;
+  size_t size = out.size();
+  out.reserve(size + n);
+  try {
+    for (size_t i = 0; i < n; i++) {
+      Mood item;
+      readText(p, end, item);
+      out.push_back(std::move(item));
+    }
+  }
+  catch (...) {
+    out.erase(out.begin() + size, out.end());
+    throw;
+  }
+  cur = p;
+}
+
+static const std::string kMoodToStr[] = {
+  "CALM", "ANGRY", 
+};
+
+std::ostream &operator<<(std::ostream &os, const Mood &obj) {
+  os << kMoodToStr[static_cast<size_t>(obj)];
+  return os;
+}
+
+void writeText(gm::OutputBuffer &os, const Mood &obj) {
+  os << kMoodToStr[static_cast<size_t>(obj)];
+}
+
+void encode(uint8_t *&out, const Mood &obj) {
+  gm::store<int32_t>(out, static_cast<int32_t>(obj));
+  out += 4;
+}
+
+void decode(const uint8_t *&in, Mood &obj) {
+  obj = static_cast<Mood>(gm::loadEnum(in, 2));
+  in += 4;
+}
+
+static const char *const kMoodToJson[] = {
+  "\"CALM\"", "\"ANGRY\"", 
+};
+
+void writeJson(std::string &out, const Mood &obj) {
+  out += kMoodToJson[static_cast<size_t>(obj)];
+}
+
+void readJson(const char *&cur, const char *end, Mood &obj) {
+  const char *key;
+  size_t length;
+  gm::json::readRawString(cur, end, key, length);
+  switch (length) {
+  case 4:
+    if (std::memcmp(key, "CALM", 4) == 0) {
+      obj = Mood::CALM;
+      return;
+    }
+    break;
+  case 5:
+    if (std::memcmp(key, "ANGRY", 5) == 0) {
+      obj = Mood::ANGRY;
+      return;
+    }
+    break;
+  }
+  gm::json::error("invalid Mood");
+}
+
+void randomize(gm::Rng &rng, Mood &obj) {
+  obj = static_cast<Mood>(rng.below(2));
+}
+
+bool Pet::operator==(const Pet &other) const {
+  return mood == other.mood
+      && age == other.age
+      && weight == other.weight
+      && tag == other.tag;
+}
+
+std::istream &operator>>(std::istream &is, Pet &obj) {
+  is >> obj.mood;
+  is >> obj.age;
+  is >> obj.weight;
+  is >> obj.tag;
+  return is;
+}
+
+void readText(const char *&cur, const char *end, Pet &obj) {
+  gm::readText(cur, end, obj.mood);
+  gm::readText(cur, end, obj.age);
+  gm::readText(cur, end, obj.weight);
+  gm::readText(cur, end, obj.tag);
+}
+
+void readMany(const char *&cur, const char *end, size_t n, Pet *out) {
+  const char *p = cur;
+  for (size_t i = 0; i < n; i++) {
+    readText(p, end, out[i]);
+  }
+  cur = p;
+}
+
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Pet> &out) {
+  const char *p = cur;
+  size_t size = out.size();
+  out.reserve(size + n);
+  try {
+    for (size_t i = 0; i < n; i++) {
+      Pet item;
+      readText(p, end, item);
+      out.push_back(std::move(item));
+    }
+  }
+  catch (...) {
+    out.erase(out.begin() + size, out.end());
+    throw;
+  }
+  cur = p;
+}
+
+std::ostream &operator<<(std::ostream &os, const Pet &obj) {
+  os << "{ ";
+  os << "mood" << ": " << obj.mood << ", ";
+  os << "age" << ": " << obj.age << ", ";
+  os << "weight" << ": " << obj.weight << ", ";
+  os << "tag" << ": " << obj.tag;
+  os << " }";
+  return os;
+}
+
+void writeText(gm::OutputBuffer &os, const Pet &obj) {
+  os << "{ ";
+  os << "mood" << ": " << obj.mood << ", ";
+  os << "age" << ": " << obj.age << ", ";
+  os << "weight" << ": " << obj.weight << ", ";
+  os << "tag" << ": " << obj.tag;
+  os << " }";
+}
+
+void encode(uint8_t *&out, const Pet &obj) {
+  gm::store<int32_t>(out, static_cast<int32_t>(obj.mood.raw()));
+  out += 4;
+  gm::store<int32_t>(out, obj.age.raw());
+  out += 4;
+  gm::store<uint8_t>(out, obj.weight.raw());
+  out += 1;
+  gm::store<uint8_t>(out, obj.weight.has_value());
+  out += 1;
+  gm::store<uint8_t>(out, static_cast<uint8_t>(obj.tag.raw().size()));
+  std::memcpy(out + 1, obj.tag.raw().data(), 3);
+  out += 4;
+  gm::store<uint8_t>(out, obj.tag.has_value());
+  out += 1;
+}
+
+void decode(const uint8_t *&in, Pet &obj) {
+  obj.mood.raw() = static_cast<Mood>(gm::loadEnum(in, 3));
+  in += 4;
+  obj.age.raw() = gm::load<int32_t>(in);
+  in += 4;
+  if (obj.age.has_value() && (obj.age.raw() < 0 || obj.age.raw() > 30)) {
+    throw std::runtime_error("Value out of range");
+  }
+  obj.weight.raw() = gm::load<uint8_t>(in);
+  in += 1;
+  obj.weight.flag() = gm::loadBool(in);
+  in += 1;
+  if (gm::load<uint8_t>(in) > 3) {
+    throw std::runtime_error("Invalid Str length");
+  }
+  obj.tag.raw().assign(reinterpret_cast<const char *>(in + 1), gm::load<uint8_t>(in));
+  in += 4;
+  obj.tag.flag() = gm::loadBool(in);
+  in += 1;
+}
+
+void writeJson(std::string &out, const Pet &obj) {
+  out += "{\"mood\":";
+  gm::writeJson(out, obj.mood);
+  out += ",\"age\":";
+  gm::writeJson(out, obj.age);
+  out += ",\"weight\":";
+  gm::writeJson(out, obj.weight);
+  out += ",\"tag\":";
+  gm::writeJson(out, obj.tag);
+  out += '}';
+}
+
+void readJson(const char *&cur, const char *end, Pet &obj) {
+  gm::json::expect(cur, end, '{');
+  if (gm::json::consume(cur, end, '}')) {
+    return;
+  }
+  const char *key;
+  size_t length;
+  do {
+    gm::json::readKey(cur, end, key, length);
+    switch (length) {
+    case 3:
+      if (std::memcmp(key, "age", 3) == 0) {
+        gm::readJson(cur, end, obj.age);
+        continue;
+      }
+      if (std::memcmp(key, "tag", 3) == 0) {
+        gm::readJson(cur, end, obj.tag);
+        continue;
+      }
+      break;
+    case 4:
+      if (std::memcmp(key, "mood", 4) == 0) {
+        gm::readJson(cur, end, obj.mood);
+        continue;
+      }
+      break;
+    case 6:
+      if (std::memcmp(key, "weight", 6) == 0) {
+        gm::readJson(cur, end, obj.weight);
+        continue;
+      }
+      break;
+    }
+    gm::json::skipValue(cur, end);
+  } while (gm::json::next(cur, end, '}'));
+}
+
+void randomize(gm::Rng &rng, Pet &obj) {
+  randomize(rng, obj.mood);
+  obj.age = rng.below(2) ? gm::Optional<int, gm::ValueNiche<int, 31, 0, 30>>(static_cast<int>(rng.below(31U))) : gm::Optional<int, gm::ValueNiche<int, 31, 0, 30>>();
+  randomize(rng, obj.weight);
+  randomize(rng, obj.tag);
+}
+
+Pet::Patch diff(const Pet &a, const Pet &b) {
+  Pet::Patch patch;
+  if (!(a.mood == b.mood)) {
+    patch.changed |= uint64_t(1) << Pet::mood_f;
+    patch.mood = b.mood;
+  }
+  if (!(a.age == b.age)) {
+    patch.changed |= uint64_t(1) << Pet::age_f;
+    patch.age = b.age;
+  }
+  if (!(a.weight == b.weight)) {
+    patch.changed |= uint64_t(1) << Pet::weight_f;
+    patch.weight = b.weight;
+  }
+  if (!(a.tag == b.tag)) {
+    patch.changed |= uint64_t(1) << Pet::tag_f;
+    patch.tag = b.tag;
+  }
+  return patch;
+}
+
+void apply(Pet &state, const Pet::Patch &patch) {
+  if (patch.has(Pet::mood_f)) {
+    state.mood = patch.mood;
+  }
+  if (patch.has(Pet::age_f)) {
+    state.age = patch.age;
+  }
+  if (patch.has(Pet::weight_f)) {
+    state.weight = patch.weight;
+  }
+  if (patch.has(Pet::tag_f)) {
+    state.tag = patch.tag;
+  }
+}
+
+void encode(uint8_t *&out, const Pet::Patch &patch) {
+  gm::store<uint8_t>(out, static_cast<uint8_t>(patch.changed));
+  out += 1;
+  if (patch.has(Pet::mood_f)) {
+    gm::store<int32_t>(out, static_cast<int32_t>(patch.mood.raw()));
+    out += 4;
+  }
+  if (patch.has(Pet::age_f)) {
+    gm::store<int32_t>(out, patch.age.raw());
+    out += 4;
+  }
+  if (patch.has(Pet::weight_f)) {
+    gm::store<uint8_t>(out, patch.weight.raw());
+    out += 1;
+    gm::store<uint8_t>(out, patch.weight.has_value());
+    out += 1;
+  }
+  if (patch.has(Pet::tag_f)) {
+    gm::store<uint8_t>(out, static_cast<uint8_t>(patch.tag.raw().size()));
+    std::memcpy(out + 1, patch.tag.raw().data(), 3);
+    out += 4;
+    gm::store<uint8_t>(out, patch.tag.has_value());
+    out += 1;
+  }
+}
+
+void decode(const uint8_t *&in, Pet::Patch &patch) {
+  patch.changed = gm::load<uint8_t>(in);
+  if (patch.changed & 0xfffffffffffffff0ULL) {
+    throw std::runtime_error("Invalid Pet patch");
+  }
+  in += 1;
+  if (patch.has(Pet::mood_f)) {
+    patch.mood.raw() = static_cast<Mood>(gm::loadEnum(in, 3));
+    in += 4;
+  }
+  if (patch.has(Pet::age_f)) {
+    patch.age.raw() = gm::load<int32_t>(in);
+    in += 4;
+    if (patch.age.has_value() && (patch.age.raw() < 0 || patch.age.raw() > 30)) {
+      throw std::runtime_error("Value out of range");
+    }
+  }
+  if (patch.has(Pet::weight_f)) {
+    patch.weight.raw() = gm::load<uint8_t>(in);
+    in += 1;
+    patch.weight.flag() = gm::loadBool(in);
+    in += 1;
+  }
+  if (patch.has(Pet::tag_f)) {
+    if (gm::load<uint8_t>(in) > 3) {
+      throw std::runtime_error("Invalid Str length");
+    }
+    patch.tag.raw().assign(reinterpret_cast<const char *>(in + 1), gm::load<uint8_t>(in));
+    in += 4;
+    patch.tag.flag() = gm::loadBool(in);
+    in += 1;
+  }
+}
+
+bool Trick::operator==(const Trick &other) const {
+  if (type != other.type) return false;
+  switch (type) {
+  case Trick::Walk_t:
+    return std::memcmp(&data.Walk, &other.data.Walk, sizeof(Walk_d)) == 0;
+  default:
+    return true;
+  }
+}
+
+#ifdef GAMMA_PROFILE
+static const char *const kTrickVariants[] = {
+  "Walk", "Sit", 
+};
+static uint64_t *const kTrickHits = gm::Profile::instance().add("Trick", kTrickVariants, 2);
+#endif
+
+std::istream &operator>>(std::istream &is, Trick &obj) {
+  std::string str;
+  if (!(is >> str)) {
+    return is;
+  }
+  if (str == "Walk") {
+    obj.type = Trick::Walk_t;
+    GM_PROFILE_HIT(kTrickHits, Trick::Walk_t - 1);
+    is >> obj.data.Walk.steps;
+  }
+  else if (str == "Sit") {
+    obj.type = Trick::Sit_t;
+    GM_PROFILE_HIT(kTrickHits, Trick::Sit_t - 1);
+  }
+  else {
+    throw std::runtime_error("Invalid Trick");
+  }
+  return is;
+}
+
+void readText(const char *&cur, const char *end, Trick &obj) {
+  const char *key;
+  size_t length;
+  gm::text::readToken(cur, end, key, length);
+  switch (length) {
+  case 3:
+    if (std::memcmp(key, "Sit", 3) == 0) {
+      obj.type = Trick::Sit_t;
+      GM_PROFILE_HIT(kTrickHits, Trick::Sit_t - 1);
+      return;
+    }
+    break;
+  case 4:
+    if (std::memcmp(key, "Walk", 4) == 0) {
+      obj.type = Trick::Walk_t;
+      GM_PROFILE_HIT(kTrickHits, Trick::Walk_t - 1);
+      gm::readText(cur, end, obj.data.Walk.steps);
+      return;
+    }
+    break;
+  }
+  gm::text::error("invalid Trick");
+}
+
+void readMany(const char *&cur, const char *end, size_t n, Trick *out) {
+  const char *p = cur;
+  for (size_t i = 0; i < n; i++) {
+    readText(p, end, out[i]);
+  }
+  cur = p;
+}
+
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Trick> &out) {
+  const char *p = cur;
+  size_t size = out.size();
+  out.reserve(size + n);
+  try {
+    for (size_t i = 0; i < n; i++) {
+      Trick item;
+      readText(p, end, item);
+      out.push_back(std::move(item));
+    }
+  }
+  catch (...) {
+    out.erase(out.begin() + size, out.end());
+    throw;
+  }
+  cur = p;
+}
+
+std::ostream &operator<<(std::ostream &os, const Trick &obj) {
+  switch (obj.type) {
+  case Trick::Walk_t:
+    os << "Walk " << obj.data.Walk.steps << "";
+  break;
+  case Trick::Sit_t:
+    os << "Sit";
+  break;
+  default:
+    break;
+  }
+  return os;
+}
+
+void encode(uint8_t *&out, const Trick &obj) {
+  gm::store<uint8_t>(out, obj.type);
+  out += 1;
+  uint8_t *end = out + 4;
+  switch (obj.type) {
+  case Trick::Walk_t:
+    gm::store<int32_t>(out, obj.data.Walk.steps);
+    out += 4;
+    break;
+  default:
+    break;
+  }
+  std::memset(out, 0, end - out);
+  out = end;
+}
+
+void decode(const uint8_t *&in, Trick &obj) {
+  auto type = static_cast<Trick::Type>(gm::load<uint8_t>(in));
+  in += 1;
+  const uint8_t *end = in + 4;
+  switch (type) {
+  case Trick::Undef:
+  case Trick::Sit_t:
+    break;
+  case Trick::Walk_t:
+    obj.data.Walk.steps = gm::load<int32_t>(in);
+    in += 4;
+    break;
+  default:
+    throw std::runtime_error("Invalid Trick type");
+  }
+  obj.type = type;
+  in = end;
+}
+
+static void writeJson(std::string &out, const Trick::Walk_d &obj) {
+  out += "{\"steps\":";
+  gm::writeJson(out, obj.steps);
+  out += '}';
+}
+
+static void readJson(const char *&cur, const char *end, Trick::Walk_d &obj) {
+  gm::json::expect(cur, end, '{');
+  if (gm::json::consume(cur, end, '}')) {
+    return;
+  }
+  const char *key;
+  size_t length;
+  do {
+    gm::json::readKey(cur, end, key, length);
+    switch (length) {
+    case 5:
+      if (std::memcmp(key, "steps", 5) == 0) {
+        gm::readJson(cur, end, obj.steps);
+        continue;
+      }
+      break;
+    }
+    gm::json::skipValue(cur, end);
+  } while (gm::json::next(cur, end, '}'));
+}
+
+static void writeJson(std::string &out, const Trick::Sit_d &) {
+  out += "{}";
+}
+
+static void readJson(const char *&cur, const char *end, Trick::Sit_d &) {
+  gm::json::skipValue(cur, end);
+}
+
+void writeJson(std::string &out, const Trick &obj) {
+  switch (obj.type) {
+  case Trick::Walk_t:
+    out += "{\"Walk\":";
+    writeJson(out, obj.data.Walk);
+    out += '}';
+    break;
+  case Trick::Sit_t:
+    out += "{\"Sit\":";
+    writeJson(out, obj.data.Sit);
+    out += '}';
+    break;
+  default:
+    out += "null";
+    break;
+  }
+}
+
+void readJson(const char *&cur, const char *end, Trick &obj) {
+  if (gm::json::consumeNull(cur, end)) {
+    obj.type = Trick::Undef;
+    return;
+  }
+  gm::json::expect(cur, end, '{');
+  const char *key;
+  size_t length;
+  gm::json::readKey(cur, end, key, length);
+  switch (length) {
+  case 3:
+    if (std::memcmp(key, "Sit", 3) == 0) {
+      obj.type = Trick::Sit_t;
+      readJson(cur, end, obj.data.Sit);
+      gm::json::expect(cur, end, '}');
+      return;
+    }
+    break;
+  case 4:
+    if (std::memcmp(key, "Walk", 4) == 0) {
+      obj.type = Trick::Walk_t;
+      readJson(cur, end, obj.data.Walk);
+      gm::json::expect(cur, end, '}');
+      return;
+    }
+    break;
+  }
+  gm::json::error("invalid Trick");
+}
+
+void randomize(gm::Rng &rng, Trick &obj) {
+  switch (rng.below(2)) {
+  case 0:
+    obj.type = Trick::Walk_t;
+    randomize(rng, obj.data.Walk.steps);
+    break;
+  case 1:
+    obj.type = Trick::Sit_t;
+    break;
+  }
+}
+
+bool Leash::operator==(const Leash &other) const {
+  return next == other.next
+      && length == other.length
+      && knots == other.knots;
+}
+
+std::istream &operator>>(std::istream &is, Leash &obj) {
+  is >> obj.next;
+  is >> obj.length;
+  is >> obj.knots;
+  return is;
+}
+
+void readText(const char *&cur, const char *end, Leash &obj) {
+  gm::readText(cur, end, obj.next);
+  gm::readText(cur, end, obj.length);
+  gm::readText(cur, end, obj.knots);
+}
+
+void readMany(const char *&cur, const char *end, size_t n, Leash *out) {
+  const char *p = cur;
+  for (size_t i = 0; i < n; i++) {
+    readText(p, end, out[i]);
+  }
+  cur = p;
+}
+
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Leash> &out) {
+  const char *p = cur;
+  size_t size = out.size();
+  out.reserve(size + n);
+  try {
+    for (size_t i = 0; i < n; i++) {
+      Leash item;
+      readText(p, end, item);
+      out.push_back(std::move(item));
+    }
+  }
+  catch (...) {
+    out.erase(out.begin() + size, out.end());
+    throw;
+  }
+  cur = p;
+}
+
+std::ostream &operator<<(std::ostream &os, const Leash &obj) {
+  os << "{ ";
+  os << "next" << ": " << obj.next << ", ";
+  os << "length" << ": " << obj.length << ", ";
+  os << "knots" << ": " << obj.knots;
+  os << " }";
+  return os;
+}
+
+void encode(uint8_t *&out, const Leash &obj) {
+  encode(out, obj.next.raw());
+  gm::store<int32_t>(out, obj.length.raw());
+  out += 4;
+  gm::store<uint8_t>(out, obj.length.has_value());
+  out += 1;
+  gm::store<uint8_t>(out, static_cast<uint8_t>(obj.knots.size()));
+  out += 1;
+  for (const auto &item : obj.knots) {
+    gm::store<int8_t>(out, item.raw());
+    out += 1;
+  }
+  std::memset(out, 0, (2 - obj.knots.size()) * 1);
+  out += (2 - obj.knots.size()) * 1;
+}
+
+void decode(const uint8_t *&in, Leash &obj) {
+  decode(in, obj.next.raw());
+  obj.length.raw() = gm::load<int32_t>(in);
+  in += 4;
+  obj.length.flag() = gm::loadBool(in);
+  in += 1;
+  obj.knots.resize(gm::load<uint8_t>(in));
+  in += 1;
+  for (auto &item : obj.knots) {
+    item.raw() = gm::load<int8_t>(in);
+    in += 1;
+    if (item.has_value() && (item.raw() < -100 || item.raw() > 100)) {
+      throw std::runtime_error("Value out of range");
+    }
+  }
+  in += (2 - obj.knots.size()) * 1;
+}
+
+void writeJson(std::string &out, const Leash &obj) {
+  out += "{\"next\":";
+  gm::writeJson(out, obj.next);
+  out += ",\"length\":";
+  gm::writeJson(out, obj.length);
+  out += ",\"knots\":";
+  gm::writeJson(out, obj.knots);
+  out += '}';
+}
+
+void readJson(const char *&cur, const char *end, Leash &obj) {
+  gm::json::expect(cur, end, '{');
+  if (gm::json::consume(cur, end, '}')) {
+    return;
+  }
+  const char *key;
+  size_t length;
+  do {
+    gm::json::readKey(cur, end, key, length);
+    switch (length) {
+    case 4:
+      if (std::memcmp(key, "next", 4) == 0) {
+        gm::readJson(cur, end, obj.next);
+        continue;
+      }
+      break;
+    case 5:
+      if (std::memcmp(key, "knots", 5) == 0) {
+        gm::readJson(cur, end, obj.knots);
+        continue;
+      }
+      break;
+    case 6:
+      if (std::memcmp(key, "length", 6) == 0) {
+        gm::readJson(cur, end, obj.length);
+        continue;
+      }
+      break;
+    }
+    gm::json::skipValue(cur, end);
+  } while (gm::json::next(cur, end, '}'));
+}
+
+void randomize(gm::Rng &rng, Leash &obj) {
+  randomize(rng, obj.next);
+  randomize(rng, obj.length);
+  randomize(rng, obj.knots);
+}
+
@@ -0,0 +1,275 @@
+#ifndef src_optional_gm__
+#define src_optional_gm__
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "gamma/bin.hpp"
+#include "gamma/containers.hpp"
+#include "gamma/io.hpp"
+#include "gamma/io_containers.hpp"
+#include "gamma/io_optional.hpp"
+#include "gamma/json.hpp"
+#include "gamma/json_containers.hpp"
+#include "gamma/json_optional.hpp"
+#include "gamma/optional.hpp"
+#include "gamma/out.hpp"
+#include "gamma/out_containers.hpp"
+#include "gamma/out_optional.hpp"
+#include "gamma/random.hpp"
+#include "gamma/random_containers.hpp"
+#include "gamma/random_optional.hpp"
+#include "gamma/text.hpp"
+#include "gamma/text_containers.hpp"
+#include "gamma/text_optional.hpp"
+#include "gamma/undo.hpp"
+
+enum class Mood {
+  CALM, ANGRY, 
+};
+
+std::istream &operator>>(std::istream &is, Mood &obj);
+void readText(const char *&cur, const char *end, Mood &obj);
+void readMany(const char *&cur, const char *end, size_t n, Mood *out);
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Mood> &out);
+
+std::ostream &operator<<(std::ostream &os, const Mood &obj);
+void writeText(gm::OutputBuffer &os, const Mood &obj);
+
+constexpr size_t kMoodBinSize = 4;
+constexpr uint64_t kMoodFingerprint = 0xc70e2ef18b8a0fedULL;
+void encode(uint8_t *&out, const Mood &obj);
+void decode(const uint8_t *&in, Mood &obj);
+
+void writeJson(std::string &out, const Mood &obj);
+void readJson(const char *&cur, const char *end, Mood &obj);
+
+void randomize(gm::Rng &rng, Mood &obj);
+
+struct Pet {
+  Pet() = default;
+  constexpr Pet(gm::Optional<Mood, gm::ValueNiche<Mood, static_cast<Mood>(2), static_cast<Mood>(0), static_cast<Mood>(1)>> mood, gm::Optional<int, gm::ValueNiche<int, 31, 0, 30>> age, gm::Optional<uint8_t> weight, gm::Optional<gm::Str<3>> tag) noexcept: mood(mood), age(age), weight(weight), tag(tag) {}
+  gm::Optional<Mood, gm::ValueNiche<Mood, static_cast<Mood>(2), static_cast<Mood>(0), static_cast<Mood>(1)>> mood;
+  gm::Optional<int, gm::ValueNiche<int, 31, 0, 30>> age;
+  gm::Optional<uint8_t> weight;
+  gm::Optional<gm::Str<3>> tag;
+  enum Field {
+    mood_f,
+    age_f,
+    weight_f,
+    tag_f,
+  };
+  bool operator==(const Pet &other) const;
+  struct Change {
+    Field field;
+    union Value {
+      Value() {}
+      gm::Optional<Mood, gm::ValueNiche<Mood, static_cast<Mood>(2), static_cast<Mood>(0), static_cast<Mood>(1)>> mood;
+      gm::Optional<int, gm::ValueNiche<int, 31, 0, 30>> age;
+      gm::Optional<uint8_t> weight;
+      gm::Optional<gm::Str<3>> tag;
+    } value;
+  };
+  void rollback(gm::UndoLog<Change> &log, size_t mark) {
+    while (log.mark() > mark) {
+      const Change &change = log.pop();
+      switch (change.field) {
+      case mood_f:
+        this->mood = change.value.mood;
+        break;
+      case age_f:
+        this->age = change.value.age;
+        break;
+      case weight_f:
+        this->weight = change.value.weight;
+        break;
+      case tag_f:
+        this->tag = change.value.tag;
+        break;
+      }
+    }
+  }
+  struct Patch {
+    uint64_t changed = 0;
+    gm::Optional<Mood, gm::ValueNiche<Mood, static_cast<Mood>(2), static_cast<Mood>(0), static_cast<Mood>(1)>> mood;
+    gm::Optional<int, gm::ValueNiche<int, 31, 0, 30>> age;
+    gm::Optional<uint8_t> weight;
+    gm::Optional<gm::Str<3>> tag;
+    bool has(Field field) const { return (changed >> field) & 1; }
+  };
+  void setMood(gm::UndoLog<Change> &log, const gm::Optional<Mood, gm::ValueNiche<Mood, static_cast<Mood>(2), static_cast<Mood>(0), static_cast<Mood>(1)>> &value) {
+    Change change;
+    change.field = mood_f;
+    change.value.mood = this->mood;
+    log.push(change);
+    this->mood = value;
+  }
+  void setAge(gm::UndoLog<Change> &log, const gm::Optional<int, gm::ValueNiche<int, 31, 0, 30>> &value) {
+    Change change;
+    change.field = age_f;
+    change.value.age = this->age;
+    log.push(change);
+    this->age = value;
+  }
+  void setWeight(gm::UndoLog<Change> &log, const gm::Optional<uint8_t> &value) {
+    Change change;
+    change.field = weight_f;
+    change.value.weight = this->weight;
+    log.push(change);
+    this->weight = value;
+  }
+  void setTag(gm::UndoLog<Change> &log, const gm::Optional<gm::Str<3>> &value) {
+    Change change;
+    change.field = tag_f;
+    change.value.tag = this->tag;
+    log.push(change);
+    this->tag = value;
+  }
+};
+
+static_assert(std::is_trivially_copyable<Pet>::value, "Pet must be trivially copyable");
+
+std::istream &operator>>(std::istream &is, Pet &obj);
+void readText(const char *&cur, const char *end, Pet &obj);
+void readMany(const char *&cur, const char *end, size_t n, Pet *out);
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Pet> &out);
+
+std::ostream &operator<<(std::ostream &os, const Pet &obj);
+void writeText(gm::OutputBuffer &os, const Pet &obj);
+
+constexpr size_t kPetBinSize = 15;
+constexpr uint64_t kPetFingerprint = 0x6ca0fd66bee3b011ULL;
+void encode(uint8_t *&out, const Pet &obj);
+void decode(const uint8_t *&in, Pet &obj);
+
+struct PetView {
+  explicit PetView(const uint8_t *data) noexcept: data(data) {}
+  bool hasMood() const noexcept { return gm::load<int32_t>(data) != 2; }
+  Mood mood() const { return static_cast<Mood>(gm::loadEnum(data, 2)); }
+  bool hasAge() const noexcept { return gm::load<int32_t>(data + 4) != 31; }
+  int age() const noexcept { return gm::load<int32_t>(data + 4); }
+  bool hasWeight() const noexcept { return gm::load<uint8_t>(data + 8 + 1) != 0; }
+  uint8_t weight() const noexcept { return gm::load<uint8_t>(data + 8); }
+  bool hasTag() const noexcept { return gm::load<uint8_t>(data + 10 + 4) != 0; }
+  gm::Str<3> tag() const { return gm::Str<3>(reinterpret_cast<const char *>(data + 10 + 1), gm::load<uint8_t>(data + 10)); }
+  const uint8_t *data;
+};
+
+void writeJson(std::string &out, const Pet &obj);
+void readJson(const char *&cur, const char *end, Pet &obj);
+
+void randomize(gm::Rng &rng, Pet &obj);
+
+Pet::Patch diff(const Pet &a, const Pet &b);
+void apply(Pet &state, const Pet::Patch &patch);
+
+constexpr size_t kPetPatchMaxBinSize = 16;
+void encode(uint8_t *&out, const Pet::Patch &patch);
+void decode(const uint8_t *&in, Pet::Patch &patch);
+
+struct Trick {
+  enum Type {
+    Undef,
+    Walk_t,
+    Sit_t,
+  } type;
+  struct Walk_d {
+    int steps;
+  };
+  struct Sit_d {
+  };
+  union Data {
+    constexpr Data() noexcept: Walk() {}
+    constexpr Data(Walk_d Walk) noexcept: Walk(Walk) {}
+    constexpr Data(Sit_d Sit) noexcept: Sit(Sit) {}
+    Walk_d Walk;
+    Sit_d Sit;
+  } data;
+  constexpr Trick(Type type = Undef) noexcept: type(type), data() {}
+  constexpr Trick(Type type, Data data) noexcept: type(type), data(data) {}
+  static constexpr Trick Walk(int steps) noexcept {
+    return Trick(Walk_t, Walk_d{steps});
+  }
+  static constexpr Trick Sit() noexcept {
+    return Trick(Sit_t, Sit_d{});
+  }
+  bool operator==(const Trick &other) const;
+};
+
+template <typename Visitor>
+auto visit(const Trick &obj, Visitor &&vis) -> decltype(vis(obj.data.Walk)) {
+  switch (obj.type) {
+  case Trick::Walk_t:
+    return vis(obj.data.Walk);
+  case Trick::Sit_t:
+    return vis(obj.data.Sit);
+  default:
+    throw std::invalid_argument("visit: undefined Trick");
+  }
+}
+
+template <typename Visitor>
+auto visit(Trick &obj, Visitor &&vis) -> decltype(vis(obj.data.Walk)) {
+  switch (obj.type) {
+  case Trick::Walk_t:
+    return vis(obj.data.Walk);
+  case Trick::Sit_t:
+    return vis(obj.data.Sit);
+  default:
+    throw std::invalid_argument("visit: undefined Trick");
+  }
+}
+
+static_assert(std::is_trivially_copyable<Trick>::value, "Trick must be trivially copyable");
+static_assert(sizeof(Trick::Walk_d) == sizeof(int), "Trick::Walk_d must have no padding");
+
+std::istream &operator>>(std::istream &is, Trick &obj);
+void readText(const char *&cur, const char *end, Trick &obj);
+void readMany(const char *&cur, const char *end, size_t n, Trick *out);
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Trick> &out);
+
+std::ostream &operator<<(std::ostream &os, const Trick &obj);
+
+constexpr size_t kTrickBinSize = 5;
+constexpr uint64_t kTrickFingerprint = 0x6846ec085b126665ULL;
+void encode(uint8_t *&out, const Trick &obj);
+void decode(const uint8_t *&in, Trick &obj);
+
+void writeJson(std::string &out, const Trick &obj);
+void readJson(const char *&cur, const char *end, Trick &obj);
+
+void randomize(gm::Rng &rng, Trick &obj);
+
+struct Leash {
+  Leash() = default;
+  constexpr Leash(gm::Optional<Trick, gm::UndefNiche<Trick>> next, gm::Optional<int> length, gm::SmallVec<gm::Optional<int8_t, gm::ValueNiche<int8_t, 101, -100, 100>>, 2> knots) noexcept: next(next), length(length), knots(knots) {}
+  gm::Optional<Trick, gm::UndefNiche<Trick>> next;
+  gm::Optional<int> length;
+  gm::SmallVec<gm::Optional<int8_t, gm::ValueNiche<int8_t, 101, -100, 100>>, 2> knots;
+  bool operator==(const Leash &other) const;
+};
+
+static_assert(std::is_trivially_copyable<Leash>::value, "Leash must be trivially copyable");
+
+std::istream &operator>>(std::istream &is, Leash &obj);
+void readText(const char *&cur, const char *end, Leash &obj);
+void readMany(const char *&cur, const char *end, size_t n, Leash *out);
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Leash> &out);
+
+std::ostream &operator<<(std::ostream &os, const Leash &obj);
+
+constexpr size_t kLeashBinSize = 13;
+constexpr uint64_t kLeashFingerprint = 0x6abb7c4d2c279fd5ULL;
+void encode(uint8_t *&out, const Leash &obj);
+void decode(const uint8_t *&in, Leash &obj);
+
+void writeJson(std::string &out, const Leash &obj);
+void readJson(const char *&cur, const char *end, Leash &obj);
+
+void randomize(gm::Rng &rng, Leash &obj);
+
+
+#endif
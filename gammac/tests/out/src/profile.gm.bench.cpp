@@ -0,0 +1,207 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "gamma/containers.hpp"
+#include "gamma/optional.hpp"
+#include "gamma/random.hpp"
+
+#include "src/profile.gm.hpp"
+
+// Generated by gammac --emit-bench; usage: <program> [count]
+
+template <typename T>
+static inline void writeInput(std::ostream &os, const T &value) { os << value; }
+static inline void writeInput(std::ostream &os, int8_t value) { os << static_cast<int>(value); }
+static inline void writeInput(std::ostream &os, uint8_t value) { os << static_cast<int>(value); }
+template <typename T, size_t N>
+static inline void writeInput(std::ostream &os, const gm::Array<T, N> &value);
+template <typename T, size_t N>
+static inline void writeInput(std::ostream &os, const gm::SmallVec<T, N> &value);
+template <typename T>
+static inline void writeInput(std::ostream &os, const gm::Vec<T> &value);
+template <typename T, typename Niche>
+static inline void writeInput(std::ostream &os, const gm::Optional<T, Niche> &value);
+
+template <typename Container>
+static inline void writeInputItems(std::ostream &os, const Container &value) {
+  for (const auto &item : value) {
+    os << ' ';
+    writeInput(os, item);
+  }
+}
+
+template <typename T, size_t N>
+static inline void writeInput(std::ostream &os, const gm::Array<T, N> &value) {
+  writeInput(os, value[0]);
+  for (size_t i = 1; i < N; i++) {
+    os << ' ';
+    writeInput(os, value[i]);
+  }
+}
+
+template <typename T, size_t N>
+static inline void writeInput(std::ostream &os, const gm::SmallVec<T, N> &value) {
+  os << value.size();
+  writeInputItems(os, value);
+}
+
+template <typename T>
+static inline void writeInput(std::ostream &os, const gm::Vec<T> &value) {
+  os << value.size();
+  writeInputItems(os, value);
+}
+
+template <typename T, typename Niche>
+static inline void writeInput(std::ostream &os, const gm::Optional<T, Niche> &value) {
+  if (value.has_value()) {
+    writeInput(os, *value);
+  }
+  else {
+    os << '-';
+  }
+}
+
+typedef std::chrono::steady_clock BenchClock;
+
+static void report(const char *type, const char *trait, BenchClock::time_point start, size_t count, size_t bytes) {
+  double ns = std::chrono::duration<double, std::nano>(BenchClock::now() - start).count();
+  if (bytes > 0) {
+    std::printf("%-20s %-8s %10.1f ns/op %10.1f MB/s\n", type, trait, ns / count, bytes * 1e3 / ns);
+  }
+  else {
+    std::printf("%-20s %-8s %10.1f ns/op\n", type, trait, ns / count);
+  }
+}
+
+static inline void randomize(gm::Rng &rng, Terrain &obj) {
+  obj = static_cast<Terrain>(rng.below(3));
+}
+
+static inline void writeInput(std::ostream &os, const Terrain &obj) {
+  static const char *const formats[] = {
+    "GRASS", "WATER", "ROCK", 
+  };
+  os << formats[static_cast<size_t>(obj)];
+}
+
+static void benchTerrain(size_t count) {
+  gm::Rng rng(7666192001752063502ULL);
+  std::vector<Terrain> values(count);
+  for (auto &value : values) {
+    randomize(rng, value);
+  }
+  {
+    std::ostringstream os;
+    for (const auto &value : values) {
+      writeInput(os, value);
+      os << '\n';
+    }
+    std::string text = os.str();
+    std::vector<Terrain> parsed;
+    const char *cur = text.data();
+    auto start = BenchClock::now();
+    readMany(cur, text.data() + text.size(), count, parsed);
+    report("Terrain", "In", start, count, text.size());
+  }
+  {
+    std::string text;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      writeJson(text, value);
+      text += '\n';
+    }
+    report("Terrain", "Json out", start, count, text.size());
+    std::vector<Terrain> parsed(count);
+    const char *cur = text.data();
+    start = BenchClock::now();
+    for (auto &value : parsed) {
+      readJson(cur, text.data() + text.size(), value);
+    }
+    report("Terrain", "Json in", start, count, text.size());
+  }
+}
+
+static inline void randomize(gm::Rng &rng, Event &obj) {
+  switch (rng.below(3)) {
+  case 0:
+    obj.type = Event::Spawn_t;
+    randomize(rng, obj.data.Spawn.x);
+    break;
+  case 1:
+    obj.type = Event::Tick_t;
+    break;
+  case 2:
+    obj.type = Event::Quit_t;
+    break;
+  }
+}
+
+static inline void writeInput(std::ostream &os, const Event &obj) {
+  switch (obj.type) {
+  case Event::Spawn_t:
+    os << "SPAWN";
+    os << ' ';
+    writeInput(os, obj.data.Spawn.x);
+    break;
+  case Event::Tick_t:
+    os << "TICK";
+    break;
+  case Event::Quit_t:
+    os << "QUIT";
+    break;
+  default:
+    break;
+  }
+}
+
+static void benchEvent(size_t count) {
+  gm::Rng rng(15053971590318654463ULL);
+  std::vector<Event> values(count);
+  for (auto &value : values) {
+    randomize(rng, value);
+  }
+  {
+    std::ostringstream os;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      os << value << '\n';
+    }
+    report("Event", "Out", start, count, os.str().size());
+  }
+  {
+    std::ostringstream os;
+    for (const auto &value : values) {
+      writeInput(os, value);
+      os << '\n';
+    }
+    std::string text = os.str();
+    std::vector<Event> parsed;
+    const char *cur = text.data();
+    auto start = BenchClock::now();
+    readMany(cur, text.data() + text.size(), count, parsed);
+    report("Event", "In", start, count, text.size());
+  }
+  {
+    std::vector<Event> copies(values);
+    size_t equal = 0;
+    auto start = BenchClock::now();
+    for (size_t i = 0; i < count; i++) {
+      equal += values[i] == copies[i];
+    }
+    report("Event", "Eq", start, count, 0);
+    if (equal != count) {
+      std::printf("%s: copies differ\n", "Event");
+    }
+  }
+}
+
+int main(int argc, char *argv[]) {
+  size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+  benchTerrain(count);
+  benchEvent(count);
+  return 0;
+}
@@ -0,0 +1,230 @@
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include "gamma/profile.hpp"
+
+#include "src/profile.gm.hpp"
+
+#ifdef GAMMA_PROFILE
+static const char *const kTerrainVariants[] = {
+  "GRASS", "WATER", "ROCK", 
+};
+static uint64_t *const kTerrainHits = gm::Profile::instance().add("Terrain", kTerrainVariants, 3);
+#endif
+
+static const std::map<std::string, Terrain> kStrToTerrain {
+  {"GRASS", Terrain::GRASS},
+  {"WATER", Terrain::WATER},
+  {"ROCK", Terrain::ROCK},
+};
+
+std::istream &operator>>(std::istream &is, Terrain &obj) {
+  std::string str;
+  is >> str;
+  obj = kStrToTerrain.at(str);
+  GM_PROFILE_HIT(kTerrainHits, static_cast<size_t>(obj));
+  return is;
+}
+
+void readText(const char *&cur, const char *end, Terrain &obj) {
+  const char *key;
+  size_t length;
+  gm::text::readToken(cur, end, key, length);
+  switch (length) {
+  case 4:
+    if (GM_UNLIKELY(std::memcmp(key, "ROCK", 4) == 0)) {
+      obj = Terrain::ROCK;
+      GM_PROFILE_HIT(kTerrainHits, static_cast<size_t>(Terrain::ROCK));
+      return;
+    }
+    break;
+  case 5:
+    if (std::memcmp(key, "WATER", 5) == 0) {
+      obj = Terrain::WATER;
+      GM_PROFILE_HIT(kTerrainHits, static_cast<size_t>(Terrain::WATER));
+      return;
+    }
+    if (GM_UNLIKELY(std::memcmp(key, "GRASS", 5) == 0)) {
+      obj = Terrain::GRASS;
+      GM_PROFILE_HIT(kTerrainHits, static_cast<size_t>(Terrain::GRASS));
+      return;
+    }
+    break;
+  }
+  gm::text::error("invalid Terrain");
+}
+
+void readMany(const char *&cur, const char *end, size_t n, Terrain *out) {
+  const char *p = cur;
+  for (size_t i = 0; i < n; i++) {
+    readText(p, end, out[i]);
+  }
+  cur = p;
+}
+
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Terrain> &out) {
+  const char *p = cur;
+  size_t size = out.size();
+  out.reserve(size + n);
+  try {
+    for (size_t i = 0; i < n; i++) {
+      Terrain item;
+      readText(p, end, item);
+      out.push_back(std::move(item));
+    }
+  }
+  catch (...) {
+    out.erase(out.begin() + size, out.end());
+    throw;
+  }
+  cur = p;
+}
+
+static const char *const kTerrainToJson[] = {
+  "\"GRASS\"", "\"WATER\"", "\"ROCK\"", 
+};
+
+void writeJson(std::string &out, const Terrain &obj) {
+  out += kTerrainToJson[static_cast<size_t>(obj)];
+}
+
+void readJson(const char *&cur, const char *end, Terrain &obj) {
+  const char *key;
+  size_t length;
+  gm::json::readRawString(cur, end, key, length);
+  switch (length) {
+  case 4:
+    if (GM_UNLIKELY(std::memcmp(key, "ROCK", 4) == 0)) {
+      obj = Terrain::ROCK;
+      return;
+    }
+    break;
+  case 5:
+    if (std::memcmp(key, "WATER", 5) == 0) {
+      obj = Terrain::WATER;
+      return;
+    }
+    if (GM_UNLIKELY(std::memcmp(key, "GRASS", 5) == 0)) {
+      obj = Terrain::GRASS;
+      return;
+    }
+    break;
+  }
+  gm::json::error("invalid Terrain");
+}
+
+bool Event::operator==(const Event &other) const {
+  if (type != other.type) return false;
+  switch (type) {
+  case Event::Spawn_t:
+    return std::memcmp(&data.Spawn, &other.data.Spawn, sizeof(Spawn_d)) == 0;
+  default:
+    return true;
+  }
+}
+
+#ifdef GAMMA_PROFILE
+static const char *const kEventVariants[] = {
+  "Spawn", "Tick", "Quit", 
+};
+static uint64_t *const kEventHits = gm::Profile::instance().add("Event", kEventVariants, 3);
+#endif
+
+std::istream &operator>>(std::istream &is, Event &obj) {
+  std::string str;
+  if (!(is >> str)) {
+    return is;
+  }
+  if (str == "TICK") {
+    obj.type = Event::Tick_t;
+    GM_PROFILE_HIT(kEventHits, Event::Tick_t - 1);
+  }
+  else if (GM_UNLIKELY(str == "SPAWN")) {
+    obj.type = Event::Spawn_t;
+    GM_PROFILE_HIT(kEventHits, Event::Spawn_t - 1);
+    is >> obj.data.Spawn.x;
+  }
+  else if (GM_UNLIKELY(str == "QUIT")) {
+    obj.type = Event::Quit_t;
+    GM_PROFILE_HIT(kEventHits, Event::Quit_t - 1);
+  }
+  else {
+    throw std::runtime_error("Invalid Event");
+  }
+  return is;
+}
+
+void readText(const char *&cur, const char *end, Event &obj) {
+  const char *key;
+  size_t length;
+  gm::text::readToken(cur, end, key, length);
+  switch (length) {
+  case 4:
+    if (std::memcmp(key, "TICK", 4) == 0) {
+      obj.type = Event::Tick_t;
+      GM_PROFILE_HIT(kEventHits, Event::Tick_t - 1);
+      return;
+    }
+    if (GM_UNLIKELY(std::memcmp(key, "QUIT", 4) == 0)) {
+      obj.type = Event::Quit_t;
+      GM_PROFILE_HIT(kEventHits, Event::Quit_t - 1);
+      return;
+    }
+    break;
+  case 5:
+    if (GM_UNLIKELY(std::memcmp(key, "SPAWN", 5) == 0)) {
+      obj.type = Event::Spawn_t;
+      GM_PROFILE_HIT(kEventHits, Event::Spawn_t - 1);
+      gm::readText(cur, end, obj.data.Spawn.x);
+      return;
+    }
+    break;
+  }
+  gm::text::error("invalid Event");
+}
+
+void readMany(const char *&cur, const char *end, size_t n, Event *out) {
+  const char *p = cur;
+  for (size_t i = 0; i < n; i++) {
+    readText(p, end, out[i]);
+  }
+  cur = p;
+}
+
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Event> &out) {
+  const char *p = cur;
+  size_t size = out.size();
+  out.reserve(size + n);
+  try {
+    for (size_t i = 0; i < n; i++) {
+      Event item;
+      readText(p, end, item);
+      out.push_back(std::move(item));
+    }
+  }
+  catch (...) {
+    out.erase(out.begin() + size, out.end());
+    throw;
+  }
+  cur = p;
+}
+
+std::ostream &operator<<(std::ostream &os, const Event &obj) {
+  switch (obj.type) {
+  case Event::Tick_t:
+    os << "TICK";
+  break;
+  case Event::Spawn_t:
+    os << "SPAWN " << obj.data.Spawn.x << "";
+  break;
+  case Event::Quit_t:
+    os << "QUIT";
+  break;
+  default:
+    break;
+  }
+  return os;
+}
+
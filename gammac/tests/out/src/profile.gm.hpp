@@ -0,0 +1,101 @@
+#ifndef src_profile_gm__
+#define src_profile_gm__
+
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "gamma/json.hpp"
+#include "gamma/out.hpp"
+#include "gamma/text.hpp"
+
+enum class Terrain {
+  GRASS, WATER, ROCK, 
+};
+
+std::istream &operator>>(std::istream &is, Terrain &obj);
+void readText(const char *&cur, const char *end, Terrain &obj);
+void readMany(const char *&cur, const char *end, size_t n, Terrain *out);
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Terrain> &out);
+
+void writeJson(std::string &out, const Terrain &obj);
+void readJson(const char *&cur, const char *end, Terrain &obj);
+
+struct Event {
+  enum Type {
+    Undef,
+    Spawn_t,
+    Tick_t,
+    Quit_t,
+  } type;
+  struct Spawn_d {
+    int x;
+  };
+  struct Tick_d {
+  };
+  struct Quit_d {
+  };
+  union Data {
+    constexpr Data() noexcept: Spawn() {}
+    constexpr Data(Spawn_d Spawn) noexcept: Spawn(Spawn) {}
+    constexpr Data(Tick_d Tick) noexcept: Tick(Tick) {}
+    constexpr Data(Quit_d Quit) noexcept: Quit(Quit) {}
+    Spawn_d Spawn;
+    Tick_d Tick;
+    Quit_d Quit;
+  } data;
+  constexpr Event(Type type = Undef) noexcept: type(type), data() {}
+  constexpr Event(Type type, Data data) noexcept: type(type), data(data) {}
+  static constexpr Event Spawn(int x) noexcept {
+    return Event(Spawn_t, Spawn_d{x});
+  }
+  static constexpr Event Tick() noexcept {
+    return Event(Tick_t, Tick_d{});
+  }
+  static constexpr Event Quit() noexcept {
+    return Event(Quit_t, Quit_d{});
+  }
+  bool operator==(const Event &other) const;
+};
+
+template <typename Visitor>
+auto visit(const Event &obj, Visitor &&vis) -> decltype(vis(obj.data.Spawn)) {
+  switch (obj.type) {
+  case Event::Spawn_t:
+    return vis(obj.data.Spawn);
+  case Event::Tick_t:
+    return vis(obj.data.Tick);
+  case Event::Quit_t:
+    return vis(obj.data.Quit);
+  default:
+    throw std::invalid_argument("visit: undefined Event");
+  }
+}
+
+template <typename Visitor>
+auto visit(Event &obj, Visitor &&vis) -> decltype(vis(obj.data.Spawn)) {
+  switch (obj.type) {
+  case Event::Spawn_t:
+    return vis(obj.data.Spawn);
+  case Event::Tick_t:
+    return vis(obj.data.Tick);
+  case Event::Quit_t:
+    return vis(obj.data.Quit);
+  default:
+    throw std::invalid_argument("visit: undefined Event");
+  }
+}
+
+static_assert(std::is_trivially_copyable<Event>::value, "Event must be trivially copyable");
+static_assert(sizeof(Event::Spawn_d) == sizeof(int), "Event::Spawn_d must have no padding");
+
+std::istream &operator>>(std::istream &is, Event &obj);
+void readText(const char *&cur, const char *end, Event &obj);
+void readMany(const char *&cur, const char *end, size_t n, Event *out);
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Event> &out);
+
+std::ostream &operator<<(std::ostream &os, const Event &obj);
+
+
+#endif
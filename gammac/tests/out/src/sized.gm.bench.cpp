@@ -0,0 +1,385 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "gamma/containers.hpp"
+#include "gamma/optional.hpp"
+#include "gamma/random.hpp"
+
+#include "src/sized.gm.hpp"
+
+// Generated by gammac --emit-bench; usage: <program> [count]
+
+template <typename T>
+static inline void writeInput(std::ostream &os, const T &value) { os << value; }
+static inline void writeInput(std::ostream &os, int8_t value) { os << static_cast<int>(value); }
+static inline void writeInput(std::ostream &os, uint8_t value) { os << static_cast<int>(value); }
+template <typename T, size_t N>
+static inline void writeInput(std::ostream &os, const gm::Array<T, N> &value);
+template <typename T, size_t N>
+static inline void writeInput(std::ostream &os, const gm::SmallVec<T, N> &value);
+template <typename T>
+static inline void writeInput(std::ostream &os, const gm::Vec<T> &value);
+template <typename T, typename Niche>
+static inline void writeInput(std::ostream &os, const gm::Optional<T, Niche> &value);
+
+template <typename Container>
+static inline void writeInputItems(std::ostream &os, const Container &value) {
+  for (const auto &item : value) {
+    os << ' ';
+    writeInput(os, item);
+  }
+}
+
+template <typename T, size_t N>
+static inline void writeInput(std::ostream &os, const gm::Array<T, N> &value) {
+  writeInput(os, value[0]);
+  for (size_t i = 1; i < N; i++) {
+    os << ' ';
+    writeInput(os, value[i]);
+  }
+}
+
+template <typename T, size_t N>
+static inline void writeInput(std::ostream &os, const gm::SmallVec<T, N> &value) {
+  os << value.size();
+  writeInputItems(os, value);
+}
+
+template <typename T>
+static inline void writeInput(std::ostream &os, const gm::Vec<T> &value) {
+  os << value.size();
+  writeInputItems(os, value);
+}
+
+template <typename T, typename Niche>
+static inline void writeInput(std::ostream &os, const gm::Optional<T, Niche> &value) {
+  if (value.has_value()) {
+    writeInput(os, *value);
+  }
+  else {
+    os << '-';
+  }
+}
+
+typedef std::chrono::steady_clock BenchClock;
+
+static void report(const char *type, const char *trait, BenchClock::time_point start, size_t count, size_t bytes) {
+  double ns = std::chrono::duration<double, std::nano>(BenchClock::now() - start).count();
+  if (bytes > 0) {
+    std::printf("%-20s %-8s %10.1f ns/op %10.1f MB/s\n", type, trait, ns / count, bytes * 1e3 / ns);
+  }
+  else {
+    std::printf("%-20s %-8s %10.1f ns/op\n", type, trait, ns / count);
+  }
+}
+
+static inline void writeInput(std::ostream &os, const Sized &obj) {
+  writeInput(os, obj.small);
+  os << ' ';
+  writeInput(os, obj.byte);
+  os << ' ';
+  writeInput(os, obj.medium);
+  os << ' ';
+  writeInput(os, obj.port);
+  os << ' ';
+  writeInput(os, obj.count);
+  os << ' ';
+  writeInput(os, obj.mask);
+  os << ' ';
+  writeInput(os, obj.big);
+  os << ' ';
+  writeInput(os, obj.huge);
+  os << ' ';
+  writeInput(os, obj.ratio);
+  os << ' ';
+  writeInput(os, obj.precise);
+}
+
+static void benchSized(size_t count) {
+  gm::Rng rng(4470750297702371816ULL);
+  std::vector<Sized> values(count);
+  for (auto &value : values) {
+    randomize(rng, value);
+  }
+  {
+    std::ostringstream os;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      os << value << '\n';
+    }
+    report("Sized", "Out", start, count, os.str().size());
+  }
+  {
+    std::ostringstream os;
+    for (const auto &value : values) {
+      writeInput(os, value);
+      os << '\n';
+    }
+    std::string text = os.str();
+    std::vector<Sized> parsed;
+    const char *cur = text.data();
+    auto start = BenchClock::now();
+    readMany(cur, text.data() + text.size(), count, parsed);
+    report("Sized", "In", start, count, text.size());
+  }
+  {
+    std::vector<Sized> copies(values);
+    size_t equal = 0;
+    auto start = BenchClock::now();
+    for (size_t i = 0; i < count; i++) {
+      equal += values[i] == copies[i];
+    }
+    report("Sized", "Eq", start, count, 0);
+    if (equal != count) {
+      std::printf("%s: copies differ\n", "Sized");
+    }
+  }
+  {
+    std::vector<uint8_t> buffer(count * kSizedBinSize);
+    uint8_t *out = buffer.data();
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      encode(out, value);
+    }
+    report("Sized", "Bin out", start, count, buffer.size());
+    std::vector<Sized> decoded(count);
+    const uint8_t *in = buffer.data();
+    start = BenchClock::now();
+    for (auto &value : decoded) {
+      decode(in, value);
+    }
+    report("Sized", "Bin in", start, count, buffer.size());
+  }
+  {
+    std::string text;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      writeJson(text, value);
+      text += '\n';
+    }
+    report("Sized", "Json out", start, count, text.size());
+    std::vector<Sized> parsed(count);
+    const char *cur = text.data();
+    start = BenchClock::now();
+    for (auto &value : parsed) {
+      readJson(cur, text.data() + text.size(), value);
+    }
+    report("Sized", "Json in", start, count, text.size());
+  }
+}
+
+static void benchCounter(size_t count) {
+  gm::Rng rng(11320984242218861763ULL);
+  std::vector<Counter> values(count);
+  for (auto &value : values) {
+    randomize(rng, value);
+  }
+  {
+    std::vector<Counter> copies(values);
+    size_t equal = 0;
+    auto start = BenchClock::now();
+    for (size_t i = 0; i < count; i++) {
+      equal += values[i] == copies[i];
+    }
+    report("Counter", "Eq", start, count, 0);
+    if (equal != count) {
+      std::printf("%s: copies differ\n", "Counter");
+    }
+  }
+}
+
+static inline void randomize(gm::Rng &rng, Packet &obj) {
+  switch (rng.below(3)) {
+  case 0:
+    obj.type = Packet::Ping_t;
+    randomize(rng, obj.data.Ping.id);
+    break;
+  case 1:
+    obj.type = Packet::Send_t;
+    randomize(rng, obj.data.Send.port);
+    randomize(rng, obj.data.Send.value);
+    break;
+  case 2:
+    obj.type = Packet::Wait_t;
+    obj.data.Wait.ticks = static_cast<uint8_t>(static_cast<int64_t>(rng.below(60U)) + 1);
+    break;
+  }
+}
+
+static inline void writeInput(std::ostream &os, const Packet &obj) {
+  switch (obj.type) {
+  case Packet::Ping_t:
+    os << "Ping";
+    os << ' ';
+    writeInput(os, obj.data.Ping.id);
+    break;
+  case Packet::Send_t:
+    os << "Send";
+    os << ' ';
+    writeInput(os, obj.data.Send.port);
+    os << ' ';
+    writeInput(os, obj.data.Send.value);
+    break;
+  case Packet::Wait_t:
+    os << "Wait";
+    os << ' ';
+    writeInput(os, obj.data.Wait.ticks);
+    break;
+  default:
+    break;
+  }
+}
+
+static void benchPacket(size_t count) {
+  gm::Rng rng(7239389540763498993ULL);
+  std::vector<Packet> values(count);
+  for (auto &value : values) {
+    randomize(rng, value);
+  }
+  {
+    std::ostringstream os;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      os << value << '\n';
+    }
+    report("Packet", "Out", start, count, os.str().size());
+  }
+  {
+    std::ostringstream os;
+    for (const auto &value : values) {
+      writeInput(os, value);
+      os << '\n';
+    }
+    std::string text = os.str();
+    std::vector<Packet> parsed;
+    const char *cur = text.data();
+    auto start = BenchClock::now();
+    readMany(cur, text.data() + text.size(), count, parsed);
+    report("Packet", "In", start, count, text.size());
+  }
+  {
+    std::vector<Packet> copies(values);
+    size_t equal = 0;
+    auto start = BenchClock::now();
+    for (size_t i = 0; i < count; i++) {
+      equal += values[i] == copies[i];
+    }
+    report("Packet", "Eq", start, count, 0);
+    if (equal != count) {
+      std::printf("%s: copies differ\n", "Packet");
+    }
+  }
+  {
+    std::vector<uint8_t> buffer(count * kPacketBinSize);
+    uint8_t *out = buffer.data();
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      encode(out, value);
+    }
+    report("Packet", "Bin out", start, count, buffer.size());
+    std::vector<Packet> decoded(count);
+    const uint8_t *in = buffer.data();
+    start = BenchClock::now();
+    for (auto &value : decoded) {
+      decode(in, value);
+    }
+    report("Packet", "Bin in", start, count, buffer.size());
+  }
+}
+
+static inline void randomize(gm::Rng &rng, Gauge &obj) {
+  obj.level = static_cast<uint8_t>(static_cast<int64_t>(rng.below(200U)) + 1);
+  obj.offset = static_cast<int32_t>(static_cast<int64_t>(rng.below(11U)) - 5);
+}
+
+static inline void writeInput(std::ostream &os, const Gauge &obj) {
+  writeInput(os, obj.level);
+  os << ' ';
+  writeInput(os, obj.offset);
+}
+
+static void benchGauge(size_t count) {
+  gm::Rng rng(2802556336567700656ULL);
+  std::vector<Gauge> values(count);
+  for (auto &value : values) {
+    randomize(rng, value);
+  }
+  {
+    std::ostringstream os;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      os << value << '\n';
+    }
+    report("Gauge", "Out", start, count, os.str().size());
+  }
+  {
+    std::ostringstream os;
+    for (const auto &value : values) {
+      writeInput(os, value);
+      os << '\n';
+    }
+    std::string text = os.str();
+    std::vector<Gauge> parsed;
+    const char *cur = text.data();
+    auto start = BenchClock::now();
+    readMany(cur, text.data() + text.size(), count, parsed);
+    report("Gauge", "In", start, count, text.size());
+  }
+  {
+    std::vector<Gauge> copies(values);
+    size_t equal = 0;
+    auto start = BenchClock::now();
+    for (size_t i = 0; i < count; i++) {
+      equal += values[i] == copies[i];
+    }
+    report("Gauge", "Eq", start, count, 0);
+    if (equal != count) {
+      std::printf("%s: copies differ\n", "Gauge");
+    }
+  }
+  {
+    std::vector<uint8_t> buffer(count * kGaugeBinSize);
+    uint8_t *out = buffer.data();
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      encode(out, value);
+    }
+    report("Gauge", "Bin out", start, count, buffer.size());
+    std::vector<Gauge> decoded(count);
+    const uint8_t *in = buffer.data();
+    start = BenchClock::now();
+    for (auto &value : decoded) {
+      decode(in, value);
+    }
+    report("Gauge", "Bin in", start, count, buffer.size());
+  }
+  {
+    std::string text;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      writeJson(text, value);
+      text += '\n';
+    }
+    report("Gauge", "Json out", start, count, text.size());
+    std::vector<Gauge> parsed(count);
+    const char *cur = text.data();
+    start = BenchClock::now();
+    for (auto &value : parsed) {
+      readJson(cur, text.data() + text.size(), value);
+    }
+    report("Gauge", "Json in", start, count, text.size());
+  }
+}
+
+int main(int argc, char *argv[]) {
+  size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+  benchSized(count);
+  benchCounter(count);
+  benchPacket(count);
+  benchGauge(count);
+  return 0;
+}
@@ -0,0 +1,715 @@
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include "gamma/profile.hpp"
+
+#include "src/sized.gm.hpp"
+
+bool Sized::operator==(const Sized &other) const {
+  return small == other.small
+      && byte == other.byte
+      && medium == other.medium
+      && port == other.port
+      && count == other.count
+      && mask == other.mask
+      && big == other.big
+      && huge == other.huge
+      && ratio == other.ratio
+      && precise == other.precise;
+}
+
+std::istream &operator>>(std::istream &is, Sized &obj) {
+  gm::readNumber(is, obj.small);
+  gm::readNumber(is, obj.byte);
+  is >> obj.medium;
+  is >> obj.port;
+  is >> obj.count;
+  is >> obj.mask;
+  is >> obj.big;
+  is >> obj.huge;
+  is >> obj.ratio;
+  is >> obj.precise;
+  return is;
+}
+
+void readText(const char *&cur, const char *end, Sized &obj) {
+  gm::readText(cur, end, obj.small);
+  gm::readText(cur, end, obj.byte);
+  gm::readText(cur, end, obj.medium);
+  gm::readText(cur, end, obj.port);
+  gm::readText(cur, end, obj.count);
+  gm::readText(cur, end, obj.mask);
+  gm::readText(cur, end, obj.big);
+  gm::readText(cur, end, obj.huge);
+  gm::readText(cur, end, obj.ratio);
+  gm::readText(cur, end, obj.precise);
+}
+
+void readMany(const char *&cur, const char *end, size_t n, Sized *out) {
+  const char *p = cur;
+  for (size_t i = 0; i < n; i++) {
+    readText(p, end, out[i]);
+  }
+  cur = p;
+}
+
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Sized> &out) {
+  const char *p = cur;
+  size_t size = out.size();
+  out.reserve(size + n);
+  try {
+    for (size_t i = 0; i < n; i++) {
+      Sized item;
+      readText(p, end, item);
+      out.push_back(std::move(item));
+    }
+  }
+  catch (...) {
+    out.erase(out.begin() + size, out.end());
+    throw;
+  }
+  cur = p;
+}
+
+std::ostream &operator<<(std::ostream &os, const Sized &obj) {
+  os << "{ ";
+  os << "small" << ": " << static_cast<int>(obj.small) << ", ";
+  os << "byte" << ": " << static_cast<int>(obj.byte) << ", ";
+  os << "medium" << ": " << obj.medium << ", ";
+  os << "port" << ": " << obj.port << ", ";
+  os << "count" << ": " << obj.count << ", ";
+  os << "mask" << ": " << obj.mask << ", ";
+  os << "big" << ": " << obj.big << ", ";
+  os << "huge" << ": " << obj.huge << ", ";
+  os << "ratio" << ": " << obj.ratio << ", ";
+  os << "precise" << ": " << obj.precise;
+  os << " }";
+  return os;
+}
+
+void writeText(gm::OutputBuffer &os, const Sized &obj) {
+  os << "{ ";
+  os << "small" << ": " << static_cast<int>(obj.small) << ", ";
+  os << "byte" << ": " << static_cast<int>(obj.byte) << ", ";
+  os << "medium" << ": " << obj.medium << ", ";
+  os << "port" << ": " << obj.port << ", ";
+  os << "count" << ": " << obj.count << ", ";
+  os << "mask" << ": " << obj.mask << ", ";
+  os << "big" << ": " << obj.big << ", ";
+  os << "huge" << ": " << obj.huge << ", ";
+  os << "ratio" << ": " << obj.ratio << ", ";
+  os << "precise" << ": " << obj.precise;
+  os << " }";
+}
+
+void encode(uint8_t *&out, const Sized &obj) {
+  gm::store<int8_t>(out, obj.small);
+  out += 1;
+  gm::store<uint8_t>(out, obj.byte);
+  out += 1;
+  gm::store<int16_t>(out, obj.medium);
+  out += 2;
+  gm::store<uint16_t>(out, obj.port);
+  out += 2;
+  gm::store<int32_t>(out, obj.count);
+  out += 4;
+  gm::store<uint32_t>(out, obj.mask);
+  out += 4;
+  gm::store<int64_t>(out, obj.big);
+  out += 8;
+  gm::store<uint64_t>(out, obj.huge);
+  out += 8;
+  gm::store<float>(out, obj.ratio);
+  out += 4;
+  gm::store<double>(out, obj.precise);
+  out += 8;
+}
+
+void decode(const uint8_t *&in, Sized &obj) {
+  obj.small = gm::load<int8_t>(in);
+  in += 1;
+  obj.byte = gm::load<uint8_t>(in);
+  in += 1;
+  obj.medium = gm::load<int16_t>(in);
+  in += 2;
+  obj.port = gm::load<uint16_t>(in);
+  in += 2;
+  obj.count = gm::load<int32_t>(in);
+  in += 4;
+  obj.mask = gm::load<uint32_t>(in);
+  in += 4;
+  obj.big = gm::load<int64_t>(in);
+  in += 8;
+  obj.huge = gm::load<uint64_t>(in);
+  in += 8;
+  obj.ratio = gm::load<float>(in);
+  in += 4;
+  obj.precise = gm::load<double>(in);
+  in += 8;
+}
+
+void writeJson(std::string &out, const Sized &obj) {
+  out += "{\"small\":";
+  gm::writeJson(out, obj.small);
+  out += ",\"byte\":";
+  gm::writeJson(out, obj.byte);
+  out += ",\"medium\":";
+  gm::writeJson(out, obj.medium);
+  out += ",\"port\":";
+  gm::writeJson(out, obj.port);
+  out += ",\"count\":";
+  gm::writeJson(out, obj.count);
+  out += ",\"mask\":";
+  gm::writeJson(out, obj.mask);
+  out += ",\"big\":";
+  gm::writeJson(out, obj.big);
+  out += ",\"huge\":";
+  gm::writeJson(out, obj.huge);
+  out += ",\"ratio\":";
+  gm::writeJson(out, obj.ratio);
+  out += ",\"precise\":";
+  gm::writeJson(out, obj.precise);
+  out += '}';
+}
+
+void readJson(const char *&cur, const char *end, Sized &obj) {
+  gm::json::expect(cur, end, '{');
+  if (gm::json::consume(cur, end, '}')) {
+    return;
+  }
+  const char *key;
+  size_t length;
+  do {
+    gm::json::readKey(cur, end, key, length);
+    switch (length) {
+    case 3:
+      if (std::memcmp(key, "big", 3) == 0) {
+        gm::readJson(cur, end, obj.big);
+        continue;
+      }
+      break;
+    case 4:
+      if (std::memcmp(key, "byte", 4) == 0) {
+        gm::readJson(cur, end, obj.byte);
+        continue;
+      }
+      if (std::memcmp(key, "port", 4) == 0) {
+        gm::readJson(cur, end, obj.port);
+        continue;
+      }
+      if (std::memcmp(key, "mask", 4) == 0) {
+        gm::readJson(cur, end, obj.mask);
+        continue;
+      }
+      if (std::memcmp(key, "huge", 4) == 0) {
+        gm::readJson(cur, end, obj.huge);
+        continue;
+      }
+      break;
+    case 5:
+      if (std::memcmp(key, "small", 5) == 0) {
+        gm::readJson(cur, end, obj.small);
+        continue;
+      }
+      if (std::memcmp(key, "count", 5) == 0) {
+        gm::readJson(cur, end, obj.count);
+        continue;
+      }
+      if (std::memcmp(key, "ratio", 5) == 0) {
+        gm::readJson(cur, end, obj.ratio);
+        continue;
+      }
+      break;
+    case 6:
+      if (std::memcmp(key, "medium", 6) == 0) {
+        gm::readJson(cur, end, obj.medium);
+        continue;
+      }
+      break;
+    case 7:
+      if (std::memcmp(key, "precise", 7) == 0) {
+        gm::readJson(cur, end, obj.precise);
+        continue;
+      }
+      break;
+    }
+    gm::json::skipValue(cur, end);
+  } while (gm::json::next(cur, end, '}'));
+}
+
+void randomize(gm::Rng &rng, Sized &obj) {
+  randomize(rng, obj.small);
+  randomize(rng, obj.byte);
+  randomize(rng, obj.medium);
+  randomize(rng, obj.port);
+  randomize(rng, obj.count);
+  randomize(rng, obj.mask);
+  randomize(rng, obj.big);
+  randomize(rng, obj.huge);
+  randomize(rng, obj.ratio);
+  randomize(rng, obj.precise);
+}
+
+bool Counter::operator==(const Counter &other) const {
+  return level == other.level
+      && delta == other.delta
+      && id == other.id
+      && stamp == other.stamp;
+}
+
+void randomize(gm::Rng &rng, Counter &obj) {
+  randomize(rng, obj.level);
+  obj.delta = static_cast<int8_t>(static_cast<int64_t>(rng.below(201U)) - 100);
+  randomize(rng, obj.id);
+  randomize(rng, obj.stamp);
+  obj.rehash();
+}
+
+const uint64_t Counter::kLevelKeys[256] = {
+  0x043e9a839dcae0b7ULL, 0x9e6de599b2b1bd14ULL, 0x09494cc7fc5649f6ULL, 0xa5ca669c95113983ULL,
+  0x6bb2eaa958ea648bULL, 0x1f73d215a19b58e6ULL, 0x4d5b26e51453199dULL, 0xf4ab2c7ba7dac294ULL,
+  0xbc6f384d4c3b6d10ULL, 0x2d3ceb47f1d92949ULL, 0xd136b1f88616cb7cULL, 0xf2be9bb49ccba8a5ULL,
+  0x127b0b02b65fd289ULL, 0x058654f5ea46fe6cULL, 0xb05ec80de7f466abULL, 0x3d528638ffa89ffdULL,
+  0x2047be82055d2c40ULL, 0xc70be2cd97d83f57ULL, 0xe25fdcd4ce3d1075ULL, 0x984fbb7c933a52e6ULL,
+  0x36fee385f536452eULL, 0xd108e2921f84c362ULL, 0xbf48ed7f26f43c3fULL, 0xc7b397d122d885e1ULL,
+  0x164d786e519e83f0ULL, 0xadfadb44b49fa202ULL, 0xf69e26b0a2bba6ccULL, 0x43ce97199cd4906eULL,
+  0x77cdae3f0a7d7122ULL, 0x52c975fea54e5149ULL, 0x7b491da372133ba3ULL, 0xfed1d874ab4d2629ULL,
+  0xd75ac34859032f71ULL, 0xfd7b60b9f3ca1bc6ULL, 0x57a24160fe64231cULL, 0x50180fd4d32b65a9ULL,
+  0x265b7a0189e89535ULL, 0xb4fee30470bbac6aULL, 0x9c818b425241f2b2ULL, 0x94ac6ca64fd5d5aaULL,
+  0x56b194f7355d55a7ULL, 0xbac3b866bb257695ULL, 0xcb07a401b30921c9ULL, 0x6a8a32025fd54e0cULL,
+  0x00021a72cb41c50aULL, 0xe7c6c66faea7b686ULL, 0x20cec10a4e3538bbULL, 0xaa176835b0a4c012ULL,
+  0x2b2dda3fcc4faf97ULL, 0x7fa98241eae5c8f8ULL, 0x1b9aee6a6f430e3fULL, 0x893b1ed322323f1dULL,
+  0xf60cd17275b3008aULL, 0xdf69fe373611c678ULL, 0x45748246a6c0516bULL, 0x6e2652355cb7a294ULL,
+  0x15f8147df7045177ULL, 0xc848b17fce0211e1ULL, 0xf79b110f8bc8925aULL, 0x1bafb3186485275dULL,
+  0x54ef83621135f613ULL, 0x4d5f51c8be29e358ULL, 0x4d54987a11e33b68ULL, 0x3eb469c263882280ULL,
+  0xb089162875c6b225ULL, 0xc578f4b4832e1e04ULL, 0x3eaa058587e6f671ULL, 0x419bf42536f83c5bULL,
+  0x50dfd0ec8cab37f7ULL, 0xde02ff56df19a36eULL, 0x263b43e4d560c113ULL, 0xa5c870936f56a326ULL,
+  0x2757ef0855c2354cULL, 0x90ae6ffc725cce74ULL, 0xa2995cc7e0c630e0ULL, 0x2388f5e2e39f433cULL,
+  0xd224b20d2dd41e99ULL, 0x7865afa9fc4bd90dULL, 0xf2b09730ff5e4364ULL, 0x7b61feca58390df2ULL,
+  0xd68de12dc5990888ULL, 0x19b23714cf5609d1ULL, 0x2b1907dabc30bb57ULL, 0xdd5c755a7f37ddf4ULL,
+  0xe725c1e33c710bb1ULL, 0xcddb822744d02810ULL, 0x30fa8c4479734ca8ULL, 0x1e2e93b7b39bea27ULL,
+  0xaa1676114578298eULL, 0xca96034ff28a8f14ULL, 0xc69ddbc92a4e9a1dULL, 0x9cb37e0054d665dbULL,
+  0xe7313400c4049d84ULL, 0x5cde8a1fc1b5a328ULL, 0x3082ef41f380bd65ULL, 0x82121390a2bbd4abULL,
+  0x5297ddf058ce38eeULL, 0x6fc41c242c57b9ceULL, 0x16f966bebbe5ea71ULL, 0x6c1469e17d6ac8ceULL,
+  0xa37c9e42e0da145cULL, 0xe5a5106a75754bf4ULL, 0xd38c19c0cdfe7a23ULL, 0xbf51997fe4de21beULL,
+  0x67ff97e426305fe7ULL, 0x94a6b16e41a89993ULL, 0xf6dfe43aca92a5abULL, 0xbedad814049a750bULL,
+  0x3052965755d94399ULL, 0xa06f8e7a8d9f1449ULL, 0x9b2f29e0836c32ffULL, 0x073d4ac2ac91c094ULL,
+  0xd211a59f3bfe0f0fULL, 0xf8b056b4f0d7a1faULL, 0x9e802062d8b3c59cULL, 0xe057fa118bddbc6dULL,
+  0xbbd2fd9377db66b8ULL, 0xd000cfffb61fcc84ULL, 0x5a4266fa50a819cdULL, 0x66f438484a0d82eeULL,
+  0xe9b3a1b485ab2beeULL, 0x196ea605312a7829ULL, 0x7306e0bf677c32b4ULL, 0x772c8b17eb626ed8ULL,
+  0x7a0239acbef18242ULL, 0x1ca39561c2006543ULL, 0xb1f15e7e8d15a505ULL, 0x25f9fab3f159707eULL,
+  0x12b11292af289980ULL, 0x560eb6febd276c41ULL, 0x8a91bba774ea3e95ULL, 0x724c949f40995b0cULL,
+  0x966bd89d1fd1ccf5ULL, 0x0e93447440e6e464ULL, 0x1f257a28f1d31f62ULL, 0xc9e93b6c579d6df0ULL,
+  0xf846de2b835e4381ULL, 0xe27a81971378b39cULL, 0x8b5643e2752d3d91ULL, 0x1da876a165fe5375ULL,
+  0x498e0ddc7e9ffb6aULL, 0xd436c7a78f520ec6ULL, 0x36ca599b4d7f6ca1ULL, 0x73cc0aadf817b74eULL,
+  0x0fca41604337a3e8ULL, 0x9e9640fa66ee8b46ULL, 0x31a5fa106a3868a3ULL, 0xcd66fc43ad283ea0ULL,
+  0x763aa2105b61c977ULL, 0x6d73f6dea69cb067ULL, 0xe995e4e69377b872ULL, 0xdeb45e95d33b8bccULL,
+  0x11ce55e6e2448632ULL, 0xa9ba88d2c5d8348dULL, 0x368f7a30de6ac8c3ULL, 0xbf00829e18f150f5ULL,
+  0xa5fba2c2e737598bULL, 0x8ddeeaf0b31050b0ULL, 0xc02001af0429cac2ULL, 0xe3147197f4e8c6deULL,
+  0x0b7eb6cde9a266aeULL, 0xe086892ff46f2120ULL, 0x1b1c16c99cd765c8ULL, 0x234a1e22240478aeULL,
+  0x9cacd3aea4c5b91cULL, 0xb39d45bead58cee9ULL, 0x958be5605d21f260ULL, 0x497a1b2a78def868ULL,
+  0x277866f99bd6c7edULL, 0x94a10165a964738dULL, 0x758068c1ba6c7587ULL, 0xb360d17369607453ULL,
+  0x3b17572f48483aaeULL, 0x702c6bda42c69dd0ULL, 0xadde63076b81e41fULL, 0x84a3b550dccff07cULL,
+  0x4b5847dca493506bULL, 0x44d824f345d0260dULL, 0x314f42b1b3eeb17aULL, 0x7f1abce88aed8fcbULL,
+  0xc6de0677c17b7035ULL, 0xae3c3102d88f3dcaULL, 0xf70de73738c4dfa3ULL, 0xbd92088ad08cbc32ULL,
+  0xe333d196ce77b335ULL, 0x23430ca473aad4d6ULL, 0x083bd7f1c7c25bd5ULL, 0x0584178b4314583dULL,
+  0x8007ace71ff002eaULL, 0xa4f1d45ab35d534eULL, 0x27389da3e42677a0ULL, 0x2c2760040cbb0be6ULL,
+  0x1443658ab0d0ca63ULL, 0xa607f03938bfeda6ULL, 0xcf2b86a47aba647bULL, 0x719a4c915e46759fULL,
+  0x061833de8e4e12b1ULL, 0x3c228625ceaa1a67ULL, 0x93de715ba3378ed8ULL, 0xaab01290211e1599ULL,
+  0xbfba3046a9f2ca6dULL, 0x62c0124519925fe7ULL, 0x3285fdc4d9b5a2e6ULL, 0xb9878f65e347ca6cULL,
+  0x4dc2f5a325e57f5eULL, 0x7c785867a247a550ULL, 0x7bbf53af67bcc094ULL, 0x0fa645302880e902ULL,
+  0x7fc9145de5772468ULL, 0x35b79a230cc55f84ULL, 0x7bcbf378c55e4b21ULL, 0x7d4071ee773d334cULL,
+  0x8071305100b5040dULL, 0x3662ec78e14d9992ULL, 0x8f826059a9e7f6efULL, 0x6d7cf5adaf97cbb0ULL,
+  0xc413fc5a25da102aULL, 0x852769ecd4ff8b5eULL, 0x78130aa5b6d85c13ULL, 0x40a0d7c794ba205fULL,
+  0x025983b9822ad1eaULL, 0xf3a05aa0ff1826e3ULL, 0xb6fb38501a56d211ULL, 0x6a85fc7322012eadULL,
+  0x94735b01487c9752ULL, 0x4d1c3bd9e0122792ULL, 0xcaa0c324a10dd9efULL, 0x8ad14c5f2626c426ULL,
+  0x73291888d9c65a76ULL, 0x405bcf197d8bc004ULL, 0x831cf460b7cd56edULL, 0x477653866cb1bbcdULL,
+  0x2260adef6898c07eULL, 0x537d81c16f1cf552ULL, 0x9b44892a77523d11ULL, 0x65a50528b1bb496cULL,
+  0xaa1d6f9e887cf27cULL, 0x701588a4ab71a30aULL, 0xef4ec06ee26fb1a5ULL, 0x7be4080ba48047ccULL,
+  0xc7be01262c514e11ULL, 0x36ff86223557b50cULL, 0xb5886e551c965cbbULL, 0xd342dfbf2d6f012eULL,
+  0x93f98ce15817df6cULL, 0x5aa81f697bf81210ULL, 0xbbf780da48d3b5adULL, 0xccc861b53793b803ULL,
+  0xb68c6d32a5892795ULL, 0x15f4cc7cc79f9dd0ULL, 0x7ce89ef2f14b2ad1ULL, 0x7d923bd04f9e3493ULL,
+  0x4a4b45a186f3b211ULL, 0x799e7e293bd7d7afULL, 0xe8ce6208691c5fa0ULL, 0x0669416b86abc8a2ULL,
+};
+
+const uint64_t Counter::kDeltaKeys[201] = {
+  0x77cb64129e5c3871ULL, 0x1c60fda71060296dULL, 0x359bf8bc48a2feebULL, 0xd6fc66309feef328ULL,
+  0xa1c1361317675644ULL, 0x3a65ea8015c0dd51ULL, 0xe1ce2efdb7dc40ffULL, 0xebc0f78688f34700ULL,
+  0x20f99b710b7dc0d5ULL, 0xebcc09b7f0c308acULL, 0xd661aa6e44853921ULL, 0xf5c3e12c577e1ebdULL,
+  0x4f38deab8cff6503ULL, 0x6268a34e1d55d878ULL, 0xba1ed87d3da6cad9ULL, 0x6b9eb878b1532deeULL,
+  0xa9e5c6f6296e4f63ULL, 0xa129107eede6ad7dULL, 0x91902437238176e0ULL, 0xde09bb2424bd14d0ULL,
+  0xc068490d11c1b2e3ULL, 0x91951ce657c67d37ULL, 0xe3d71683afc7596aULL, 0x6dedc172c36ddbffULL,
+  0x6fc69ca3d4b5c4f3ULL, 0xfca866f162ffb469ULL, 0x4407fb12cbd575b8ULL, 0x7ca1cfec0e39633dULL,
+  0xccc5b7dd022b1d65ULL, 0x87398d66765c090cULL, 0xbfa98a34241ea4f8ULL, 0xac4597368a06d7dcULL,
+  0xb94e0793f7facbb8ULL, 0x98879a7694dc2d7bULL, 0xbb18bbca532eeb68ULL, 0x7ae08bdddffbeeecULL,
+  0xa96b22a5dc1e8a4fULL, 0xd8baddde9614713aULL, 0xd1ffe1394f19ae30ULL, 0x5349190ea093d6f4ULL,
+  0x2d27eed0b738e7deULL, 0x84cef5926668eb04ULL, 0x851654f9b0e519dbULL, 0xb0de9eca310d69e5ULL,
+  0x45f74e8f895299f2ULL, 0x2b5f8521731e0060ULL, 0xfe75d0b8b3ebabd7ULL, 0x7efa45bda0cdd992ULL,
+  0xaa1a3e6e332ca6c5ULL, 0xbb2c26f44f2394a3ULL, 0x390fce6dd03762f0ULL, 0xa724ed2933379ceaULL,
+  0x865e64c5ee0c4a2cULL, 0x39f0d9254920d635ULL, 0xd5edc590d8e34223ULL, 0xb2302e7dce358364ULL,
+  0x2a812e3d9585b658ULL, 0x3ddad4f41a73d8cbULL, 0x966c8b55a84c824aULL, 0x6ae27166b2061f70ULL,
+  0xf8ee03e334bd8d30ULL, 0x5162103130fadc0aULL, 0xe6bc127fbcce8af5ULL, 0x488d0e387aabf9abULL,
+  0xb140a7962ce5f4b7ULL, 0x169e4d85e7b25a1bULL, 0x380634a2b40b5864ULL, 0x39c5b851e004d485ULL,
+  0x1498f28102f34fafULL, 0x8f8f78c43a1746edULL, 0xa724161e08311591ULL, 0xed1a81a6f48b2a09ULL,
+  0xc2dcdcf1afde5585ULL, 0x387e51b185f42f67ULL, 0x80405c2b99b4e730ULL, 0x4c4b31848ce508ddULL,
+  0xacb0905b780a5655ULL, 0x6f3fb1a2a8ceac93ULL, 0xe68602afa6ff10f6ULL, 0x2ea7fb5f74be05e5ULL,
+  0x006e46ebdf738b72ULL, 0x7e05c4a339edfed3ULL, 0x792903a0d106c389ULL, 0xcd514d4cef5300b0ULL,
+  0x2de60e9b9d26061eULL, 0x1aefe103a861afffULL, 0xb90f62e40e94965eULL, 0xd1fb2d7ed102e705ULL,
+  0x558f2b8ca890f388ULL, 0x20f500ec4622cd18ULL, 0xb2ee17d6b2bc97cbULL, 0x87ae26c72dc23830ULL,
+  0x225eb18bd616b50aULL, 0x3831e30007af4bdbULL, 0x82661afb13a22040ULL, 0xfb9cb2cac444f287ULL,
+  0x82da1c6feca4e8caULL, 0x6e2d07aa05be1a00ULL, 0xa597899b2f6be41aULL, 0x64ed3afd877120a8ULL,
+  0x6d7f47bd1fe16148ULL, 0xab132995288921eeULL, 0x4af02ff2d3343532ULL, 0xa12584f404d6bd20ULL,
+  0x095acfe5d5bd2690ULL, 0xbec1918a9fdd5921ULL, 0x36c746f2e9cd4cdfULL, 0x63053bc8113d17e4ULL,
+  0x279641268cd0a36cULL, 0x20c67475ca5a6dfaULL, 0xde7fc98a816e8addULL, 0x1faade8dea68c31eULL,
+  0xfef1ce317c31df78ULL, 0x0ce9498409b4c006ULL, 0x4162d0326b3fb32aULL, 0x99f78ba3558042edULL,
+  0xce7b4554a23d8b0aULL, 0x47ea2316f4f1170fULL, 0x989b4d292c6efb4aULL, 0xaf105832e13251e1ULL,
+  0x38c571beb94a3dd8ULL, 0x6ad91996bee2482dULL, 0x8a9c5df29e0602feULL, 0xabbd77cfa6c7d3e8ULL,
+  0x5e778d4b70abe4a5ULL, 0xc2609b8e454bb246ULL, 0x79f836f63716d974ULL, 0x7c468f71862e080dULL,
+  0xf438b7f24bb4ce6bULL, 0xc67d0659b72e6001ULL, 0x2f9812e42607d513ULL, 0x6f586a0f88bff340ULL,
+  0x9a9317463d4a4d31ULL, 0x456d2cad05f67a58ULL, 0x09812ab023972520ULL, 0xb5b8bd36f53de320ULL,
+  0x5f108dd7a535cd55ULL, 0x4083d25defc46f98ULL, 0xa6b7096d17e3204dULL, 0x164ed969aec7bf56ULL,
+  0x27baa1651f8b4b30ULL, 0x3ddf9bb8fb708fd1ULL, 0x067e1c936f7bc046ULL, 0xfd105721632392b6ULL,
+  0xd1d0a0b3184014ceULL, 0x39faa049191de979ULL, 0x3d2a69f53dc1968aULL, 0xe1d0b1dc9d071073ULL,
+  0x0b935dcb6e265b71ULL, 0xe459cd08945f59c1ULL, 0x71360ea36f436045ULL, 0xec5c2efb7584615aULL,
+  0xb4326d28dc6d8009ULL, 0x847e7b771d5b4322ULL, 0x4f3a3ea542721406ULL, 0xdceb5bba775017d8ULL,
+  0x1b482e77ad8a468cULL, 0x916837e450457fe3ULL, 0xa1d7716d9ba375c7ULL, 0x641d3a5ac1278d2dULL,
+  0x8d2b4998af007ef4ULL, 0x64c88c295cd86be3ULL, 0x605b7a7bee4d0364ULL, 0x1b32feeeab636abaULL,
+  0x012d78c111c1debeULL, 0x7053d2330d08f527ULL, 0x683f795015860238ULL, 0x716eb47cb7fb6a00ULL,
+  0xbe130153f96b7e3eULL, 0x3e2a432c9bce278cULL, 0xaca7eff71f0a7c4eULL, 0x8db979505cda87c6ULL,
+  0x0574622ffd4a43c3ULL, 0x37943f742ec4f5e3ULL, 0x3e2d1dd361cb22abULL, 0x9f41740ac9a98776ULL,
+  0x02feeb35bdefc001ULL, 0x0c394898ef4d986bULL, 0x9902496a8dfe37c7ULL, 0x6820318e8b486682ULL,
+  0x7c12c47a17106d5dULL, 0xef7d68d463141f7eULL, 0x5a39ca1c047790b4ULL, 0x7ad0833c2a25a77dULL,
+  0x35a828150b6b228aULL, 0x210ee9fa888a1698ULL, 0xb03c4624fca7c8b2ULL, 0x67816bc90bdc0a75ULL,
+  0x5b3ca49a93d157faULL, 0x04fbde3db14b69dcULL, 0x98f6948f3593e695ULL, 0x2ec05eb26fe65359ULL,
+  0x2e31a83ff0ccdb8bULL, 0x1165146db7138e46ULL, 0xb2e7ccea64650574ULL, 0xb26e6f1d3ca3feb7ULL,
+  0x0e65a6f97d5cacb3ULL, 0xa38c216416a1516cULL, 0xa8b3002923a147e2ULL, 0xa4513b4912a85bfeULL,
+  0x6c926fd71fd7bb3fULL,
+};
+
+CounterPacked pack(const Counter &obj) {
+  CounterPacked packed;
+  packed.setLevel(obj.level);
+  packed.setDelta(obj.delta);
+  packed.setId(obj.id);
+  packed.setStamp(obj.stamp);
+  return packed;
+}
+
+void unpack(const CounterPacked &packed, Counter &obj) {
+  obj.level = packed.level();
+  obj.delta = packed.delta();
+  obj.id = packed.id();
+  obj.stamp = packed.stamp();
+  obj.rehash();
+}
+
+bool Packet::operator==(const Packet &other) const {
+  if (type != other.type) return false;
+  switch (type) {
+  case Packet::Ping_t:
+    return std::memcmp(&data.Ping, &other.data.Ping, sizeof(Ping_d)) == 0;
+  case Packet::Send_t:
+    return data.Send.port == other.data.Send.port
+      && data.Send.value == other.data.Send.value;
+  break;
+  case Packet::Wait_t:
+    return std::memcmp(&data.Wait, &other.data.Wait, sizeof(Wait_d)) == 0;
+  default:
+    return true;
+  }
+}
+
+#ifdef GAMMA_PROFILE
+static const char *const kPacketVariants[] = {
+  "Ping", "Send", "Wait", 
+};
+static uint64_t *const kPacketHits = gm::Profile::instance().add("Packet", kPacketVariants, 3);
+#endif
+
+std::istream &operator>>(std::istream &is, Packet &obj) {
+  std::string str;
+  if (!(is >> str)) {
+    return is;
+  }
+  if (str == "Ping") {
+    obj.type = Packet::Ping_t;
+    GM_PROFILE_HIT(kPacketHits, Packet::Ping_t - 1);
+    gm::readNumber(is, obj.data.Ping.id);
+  }
+  else if (str == "Send") {
+    obj.type = Packet::Send_t;
+    GM_PROFILE_HIT(kPacketHits, Packet::Send_t - 1);
+    is >> obj.data.Send.port;
+    is >> obj.data.Send.value;
+  }
+  else if (str == "Wait") {
+    obj.type = Packet::Wait_t;
+    GM_PROFILE_HIT(kPacketHits, Packet::Wait_t - 1);
+    gm::readNumber(is, obj.data.Wait.ticks);
+    if (obj.data.Wait.ticks < 1 || obj.data.Wait.ticks > 60) {
+      throw std::runtime_error("Invalid Packet");
+    }
+  }
+  else {
+    throw std::runtime_error("Invalid Packet");
+  }
+  return is;
+}
+
+void readText(const char *&cur, const char *end, Packet &obj) {
+  const char *key;
+  size_t length;
+  gm::text::readToken(cur, end, key, length);
+  switch (length) {
+  case 4:
+    if (std::memcmp(key, "Ping", 4) == 0) {
+      obj.type = Packet::Ping_t;
+      GM_PROFILE_HIT(kPacketHits, Packet::Ping_t - 1);
+      gm::readText(cur, end, obj.data.Ping.id);
+      return;
+    }
+    if (std::memcmp(key, "Send", 4) == 0) {
+      obj.type = Packet::Send_t;
+      GM_PROFILE_HIT(kPacketHits, Packet::Send_t - 1);
+      gm::readText(cur, end, obj.data.Send.port);
+      gm::readText(cur, end, obj.data.Send.value);
+      return;
+    }
+    if (std::memcmp(key, "Wait", 4) == 0) {
+      obj.type = Packet::Wait_t;
+      GM_PROFILE_HIT(kPacketHits, Packet::Wait_t - 1);
+      gm::readText(cur, end, obj.data.Wait.ticks);
+      if (obj.data.Wait.ticks < 1 || obj.data.Wait.ticks > 60) {
+        gm::text::error("Packet::Wait::ticks out of range");
+      }
+      return;
+    }
+    break;
+  }
+  gm::text::error("invalid Packet");
+}
+
+void readMany(const char *&cur, const char *end, size_t n, Packet *out) {
+  const char *p = cur;
+  for (size_t i = 0; i < n; i++) {
+    readText(p, end, out[i]);
+  }
+  cur = p;
+}
+
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Packet> &out) {
+  const char *p = cur;
+  size_t size = out.size();
+  out.reserve(size + n);
+  try {
+    for (size_t i = 0; i < n; i++) {
+      Packet item;
+      readText(p, end, item);
+      out.push_back(std::move(item));
+    }
+  }
+  catch (...) {
+    out.erase(out.begin() + size, out.end());
+    throw;
+  }
+  cur = p;
+}
+
+std::ostream &operator<<(std::ostream &os, const Packet &obj) {
+  switch (obj.type) {
+  case Packet::Ping_t:
+    os << "Ping " << static_cast<int>(obj.data.Ping.id) << "";
+  break;
+  case Packet::Send_t:
+    os << "Send " << obj.data.Send.port << " " << obj.data.Send.value << "";
+  break;
+  case Packet::Wait_t:
+    os << "Wait " << static_cast<int>(obj.data.Wait.ticks) << "";
+  break;
+  default:
+    break;
+  }
+  return os;
+}
+
+void encode(uint8_t *&out, const Packet &obj) {
+  gm::store<uint8_t>(out, obj.type);
+  out += 1;
+  uint8_t *end = out + 10;
+  switch (obj.type) {
+  case Packet::Ping_t:
+    gm::store<uint8_t>(out, obj.data.Ping.id);
+    out += 1;
+    break;
+  case Packet::Send_t:
+    gm::store<uint16_t>(out, obj.data.Send.port);
+    out += 2;
+    gm::store<int64_t>(out, obj.data.Send.value);
+    out += 8;
+    break;
+  case Packet::Wait_t:
+    gm::store<uint8_t>(out, obj.data.Wait.ticks);
+    out += 1;
+    break;
+  default:
+    break;
+  }
+  std::memset(out, 0, end - out);
+  out = end;
+}
+
+void decode(const uint8_t *&in, Packet &obj) {
+  auto type = static_cast<Packet::Type>(gm::load<uint8_t>(in));
+  in += 1;
+  const uint8_t *end = in + 10;
+  switch (type) {
+  case Packet::Undef:
+    break;
+  case Packet::Ping_t:
+    obj.data.Ping.id = gm::load<uint8_t>(in);
+    in += 1;
+    break;
+  case Packet::Send_t:
+    obj.data.Send.port = gm::load<uint16_t>(in);
+    in += 2;
+    obj.data.Send.value = gm::load<int64_t>(in);
+    in += 8;
+    break;
+  case Packet::Wait_t:
+    obj.data.Wait.ticks = gm::load<uint8_t>(in);
+    if (obj.data.Wait.ticks < 1 || obj.data.Wait.ticks > 60) {
+      throw std::runtime_error("Value out of range");
+    }
+    in += 1;
+    break;
+  default:
+    throw std::runtime_error("Invalid Packet type");
+  }
+  obj.type = type;
+  in = end;
+}
+
+bool Gauge::operator==(const Gauge &other) const {
+  return level == other.level
+      && offset == other.offset;
+}
+
+std::istream &operator>>(std::istream &is, Gauge &obj) {
+  gm::readNumber(is, obj.level);
+  if (obj.level < 1 || obj.level > 200) {
+    is.setstate(std::ios::failbit);
+  }
+  is >> obj.offset;
+  if (obj.offset < -5 || obj.offset > 5) {
+    is.setstate(std::ios::failbit);
+  }
+  return is;
+}
+
+void readText(const char *&cur, const char *end, Gauge &obj) {
+  gm::readText(cur, end, obj.level);
+  if (obj.level < 1 || obj.level > 200) {
+    gm::text::error("Gauge::level out of range");
+  }
+  gm::readText(cur, end, obj.offset);
+  if (obj.offset < -5 || obj.offset > 5) {
+    gm::text::error("Gauge::offset out of range");
+  }
+}
+
+void readMany(const char *&cur, const char *end, size_t n, Gauge *out) {
+  const char *p = cur;
+  for (size_t i = 0; i < n; i++) {
+    readText(p, end, out[i]);
+  }
+  cur = p;
+}
+
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Gauge> &out) {
+  const char *p = cur;
+  size_t size = out.size();
+  out.reserve(size + n);
+  try {
+    for (size_t i = 0; i < n; i++) {
+      Gauge item;
+      readText(p, end, item);
+      out.push_back(std::move(item));
+    }
+  }
+  catch (...) {
+    out.erase(out.begin() + size, out.end());
+    throw;
+  }
+  cur = p;
+}
+
+std::ostream &operator<<(std::ostream &os, const Gauge &obj) {
+  os << "{ ";
+  os << "level" << ": " << static_cast<int>(obj.level) << ", ";
+  os << "offset" << ": " << obj.offset;
+  os << " }";
+  return os;
+}
+
+void encode(uint8_t *&out, const Gauge &obj) {
+  gm::store<uint8_t>(out, obj.level);
+  out += 1;
+  gm::store<int32_t>(out, obj.offset);
+  out += 4;
+}
+
+void decode(const uint8_t *&in, Gauge &obj) {
+  obj.level = gm::load<uint8_t>(in);
+  if (obj.level < 1 || obj.level > 200) {
+    throw std::runtime_error("Value out of range");
+  }
+  in += 1;
+  obj.offset = gm::load<int32_t>(in);
+  if (obj.offset < -5 || obj.offset > 5) {
+    throw std::runtime_error("Value out of range");
+  }
+  in += 4;
+}
+
+void writeJson(std::string &out, const Gauge &obj) {
+  out += "{\"level\":";
+  gm::writeJson(out, obj.level);
+  out += ",\"offset\":";
+  gm::writeJson(out, obj.offset);
+  out += '}';
+}
+
+void readJson(const char *&cur, const char *end, Gauge &obj) {
+  gm::json::expect(cur, end, '{');
+  if (gm::json::consume(cur, end, '}')) {
+    return;
+  }
+  const char *key;
+  size_t length;
+  do {
+    gm::json::readKey(cur, end, key, length);
+    switch (length) {
+    case 5:
+      if (std::memcmp(key, "level", 5) == 0) {
+        gm::readJson(cur, end, obj.level);
+        if (obj.level < 1 || obj.level > 200) {
+          gm::json::error("Gauge::level out of range");
+        }
+        continue;
+      }
+      break;
+    case 6:
+      if (std::memcmp(key, "offset", 6) == 0) {
+        gm::readJson(cur, end, obj.offset);
+        if (obj.offset < -5 || obj.offset > 5) {
+          gm::json::error("Gauge::offset out of range");
+        }
+        continue;
+      }
+      break;
+    }
+    gm::json::skipValue(cur, end);
+  } while (gm::json::next(cur, end, '}'));
+}
+
@@ -0,0 +1,255 @@
+#ifndef src_sized_gm__
+#define src_sized_gm__
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "gamma/bin.hpp"
+#include "gamma/io.hpp"
+#include "gamma/json.hpp"
+#include "gamma/out.hpp"
+#include "gamma/random.hpp"
+#include "gamma/text.hpp"
+
+struct Sized {
+  Sized() = default;
+  constexpr Sized(int8_t small, uint8_t byte, int16_t medium, uint16_t port, int32_t count, uint32_t mask, int64_t big, uint64_t huge, float ratio, double precise) noexcept: small(small), byte(byte), medium(medium), port(port), count(count), mask(mask), big(big), huge(huge), ratio(ratio), precise(precise) {}
+  int8_t small;
+  uint8_t byte;
+  int16_t medium;
+  uint16_t port;
+  int32_t count;
+  uint32_t mask;
+  int64_t big;
+  uint64_t huge;
+  float ratio;
+  double precise;
+  bool operator==(const Sized &other) const;
+};
+
+static_assert(std::is_trivially_copyable<Sized>::value, "Sized must be trivially copyable");
+
+std::istream &operator>>(std::istream &is, Sized &obj);
+void readText(const char *&cur, const char *end, Sized &obj);
+void readMany(const char *&cur, const char *end, size_t n, Sized *out);
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Sized> &out);
+
+std::ostream &operator<<(std::ostream &os, const Sized &obj);
+void writeText(gm::OutputBuffer &os, const Sized &obj);
+
+constexpr size_t kSizedBinSize = 42;
+constexpr uint64_t kSizedFingerprint = 0x4dc2ea19e8134385ULL;
+void encode(uint8_t *&out, const Sized &obj);
+void decode(const uint8_t *&in, Sized &obj);
+
+void writeJson(std::string &out, const Sized &obj);
+void readJson(const char *&cur, const char *end, Sized &obj);
+
+void randomize(gm::Rng &rng, Sized &obj);
+
+struct Counter {
+  Counter() : level(), delta(), id(), stamp() {
+    rehash();
+  }
+  Counter(uint8_t level, int8_t delta, uint16_t id, int64_t stamp) : level(level), delta(delta), id(id), stamp(stamp) {
+    rehash();
+  }
+  uint8_t level;
+  int8_t delta;
+  uint16_t id;
+  int64_t stamp;
+  uint64_t hash;
+  enum Field {
+    level_f,
+    delta_f,
+    id_f,
+    stamp_f,
+  };
+  bool operator==(const Counter &other) const;
+  static const uint64_t kLevelKeys[256];
+  static const uint64_t kDeltaKeys[201];
+  uint64_t computeHash() const {
+    uint64_t hash = 0;
+    hash ^= kLevelKeys[static_cast<unsigned char>(level)];
+    if (delta < -100 || delta > 100) {
+      throw std::out_of_range("Counter::delta");
+    }
+    hash ^= kDeltaKeys[static_cast<size_t>(delta + 100)];
+    return hash;
+  }
+  void rehash() {
+    hash = computeHash();
+  }
+  void setLevel(uint8_t value) {
+    this->hash ^= kLevelKeys[static_cast<unsigned char>(this->level)] ^ kLevelKeys[static_cast<unsigned char>(value)];
+    this->level = value;
+  }
+  void setDelta(int8_t value) {
+    if (value < -100 || value > 100) {
+      throw std::out_of_range("Counter::setDelta");
+    }
+    this->hash ^= kDeltaKeys[static_cast<size_t>(this->delta + 100)] ^ kDeltaKeys[static_cast<size_t>(value + 100)];
+    this->delta = value;
+  }
+  void setId(uint16_t value) {
+    this->id = value;
+  }
+  void setStamp(int64_t value) {
+    this->stamp = value;
+  }
+};
+
+static_assert(std::is_trivially_copyable<Counter>::value, "Counter must be trivially copyable");
+
+void randomize(gm::Rng &rng, Counter &obj);
+
+struct CounterPacked {
+  CounterPacked() : words() {}
+  uint8_t level() const { return static_cast<uint8_t>(words[0] & 0xffULL); }
+  void setLevel(uint8_t value) {
+    words[0] = (words[0] & ~0xffULL) | (static_cast<uint8_t>(value) & 0xffULL);
+  }
+  int8_t delta() const { return static_cast<int8_t>(static_cast<int64_t>((words[0] >> 8) & 0xffULL) - 100); }
+  void setDelta(int8_t value) {
+    if (value < -100 || value > 100) {
+      throw std::out_of_range("CounterPacked::setDelta");
+    }
+    words[0] = (words[0] & ~0xff00ULL) | (((static_cast<uint64_t>(value) + 100) & 0xffULL) << 8);
+  }
+  uint16_t id() const { return static_cast<uint16_t>((words[0] >> 16) & 0xffffULL); }
+  void setId(uint16_t value) {
+    words[0] = (words[0] & ~0xffff0000ULL) | ((static_cast<uint16_t>(value) & 0xffffULL) << 16);
+  }
+  int64_t stamp() const { return static_cast<int64_t>(static_cast<uint64_t>(words[1])); }
+  void setStamp(int64_t value) {
+    words[1] = static_cast<uint64_t>(value);
+  }
+  bool operator==(const CounterPacked &other) const {
+    return words[0] == other.words[0] && words[1] == other.words[1];
+  }
+  bool operator!=(const CounterPacked &other) const { return !(*this == other); }
+  uint64_t hash() const {
+    uint64_t h = words[0] * 0x9E3779B97F4A7C15ULL;
+    h = (h ^ words[1]) * 0x9E3779B97F4A7C15ULL;
+    return h ^ (h >> 29);
+  }
+  uint64_t words[2];
+};
+
+CounterPacked pack(const Counter &obj);
+void unpack(const CounterPacked &packed, Counter &obj);
+
+struct Packet {
+  enum Type {
+    Undef,
+    Ping_t,
+    Send_t,
+    Wait_t,
+  } type;
+  struct Ping_d {
+    uint8_t id;
+  };
+  struct Send_d {
+    uint16_t port;
+    int64_t value;
+  };
+  struct Wait_d {
+    uint8_t ticks;
+  };
+  union Data {
+    constexpr Data() noexcept: Ping() {}
+    constexpr Data(Ping_d Ping) noexcept: Ping(Ping) {}
+    constexpr Data(Send_d Send) noexcept: Send(Send) {}
+    constexpr Data(Wait_d Wait) noexcept: Wait(Wait) {}
+    Ping_d Ping;
+    Send_d Send;
+    Wait_d Wait;
+  } data;
+  constexpr Packet(Type type = Undef) noexcept: type(type), data() {}
+  constexpr Packet(Type type, Data data) noexcept: type(type), data(data) {}
+  static constexpr Packet Ping(uint8_t id) noexcept {
+    return Packet(Ping_t, Ping_d{id});
+  }
+  static constexpr Packet Send(uint16_t port, int64_t value) noexcept {
+    return Packet(Send_t, Send_d{port, value});
+  }
+  static constexpr Packet Wait(uint8_t ticks) noexcept {
+    return Packet(Wait_t, Wait_d{ticks});
+  }
+  bool operator==(const Packet &other) const;
+};
+
+template <typename Visitor>
+auto visit(const Packet &obj, Visitor &&vis) -> decltype(vis(obj.data.Ping)) {
+  switch (obj.type) {
+  case Packet::Ping_t:
+    return vis(obj.data.Ping);
+  case Packet::Send_t:
+    return vis(obj.data.Send);
+  case Packet::Wait_t:
+    return vis(obj.data.Wait);
+  default:
+    throw std::invalid_argument("visit: undefined Packet");
+  }
+}
+
+template <typename Visitor>
+auto visit(Packet &obj, Visitor &&vis) -> decltype(vis(obj.data.Ping)) {
+  switch (obj.type) {
+  case Packet::Ping_t:
+    return vis(obj.data.Ping);
+  case Packet::Send_t:
+    return vis(obj.data.Send);
+  case Packet::Wait_t:
+    return vis(obj.data.Wait);
+  default:
+    throw std::invalid_argument("visit: undefined Packet");
+  }
+}
+
+static_assert(std::is_trivially_copyable<Packet>::value, "Packet must be trivially copyable");
+static_assert(sizeof(Packet::Ping_d) == sizeof(uint8_t), "Packet::Ping_d must have no padding");
+static_assert(sizeof(Packet::Wait_d) == sizeof(uint8_t), "Packet::Wait_d must have no padding");
+
+std::istream &operator>>(std::istream &is, Packet &obj);
+void readText(const char *&cur, const char *end, Packet &obj);
+void readMany(const char *&cur, const char *end, size_t n, Packet *out);
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Packet> &out);
+
+std::ostream &operator<<(std::ostream &os, const Packet &obj);
+
+constexpr size_t kPacketBinSize = 11;
+constexpr uint64_t kPacketFingerprint = 0x93719f2b7a56f959ULL;
+void encode(uint8_t *&out, const Packet &obj);
+void decode(const uint8_t *&in, Packet &obj);
+
+struct Gauge {
+  Gauge() = default;
+  constexpr Gauge(uint8_t level, int32_t offset) noexcept: level(level), offset(offset) {}
+  uint8_t level;
+  int32_t offset;
+  bool operator==(const Gauge &other) const;
+};
+
+static_assert(std::is_trivially_copyable<Gauge>::value, "Gauge must be trivially copyable");
+
+std::istream &operator>>(std::istream &is, Gauge &obj);
+void readText(const char *&cur, const char *end, Gauge &obj);
+void readMany(const char *&cur, const char *end, size_t n, Gauge *out);
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Gauge> &out);
+
+std::ostream &operator<<(std::ostream &os, const Gauge &obj);
+
+constexpr size_t kGaugeBinSize = 5;
+constexpr uint64_t kGaugeFingerprint = 0x63c71e115343f361ULL;
+void encode(uint8_t *&out, const Gauge &obj);
+void decode(const uint8_t *&in, Gauge &obj);
+
+void writeJson(std::string &out, const Gauge &obj);
+void readJson(const char *&cur, const char *end, Gauge &obj);
+
+
+#endif
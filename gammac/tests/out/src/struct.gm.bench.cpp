@@ -0,0 +1,426 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "gamma/containers.hpp"
+#include "gamma/optional.hpp"
+#include "gamma/random.hpp"
+
+#include "src/struct.gm.hpp"
+
+// Generated by gammac --emit-bench; usage: <program> [count]
+
+template <typename T>
+static inline void writeInput(std::ostream &os, const T &value) { os << value; }
+static inline void writeInput(std::ostream &os, int8_t value) { os << static_cast<int>(value); }
+static inline void writeInput(std::ostream &os, uint8_t value) { os << static_cast<int>(value); }
+template <typename T, size_t N>
+static inline void writeInput(std::ostream &os, const gm::Array<T, N> &value);
+template <typename T, size_t N>
+static inline void writeInput(std::ostream &os, const gm::SmallVec<T, N> &value);
+template <typename T>
+static inline void writeInput(std::ostream &os, const gm::Vec<T> &value);
+template <typename T, typename Niche>
+static inline void writeInput(std::ostream &os, const gm::Optional<T, Niche> &value);
+
+template <typename Container>
+static inline void writeInputItems(std::ostream &os, const Container &value) {
+  for (const auto &item : value) {
+    os << ' ';
+    writeInput(os, item);
+  }
+}
+
+template <typename T, size_t N>
+static inline void writeInput(std::ostream &os, const gm::Array<T, N> &value) {
+  writeInput(os, value[0]);
+  for (size_t i = 1; i < N; i++) {
+    os << ' ';
+    writeInput(os, value[i]);
+  }
+}
+
+template <typename T, size_t N>
+static inline void writeInput(std::ostream &os, const gm::SmallVec<T, N> &value) {
+  os << value.size();
+  writeInputItems(os, value);
+}
+
+template <typename T>
+static inline void writeInput(std::ostream &os, const gm::Vec<T> &value) {
+  os << value.size();
+  writeInputItems(os, value);
+}
+
+template <typename T, typename Niche>
+static inline void writeInput(std::ostream &os, const gm::Optional<T, Niche> &value) {
+  if (value.has_value()) {
+    writeInput(os, *value);
+  }
+  else {
+    os << '-';
+  }
+}
+
+typedef std::chrono::steady_clock BenchClock;
+
+static void report(const char *type, const char *trait, BenchClock::time_point start, size_t count, size_t bytes) {
+  double ns = std::chrono::duration<double, std::nano>(BenchClock::now() - start).count();
+  if (bytes > 0) {
+    std::printf("%-20s %-8s %10.1f ns/op %10.1f MB/s\n", type, trait, ns / count, bytes * 1e3 / ns);
+  }
+  else {
+    std::printf("%-20s %-8s %10.1f ns/op\n", type, trait, ns / count);
+  }
+}
+
+static inline void randomize(gm::Rng &, Unit &) {
+}
+
+static inline void randomize(gm::Rng &rng, Coord &obj) {
+  randomize(rng, obj.x);
+  randomize(rng, obj.y);
+}
+
+static void benchCoord(size_t count) {
+  gm::Rng rng(1932118957629651470ULL);
+  std::vector<Coord> values(count);
+  for (auto &value : values) {
+    randomize(rng, value);
+  }
+  {
+    std::vector<Coord> copies(values);
+    size_t equal = 0;
+    auto start = BenchClock::now();
+    for (size_t i = 0; i < count; i++) {
+      equal += values[i] == copies[i];
+    }
+    report("Coord", "Eq", start, count, 0);
+    if (equal != count) {
+      std::printf("%s: copies differ\n", "Coord");
+    }
+  }
+}
+
+static inline void writeInput(std::ostream &os, const Player &obj) {
+  writeInput(os, obj.life);
+  os << ' ';
+  writeInput(os, obj.bombs);
+}
+
+static void benchPlayer(size_t count) {
+  gm::Rng rng(3692324345213718176ULL);
+  std::vector<Player> values(count);
+  for (auto &value : values) {
+    randomize(rng, value);
+  }
+  {
+    std::ostringstream os;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      os << value << '\n';
+    }
+    report("Player", "Out", start, count, os.str().size());
+  }
+  {
+    std::ostringstream os;
+    for (const auto &value : values) {
+      writeInput(os, value);
+      os << '\n';
+    }
+    std::string text = os.str();
+    std::vector<Player> parsed;
+    const char *cur = text.data();
+    auto start = BenchClock::now();
+    readMany(cur, text.data() + text.size(), count, parsed);
+    report("Player", "In", start, count, text.size());
+  }
+  {
+    std::vector<Player> copies(values);
+    size_t equal = 0;
+    auto start = BenchClock::now();
+    for (size_t i = 0; i < count; i++) {
+      equal += values[i] == copies[i];
+    }
+    report("Player", "Eq", start, count, 0);
+    if (equal != count) {
+      std::printf("%s: copies differ\n", "Player");
+    }
+  }
+}
+
+static inline void randomize(gm::Rng &rng, Named &obj) {
+  randomize(rng, obj.name);
+  randomize(rng, obj.score);
+}
+
+static void benchNamed(size_t count) {
+  gm::Rng rng(7786720896912775014ULL);
+  std::vector<Named> values(count);
+  for (auto &value : values) {
+    randomize(rng, value);
+  }
+  {
+    std::ostringstream os;
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      os << value << '\n';
+    }
+    report("Named", "Out", start, count, os.str().size());
+  }
+  {
+    std::vector<Named> copies(values);
+    size_t equal = 0;
+    auto start = BenchClock::now();
+    for (size_t i = 0; i < count; i++) {
+      equal += values[i] == copies[i];
+    }
+    report("Named", "Eq", start, count, 0);
+    if (equal != count) {
+      std::printf("%s: copies differ\n", "Named");
+    }
+  }
+}
+
+static inline void randomize(gm::Rng &rng, GameState &obj) {
+  randomize(rng, obj.turn);
+  randomize(rng, obj.score);
+  randomize(rng, obj.pos);
+  randomize(rng, obj.alive);
+}
+
+static void benchGameState(size_t count) {
+  gm::Rng rng(3981560271957445032ULL);
+  std::vector<GameState> values(count);
+  for (auto &value : values) {
+    randomize(rng, value);
+  }
+  {
+    std::vector<GameState> copies(values);
+    size_t equal = 0;
+    auto start = BenchClock::now();
+    for (size_t i = 0; i < count; i++) {
+      equal += values[i] == copies[i];
+    }
+    report("GameState", "Eq", start, count, 0);
+    if (equal != count) {
+      std::printf("%s: copies differ\n", "GameState");
+    }
+  }
+}
+
+static inline void writeInput(std::ostream &os, const Floor &obj) {
+  static const char *const formats[] = {
+    "EMPTY", "WALL", "BOX", 
+  };
+  os << formats[static_cast<size_t>(obj)];
+}
+
+static void benchFloor(size_t count) {
+  gm::Rng rng(13150330638402972445ULL);
+  std::vector<Floor> values(count);
+  for (auto &value : values) {
+    randomize(rng, value);
+  }
+  {
+    std::ostringstream os;
+    for (const auto &value : values) {
+      writeInput(os, value);
+      os << '\n';
+    }
+    std::string text = os.str();
+    std::vector<Floor> parsed;
+    const char *cur = text.data();
+    auto start = BenchClock::now();
+    readMany(cur, text.data() + text.size(), count, parsed);
+    report("Floor", "In", start, count, text.size());
+  }
+  {
+    std::vector<uint8_t> buffer(count * kFloorBinSize);
+    uint8_t *out = buffer.data();
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      encode(out, value);
+    }
+    report("Floor", "Bin out", start, count, buffer.size());
+    std::vector<Floor> decoded(count);
+    const uint8_t *in = buffer.data();
+    start = BenchClock::now();
+    for (auto &value : decoded) {
+      decode(in, value);
+    }
+    report("Floor", "Bin in", start, count, buffer.size());
+  }
+}
+
+static inline void writeInput(std::ostream &os, const Square &obj) {
+  writeInput(os, obj.turn);
+  os << ' ';
+  writeInput(os, obj.floor);
+  os << ' ';
+  writeInput(os, obj.lit);
+  os << ' ';
+  writeInput(os, obj.mark);
+}
+
+static void benchSquare(size_t count) {
+  gm::Rng rng(7368384151532411686ULL);
+  std::vector<Square> values(count);
+  for (auto &value : values) {
+    randomize(rng, value);
+  }
+  {
+    std::ostringstream os;
+    for (const auto &value : values) {
+      writeInput(os, value);
+      os << '\n';
+    }
+    std::string text = os.str();
+    std::vector<Square> parsed;
+    const char *cur = text.data();
+    auto start = BenchClock::now();
+    readMany(cur, text.data() + text.size(), count, parsed);
+    report("Square", "In", start, count, text.size());
+  }
+  {
+    std::vector<Square> copies(values);
+    size_t equal = 0;
+    auto start = BenchClock::now();
+    for (size_t i = 0; i < count; i++) {
+      equal += values[i] == copies[i];
+    }
+    report("Square", "Eq", start, count, 0);
+    if (equal != count) {
+      std::printf("%s: copies differ\n", "Square");
+    }
+  }
+  {
+    std::vector<uint8_t> buffer(count * kSquareBinSize);
+    uint8_t *out = buffer.data();
+    auto start = BenchClock::now();
+    for (const auto &value : values) {
+      encode(out, value);
+    }
+    report("Square", "Bin out", start, count, buffer.size());
+    std::vector<Square> decoded(count);
+    const uint8_t *in = buffer.data();
+    start = BenchClock::now();
+    for (auto &value : decoded) {
+      decode(in, value);
+    }
+    report("Square", "Bin in", start, count, buffer.size());
+  }
+}
+
+static inline void randomize(gm::Rng &rng, Stats &obj) {
+  randomize(rng, obj.hp);
+  randomize(rng, obj.speed);
+  randomize(rng, obj.name);
+  obj.dirty = Stats::kAllFields;
+}
+
+static inline void writeInput(std::ostream &os, const Stats &obj) {
+  writeInput(os, obj.hp);
+  os << ' ';
+  writeInput(os, obj.speed);
+  os << ' ';
+  writeInput(os, obj.name);
+}
+
+static void benchStats(size_t count) {
+  gm::Rng rng(12548018207006845868ULL);
+  std::vector<Stats> values(count);
+  for (auto &value : values) {
+    randomize(rng, value);
+  }
+  {
+    std::ostringstream os;
+    for (const auto &value : values) {
+      writeInput(os, value);
+      os << '\n';
+    }
+    std::string text = os.str();
+    std::vector<Stats> parsed;
+    const char *cur = text.data();
+    auto start = BenchClock::now();
+    readMany(cur, text.data() + text.size(), count, parsed);
+    report("Stats", "In", start, count, text.size());
+  }
+  {
+    std::vector<Stats> copies(values);
+    size_t equal = 0;
+    auto start = BenchClock::now();
+    for (size_t i = 0; i < count; i++) {
+      equal += values[i] == copies[i];
+    }
+    report("Stats", "Eq", start, count, 0);
+    if (equal != count) {
+      std::printf("%s: copies differ\n", "Stats");
+    }
+  }
+}
+
+static inline void writeInput(std::ostream &os, const Piece &obj) {
+  writeInput(os, obj.floor);
+  os << ' ';
+  writeInput(os, obj.row);
+  os << ' ';
+  writeInput(os, obj.col);
+  os << ' ';
+  writeInput(os, obj.lit);
+  os << ' ';
+  writeInput(os, obj.tag);
+  os << ' ';
+  writeInput(os, obj.id);
+  os << ' ';
+  writeInput(os, obj.score);
+}
+
+static void benchPiece(size_t count) {
+  gm::Rng rng(12072903533323154853ULL);
+  std::vector<Piece> values(count);
+  for (auto &value : values) {
+    randomize(rng, value);
+  }
+  {
+    std::ostringstream os;
+    for (const auto &value : values) {
+      writeInput(os, value);
+      os << '\n';
+    }
+    std::string text = os.str();
+    std::vector<Piece> parsed;
+    const char *cur = text.data();
+    auto start = BenchClock::now();
+    readMany(cur, text.data() + text.size(), count, parsed);
+    report("Piece", "In", start, count, text.size());
+  }
+  {
+    std::vector<Piece> copies(values);
+    size_t equal = 0;
+    auto start = BenchClock::now();
+    for (size_t i = 0; i < count; i++) {
+      equal += values[i] == copies[i];
+    }
+    report("Piece", "Eq", start, count, 0);
+    if (equal != count) {
+      std::printf("%s: copies differ\n", "Piece");
+    }
+  }
+}
+
+int main(int argc, char *argv[]) {
+  size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+  benchCoord(count);
+  benchPlayer(count);
+  benchNamed(count);
+  benchGameState(count);
+  benchFloor(count);
+  benchSquare(count);
+  benchStats(count);
+  benchPiece(count);
+  return 0;
+}
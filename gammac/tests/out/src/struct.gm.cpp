@@ -1,8 +1,67 @@
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include "gamma/profile.hpp"
+
 #include "src/struct.gm.hpp"
 
+bool Coord::operator==(const Coord &other) const {
+  return std::memcmp(this, &other, sizeof(Coord)) == 0;
+}
+
 bool Player::operator==(const Player &other) const {
-  return life == other.life
-      && bombs == other.bombs;
+  return std::memcmp(this, &other, sizeof(Player)) == 0;
+}
+
+std::istream &operator>>(std::istream &is, Player &obj) {
+  is >> obj.life;
+  if (obj.life < 0 || obj.life > 127) {
+    is.setstate(std::ios::failbit);
+  }
+  is >> obj.bombs;
+  if (obj.bombs < 0 || obj.bombs > 15) {
+    is.setstate(std::ios::failbit);
+  }
+  return is;
+}
+
+void readText(const char *&cur, const char *end, Player &obj) {
+  gm::readText(cur, end, obj.life);
+  if (obj.life < 0 || obj.life > 127) {
+    gm::text::error("Player::life out of range");
+  }
+  gm::readText(cur, end, obj.bombs);
+  if (obj.bombs < 0 || obj.bombs > 15) {
+    gm::text::error("Player::bombs out of range");
+  }
+}
+
+void readMany(const char *&cur, const char *end, size_t n, Player *out) {
+  const char *p = cur;
+  for (size_t i = 0; i < n; i++) {
+    readText(p, end, out[i]);
+  }
+  cur = p;
+}
+
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Player> &out) {
+  const char *p = cur;
+  size_t size = out.size();
+  out.reserve(size + n);
+  try {
+    for (size_t i = 0; i < n; i++) {
+      Player item;
+      readText(p, end, item);
+      out.push_back(std::move(item));
+    }
+  }
+  catch (...) {
+    out.erase(out.begin() + size, out.end());
+    throw;
+  }
+  cur = p;
 }
 
 std::ostream &operator<<(std::ostream &os, const Player &obj) {
@@ -13,3 +72,686 @@ std::ostream &operator<<(std::ostream &os, const Player &obj) {
   return os;
 }
 
+void randomize(gm::Rng &rng, Player &obj) {
+  obj.life = static_cast<int>(rng.below(128U));
+  obj.bombs = static_cast<int>(rng.below(16U));
+}
+
+PlayerPacked pack(const Player &obj) {
+  PlayerPacked packed;
+  packed.setLife(obj.life);
+  packed.setBombs(obj.bombs);
+  return packed;
+}
+
+void unpack(const PlayerPacked &packed, Player &obj) {
+  obj.life = packed.life();
+  obj.bombs = packed.bombs();
+}
+
+bool Named::operator==(const Named &other) const {
+  return name == other.name
+      && score == other.score;
+}
+
+std::ostream &operator<<(std::ostream &os, const Named &obj) {
+  os << "{ ";
+  os << "name" << ": " << obj.name << ", ";
+  os << "score" << ": " << obj.score;
+  os << " }";
+  return os;
+}
+
+bool GameState::operator==(const GameState &other) const {
+  return turn == other.turn
+      && score == other.score
+      && pos == other.pos
+      && alive == other.alive;
+}
+
+GameState::Patch diff(const GameState &a, const GameState &b) {
+  GameState::Patch patch;
+  if (!(a.turn == b.turn)) {
+    patch.changed |= uint64_t(1) << GameState::turn_f;
+    patch.turn = b.turn;
+  }
+  if (!(a.score == b.score)) {
+    patch.changed |= uint64_t(1) << GameState::score_f;
+    patch.score = b.score;
+  }
+  if (!(a.pos == b.pos)) {
+    patch.changed |= uint64_t(1) << GameState::pos_f;
+    patch.pos = b.pos;
+  }
+  if (!(a.alive == b.alive)) {
+    patch.changed |= uint64_t(1) << GameState::alive_f;
+    patch.alive = b.alive;
+  }
+  return patch;
+}
+
+void apply(GameState &state, const GameState::Patch &patch) {
+  if (patch.has(GameState::turn_f)) {
+    state.turn = patch.turn;
+  }
+  if (patch.has(GameState::score_f)) {
+    state.score = patch.score;
+  }
+  if (patch.has(GameState::pos_f)) {
+    state.pos = patch.pos;
+  }
+  if (patch.has(GameState::alive_f)) {
+    state.alive = patch.alive;
+  }
+}
+
+#ifdef GAMMA_PROFILE
+static const char *const kFloorVariants[] = {
+  "EMPTY", "WALL", "BOX", 
+};
+static uint64_t *const kFloorHits = gm::Profile::instance().add("Floor", kFloorVariants, 3);
+#endif
+
+static const std::map<std::string, Floor> kStrToFloor {
+  {"EMPTY", Floor::EMPTY},
+  {"WALL", Floor::WALL},
+  {"BOX", Floor::BOX},
+};
+
+std::istream &operator>>(std::istream &is, Floor &obj) {
+  std::string str;
+  is >> str;
+  obj = kStrToFloor.at(str);
+  GM_PROFILE_HIT(kFloorHits, static_cast<size_t>(obj));
+  return is;
+}
+
+void readText(const char *&cur, const char *end, Floor &obj) {
+  const char *key;
+  size_t length;
+  gm::text::readToken(cur, end, key, length);
+  switch (length) {
+  case 3:
+    if (std::memcmp(key, "BOX", 3) == 0) {
+      obj = Floor::BOX;
+      GM_PROFILE_HIT(kFloorHits, static_cast<size_t>(Floor::BOX));
+      return;
+    }
+    break;
+  case 4:
+    if (std::memcmp(key, "WALL", 4) == 0) {
+      obj = Floor::WALL;
+      GM_PROFILE_HIT(kFloorHits, static_cast<size_t>(Floor::WALL));
+      return;
+    }
+    break;
+  case 5:
+    if (std::memcmp(key, "EMPTY", 5) == 0) {
+      obj = Floor::EMPTY;
+      GM_PROFILE_HIT(kFloorHits, static_cast<size_t>(Floor::EMPTY));
+      return;
+    }
+    break;
+  }
+  gm::text::error("invalid Floor");
+}
+
+void readMany(const char *&cur, const char *end, size_t n, Floor *out) {
+  const char *p = cur;
+  for (size_t i = 0; i < n; i++) {
+    readText(p, end, out[i]);
+  }
+  cur = p;
+}
+
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Floor> &out) {
+  const char *p = cur;
+  size_t size = out.size();
+  out.reserve(size + n);
+  try {
+    for (size_t i = 0; i < n; i++) {
+      Floor item;
+      readText(p, end, item);
+      out.push_back(std::move(item));
+    }
+  }
+  catch (...) {
+    out.erase(out.begin() + size, out.end());
+    throw;
+  }
+  cur = p;
+}
+
+void encode(uint8_t *&out, const Floor &obj) {
+  gm::store<int32_t>(out, static_cast<int32_t>(obj));
+  out += 4;
+}
+
+void decode(const uint8_t *&in, Floor &obj) {
+  obj = static_cast<Floor>(gm::loadEnum(in, 3));
+  in += 4;
+}
+
+void randomize(gm::Rng &rng, Floor &obj) {
+  obj = static_cast<Floor>(rng.below(3));
+}
+
+bool Square::operator==(const Square &other) const {
+  return turn == other.turn
+      && floor == other.floor
+      && lit == other.lit
+      && mark == other.mark;
+}
+
+std::istream &operator>>(std::istream &is, Square &obj) {
+  is >> obj.turn;
+  is >> obj.floor;
+  is >> obj.lit;
+  is >> obj.mark;
+  obj.rehash();
+  return is;
+}
+
+void readText(const char *&cur, const char *end, Square &obj) {
+  gm::readText(cur, end, obj.turn);
+  readText(cur, end, obj.floor);
+  gm::readText(cur, end, obj.lit);
+  gm::readText(cur, end, obj.mark);
+  obj.rehash();
+}
+
+void readMany(const char *&cur, const char *end, size_t n, Square *out) {
+  const char *p = cur;
+  for (size_t i = 0; i < n; i++) {
+    readText(p, end, out[i]);
+  }
+  cur = p;
+}
+
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Square> &out) {
+  const char *p = cur;
+  size_t size = out.size();
+  out.reserve(size + n);
+  try {
+    for (size_t i = 0; i < n; i++) {
+      Square item;
+      readText(p, end, item);
+      out.push_back(std::move(item));
+    }
+  }
+  catch (...) {
+    out.erase(out.begin() + size, out.end());
+    throw;
+  }
+  cur = p;
+}
+
+void encode(uint8_t *&out, const Square &obj) {
+  gm::store<int32_t>(out, obj.turn);
+  out += 4;
+  gm::store<int32_t>(out, static_cast<int32_t>(obj.floor));
+  out += 4;
+  gm::store<bool>(out, obj.lit);
+  out += 1;
+  gm::store<char>(out, obj.mark);
+  out += 1;
+}
+
+void decode(const uint8_t *&in, Square &obj) {
+  obj.turn = gm::load<int32_t>(in);
+  in += 4;
+  obj.floor = static_cast<Floor>(gm::loadEnum(in, 3));
+  in += 4;
+  obj.lit = gm::loadBool(in);
+  in += 1;
+  obj.mark = gm::load<char>(in);
+  in += 1;
+  obj.rehash();
+}
+
+void randomize(gm::Rng &rng, Square &obj) {
+  randomize(rng, obj.turn);
+  randomize(rng, obj.floor);
+  randomize(rng, obj.lit);
+  randomize(rng, obj.mark);
+  obj.rehash();
+}
+
+const uint64_t Square::kFloorKeys[3] = {
+  0x8d335959aecf5fc8ULL, 0x75618fa4f1d8f8acULL, 0x73eb85fff5d8d750ULL,
+};
+
+const uint64_t Square::kLitKeys[2] = {
+  0x7cb6a99aab71c4eaULL, 0xe470f128e3bdf75fULL,
+};
+
+const uint64_t Square::kMarkKeys[256] = {
+  0x166ed113e586e348ULL, 0x9ecabb4c291b4f52ULL, 0xe1441aaccabbdb29ULL, 0xb254897cd2bd8129ULL,
+  0x025130f2cba01cc0ULL, 0x5ed34fafce98bec0ULL, 0x3b78e3f6f63ea71eULL, 0x8486a6705db4aac6ULL,
+  0x6188c486859cfbc7ULL, 0x4e1f40611c475883ULL, 0xd9a1ef1ca9bf2ba1ULL, 0xe0883f2fe7cb7631ULL,
+  0x930e1ccf3af0c11fULL, 0x5389f4833f936a9eULL, 0x928b79638756dc67ULL, 0x5b8caa6827466a37ULL,
+  0x5157b45126adf18cULL, 0x8a5a522aa6fb684cULL, 0xae00a13d3110e9daULL, 0x235ea0b3e947670cULL,
+  0x7d390e385d04be05ULL, 0xf4a0070719444311ULL, 0x8af74b9bff4a8c92ULL, 0xbadbf26f346606c1ULL,
+  0x32ed1f01206d8fd6ULL, 0x1e7ac464e889247cULL, 0x43d95949f3271ddaULL, 0xa395eb78765b3510ULL,
+  0x958f6d72a8256b88ULL, 0x9dddf789447c83d6ULL, 0x2b8619a253166cbdULL, 0x21e0b9291c132595ULL,
+  0x332bc39c6f83647fULL, 0xfcda7c499c74f0faULL, 0x4eb1420c94f7dc12ULL, 0x71a13996d62c25b2ULL,
+  0x85d333a4004b9403ULL, 0x14227a98e2e0b8cbULL, 0xe536912d1423c34fULL, 0xaf4213d5fd37fd51ULL,
+  0x78effd7c60f09433ULL, 0x2632fed34d88c357ULL, 0x3c89e0e3fd3c9ba1ULL, 0x8db555829f3684bcULL,
+  0xba0c06f38fcf44e8ULL, 0x43c5882855ccd4ddULL, 0xe6a82d0dae28ff00ULL, 0xef8dc27861915551ULL,
+  0x6f9f3d9539ee9dbcULL, 0xddedb8bae2e7da42ULL, 0xde39ae11120ca023ULL, 0x9483968edebbd852ULL,
+  0xb1f9c8efd66b9c2bULL, 0x9a44d65a6b92baa7ULL, 0x97d1811cf9fc0791ULL, 0xe67e5ccbe1b0bcf4ULL,
+  0x5e0d271829da49b2ULL, 0x3c0a66c2aec26278ULL, 0xa8a04a11529067ccULL, 0xd68bbac5d4fe28cbULL,
+  0x17597eed0cd312e4ULL, 0x4124ad30fff9224eULL, 0xc022894f812b59d4ULL, 0x74df87d4484ded12ULL,
+  0x1229d358cb06567bULL, 0x0828516d142c582fULL, 0x1bfa0d777e4600a9ULL, 0x83eb862d8bc99a61ULL,
+  0x5008af7fe80a948bULL, 0x9690fbc3512b01e8ULL, 0x4bf1685068e6e897ULL, 0x800ac4d54dac5038ULL,
+  0x6c33a7c461db8fdfULL, 0x76c473be3e52a54bULL, 0xfb8183aa2d703adeULL, 0x0f5b28b3f435c96eULL,
+  0x4b0dd5f28bad1fecULL, 0xb5ab6e9c64841e58ULL, 0x971b166f9f7a9246ULL, 0xd84e90763dbd523eULL,
+  0x97cba2f973814be1ULL, 0x3ab6aa83479a2a6bULL, 0x0026a91492877796ULL, 0x05a37594e8af0522ULL,
+  0x1b1a25294f025601ULL, 0x29dc29a612f6a3ceULL, 0xcc7e6dd1d3341e14ULL, 0x19e3397f9a2bc2d5ULL,
+  0x7394de28fe8700ccULL, 0xf911a55be8003534ULL, 0xb780103cdc7c5b89ULL, 0x7f0f8b48d990d811ULL,
+  0xfe698c35ae4f9094ULL, 0xf857916d356a7777ULL, 0xd633598e22502c4dULL, 0xc6577f850285409aULL,
+  0x1ac86bc666a9a8cdULL, 0x5c3d9be62fc8e62eULL, 0xd5592af8c605504aULL, 0x38419e8e63904143ULL,
+  0x7f70d50b60aef417ULL, 0xf2bab403d9a38b1aULL, 0xe390d9754521e05fULL, 0x6d43a91f7fc20720ULL,
+  0x44ff248ed4588548ULL, 0x6b0c6ce3ae20d008ULL, 0x74bb3f535c1079f0ULL, 0x041820edce5b8b06ULL,
+  0x6318d8435f0015f6ULL, 0x937747d8c17dda87ULL, 0x6f9c67e4a3dd8934ULL, 0x5f6f00881756e59fULL,
+  0x4fc2036f5f7fc65eULL, 0xa5bab3bbf4e330fbULL, 0x7a66982418b700c1ULL, 0xbda877d3d210db62ULL,
+  0xe71d52416dfa2fcfULL, 0x3acee714d34f42b1ULL, 0x0d2e12848d6fa133ULL, 0x5a49906eca27b50cULL,
+  0xf598d90e1206e983ULL, 0xe1ebc49bdc1ed481ULL, 0x6f25353be94b476dULL, 0x086a754a2a642addULL,
+  0x21d520a2adb06312ULL, 0xa55643e969121b33ULL, 0x81ef69acbbaf511aULL, 0x3929c85ca4bcad19ULL,
+  0xe093b2afa79ad4d9ULL, 0x613ec321f44844e1ULL, 0xb0de6d76ea129095ULL, 0x09189c518de3cfeaULL,
+  0xb0d1a7dd5d47e97bULL, 0xfae6b313c8bce44dULL, 0x6e50d11be8e3047aULL, 0xb77d2faddf09bb61ULL,
+  0x5046c459a41be666ULL, 0x2d667b25304d3870ULL, 0x24fae963db1008e9ULL, 0xab5fc573992c7dc5ULL,
+  0xceb48523383ea576ULL, 0xd1b31384680f964fULL, 0xa1f94ff5704861d2ULL, 0x9ca5b1a59113a6d8ULL,
+  0x39b56f0c8a7a9efbULL, 0xa9a232d4435e2c5cULL, 0x632371c35c28dfa8ULL, 0x57fe4a21f19c9e30ULL,
+  0x11879c9ad38aadd8ULL, 0x5646d93d28ad4484ULL, 0xcb8bb14d54b4ceb7ULL, 0x8287bf585e160583ULL,
+  0x3018a9c237d0ca6fULL, 0x984a62454916b846ULL, 0x3b0b31afa2357515ULL, 0xeed0f56ddbb63344ULL,
+  0x03227a428a0d7ebeULL, 0x0a400016c49961f8ULL, 0x79aa5685ccd90ecfULL, 0xaf46df5b8e93e9f2ULL,
+  0x44ef4d2e1f11cb93ULL, 0xc92e36c4d9fbaffaULL, 0xd3807b8fbf72d1e0ULL, 0xdf670a9d0aa3d4eaULL,
+  0xf829bd7fc66364ecULL, 0x18373286fdd94455ULL, 0x738398374b73a6c8ULL, 0x1410025be8bc4f49ULL,
+  0x9b8dffcce9b5aadbULL, 0x00c90f2c566c9f63ULL, 0x53777390abd74c29ULL, 0x0ef4984d5cbe724fULL,
+  0xad552231f4265421ULL, 0xf87087ab7e41dfa8ULL, 0xcee32b5449c9613bULL, 0x9d1a2b199cc45bc0ULL,
+  0x82af41033df6664aULL, 0xad10856c80baca3fULL, 0x3311d8f5cbac8bddULL, 0xd20361246e7d91a8ULL,
+  0x501c4527062acc27ULL, 0xfe5fbfb2377cf066ULL, 0x1d00b3af2d30d298ULL, 0x85a1fbe2ee2e85d7ULL,
+  0xff3ab4fcecafe2d0ULL, 0x59a41f5641381613ULL, 0x4bf8c8001c13dd2fULL, 0x5c14c94c8ea4b182ULL,
+  0x3ddbf7107d62b3e9ULL, 0xd99415baddfeb963ULL, 0x916445c5802803b4ULL, 0x705f3a6de001a8acULL,
+  0x0f68120d488f80c7ULL, 0xb250bfb1e73da6edULL, 0x1ffa51a4274fe138ULL, 0xa394bb872c79ea80ULL,
+  0x1512846d9f395ac0ULL, 0xd1129f5c88414ba6ULL, 0x815555433b512f42ULL, 0xfdcfc9f503346a32ULL,
+  0x5c5d90c74ec9394bULL, 0x1f0348e276073ba4ULL, 0xb0b6b26bdd2f738aULL, 0xffc8362992a74422ULL,
+  0x6fbb60078130efddULL, 0x18eabe6ce834a6e4ULL, 0x869ad68210a429beULL, 0x7d46b65e86daedf2ULL,
+  0x5712bdce83c979e1ULL, 0xb7a6584ac22430b9ULL, 0xe90b8c7cb6c36148ULL, 0x866ba682d2e2a337ULL,
+  0xdc0efbc5be508543ULL, 0x449c3e144f18cef4ULL, 0x11ca7fbea43059abULL, 0x3df480284e158c80ULL,
+  0xa1dde61629dbe55eULL, 0xf462f158d20333e7ULL, 0x8172632712c71a10ULL, 0xf569e15538fd15e3ULL,
+  0x1d96997d146cb40cULL, 0xc992527e80a19ce1ULL, 0x59498c69c8d6bc60ULL, 0x8754f92a6c94c356ULL,
+  0xcc2e248b665226a0ULL, 0xfe7cafe83a7dc6a9ULL, 0x68233fc4089929d3ULL, 0x5b81f12fd15c460aULL,
+  0x1c5b0eb29c2ad011ULL, 0x36d03f64f9c63a6bULL, 0xd6d746dc6d6f692eULL, 0xb6a2f4cea3692035ULL,
+  0xedd368b7d5cf15d3ULL, 0x25e8016800fc1a7dULL, 0xb27a78ff9a88f8ccULL, 0xb5457587f5d8161eULL,
+  0x9fd1730f6f4aad73ULL, 0xbfe4dfa674382ab6ULL, 0xc124d01234955ff9ULL, 0x987d074915c89084ULL,
+  0xb745eab6afc9fa30ULL, 0xc804e24b96fa2dd5ULL, 0xa1675bf517dc293bULL, 0x11a6393a8fc9ca71ULL,
+  0x38e13e90a041b352ULL, 0xd34293a58c7555dfULL, 0xab1a315714969caaULL, 0x35c38a5fbe28707fULL,
+  0x30441d5d75305006ULL, 0xd93b158b9c9790dbULL, 0x2d2dfaa837b375ceULL, 0xae4d0bf2aac8474fULL,
+  0xd57b2e5229c2030dULL, 0x2c069f8763772eb9ULL, 0x3d426cd49c5efb15ULL, 0xceedc1f209a61a69ULL,
+};
+
+Square::Patch diff(const Square &a, const Square &b) {
+  Square::Patch patch;
+  if (!(a.turn == b.turn)) {
+    patch.changed |= uint64_t(1) << Square::turn_f;
+    patch.turn = b.turn;
+  }
+  if (!(a.floor == b.floor)) {
+    patch.changed |= uint64_t(1) << Square::floor_f;
+    patch.floor = b.floor;
+  }
+  if (!(a.lit == b.lit)) {
+    patch.changed |= uint64_t(1) << Square::lit_f;
+    patch.lit = b.lit;
+  }
+  if (!(a.mark == b.mark)) {
+    patch.changed |= uint64_t(1) << Square::mark_f;
+    patch.mark = b.mark;
+  }
+  return patch;
+}
+
+void apply(Square &state, const Square::Patch &patch) {
+  if (patch.has(Square::turn_f)) {
+    state.turn = patch.turn;
+  }
+  if (patch.has(Square::floor_f)) {
+    state.floor = patch.floor;
+  }
+  if (patch.has(Square::lit_f)) {
+    state.lit = patch.lit;
+  }
+  if (patch.has(Square::mark_f)) {
+    state.mark = patch.mark;
+  }
+  state.rehash();
+}
+
+void encode(uint8_t *&out, const Square::Patch &patch) {
+  gm::store<uint8_t>(out, static_cast<uint8_t>(patch.changed));
+  out += 1;
+  if (patch.has(Square::turn_f)) {
+    gm::store<int32_t>(out, patch.turn);
+    out += 4;
+  }
+  if (patch.has(Square::floor_f)) {
+    gm::store<int32_t>(out, static_cast<int32_t>(patch.floor));
+    out += 4;
+  }
+  if (patch.has(Square::lit_f)) {
+    gm::store<bool>(out, patch.lit);
+    out += 1;
+  }
+  if (patch.has(Square::mark_f)) {
+    gm::store<char>(out, patch.mark);
+    out += 1;
+  }
+}
+
+void decode(const uint8_t *&in, Square::Patch &patch) {
+  patch.changed = gm::load<uint8_t>(in);
+  if (patch.changed & 0xfffffffffffffff0ULL) {
+    throw std::runtime_error("Invalid Square patch");
+  }
+  in += 1;
+  if (patch.has(Square::turn_f)) {
+    patch.turn = gm::load<int32_t>(in);
+    in += 4;
+  }
+  if (patch.has(Square::floor_f)) {
+    patch.floor = static_cast<Floor>(gm::loadEnum(in, 3));
+    in += 4;
+  }
+  if (patch.has(Square::lit_f)) {
+    patch.lit = gm::loadBool(in);
+    in += 1;
+  }
+  if (patch.has(Square::mark_f)) {
+    patch.mark = gm::load<char>(in);
+    in += 1;
+  }
+}
+
+bool Stats::operator==(const Stats &other) const {
+  return hp == other.hp
+      && speed == other.speed
+      && name == other.name;
+}
+
+std::istream &operator>>(std::istream &is, Stats &obj) {
+  is >> obj.hp;
+  is >> obj.speed;
+  is >> obj.name;
+  obj.dirty = Stats::kAllFields;
+  return is;
+}
+
+void readText(const char *&cur, const char *end, Stats &obj) {
+  gm::readText(cur, end, obj.hp);
+  gm::readText(cur, end, obj.speed);
+  gm::readText(cur, end, obj.name);
+  obj.dirty = Stats::kAllFields;
+}
+
+void readMany(const char *&cur, const char *end, size_t n, Stats *out) {
+  const char *p = cur;
+  for (size_t i = 0; i < n; i++) {
+    readText(p, end, out[i]);
+  }
+  cur = p;
+}
+
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Stats> &out) {
+  const char *p = cur;
+  size_t size = out.size();
+  out.reserve(size + n);
+  try {
+    for (size_t i = 0; i < n; i++) {
+      Stats item;
+      readText(p, end, item);
+      out.push_back(std::move(item));
+    }
+  }
+  catch (...) {
+    out.erase(out.begin() + size, out.end());
+    throw;
+  }
+  cur = p;
+}
+
+constexpr uint64_t Stats::kAllFields;
+
+Stats::Patch diff(const Stats &a, const Stats &b) {
+  Stats::Patch patch;
+  if (!(a.hp == b.hp)) {
+    patch.changed |= uint64_t(1) << Stats::hp_f;
+    patch.hp = b.hp;
+  }
+  if (!(a.speed == b.speed)) {
+    patch.changed |= uint64_t(1) << Stats::speed_f;
+    patch.speed = b.speed;
+  }
+  if (!(a.name == b.name)) {
+    patch.changed |= uint64_t(1) << Stats::name_f;
+    patch.name = b.name;
+  }
+  return patch;
+}
+
+void apply(Stats &state, const Stats::Patch &patch) {
+  if (patch.has(Stats::hp_f)) {
+    state.hp = patch.hp;
+  }
+  if (patch.has(Stats::speed_f)) {
+    state.speed = patch.speed;
+  }
+  if (patch.has(Stats::name_f)) {
+    state.name = patch.name;
+  }
+  state.dirty |= patch.changed;
+}
+
+bool Piece::operator==(const Piece &other) const {
+  return floor == other.floor
+      && row == other.row
+      && col == other.col
+      && lit == other.lit
+      && tag == other.tag
+      && id == other.id
+      && score == other.score;
+}
+
+std::istream &operator>>(std::istream &is, Piece &obj) {
+  is >> obj.floor;
+  is >> obj.row;
+  if (obj.row < -4 || obj.row > 3) {
+    is.setstate(std::ios::failbit);
+  }
+  is >> obj.col;
+  if (obj.col < 0 || obj.col > 7) {
+    is.setstate(std::ios::failbit);
+  }
+  is >> obj.lit;
+  is >> obj.tag;
+  is >> obj.id;
+  if (obj.id < 0 || obj.id > 1000000000) {
+    is.setstate(std::ios::failbit);
+  }
+  is >> obj.score;
+  if (obj.score < -1000000 || obj.score > 1000000) {
+    is.setstate(std::ios::failbit);
+  }
+  obj.rehash();
+  return is;
+}
+
+void readText(const char *&cur, const char *end, Piece &obj) {
+  readText(cur, end, obj.floor);
+  gm::readText(cur, end, obj.row);
+  if (obj.row < -4 || obj.row > 3) {
+    gm::text::error("Piece::row out of range");
+  }
+  gm::readText(cur, end, obj.col);
+  if (obj.col < 0 || obj.col > 7) {
+    gm::text::error("Piece::col out of range");
+  }
+  gm::readText(cur, end, obj.lit);
+  gm::readText(cur, end, obj.tag);
+  gm::readText(cur, end, obj.id);
+  if (obj.id < 0 || obj.id > 1000000000) {
+    gm::text::error("Piece::id out of range");
+  }
+  gm::readText(cur, end, obj.score);
+  if (obj.score < -1000000 || obj.score > 1000000) {
+    gm::text::error("Piece::score out of range");
+  }
+  obj.rehash();
+}
+
+void readMany(const char *&cur, const char *end, size_t n, Piece *out) {
+  const char *p = cur;
+  for (size_t i = 0; i < n; i++) {
+    readText(p, end, out[i]);
+  }
+  cur = p;
+}
+
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Piece> &out) {
+  const char *p = cur;
+  size_t size = out.size();
+  out.reserve(size + n);
+  try {
+    for (size_t i = 0; i < n; i++) {
+      Piece item;
+      readText(p, end, item);
+      out.push_back(std::move(item));
+    }
+  }
+  catch (...) {
+    out.erase(out.begin() + size, out.end());
+    throw;
+  }
+  cur = p;
+}
+
+void randomize(gm::Rng &rng, Piece &obj) {
+  randomize(rng, obj.floor);
+  obj.row = static_cast<int>(rng.below(8U)) - 4;
+  obj.col = static_cast<int>(rng.below(8U));
+  randomize(rng, obj.lit);
+  randomize(rng, obj.tag);
+  obj.id = static_cast<int>(rng.below(1000000001U));
+  obj.score = static_cast<int>(rng.below(2000001U)) - 1000000;
+  obj.rehash();
+}
+
+const uint64_t Piece::kFloorKeys[3] = {
+  0xd8d77314be27a5f1ULL, 0xa81f08c1a3adcc18ULL, 0xdb8aa107e988d025ULL,
+};
+
+const uint64_t Piece::kRowKeys[8] = {
+  0xcaba04f6f7ffd1d9ULL, 0xa0fda76ff63c2d0bULL, 0xd57c9cf42bcf0067ULL, 0xd82cb70f832dfef0ULL,
+  0xf7711042154ebd7bULL, 0x103477d1a652cc11ULL, 0x105f0b68e5ec3147ULL, 0x5fe11825c0277c68ULL,
+};
+
+const uint64_t Piece::kColKeys[8] = {
+  0x4b716ccd22a2de54ULL, 0x46be36f7bbd287c3ULL, 0x405da02bef40a913ULL, 0xa6ac29b230e25157ULL,
+  0x3eefbda1c580f47dULL, 0xd1b86a49d0bb3bb6ULL, 0x1fd10eab2731bd4fULL, 0x621cacd9b29f16f2ULL,
+};
+
+const uint64_t Piece::kLitKeys[2] = {
+  0xb586e4b9edb7dbefULL, 0x7e2070363b1add62ULL,
+};
+
+const uint64_t Piece::kTagKeys[256] = {
+  0x451d3b19860c8bc4ULL, 0x7e5e44f4302ac7c2ULL, 0xff82e1d481890ce9ULL, 0xe4a5d141138387d6ULL,
+  0x86a463b9caa92207ULL, 0x68c6ad89be5c3909ULL, 0x23e21b9a970f4365ULL, 0x937de3d39c3f6e6dULL,
+  0x957bd73fc7bcea12ULL, 0x7458f55d1ce5eb65ULL, 0x9541a3861c4c5ac5ULL, 0x144f6e67689fa7ebULL,
+  0x6a28633330cce38cULL, 0xa6415993b95b3c0bULL, 0x250b813ad1c890aeULL, 0x71bf3ab61e6e8e6bULL,
+  0x578bf1d8df376df7ULL, 0xd672445ef69b83dfULL, 0x857ade3db4212a3eULL, 0x8d696c84fc2f0feaULL,
+  0x80d331bcdd30072eULL, 0xf5822942ce1a040bULL, 0x2d5e16b74044e3d0ULL, 0x7d2d4ed4c5ed2971ULL,
+  0x55a2a1afa064c7e4ULL, 0x601dc84fd7fbcbb8ULL, 0x206f08966902d591ULL, 0x1c3af8fb5dfd6aabULL,
+  0x8420f98b16abd307ULL, 0xc8d39986d18108c2ULL, 0x97af8a25da2b0b76ULL, 0x1326fc86959b85f4ULL,
+  0xf1845f1a6aa6db38ULL, 0xe0f24713aae78e4eULL, 0x83b97063e01a5654ULL, 0x5934dc072e98407fULL,
+  0xd77b36004c9ab1feULL, 0x163bb7f653bf2943ULL, 0xbd30492e7a59d498ULL, 0x8eb8689b0f721c76ULL,
+  0xe310819d7b95bdabULL, 0xbf5735135c50c74fULL, 0x3ce75b8c0d18f61eULL, 0x00c74ac8d5d04a25ULL,
+  0xfa3a35ccf665d039ULL, 0x7199ab622a80960dULL, 0x2b52a5a9fc121fceULL, 0x10d373ee93ae4fa4ULL,
+  0xf6cb441af819c615ULL, 0x6bee28131f60cadfULL, 0x792056dedf806a84ULL, 0x55e51703624233cdULL,
+  0xa03a51f35afc13ccULL, 0xc226e6afcb57325cULL, 0x76db42382f071e7fULL, 0x9d71f716f00851b8ULL,
+  0x423661e7783594eeULL, 0x0e586bf8b71aca8eULL, 0xb1fedeed5971a45fULL, 0x262376d2a4d805d9ULL,
+  0x77554f7e044924a4ULL, 0x2eaa9b3bd6c20cf2ULL, 0xfc22198edf147e08ULL, 0x1526a656b55a00d2ULL,
+  0x8868282ebd9cf13eULL, 0x779d93e58e686577ULL, 0x918527ac1044b2ebULL, 0x94f045b41d90038aULL,
+  0xb19049f32eb0270eULL, 0xec59742cc435cb0aULL, 0x4fae2e207e49502fULL, 0xe2a3945dd1d11ed4ULL,
+  0x447b0784922c2338ULL, 0x2f52b1495bc87037ULL, 0x217e870b41cf3a50ULL, 0x0f92376f6fffefa0ULL,
+  0xd86ac956e19aef07ULL, 0xd52a5e0826b60d61ULL, 0xea8ec09ea1159d45ULL, 0x71e6d1758e0c580cULL,
+  0xc54fe3566e3ba04bULL, 0x16c5568242156dabULL, 0x99eb79cd4e325f46ULL, 0xd1ab655bc1c75e35ULL,
+  0xc8e10acd620c9185ULL, 0xea1d3524ab59829eULL, 0xdab2491d141d90f9ULL, 0xe22dc16e9b258e15ULL,
+  0xc8b307dc4f5216e0ULL, 0xc1ac40054ae4c344ULL, 0x3d1a42cacbb625feULL, 0xcb38236408afbcd6ULL,
+  0x8c8fd4795d38e091ULL, 0x699cdc854ac0f8f1ULL, 0xd7a6bb8f86d6b057ULL, 0x6fe5b1a151eec5c5ULL,
+  0x47e3b19c34e95421ULL, 0x1355058ca17a349cULL, 0x9ba66b942c42cc12ULL, 0x9f5f5e6f0e102db3ULL,
+  0xc755566dfc0113f4ULL, 0x3be1261d310db2c6ULL, 0xb47942e0d2b3daf6ULL, 0xa8f9d6b152fa69d7ULL,
+  0xae79ab4bd7386b9dULL, 0x380c71410e18d711ULL, 0x867efebe1dcd4e5cULL, 0x0eaff654ea0a7aa7ULL,
+  0x716b65313d592ad5ULL, 0xf290d0485881cbeaULL, 0x483c546c74d21311ULL, 0x0e50bd20bd72b12fULL,
+  0x71723dce879672faULL, 0x502965e5c8a59501ULL, 0x7d93798052e3361cULL, 0x0a8808b51c5ee803ULL,
+  0xe95240ee6e1c5fcdULL, 0xf0a3394e0e3f72afULL, 0x8951805f1ba52941ULL, 0x0e72e3cd913d6574ULL,
+  0x5bc5241a17761aa3ULL, 0x78a03a86de50a670ULL, 0xb5f2f616863fbe1fULL, 0x0992e20574f17891ULL,
+  0x45d3e35000060b16ULL, 0xe3395545760725f6ULL, 0x5ee171841d030c1dULL, 0x983952f99b41b2a5ULL,
+  0x1bcc486e0a7d4db3ULL, 0x7cdcefe2ffef5a33ULL, 0x29d18b23300ec6c0ULL, 0x72e283516fc49331ULL,
+  0x20cb55dfbf9e882eULL, 0x02c42584835ba001ULL, 0xa069526859db7dadULL, 0x2841e9b1709abd75ULL,
+  0xc75821fa9255e777ULL, 0x7ff7315c27fa471fULL, 0xc2e2eda173fd9f70ULL, 0x7ed9099e324e0f45ULL,
+  0xe0cb56c31a7ed660ULL, 0xb5bca56597d8e614ULL, 0x6f44219817677ce8ULL, 0x0f1ca284f95e77eaULL,
+  0x0d116523516097eaULL, 0x326358da70a86e3bULL, 0x9e03d8a82c452486ULL, 0xdb1de6cc7ad04f39ULL,
+  0x5ef19eb7f4734b5cULL, 0xcbef8636e53d20a5ULL, 0xf9004ef765902e8fULL, 0x7ffc89db018bbefcULL,
+  0x2d2af46970b83857ULL, 0x356ec011d23b60acULL, 0x58b9511531e17d02ULL, 0x478adca44b43484fULL,
+  0x1ff964a970427ac1ULL, 0xe167172bde837ecbULL, 0x9e320450ef6794caULL, 0x8ba471a9c89bb332ULL,
+  0xc467bed4aecd0a55ULL, 0xfa35b166e93e0cd9ULL, 0x93102d24165ec182ULL, 0x6fb3dcb1d7995b04ULL,
+  0xa817dcd77342bbccULL, 0x7f3b14d8abe6002aULL, 0x552a00594663ea81ULL, 0xc2d17c56792fdb00ULL,
+  0xa7567544bc9268e0ULL, 0x370b6176d3cd58caULL, 0x7162962665d14013ULL, 0xbdb4b85ff595bad7ULL,
+  0xd0d00a8d18c6fc9cULL, 0xd8761426ff23448cULL, 0x8b844fe8d796333aULL, 0xbd587e39e86229ecULL,
+  0x9235cc62d072eb3cULL, 0xce5ca6f0dd0cea39ULL, 0xe8ce67ff42f79195ULL, 0xb2ab3e75f0e9829cULL,
+  0x4d8b52bc688daca7ULL, 0xcd9702fec6123d2eULL, 0xd9d54fb1078ae477ULL, 0xb7ec650436bfdcb3ULL,
+  0x4b3a8ee6255c5b83ULL, 0x700a715292eaf398ULL, 0x690be68f9493327eULL, 0xeca58ff5de3c64aaULL,
+  0xf2464cb5987ec7c3ULL, 0xcdde3ff48c0f0ac0ULL, 0xfb98d2d3c35db873ULL, 0x03a142441845088aULL,
+  0x7b522d572708cd1bULL, 0xfb98ce55179f1348ULL, 0x97908ccb78b6af12ULL, 0xcf35e7d3f42e0346ULL,
+  0x2b429f973c32e0e5ULL, 0xe07af17706edeed3ULL, 0xe97684415e3a6903ULL, 0x7dc5e23e9d9fb2c2ULL,
+  0xf6180f9ffe59f9a4ULL, 0x838f4203690b7243ULL, 0x5675ba755a84ea23ULL, 0x00492c38d9f31722ULL,
+  0x7f0a1001ad51d69aULL, 0x9252b6f9a63c2ff4ULL, 0xaabc3e33c98bff23ULL, 0x014de8f43051cc71ULL,
+  0x6c6f593d5eb7e538ULL, 0x40f2e37fb0ffea9eULL, 0xed9fbe9b89f4f817ULL, 0xb068737d126f030aULL,
+  0x5af88c325f3c02d0ULL, 0x0956869fb3270ba8ULL, 0x064a98ab58082355ULL, 0x2bb5fdfb630a04ffULL,
+  0x9247da211e1aeb2bULL, 0x8b43bbd9cf492680ULL, 0x4cc2ce6b596080ffULL, 0xb474c77620d3627fULL,
+  0x5c28f81fa372af8bULL, 0x4fa64ad40384ce52ULL, 0x392d855b8057cd4fULL, 0x6cdb3110c243d4b0ULL,
+  0xbfb0a0b025cb67b8ULL, 0x87989b339db40775ULL, 0xe5dad2b11960810aULL, 0x74d2ef59d3f1f0c1ULL,
+  0xafa0b5c4b577606bULL, 0xaf54317b93245a93ULL, 0x0b6902e81f23a96aULL, 0xdb3db9e624e877fcULL,
+  0x48340ba95fdeac3fULL, 0x712c13e3e884130dULL, 0x2249ce0233149ddaULL, 0x3d94fa595703cf88ULL,
+  0x884db2d38d3362e3ULL, 0x2bbb46a7a06bc937ULL, 0x1625c08b6112b7e4ULL, 0x2e342ce78bbc7956ULL,
+  0x0913f8c2689c5e80ULL, 0xfbb980198d63e5d9ULL, 0x6d33e722c3f83d78ULL, 0x4a91dcc1e578d929ULL,
+  0xb922b62a7e3660dfULL, 0xb0ef58e33021a731ULL, 0xa4206de2e40a8770ULL, 0xf184b80b1b994507ULL,
+  0x4d431bcaae7556aaULL, 0x7fcdb0b5448aa3c0ULL, 0xcfba13acdcb655fcULL, 0x0150f07d76cd205bULL,
+  0xd2106a7dc1af727eULL, 0xdab2c627327aba27ULL, 0xa7a749e5cbca7232ULL, 0x8166d0d49a5e4352ULL,
+};
+
+PiecePacked pack(const Piece &obj) {
+  PiecePacked packed;
+  packed.setFloor(obj.floor);
+  packed.setRow(obj.row);
+  packed.setCol(obj.col);
+  packed.setLit(obj.lit);
+  packed.setTag(obj.tag);
+  packed.setId(obj.id);
+  packed.setScore(obj.score);
+  return packed;
+}
+
+void unpack(const PiecePacked &packed, Piece &obj) {
+  obj.floor = packed.floor();
+  obj.row = packed.row();
+  obj.col = packed.col();
+  obj.lit = packed.lit();
+  obj.tag = packed.tag();
+  obj.id = packed.id();
+  obj.score = packed.score();
+  obj.rehash();
+}
+
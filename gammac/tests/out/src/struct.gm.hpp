@@ -1,28 +1,526 @@
 #ifndef src_struct_gm__
 #define src_struct_gm__
 
+#include <cstdint>
+#include <istream>
 #include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "gamma/bin.hpp"
+#include "gamma/out.hpp"
+#include "gamma/random.hpp"
+#include "gamma/text.hpp"
+#include "gamma/undo.hpp"
 
 struct Unit {
   Unit() = default;
 };
 
+static_assert(std::is_trivially_copyable<Unit>::value, "Unit must be trivially copyable");
+
 struct Coord {
   Coord() = default;
-  Coord(int x, int y): x(x), y(y) {}
+  constexpr Coord(int x, int y) noexcept: x(x), y(y) {}
   int x;
   int y;
+  bool operator==(const Coord &other) const;
 };
 
+static_assert(std::is_trivially_copyable<Coord>::value, "Coord must be trivially copyable");
+static_assert(sizeof(Coord) == sizeof(int) + sizeof(int), "Coord must have no padding");
+
 struct Player {
   Player() = default;
-  Player(int life, int bombs): life(life), bombs(bombs) {}
+  constexpr Player(int life, int bombs) noexcept: life(life), bombs(bombs) {}
   int life;
   int bombs;
   bool operator==(const Player &other) const;
 };
 
+static_assert(std::is_trivially_copyable<Player>::value, "Player must be trivially copyable");
+static_assert(sizeof(Player) == sizeof(int) + sizeof(int), "Player must have no padding");
+
+std::istream &operator>>(std::istream &is, Player &obj);
+void readText(const char *&cur, const char *end, Player &obj);
+void readMany(const char *&cur, const char *end, size_t n, Player *out);
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Player> &out);
+
 std::ostream &operator<<(std::ostream &os, const Player &obj);
 
+void randomize(gm::Rng &rng, Player &obj);
+
+struct PlayerPacked {
+  PlayerPacked() : words() {}
+  int life() const { return static_cast<int>(words[0] & 0x7fULL); }
+  void setLife(int value) {
+    if (value < 0 || value > 127) {
+      throw std::out_of_range("PlayerPacked::setLife");
+    }
+    words[0] = (words[0] & ~0x7fULL) | (static_cast<uint64_t>(value) & 0x7fULL);
+  }
+  int bombs() const { return static_cast<int>((words[0] >> 7) & 0xfULL); }
+  void setBombs(int value) {
+    if (value < 0 || value > 15) {
+      throw std::out_of_range("PlayerPacked::setBombs");
+    }
+    words[0] = (words[0] & ~0x780ULL) | ((static_cast<uint64_t>(value) & 0xfULL) << 7);
+  }
+  bool operator==(const PlayerPacked &other) const {
+    return words[0] == other.words[0];
+  }
+  bool operator!=(const PlayerPacked &other) const { return !(*this == other); }
+  uint64_t hash() const {
+    uint64_t h = words[0] * 0x9E3779B97F4A7C15ULL;
+    return h ^ (h >> 29);
+  }
+  uint64_t words[1];
+};
+
+PlayerPacked pack(const Player &obj);
+void unpack(const PlayerPacked &packed, Player &obj);
+
+struct Named {
+  Named() = default;
+  Named(std::string name, int score) noexcept(std::is_nothrow_move_constructible<std::string>::value): name(std::move(name)), score(score) {}
+  std::string name;
+  int score;
+  bool operator==(const Named &other) const;
+};
+
+std::ostream &operator<<(std::ostream &os, const Named &obj);
+
+struct GameState {
+  GameState() = default;
+  constexpr GameState(int turn, double score, Coord pos, bool alive) noexcept: turn(turn), score(score), pos(pos), alive(alive) {}
+  int turn;
+  double score;
+  Coord pos;
+  bool alive;
+  enum Field {
+    turn_f,
+    score_f,
+    pos_f,
+    alive_f,
+  };
+  bool operator==(const GameState &other) const;
+  struct Change {
+    Field field;
+    union Value {
+      Value() {}
+      int turn;
+      double score;
+      Coord pos;
+      bool alive;
+    } value;
+  };
+  void rollback(gm::UndoLog<Change> &log, size_t mark) {
+    while (log.mark() > mark) {
+      const Change &change = log.pop();
+      switch (change.field) {
+      case turn_f:
+        this->turn = change.value.turn;
+        break;
+      case score_f:
+        this->score = change.value.score;
+        break;
+      case pos_f:
+        this->pos = change.value.pos;
+        break;
+      case alive_f:
+        this->alive = change.value.alive;
+        break;
+      }
+    }
+  }
+  struct Patch {
+    uint64_t changed = 0;
+    int turn;
+    double score;
+    Coord pos;
+    bool alive;
+    bool has(Field field) const { return (changed >> field) & 1; }
+  };
+  void setTurn(gm::UndoLog<Change> &log, int value) {
+    Change change;
+    change.field = turn_f;
+    change.value.turn = this->turn;
+    log.push(change);
+    this->turn = value;
+  }
+  void setScore(gm::UndoLog<Change> &log, double value) {
+    Change change;
+    change.field = score_f;
+    change.value.score = this->score;
+    log.push(change);
+    this->score = value;
+  }
+  void setPos(gm::UndoLog<Change> &log, const Coord &value) {
+    Change change;
+    change.field = pos_f;
+    change.value.pos = this->pos;
+    log.push(change);
+    this->pos = value;
+  }
+  void setAlive(gm::UndoLog<Change> &log, bool value) {
+    Change change;
+    change.field = alive_f;
+    change.value.alive = this->alive;
+    log.push(change);
+    this->alive = value;
+  }
+};
+
+static_assert(std::is_trivially_copyable<GameState>::value, "GameState must be trivially copyable");
+
+GameState::Patch diff(const GameState &a, const GameState &b);
+void apply(GameState &state, const GameState::Patch &patch);
+
+enum class Floor {
+  EMPTY, WALL, BOX, 
+};
+
+std::istream &operator>>(std::istream &is, Floor &obj);
+void readText(const char *&cur, const char *end, Floor &obj);
+void readMany(const char *&cur, const char *end, size_t n, Floor *out);
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Floor> &out);
+
+constexpr size_t kFloorBinSize = 4;
+constexpr uint64_t kFloorFingerprint = 0x7221e81441aae9b3ULL;
+void encode(uint8_t *&out, const Floor &obj);
+void decode(const uint8_t *&in, Floor &obj);
+
+void randomize(gm::Rng &rng, Floor &obj);
+
+struct Square {
+  Square() : turn(), floor(), lit(), mark() {
+    rehash();
+  }
+  Square(int turn, Floor floor, bool lit, char mark) : turn(turn), floor(floor), lit(lit), mark(mark) {
+    rehash();
+  }
+  int turn;
+  Floor floor;
+  bool lit;
+  char mark;
+  uint64_t hash;
+  enum Field {
+    turn_f,
+    floor_f,
+    lit_f,
+    mark_f,
+  };
+  bool operator==(const Square &other) const;
+  struct Change {
+    Field field;
+    union Value {
+      Value() {}
+      int turn;
+      Floor floor;
+      bool lit;
+      char mark;
+    } value;
+  };
+  void rollback(gm::UndoLog<Change> &log, size_t mark) {
+    while (log.mark() > mark) {
+      const Change &change = log.pop();
+      switch (change.field) {
+      case turn_f:
+        this->turn = change.value.turn;
+        break;
+      case floor_f:
+        this->hash ^= kFloorKeys[static_cast<size_t>(this->floor)] ^ kFloorKeys[static_cast<size_t>(change.value.floor)];
+        this->floor = change.value.floor;
+        break;
+      case lit_f:
+        this->hash ^= kLitKeys[static_cast<size_t>(this->lit)] ^ kLitKeys[static_cast<size_t>(change.value.lit)];
+        this->lit = change.value.lit;
+        break;
+      case mark_f:
+        this->hash ^= kMarkKeys[static_cast<unsigned char>(this->mark)] ^ kMarkKeys[static_cast<unsigned char>(change.value.mark)];
+        this->mark = change.value.mark;
+        break;
+      }
+    }
+  }
+  static const uint64_t kFloorKeys[3];
+  static const uint64_t kLitKeys[2];
+  static const uint64_t kMarkKeys[256];
+  uint64_t computeHash() const {
+    uint64_t hash = 0;
+    hash ^= kFloorKeys[static_cast<size_t>(floor)];
+    hash ^= kLitKeys[static_cast<size_t>(lit)];
+    hash ^= kMarkKeys[static_cast<unsigned char>(mark)];
+    return hash;
+  }
+  void rehash() {
+    hash = computeHash();
+  }
+  struct Patch {
+    uint64_t changed = 0;
+    int turn;
+    Floor floor;
+    bool lit;
+    char mark;
+    bool has(Field field) const { return (changed >> field) & 1; }
+  };
+  void setTurn(gm::UndoLog<Change> &log, int value) {
+    Change change;
+    change.field = turn_f;
+    change.value.turn = this->turn;
+    log.push(change);
+    this->turn = value;
+  }
+  void setFloor(gm::UndoLog<Change> &log, const Floor &value) {
+    Change change;
+    change.field = floor_f;
+    change.value.floor = this->floor;
+    log.push(change);
+    this->hash ^= kFloorKeys[static_cast<size_t>(this->floor)] ^ kFloorKeys[static_cast<size_t>(value)];
+    this->floor = value;
+  }
+  void setLit(gm::UndoLog<Change> &log, bool value) {
+    Change change;
+    change.field = lit_f;
+    change.value.lit = this->lit;
+    log.push(change);
+    this->hash ^= kLitKeys[static_cast<size_t>(this->lit)] ^ kLitKeys[static_cast<size_t>(value)];
+    this->lit = value;
+  }
+  void setMark(gm::UndoLog<Change> &log, char value) {
+    Change change;
+    change.field = mark_f;
+    change.value.mark = this->mark;
+    log.push(change);
+    this->hash ^= kMarkKeys[static_cast<unsigned char>(this->mark)] ^ kMarkKeys[static_cast<unsigned char>(value)];
+    this->mark = value;
+  }
+};
+
+static_assert(std::is_trivially_copyable<Square>::value, "Square must be trivially copyable");
+
+std::istream &operator>>(std::istream &is, Square &obj);
+void readText(const char *&cur, const char *end, Square &obj);
+void readMany(const char *&cur, const char *end, size_t n, Square *out);
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Square> &out);
+
+constexpr size_t kSquareBinSize = 10;
+constexpr uint64_t kSquareFingerprint = 0xa3e4d3b259399e13ULL;
+void encode(uint8_t *&out, const Square &obj);
+void decode(const uint8_t *&in, Square &obj);
+
+void randomize(gm::Rng &rng, Square &obj);
+
+Square::Patch diff(const Square &a, const Square &b);
+void apply(Square &state, const Square::Patch &patch);
+
+constexpr size_t kSquarePatchMaxBinSize = 11;
+void encode(uint8_t *&out, const Square::Patch &patch);
+void decode(const uint8_t *&in, Square::Patch &patch);
+
+struct Stats {
+  Stats() = default;
+  Stats(int hp, double speed, std::string name) noexcept(std::is_nothrow_move_constructible<std::string>::value): hp(hp), speed(speed), name(std::move(name)) {
+    dirty = Stats::kAllFields;
+  }
+  int hp;
+  double speed;
+  std::string name;
+  uint64_t dirty = kAllFields;
+  enum Field {
+    hp_f,
+    speed_f,
+    name_f,
+  };
+  bool operator==(const Stats &other) const;
+  static constexpr uint64_t kAllFields = 0x7ULL;
+  bool isDirty(Field field) const { return (dirty >> field) & 1; }
+  uint64_t dirtyFields() const { return dirty; }
+  void clearDirty() { dirty = 0; }
+  struct Patch {
+    uint64_t changed = 0;
+    int hp;
+    double speed;
+    std::string name;
+    bool has(Field field) const { return (changed >> field) & 1; }
+  };
+  void setHp(int value) {
+    this->dirty |= uint64_t(1) << hp_f;
+    this->hp = value;
+  }
+  void setSpeed(double value) {
+    this->dirty |= uint64_t(1) << speed_f;
+    this->speed = value;
+  }
+  void setName(const std::string &value) {
+    this->dirty |= uint64_t(1) << name_f;
+    this->name = value;
+  }
+};
+
+std::istream &operator>>(std::istream &is, Stats &obj);
+void readText(const char *&cur, const char *end, Stats &obj);
+void readMany(const char *&cur, const char *end, size_t n, Stats *out);
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Stats> &out);
+
+Stats::Patch diff(const Stats &a, const Stats &b);
+void apply(Stats &state, const Stats::Patch &patch);
+
+struct Piece {
+  Piece() : floor(), row(), col(), lit(), tag(), id(), score() {
+    rehash();
+  }
+  Piece(Floor floor, int row, int col, bool lit, char tag, int id, int score) : floor(floor), row(row), col(col), lit(lit), tag(tag), id(id), score(score) {
+    rehash();
+  }
+  Floor floor;
+  int row;
+  int col;
+  bool lit;
+  char tag;
+  int id;
+  int score;
+  uint64_t hash;
+  enum Field {
+    floor_f,
+    row_f,
+    col_f,
+    lit_f,
+    tag_f,
+    id_f,
+    score_f,
+  };
+  bool operator==(const Piece &other) const;
+  static const uint64_t kFloorKeys[3];
+  static const uint64_t kRowKeys[8];
+  static const uint64_t kColKeys[8];
+  static const uint64_t kLitKeys[2];
+  static const uint64_t kTagKeys[256];
+  uint64_t computeHash() const {
+    uint64_t hash = 0;
+    hash ^= kFloorKeys[static_cast<size_t>(floor)];
+    if (row < -4 || row > 3) {
+      throw std::out_of_range("Piece::row");
+    }
+    hash ^= kRowKeys[static_cast<size_t>(row + 4)];
+    if (col < 0 || col > 7) {
+      throw std::out_of_range("Piece::col");
+    }
+    hash ^= kColKeys[static_cast<size_t>(col)];
+    hash ^= kLitKeys[static_cast<size_t>(lit)];
+    hash ^= kTagKeys[static_cast<unsigned char>(tag)];
+    return hash;
+  }
+  void rehash() {
+    hash = computeHash();
+  }
+  void setFloor(const Floor &value) {
+    this->hash ^= kFloorKeys[static_cast<size_t>(this->floor)] ^ kFloorKeys[static_cast<size_t>(value)];
+    this->floor = value;
+  }
+  void setRow(int value) {
+    if (value < -4 || value > 3) {
+      throw std::out_of_range("Piece::setRow");
+    }
+    this->hash ^= kRowKeys[static_cast<size_t>(this->row + 4)] ^ kRowKeys[static_cast<size_t>(value + 4)];
+    this->row = value;
+  }
+  void setCol(int value) {
+    if (value < 0 || value > 7) {
+      throw std::out_of_range("Piece::setCol");
+    }
+    this->hash ^= kColKeys[static_cast<size_t>(this->col)] ^ kColKeys[static_cast<size_t>(value)];
+    this->col = value;
+  }
+  void setLit(bool value) {
+    this->hash ^= kLitKeys[static_cast<size_t>(this->lit)] ^ kLitKeys[static_cast<size_t>(value)];
+    this->lit = value;
+  }
+  void setTag(char value) {
+    this->hash ^= kTagKeys[static_cast<unsigned char>(this->tag)] ^ kTagKeys[static_cast<unsigned char>(value)];
+    this->tag = value;
+  }
+  void setId(int value) {
+    if (value < 0 || value > 1000000000) {
+      throw std::out_of_range("Piece::setId");
+    }
+    this->id = value;
+  }
+  void setScore(int value) {
+    if (value < -1000000 || value > 1000000) {
+      throw std::out_of_range("Piece::setScore");
+    }
+    this->score = value;
+  }
+};
+
+static_assert(std::is_trivially_copyable<Piece>::value, "Piece must be trivially copyable");
+
+std::istream &operator>>(std::istream &is, Piece &obj);
+void readText(const char *&cur, const char *end, Piece &obj);
+void readMany(const char *&cur, const char *end, size_t n, Piece *out);
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Piece> &out);
+
+void randomize(gm::Rng &rng, Piece &obj);
+
+struct PiecePacked {
+  PiecePacked() : words() {}
+  Floor floor() const { return static_cast<Floor>(words[0] & 0x3ULL); }
+  void setFloor(Floor value) {
+    words[0] = (words[0] & ~0x3ULL) | (static_cast<uint64_t>(value) & 0x3ULL);
+  }
+  int row() const { return static_cast<int>((words[0] >> 2) & 0x7ULL) - 4; }
+  void setRow(int value) {
+    if (value < -4 || value > 3) {
+      throw std::out_of_range("PiecePacked::setRow");
+    }
+    words[0] = (words[0] & ~0x1cULL) | (((static_cast<uint64_t>(value) + 4) & 0x7ULL) << 2);
+  }
+  int col() const { return static_cast<int>((words[0] >> 5) & 0x7ULL); }
+  void setCol(int value) {
+    if (value < 0 || value > 7) {
+      throw std::out_of_range("PiecePacked::setCol");
+    }
+    words[0] = (words[0] & ~0xe0ULL) | ((static_cast<uint64_t>(value) & 0x7ULL) << 5);
+  }
+  bool lit() const { return ((words[0] >> 8) & 0x1ULL) != 0; }
+  void setLit(bool value) {
+    words[0] = (words[0] & ~0x100ULL) | ((static_cast<uint64_t>(value) & 0x1ULL) << 8);
+  }
+  char tag() const { return static_cast<char>((words[0] >> 9) & 0xffULL); }
+  void setTag(char value) {
+    words[0] = (words[0] & ~0x1fe00ULL) | ((static_cast<unsigned char>(value) & 0xffULL) << 9);
+  }
+  int id() const { return static_cast<int>((words[0] >> 17) & 0x3fffffffULL); }
+  void setId(int value) {
+    if (value < 0 || value > 1000000000) {
+      throw std::out_of_range("PiecePacked::setId");
+    }
+    words[0] = (words[0] & ~0x7ffffffe0000ULL) | ((static_cast<uint64_t>(value) & 0x3fffffffULL) << 17);
+  }
+  int score() const { return static_cast<int>(words[1] & 0x1fffffULL) - 1000000; }
+  void setScore(int value) {
+    if (value < -1000000 || value > 1000000) {
+      throw std::out_of_range("PiecePacked::setScore");
+    }
+    words[1] = (words[1] & ~0x1fffffULL) | ((static_cast<uint64_t>(value) + 1000000) & 0x1fffffULL);
+  }
+  bool operator==(const PiecePacked &other) const {
+    return words[0] == other.words[0] && words[1] == other.words[1];
+  }
+  bool operator!=(const PiecePacked &other) const { return !(*this == other); }
+  uint64_t hash() const {
+    uint64_t h = words[0] * 0x9E3779B97F4A7C15ULL;
+    h = (h ^ words[1]) * 0x9E3779B97F4A7C15ULL;
+    return h ^ (h >> 29);
+  }
+  uint64_t words[2];
+};
+
+PiecePacked pack(const Piece &obj);
+void unpack(const PiecePacked &packed, Piece &obj);
+
 
 #endif
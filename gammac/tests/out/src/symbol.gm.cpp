@@ -0,0 +1,349 @@
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include "gamma/profile.hpp"
+
+#include "src/symbol.gm.hpp"
+
+bool Route::operator==(const Route &other) const {
+  return from == other.from
+      && to == other.to
+      && hops == other.hops;
+}
+
+std::istream &operator>>(std::istream &is, Route &obj) {
+  is >> obj.from;
+  is >> obj.to;
+  is >> obj.hops;
+  return is;
+}
+
+void readText(const char *&cur, const char *end, Route &obj) {
+  gm::readText(cur, end, obj.from);
+  gm::readText(cur, end, obj.to);
+  gm::readText(cur, end, obj.hops);
+}
+
+void readMany(const char *&cur, const char *end, size_t n, Route *out) {
+  const char *p = cur;
+  for (size_t i = 0; i < n; i++) {
+    readText(p, end, out[i]);
+  }
+  cur = p;
+}
+
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Route> &out) {
+  const char *p = cur;
+  size_t size = out.size();
+  out.reserve(size + n);
+  try {
+    for (size_t i = 0; i < n; i++) {
+      Route item;
+      readText(p, end, item);
+      out.push_back(std::move(item));
+    }
+  }
+  catch (...) {
+    out.erase(out.begin() + size, out.end());
+    throw;
+  }
+  cur = p;
+}
+
+std::ostream &operator<<(std::ostream &os, const Route &obj) {
+  os << "{ ";
+  os << "from" << ": " << obj.from << ", ";
+  os << "to" << ": " << obj.to << ", ";
+  os << "hops" << ": " << obj.hops;
+  os << " }";
+  return os;
+}
+
+void writeText(gm::OutputBuffer &os, const Route &obj) {
+  os << "{ ";
+  os << "from" << ": " << obj.from << ", ";
+  os << "to" << ": " << obj.to << ", ";
+  os << "hops" << ": " << obj.hops;
+  os << " }";
+}
+
+void writeJson(std::string &out, const Route &obj) {
+  out += "{\"from\":";
+  gm::writeJson(out, obj.from);
+  out += ",\"to\":";
+  gm::writeJson(out, obj.to);
+  out += ",\"hops\":";
+  gm::writeJson(out, obj.hops);
+  out += '}';
+}
+
+void readJson(const char *&cur, const char *end, Route &obj) {
+  gm::json::expect(cur, end, '{');
+  if (gm::json::consume(cur, end, '}')) {
+    return;
+  }
+  const char *key;
+  size_t length;
+  do {
+    gm::json::readKey(cur, end, key, length);
+    switch (length) {
+    case 2:
+      if (std::memcmp(key, "to", 2) == 0) {
+        gm::readJson(cur, end, obj.to);
+        continue;
+      }
+      break;
+    case 4:
+      if (std::memcmp(key, "from", 4) == 0) {
+        gm::readJson(cur, end, obj.from);
+        continue;
+      }
+      if (std::memcmp(key, "hops", 4) == 0) {
+        gm::readJson(cur, end, obj.hops);
+        continue;
+      }
+      break;
+    }
+    gm::json::skipValue(cur, end);
+  } while (gm::json::next(cur, end, '}'));
+}
+
+void randomize(gm::Rng &rng, Route &obj) {
+  randomize(rng, obj.from);
+  randomize(rng, obj.to);
+  randomize(rng, obj.hops);
+}
+
+Route::Patch diff(const Route &a, const Route &b) {
+  Route::Patch patch;
+  if (!(a.from == b.from)) {
+    patch.changed |= uint64_t(1) << Route::from_f;
+    patch.from = b.from;
+  }
+  if (!(a.to == b.to)) {
+    patch.changed |= uint64_t(1) << Route::to_f;
+    patch.to = b.to;
+  }
+  if (!(a.hops == b.hops)) {
+    patch.changed |= uint64_t(1) << Route::hops_f;
+    patch.hops = b.hops;
+  }
+  return patch;
+}
+
+void apply(Route &state, const Route::Patch &patch) {
+  if (patch.has(Route::from_f)) {
+    state.from = patch.from;
+  }
+  if (patch.has(Route::to_f)) {
+    state.to = patch.to;
+  }
+  if (patch.has(Route::hops_f)) {
+    state.hops = patch.hops;
+  }
+}
+
+bool Message::operator==(const Message &other) const {
+  if (type != other.type) return false;
+  switch (type) {
+  case Message::Send_t:
+    return std::memcmp(&data.Send, &other.data.Send, sizeof(Send_d)) == 0;
+  default:
+    return true;
+  }
+}
+
+#ifdef GAMMA_PROFILE
+static const char *const kMessageVariants[] = {
+  "Send", "Quit", 
+};
+static uint64_t *const kMessageHits = gm::Profile::instance().add("Message", kMessageVariants, 2);
+#endif
+
+std::istream &operator>>(std::istream &is, Message &obj) {
+  std::string str;
+  if (!(is >> str)) {
+    return is;
+  }
+  if (str == "Send") {
+    obj.type = Message::Send_t;
+    GM_PROFILE_HIT(kMessageHits, Message::Send_t - 1);
+    is >> obj.data.Send.to;
+    is >> obj.data.Send.body;
+  }
+  else if (str == "Quit") {
+    obj.type = Message::Quit_t;
+    GM_PROFILE_HIT(kMessageHits, Message::Quit_t - 1);
+  }
+  else {
+    throw std::runtime_error("Invalid Message");
+  }
+  return is;
+}
+
+void readText(const char *&cur, const char *end, Message &obj) {
+  const char *key;
+  size_t length;
+  gm::text::readToken(cur, end, key, length);
+  switch (length) {
+  case 4:
+    if (std::memcmp(key, "Send", 4) == 0) {
+      obj.type = Message::Send_t;
+      GM_PROFILE_HIT(kMessageHits, Message::Send_t - 1);
+      gm::readText(cur, end, obj.data.Send.to);
+      gm::readText(cur, end, obj.data.Send.body);
+      return;
+    }
+    if (std::memcmp(key, "Quit", 4) == 0) {
+      obj.type = Message::Quit_t;
+      GM_PROFILE_HIT(kMessageHits, Message::Quit_t - 1);
+      return;
+    }
+    break;
+  }
+  gm::text::error("invalid Message");
+}
+
+void readMany(const char *&cur, const char *end, size_t n, Message *out) {
+  const char *p = cur;
+  for (size_t i = 0; i < n; i++) {
+    readText(p, end, out[i]);
+  }
+  cur = p;
+}
+
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Message> &out) {
+  const char *p = cur;
+  size_t size = out.size();
+  out.reserve(size + n);
+  try {
+    for (size_t i = 0; i < n; i++) {
+      Message item;
+      readText(p, end, item);
+      out.push_back(std::move(item));
+    }
+  }
+  catch (...) {
+    out.erase(out.begin() + size, out.end());
+    throw;
+  }
+  cur = p;
+}
+
+std::ostream &operator<<(std::ostream &os, const Message &obj) {
+  switch (obj.type) {
+  case Message::Send_t:
+    os << "Send " << obj.data.Send.to << " " << obj.data.Send.body << "";
+  break;
+  case Message::Quit_t:
+    os << "Quit";
+  break;
+  default:
+    break;
+  }
+  return os;
+}
+
+static void writeJson(std::string &out, const Message::Send_d &obj) {
+  out += "{\"to\":";
+  gm::writeJson(out, obj.to);
+  out += ",\"body\":";
+  gm::writeJson(out, obj.body);
+  out += '}';
+}
+
+static void readJson(const char *&cur, const char *end, Message::Send_d &obj) {
+  gm::json::expect(cur, end, '{');
+  if (gm::json::consume(cur, end, '}')) {
+    return;
+  }
+  const char *key;
+  size_t length;
+  do {
+    gm::json::readKey(cur, end, key, length);
+    switch (length) {
+    case 2:
+      if (std::memcmp(key, "to", 2) == 0) {
+        gm::readJson(cur, end, obj.to);
+        continue;
+      }
+      break;
+    case 4:
+      if (std::memcmp(key, "body", 4) == 0) {
+        gm::readJson(cur, end, obj.body);
+        continue;
+      }
+      break;
+    }
+    gm::json::skipValue(cur, end);
+  } while (gm::json::next(cur, end, '}'));
+}
+
+static void writeJson(std::string &out, const Message::Quit_d &) {
+  out += "{}";
+}
+
+static void readJson(const char *&cur, const char *end, Message::Quit_d &) {
+  gm::json::skipValue(cur, end);
+}
+
+void writeJson(std::string &out, const Message &obj) {
+  switch (obj.type) {
+  case Message::Send_t:
+    out += "{\"Send\":";
+    writeJson(out, obj.data.Send);
+    out += '}';
+    break;
+  case Message::Quit_t:
+    out += "{\"Quit\":";
+    writeJson(out, obj.data.Quit);
+    out += '}';
+    break;
+  default:
+    out += "null";
+    break;
+  }
+}
+
+void readJson(const char *&cur, const char *end, Message &obj) {
+  if (gm::json::consumeNull(cur, end)) {
+    obj.type = Message::Undef;
+    return;
+  }
+  gm::json::expect(cur, end, '{');
+  const char *key;
+  size_t length;
+  gm::json::readKey(cur, end, key, length);
+  switch (length) {
+  case 4:
+    if (std::memcmp(key, "Send", 4) == 0) {
+      obj.type = Message::Send_t;
+      readJson(cur, end, obj.data.Send);
+      gm::json::expect(cur, end, '}');
+      return;
+    }
+    if (std::memcmp(key, "Quit", 4) == 0) {
+      obj.type = Message::Quit_t;
+      readJson(cur, end, obj.data.Quit);
+      gm::json::expect(cur, end, '}');
+      return;
+    }
+    break;
+  }
+  gm::json::error("invalid Message");
+}
+
+void randomize(gm::Rng &rng, Message &obj) {
+  switch (rng.below(2)) {
+  case 0:
+    obj.type = Message::Send_t;
+    randomize(rng, obj.data.Send.to);
+    randomize(rng, obj.data.Send.body);
+    break;
+  case 1:
+    obj.type = Message::Quit_t;
+    break;
+  }
+}
+
@@ -0,0 +1,137 @@
+#ifndef src_symbol_gm__
+#define src_symbol_gm__
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "gamma/containers.hpp"
+#include "gamma/io.hpp"
+#include "gamma/io_containers.hpp"
+#include "gamma/io_symbol.hpp"
+#include "gamma/json.hpp"
+#include "gamma/json_containers.hpp"
+#include "gamma/json_symbol.hpp"
+#include "gamma/out.hpp"
+#include "gamma/out_containers.hpp"
+#include "gamma/out_symbol.hpp"
+#include "gamma/random.hpp"
+#include "gamma/random_containers.hpp"
+#include "gamma/random_symbol.hpp"
+#include "gamma/symbol.hpp"
+#include "gamma/text.hpp"
+#include "gamma/text_containers.hpp"
+#include "gamma/text_symbol.hpp"
+
+struct Route {
+  Route() = default;
+  constexpr Route(gm::Sym from, gm::Sym to, gm::SmallVec<gm::Sym, 4> hops) noexcept: from(from), to(to), hops(hops) {}
+  gm::Sym from;
+  gm::Sym to;
+  gm::SmallVec<gm::Sym, 4> hops;
+  enum Field {
+    from_f,
+    to_f,
+    hops_f,
+  };
+  bool operator==(const Route &other) const;
+  struct Patch {
+    uint64_t changed = 0;
+    gm::Sym from;
+    gm::Sym to;
+    gm::SmallVec<gm::Sym, 4> hops;
+    bool has(Field field) const { return (changed >> field) & 1; }
+  };
+};
+
+static_assert(std::is_trivially_copyable<Route>::value, "Route must be trivially copyable");
+
+std::istream &operator>>(std::istream &is, Route &obj);
+void readText(const char *&cur, const char *end, Route &obj);
+void readMany(const char *&cur, const char *end, size_t n, Route *out);
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Route> &out);
+
+std::ostream &operator<<(std::ostream &os, const Route &obj);
+void writeText(gm::OutputBuffer &os, const Route &obj);
+
+void writeJson(std::string &out, const Route &obj);
+void readJson(const char *&cur, const char *end, Route &obj);
+
+void randomize(gm::Rng &rng, Route &obj);
+
+Route::Patch diff(const Route &a, const Route &b);
+void apply(Route &state, const Route::Patch &patch);
+
+struct Message {
+  enum Type {
+    Undef,
+    Send_t,
+    Quit_t,
+  } type;
+  struct Send_d {
+    gm::Sym to;
+    gm::Sym body;
+  };
+  struct Quit_d {
+  };
+  union Data {
+    constexpr Data() noexcept: Send() {}
+    constexpr Data(Send_d Send) noexcept: Send(Send) {}
+    constexpr Data(Quit_d Quit) noexcept: Quit(Quit) {}
+    Send_d Send;
+    Quit_d Quit;
+  } data;
+  constexpr Message(Type type = Undef) noexcept: type(type), data() {}
+  constexpr Message(Type type, Data data) noexcept: type(type), data(data) {}
+  static constexpr Message Send(gm::Sym to, gm::Sym body) noexcept {
+    return Message(Send_t, Send_d{to, body});
+  }
+  static constexpr Message Quit() noexcept {
+    return Message(Quit_t, Quit_d{});
+  }
+  bool operator==(const Message &other) const;
+};
+
+template <typename Visitor>
+auto visit(const Message &obj, Visitor &&vis) -> decltype(vis(obj.data.Send)) {
+  switch (obj.type) {
+  case Message::Send_t:
+    return vis(obj.data.Send);
+  case Message::Quit_t:
+    return vis(obj.data.Quit);
+  default:
+    throw std::invalid_argument("visit: undefined Message");
+  }
+}
+
+template <typename Visitor>
+auto visit(Message &obj, Visitor &&vis) -> decltype(vis(obj.data.Send)) {
+  switch (obj.type) {
+  case Message::Send_t:
+    return vis(obj.data.Send);
+  case Message::Quit_t:
+    return vis(obj.data.Quit);
+  default:
+    throw std::invalid_argument("visit: undefined Message");
+  }
+}
+
+static_assert(std::is_trivially_copyable<Message>::value, "Message must be trivially copyable");
+static_assert(sizeof(Message::Send_d) == sizeof(gm::Sym) + sizeof(gm::Sym), "Message::Send_d must have no padding");
+
+std::istream &operator>>(std::istream &is, Message &obj);
+void readText(const char *&cur, const char *end, Message &obj);
+void readMany(const char *&cur, const char *end, size_t n, Message *out);
+void readMany(const char *&cur, const char *end, size_t n, std::vector<Message> &out);
+
+std::ostream &operator<<(std::ostream &os, const Message &obj);
+
+void writeJson(std::string &out, const Message &obj);
+void readJson(const char *&cur, const char *end, Message &obj);
+
+void randomize(gm::Rng &rng, Message &obj);
+
+
+#endif
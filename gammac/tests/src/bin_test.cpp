@@ -0,0 +1,244 @@
+/*
+ * Copyright (C) 2017 Cyril Deguet <cyril.deguet@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <stdexcept>
+
+#include "catch.hpp"
+#include "src/bin.gm.hpp"
+
+TEST_CASE("Binary encoding of a struct", "[bin]")
+{
+    uint8_t buffer[kPosBinSize];
+    uint8_t *out = buffer;
+    encode(out, Pos(1, -2));
+    REQUIRE(out == buffer + kPosBinSize);
+    const uint8_t expected[] = {1, 0, 0, 0, 0xfe, 0xff, 0xff, 0xff};
+    REQUIRE(std::memcmp(buffer, expected, sizeof(expected)) == 0);
+}
+
+TEST_CASE("Binary encoding of a union", "[bin]")
+{
+    uint8_t buffer[kOrderBinSize];
+    uint8_t *out = buffer;
+    encode(out, Order::Drop(Cell::BOX, 3));
+    REQUIRE(out == buffer + kOrderBinSize);
+    const uint8_t expected[] = {2, 2, 0, 0, 0, 3, 0, 0, 0};
+    REQUIRE(std::memcmp(buffer, expected, sizeof(expected)) == 0);
+}
+
+TEST_CASE("Binary round trip", "[bin]")
+{
+    Bot bots[] = {Bot(Pos(3, 4), Cell::WALL, true, 0.5, Order::Go(Pos(5, 6))),
+                  Bot(Pos(-1, 0), Cell::EMPTY, false, 12.0, Order::Idle()),
+                  Bot(Pos(0, 9), Cell::BOX, true, -1.0, Order())};
+    uint8_t buffer[3 * kBotBinSize];
+    uint8_t *out = buffer;
+    for (const Bot &bot : bots)
+    {
+        encode(out, bot);
+    }
+    REQUIRE(out == buffer + sizeof(buffer));
+    const uint8_t *in = buffer;
+    for (const Bot &bot : bots)
+    {
+        Bot decoded;
+        decode(in, decoded);
+        REQUIRE(decoded == bot);
+    }
+    REQUIRE(in == buffer + sizeof(buffer));
+}
+
+TEST_CASE("Binary stream fingerprint", "[bin]")
+{
+    uint8_t buffer[8 + kCellBinSize];
+    uint8_t *out = buffer;
+    gm::encodeFingerprint(out, kCellFingerprint);
+    encode(out, Cell::WALL);
+    const uint8_t *in = buffer;
+    gm::decodeFingerprint(in, kCellFingerprint);
+    Cell cell;
+    decode(in, cell);
+    REQUIRE(cell == Cell::WALL);
+    in = buffer;
+    REQUIRE_THROWS_AS(gm::decodeFingerprint(in, kPosFingerprint), std::runtime_error);
+}
+
+TEST_CASE("Binary decoding of an invalid union", "[bin]")
+{
+    const uint8_t buffer[kOrderBinSize] = {42};
+    const uint8_t *in = buffer;
+    Order order;
+    REQUIRE_THROWS_AS(decode(in, order), std::runtime_error);
+}
+
+TEST_CASE("Binary decoding of invalid enums and bools", "[bin]")
+{
+    const uint8_t cellBuffer[kCellBinSize] = {3};
+    const uint8_t *in = cellBuffer;
+    Cell cell;
+    REQUIRE_THROWS_AS(decode(in, cell), std::runtime_error);
+    uint8_t buffer[kBotBinSize];
+    uint8_t *out = buffer;
+    encode(out, Bot(Pos(1, 2), Cell::BOX, true, 1.0, Order::Idle()));
+    // The cell follows the position, and the alive flag follows the cell
+    buffer[8] = 0xff;
+    in = buffer;
+    Bot bot;
+    REQUIRE_THROWS_AS(decode(in, bot), std::runtime_error);
+    buffer[8] = 0;
+    buffer[12] = 2;
+    in = buffer;
+    REQUIRE_THROWS_AS(decode(in, bot), std::runtime_error);
+    buffer[12] = 0;
+    in = buffer;
+    decode(in, bot);
+    REQUIRE_FALSE(bot.alive);
+}
+
+TEST_CASE("View over encoded structs", "[bin]")
+{
+    Bot bots[] = {Bot(Pos(3, 4), Cell::WALL, true, 0.5, Order::Go(Pos(5, 6))),
+                  Bot(Pos(-1, 0), Cell::EMPTY, false, 12.0, Order::Drop(Cell::BOX, 7))};
+    uint8_t buffer[2 * kBotBinSize];
+    uint8_t *out = buffer;
+    for (const Bot &bot : bots)
+    {
+        encode(out, bot);
+    }
+    BotView first(buffer);
+    REQUIRE(first.pos().x() == 3);
+    REQUIRE(first.pos().y() == 4);
+    REQUIRE(first.cell() == Cell::WALL);
+    REQUIRE(first.alive());
+    REQUIRE(first.energy() == 0.5);
+    REQUIRE(first.order().type() == Order::Go_t);
+    REQUIRE(first.order().Go().to().y() == 6);
+    BotView second(buffer + kBotBinSize);
+    REQUIRE_FALSE(second.alive());
+    REQUIRE(second.energy() == 12.0);
+    REQUIRE(second.order().type() == Order::Drop_t);
+    REQUIRE(second.order().Drop().cell() == Cell::BOX);
+    REQUIRE(second.order().Drop().count() == 7);
+}
+
+TEST_CASE("View over corrupt structs", "[bin]")
+{
+    uint8_t buffer[kBotBinSize];
+    uint8_t *out = buffer;
+    encode(out, Bot(Pos(1, 2), Cell::BOX, true, 1.0, Order::Drop(Cell::WALL, 3)));
+    BotView view(buffer);
+    // Offsets of the cell, the alive flag, the order tag and the dropped cell
+    buffer[8] = 3;
+    REQUIRE_THROWS_AS(view.cell(), std::runtime_error);
+    buffer[12] = 2;
+    REQUIRE_THROWS_AS(view.alive(), std::runtime_error);
+    buffer[22] = 3;
+    REQUIRE_THROWS_AS(view.order().Drop().cell(), std::runtime_error);
+    buffer[21] = 4;
+    REQUIRE_THROWS_AS(view.order().type(), std::runtime_error);
+    buffer[21] = 0;
+    REQUIRE(view.order().type() == Order::Undef);
+}
+
+TEST_CASE("Column file", "[bin]")
+{
+    const std::string path = "out/obj/columns_test.gmc";
+    Bot bots[] = {Bot(Pos(3, 4), Cell::WALL, true, 0.5, Order::Go(Pos(5, 6))),
+                  Bot(Pos(-1, 0), Cell::EMPTY, false, 12.0, Order::Idle()),
+                  Bot(Pos(0, 9), Cell::BOX, true, -1.0, Order::Drop(Cell::BOX, 7))};
+    {
+        gm::ColumnWriter writer(path, BotColumns::kFingerprint, BotColumns::kFieldCount);
+        appendColumns(writer, bots, 2);
+    }
+    {
+        gm::ColumnWriter writer(path, BotColumns::kFingerprint, BotColumns::kFieldCount, true);
+        appendColumns(writer, bots + 2, 1);
+    }
+    gm::ColumnReader reader(path, BotColumns::kFingerprint, BotColumns::kFieldCount, BotColumns::kFieldSizes);
+    REQUIRE(reader.chunkCount() == 2);
+    REQUIRE(reader.size() == 3);
+    BotColumns first(reader.chunk(0));
+    REQUIRE(first.size == 2);
+    REQUIRE(first.pos(0).x() == 3);
+    REQUIRE(first.cell(1) == Cell::EMPTY);
+    REQUIRE(first.alive(0));
+    REQUIRE_FALSE(first.alive(1));
+    REQUIRE(first.energy(1) == 12.0);
+    REQUIRE(first.order(0).Go().to().y() == 6);
+    REQUIRE(first.order(1).type() == Order::Idle_t);
+    BotColumns second(reader.chunk(1));
+    REQUIRE(second.size == 1);
+    REQUIRE(second.pos(0).y() == 9);
+    REQUIRE(second.order(0).Drop().count() == 7);
+    REQUIRE_THROWS_AS(gm::ColumnReader(path, kPosFingerprint, BotColumns::kFieldCount, BotColumns::kFieldSizes),
+                      std::runtime_error);
+}
+
+TEST_CASE("Corrupt column file", "[bin]")
+{
+    const std::string path = "out/obj/corrupt_columns_test.gmc";
+    const Bot bot(Pos(3, 4), Cell::WALL, true, 0.5, Order::Go(Pos(5, 6)));
+    {
+        gm::ColumnWriter writer(path, BotColumns::kFingerprint, BotColumns::kFieldCount);
+        appendColumns(writer, &bot, 1);
+    }
+    // Record count of the first chunk, after the file header and chunk size
+    const long countOffset = 24 + 8;
+    std::FILE *file = std::fopen(path.c_str(), "r+b");
+    REQUIRE(file);
+    uint8_t count[8];
+    gm::store<uint64_t>(count, 1000);
+    std::fseek(file, countOffset, SEEK_SET);
+    REQUIRE(std::fwrite(count, 1, sizeof(count), file) == sizeof(count));
+    std::fclose(file);
+    REQUIRE_THROWS_AS(gm::ColumnReader(path, BotColumns::kFingerprint, BotColumns::kFieldCount, BotColumns::kFieldSizes),
+                      std::runtime_error);
+}
+
+// Overwrites the first value of a column of the first chunk
+static void corruptColumn(const std::string &path, size_t field, uint8_t value)
+{
+    const long chunkOffset = 24;
+    std::FILE *file = std::fopen(path.c_str(), "r+b");
+    REQUIRE(file);
+    uint8_t offset[8];
+    std::fseek(file, chunkOffset + 16 + 8 * field, SEEK_SET);
+    REQUIRE(std::fread(offset, 1, sizeof(offset), file) == sizeof(offset));
+    std::fseek(file, chunkOffset + static_cast<long>(gm::load<uint64_t>(offset)), SEEK_SET);
+    REQUIRE(std::fwrite(&value, 1, 1, file) == 1);
+    std::fclose(file);
+}
+
+TEST_CASE("Column file with corrupt values", "[bin]")
+{
+    const std::string path = "out/obj/corrupt_columns_test.gmc";
+    const Bot bot(Pos(3, 4), Cell::WALL, true, 0.5, Order::Go(Pos(5, 6)));
+    {
+        gm::ColumnWriter writer(path, BotColumns::kFingerprint, BotColumns::kFieldCount);
+        appendColumns(writer, &bot, 1);
+    }
+    // Columns of the cell, the alive flag and the order
+    corruptColumn(path, 1, 3);
+    corruptColumn(path, 2, 2);
+    corruptColumn(path, 4, 4);
+    gm::ColumnReader reader(path, BotColumns::kFingerprint, BotColumns::kFieldCount, BotColumns::kFieldSizes);
+    BotColumns columns(reader.chunk(0));
+    REQUIRE(columns.pos(0).x() == 3);
+    REQUIRE_THROWS_AS(columns.cell(0), std::runtime_error);
+    REQUIRE_THROWS_AS(columns.alive(0), std::runtime_error);
+    REQUIRE_THROWS_AS(columns.order(0).type(), std::runtime_error);
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2017 Cyril Deguet <cyril.deguet@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <unistd.h>
+
+#include "catch.hpp"
+#include "gamma/io.hpp"
+
+// Returns the text written by a gm::OutputBuffer, flushed to a pipe rather
+// than to the standard output
+template <typename T>
+std::string writeBuffered(const T &value)
+{
+    int fds[2];
+    REQUIRE(pipe(fds) == 0);
+    {
+        gm::OutputBuffer output(fds[1]);
+        output << value;
+    }
+    close(fds[1]);
+    std::string text;
+    char buffer[256];
+    ssize_t length;
+    while ((length = read(fds[0], buffer, sizeof(buffer))) > 0)
+    {
+        text.append(buffer, length);
+    }
+    close(fds[0]);
+    return text;
+}
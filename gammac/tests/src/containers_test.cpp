@@ -0,0 +1,291 @@
+/*
+ * Copyright (C) 2017 Cyril Deguet <cyril.deguet@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "buffer_helpers.hpp"
+#include "catch.hpp"
+#include "src/containers.gm.hpp"
+
+static Board makeBoard()
+{
+    Board board;
+    board.tiles = {{Ground::GRASS, Ground::WATER, Ground::ROCK, Ground::GRASS}};
+    board.path = {Step(1, 2), Step(3, 4)};
+    board.heights = {{{{-1, 2}}, {{3, -4}}}};
+    board.marks = {7, 255};
+    return board;
+}
+
+static const char kBoardText[] = "GRASS WATER ROCK GRASS 2 1 2 3 4 -1 2 3 -4 2 7 255";
+
+TEST_CASE("Container field types", "[containers]")
+{
+    static_assert(std::is_same<decltype(Board::tiles), gm::Array<Ground, 4>>::value, "Array field");
+    static_assert(std::is_same<decltype(Board::path), gm::SmallVec<Step, 3>>::value, "SmallVec field");
+    static_assert(std::is_same<decltype(History::moves), gm::Vec<Step>>::value, "Vec field");
+    static_assert(std::is_trivially_copyable<Board>::value, "inline containers are trivially copyable");
+    static_assert(sizeof(gm::SmallVec<uint8_t, 5>) == 6, "SmallVec count on a byte");
+    static_assert(kBoardBinSize == 16 + 1 + 3 * 8 + 4 + 1 + 5, "board encoding size");
+}
+
+TEST_CASE("SmallVec capacity", "[containers]")
+{
+    gm::SmallVec<int, 2> vec;
+    REQUIRE(vec.empty());
+    vec.push_back(1);
+    vec.push_back(2);
+    REQUIRE(vec.size() == 2);
+    REQUIRE_THROWS_AS(vec.push_back(3), std::length_error);
+    vec.pop_back();
+    REQUIRE((vec == gm::SmallVec<int, 2>{1}));
+}
+
+TEST_CASE("Container text input", "[containers]")
+{
+    Board board;
+    std::istringstream is(kBoardText);
+    is >> board;
+    REQUIRE(is);
+    REQUIRE(board == makeBoard());
+    Board parsed;
+    const char *cur = kBoardText;
+    readText(cur, kBoardText + sizeof(kBoardText) - 1, parsed);
+    REQUIRE(parsed == makeBoard());
+}
+
+TEST_CASE("Container text input over capacity", "[containers]")
+{
+    const char text[] = "GRASS WATER ROCK GRASS 4 1 2 3 4 5 6 7 8 0 0 0 0 0";
+    Board board;
+    const char *cur = text;
+    REQUIRE_THROWS_AS(readText(cur, text + sizeof(text) - 1, board), std::runtime_error);
+    std::istringstream is(text);
+    is >> board;
+    REQUIRE(is.fail());
+}
+
+TEST_CASE("Container text output", "[containers]")
+{
+    std::ostringstream os;
+    os << makeBoard();
+    REQUIRE(os.str() == "{ tiles: GRASS WATER ROCK GRASS, path: 2 { x: 1, y: 2 } { x: 3, y: 4 }, "
+                        "heights: -1 2 3 -4, marks: 2 7 255 }");
+    REQUIRE(writeBuffered(makeBoard()) == os.str());
+}
+
+TEST_CASE("Container binary encoding", "[containers]")
+{
+    uint8_t buffer[kBoardBinSize];
+    uint8_t *out = buffer;
+    encode(out, makeBoard());
+    REQUIRE(out == buffer + kBoardBinSize);
+    BoardView view(buffer);
+    REQUIRE(view.tiles(2) == Ground::ROCK);
+    REQUIRE(view.pathCount() == 2);
+    REQUIRE(view.path(1).y() == 4);
+    REQUIRE(view.heights(1, 1) == -4);
+    REQUIRE(view.marksCount() == 2);
+    REQUIRE(view.marks(1) == 255);
+    REQUIRE(buffer[kBoardBinSize - 1] == 0);
+    Board decoded;
+    decoded.path = {Step(5, 6), Step(7, 8), Step(9, 10)};
+    const uint8_t *in = buffer;
+    decode(in, decoded);
+    REQUIRE(in == buffer + kBoardBinSize);
+    REQUIRE(decoded == makeBoard());
+    // The values beyond the size are reset
+    REQUIRE(decoded.path.begin()[2] == Step());
+}
+
+TEST_CASE("Container JSON", "[containers]")
+{
+    std::string json;
+    writeJson(json, makeBoard());
+    REQUIRE(json == "{\"tiles\":[\"GRASS\",\"WATER\",\"ROCK\",\"GRASS\"],"
+                    "\"path\":[{\"x\":1,\"y\":2},{\"x\":3,\"y\":4}],"
+                    "\"heights\":[[-1,2],[3,-4]],\"marks\":[7,255]}");
+    Board parsed;
+    const char *cur = json.data();
+    readJson(cur, json.data() + json.size(), parsed);
+    REQUIRE(parsed == makeBoard());
+    const std::string missing = "{\"tiles\":[\"GRASS\"]}";
+    cur = missing.data();
+    REQUIRE_THROWS_AS(readJson(cur, missing.data() + missing.size(), parsed), std::runtime_error);
+}
+
+TEST_CASE("Container undo and diff", "[containers]")
+{
+    Board board = makeBoard();
+    gm::UndoLog<Board::Change> log(16);
+    board.setMarks(log, {1, 2, 3});
+    Board::Patch patch = diff(makeBoard(), board);
+    REQUIRE(patch.changed == (uint64_t(1) << Board::marks_f));
+    board.rollback(log, 0);
+    REQUIRE(board == makeBoard());
+    apply(board, patch);
+    REQUIRE((board.marks == gm::SmallVec<uint8_t, 5>{1, 2, 3}));
+}
+
+TEST_CASE("Vec fields", "[containers]")
+{
+    History history;
+    history.moves = {Step(1, 1), Step(2, 2)};
+    history.names = {"a", "b", "c"};
+    history.turns = {gm::Vec<int>{1, 2}, gm::Vec<int>{}};
+    std::ostringstream os;
+    os << history;
+    REQUIRE(os.str() == "{ moves: 2 { x: 1, y: 1 } { x: 2, y: 2 }, names: 3 a b c, turns: 2 2 1 2 0 }");
+    const std::string text = "2 1 1 2 2 3 a b c 2 2 1 2 0";
+    History parsed;
+    const char *cur = text.data();
+    readText(cur, text.data() + text.size(), parsed);
+    REQUIRE(parsed == history);
+    REQUIRE(parsed.dirtyFields() == History::kAllFields);
+    std::string json;
+    writeJson(json, history);
+    History fromJson;
+    cur = json.data();
+    readJson(cur, json.data() + json.size(), fromJson);
+    REQUIRE(fromJson == history);
+}
+
+TEST_CASE("Container unions and random values", "[containers]")
+{
+    const Plan order = Plan::Build({Step(1, 2)});
+    std::ostringstream os;
+    os << order;
+    REQUIRE(os.str() == "Build 1 { x: 1, y: 2 }");
+    std::istringstream is("Build 1 1 2");
+    Plan parsed;
+    is >> parsed;
+    REQUIRE(parsed == order);
+    gm::Rng rng(3);
+    for (int i = 0; i < 100; i++)
+    {
+        Board board;
+        randomize(rng, board);
+        uint8_t buffer[kBoardBinSize];
+        uint8_t *out = buffer;
+        encode(out, board);
+        Board decoded;
+        const uint8_t *in = buffer;
+        decode(in, decoded);
+        if (!(decoded == board) || board.path.size() > 3)
+        {
+            FAIL("random board not decoded");
+        }
+    }
+}
+
+TEST_CASE("Inline string fields", "[containers]")
+{
+    static_assert(std::is_trivially_copyable<Hero>::value, "inline strings are trivially copyable");
+    static_assert(sizeof(Hero) == 16 && kHeroBinSize == 16, "inline string size");
+    const Hero hero(gm::Str<11>("Conan"), 42);
+    REQUIRE(hero.name.size() == 5);
+    REQUIRE(hero.name.str() == "Conan");
+    REQUIRE(hero == Hero(gm::Str<11>(std::string("Conan")), 42));
+    REQUIRE_FALSE(hero == Hero(gm::Str<11>("Conan2"), 42));
+    REQUIRE_THROWS_AS(gm::Str<3>("toolong"), std::length_error);
+    std::ostringstream os;
+    os << hero;
+    REQUIRE(os.str() == "{ name: Conan, hp: 42 }");
+    REQUIRE(writeBuffered(hero) == os.str());
+    const char text[] = "Conan 42";
+    Hero parsed;
+    const char *cur = text;
+    readText(cur, text + sizeof(text) - 1, parsed);
+    REQUIRE(parsed == hero);
+    std::istringstream is("Conan 42 Conan_the_Barbarian 1");
+    is >> parsed;
+    REQUIRE(parsed == hero);
+    is >> parsed;
+    REQUIRE(is.fail());
+    const char tooLong[] = "Conan_the_Barbarian 1";
+    cur = tooLong;
+    REQUIRE_THROWS_AS(readText(cur, tooLong + sizeof(tooLong) - 1, parsed), std::runtime_error);
+}
+
+TEST_CASE("Inline string encoding", "[containers]")
+{
+    const Hero hero(gm::Str<11>("Red Sonja"), 7);
+    uint8_t buffer[kHeroBinSize];
+    uint8_t *out = buffer;
+    encode(out, hero);
+    REQUIRE(buffer[0] == 9);
+    REQUIRE(std::memcmp(buffer + 1, "Red Sonja\0\0", 11) == 0);
+    REQUIRE(HeroView(buffer).name() == hero.name);
+    Hero decoded;
+    const uint8_t *in = buffer;
+    decode(in, decoded);
+    REQUIRE(decoded == hero);
+    // Bytes past the length are ignored, and the length must fit
+    buffer[11] = 'x';
+    in = buffer;
+    decode(in, decoded);
+    REQUIRE(decoded == hero);
+    buffer[0] = 200;
+    in = buffer;
+    REQUIRE_THROWS_AS(decode(in, decoded), std::runtime_error);
+    std::string json;
+    writeJson(json, hero);
+    REQUIRE(json == "{\"name\":\"Red Sonja\",\"hp\":7}");
+    Hero parsed;
+    const char *cur = json.data();
+    readJson(cur, json.data() + json.size(), parsed);
+    REQUIRE(parsed == hero);
+    const std::string escaped = "{\"name\":\"Red\\tSonja\",\"hp\":7}";
+    cur = escaped.data();
+    readJson(cur, escaped.data() + escaped.size(), parsed);
+    REQUIRE(parsed.name.str() == "Red\tSonja");
+}
+
+TEST_CASE("Inline strings in containers", "[containers]")
+{
+    gm::Rng rng(5);
+    for (int i = 0; i < 100; i++)
+    {
+        Squad squad;
+        randomize(rng, squad);
+        uint8_t buffer[kSquadBinSize];
+        uint8_t *out = buffer;
+        encode(out, squad);
+        Squad decoded;
+        const uint8_t *in = buffer;
+        decode(in, decoded);
+        if (!(decoded == squad) || squad.tags[0].size() < 1 || squad.tags[0].size() > 3)
+        {
+            FAIL("random squad not decoded");
+        }
+    }
+}
+
+TEST_CASE("Vec text input with a huge count", "[containers]")
+{
+    const std::string text = "1000000000000 1 1 2 2";
+    History history;
+    const char *cur = text.data();
+    REQUIRE_THROWS(readText(cur, text.data() + text.size(), history));
+    REQUIRE(history.moves.size() == 2);
+    std::istringstream is(text);
+    is >> history;
+    REQUIRE(is.fail());
+}
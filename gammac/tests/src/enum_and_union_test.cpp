@@ -14,10 +14,17 @@
  * limitations under the License.
  */
 
+#include <cstring>
 #include <iostream>
 #include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include <unistd.h>
 
 #include "catch.hpp"
+#include "gamma/io.hpp"
 #include "src/enum_and_union.gm.hpp"
 
 TEST_CASE("Enum from istream", "[enum]")
@@ -28,6 +35,166 @@ TEST_CASE("Enum from istream", "[enum]")
     REQUIRE(dir == Direction::E);
 }
 
+TEST_CASE("Enum batch read", "[enum]")
+{
+    std::string input = "N W\nS";
+    const char *cur = input.data();
+    Direction dirs[3];
+    readMany(cur, input.data() + input.size(), 3, dirs);
+    REQUIRE(dirs[0] == Direction::N);
+    REQUIRE(dirs[1] == Direction::W);
+    REQUIRE(dirs[2] == Direction::S);
+    REQUIRE(cur == input.data() + input.size());
+}
+
+TEST_CASE("Enum batch read invalid", "[enum]")
+{
+    std::string input = "N X";
+    const char *cur = input.data();
+    Direction dirs[2];
+    REQUIRE_THROWS_AS(readMany(cur, input.data() + input.size(), 2, dirs), std::runtime_error);
+    std::vector<Direction> vec{Direction::W};
+    REQUIRE_THROWS_AS(readMany(cur, input.data() + input.size(), 2, vec), std::runtime_error);
+    REQUIRE(vec == std::vector<Direction>{Direction::W});
+    REQUIRE(cur == input.data());
+}
+
+TEST_CASE("Union from istream", "[union]")
+{
+    std::stringstream input("SHOOT E 42 WAIT MOVE S");
+    Action a1, a2, a3;
+    input >> a1 >> a2 >> a3;
+    REQUIRE(a1 == Action::Shoot(Direction::E, 42));
+    REQUIRE(a2 == Action::Wait());
+    REQUIRE(a3 == Action::Move(Direction::S));
+}
+
+TEST_CASE("Union from istream invalid", "[union]")
+{
+    std::stringstream input("JUMP");
+    Action action;
+    REQUIRE_THROWS_AS(input >> action, std::runtime_error);
+}
+
+TEST_CASE("Union batch read", "[union]")
+{
+    std::string input = "3\nMOVE N\nSHOOT W 7\nWAIT\n";
+    const char *cur = input.data();
+    const char *end = input.data() + input.size();
+    int count;
+    gm::readText(cur, end, count);
+    std::vector<Action> actions;
+    readMany(cur, end, count, actions);
+    REQUIRE(actions.size() == 3);
+    REQUIRE(actions[0] == Action::Move(Direction::N));
+    REQUIRE(actions[1] == Action::Shoot(Direction::W, 7));
+    REQUIRE(actions[2] == Action::Wait());
+}
+
+TEST_CASE("Union batch read truncated", "[union]")
+{
+    std::string input = "MOVE N SHOOT W";
+    const char *cur = input.data();
+    Action actions[2];
+    REQUIRE_THROWS_AS(readMany(cur, input.data() + input.size(), 2, actions), std::runtime_error);
+}
+
+// Returns the read end of a pipe holding the given text
+static int pipeFrom(const std::string &text)
+{
+    int fds[2];
+    REQUIRE(pipe(fds) == 0);
+    REQUIRE(write(fds[1], text.data(), text.size()) == static_cast<ssize_t>(text.size()));
+    close(fds[1]);
+    return fds[0];
+}
+
+TEST_CASE("Union from input buffer", "[union]")
+{
+    int fd = pipeFrom("3\nMOVE N\nSHOOT W 1234\nWAIT\n");
+    gm::InputBuffer input(fd, 4);
+    int count;
+    input >> count;
+    std::vector<Action> actions(count);
+    for (auto &action : actions)
+    {
+        input >> action;
+    }
+    REQUIRE_FALSE(input.more());
+    close(fd);
+    REQUIRE(actions[0] == Action::Move(Direction::N));
+    REQUIRE(actions[1] == Action::Shoot(Direction::W, 1234));
+    REQUIRE(actions[2] == Action::Wait());
+}
+
+TEST_CASE("Union from truncated input buffer", "[union]")
+{
+    int fd = pipeFrom("SHOOT W");
+    gm::InputBuffer input(fd);
+    Action action;
+    REQUIRE_THROWS_AS(input >> action, gm::text::EndOfInput);
+    close(fd);
+}
+
+TEST_CASE("Union to output buffer", "[union]")
+{
+    int fds[2];
+    REQUIRE(pipe(fds) == 0);
+    {
+        gm::OutputBuffer output(fds[1]);
+        output << Action::Move(Direction::N) << ", " << Action::Shoot(Direction::E, -42) << ", " << Action::Wait();
+        REQUIRE(output.str() == "MOVE N, SHOOT E -42, WAIT");
+        output.flush();
+        REQUIRE(output.str().empty());
+    }
+    close(fds[1]);
+    char buffer[64];
+    ssize_t length = read(fds[0], buffer, sizeof(buffer));
+    close(fds[0]);
+    REQUIRE(std::string(buffer, length) == "MOVE N, SHOOT E -42, WAIT");
+}
+
+TEST_CASE("Union random values", "[union]")
+{
+    gm::Rng rng(42);
+    int counts[4] = {};
+    int invalid = 0;
+    for (int i = 0; i < 3000; i++)
+    {
+        Action action;
+        randomize(rng, action);
+        counts[action.type]++;
+        invalid += action.type == Action::Move_t && static_cast<size_t>(action.data.Move.dir) >= 4;
+    }
+    REQUIRE(invalid == 0);
+    REQUIRE(counts[Action::Undef] == 0);
+    REQUIRE(counts[Action::Move_t] > 800);
+    REQUIRE(counts[Action::Shoot_t] > 800);
+    REQUIRE(counts[Action::Wait_t] > 800);
+}
+
+TEST_CASE("Union random values are reproducible and read back", "[union]")
+{
+    gm::Rng rng1(7), rng2(7);
+    std::vector<Action> actions(100);
+    size_t same = 0;
+    std::stringstream text;
+    for (auto &action : actions)
+    {
+        randomize(rng1, action);
+        Action other;
+        randomize(rng2, other);
+        same += action == other;
+        text << action << "\n";
+    }
+    REQUIRE(same == actions.size());
+    std::string input = text.str();
+    const char *cur = input.data();
+    std::vector<Action> parsed;
+    readMany(cur, input.data() + input.size(), actions.size(), parsed);
+    REQUIRE(parsed == actions);
+}
+
 TEST_CASE("Union to ostream", "[union]")
 {
     Action a1 = Action::Move(Direction::N);
@@ -81,3 +248,61 @@ TEST_CASE("Union equality multiple arguments", "[union]")
     REQUIRE_FALSE(Action::Shoot(Direction::N, 42) == Action::Shoot(Direction::E, 42));
     REQUIRE_FALSE(Action::Shoot(Direction::N, 42) == Action::Shoot(Direction::E, 12));
 }
+
+struct ActionCost
+{
+    int operator()(const Action::Move_d &) const { return 1; }
+    int operator()(const Action::Shoot_d &shoot) const { return shoot.strength; }
+    int operator()(const Action::Wait_d &) const { return 0; }
+};
+
+TEST_CASE("Union visit", "[union]")
+{
+    REQUIRE(visit(Action::Move(Direction::N), ActionCost()) == 1);
+    REQUIRE(visit(Action::Shoot(Direction::N, 42), ActionCost()) == 42);
+    REQUIRE(visit(Action::Wait(), ActionCost()) == 0);
+}
+
+struct ActionTurn
+{
+    void operator()(Action::Move_d &move) const { move.dir = Direction::W; }
+    void operator()(Action::Shoot_d &shoot) const { shoot.dir = Direction::W; }
+    void operator()(Action::Wait_d &) const {}
+};
+
+TEST_CASE("Union visit by reference", "[union]")
+{
+    Action a = Action::Shoot(Direction::N, 42);
+    visit(a, ActionTurn());
+    REQUIRE(a == Action::Shoot(Direction::W, 42));
+}
+
+TEST_CASE("Union visit undefined", "[union]")
+{
+    REQUIRE_THROWS_AS(visit(Action(), ActionCost()), std::invalid_argument);
+}
+
+TEST_CASE("Union bulk copy", "[union]")
+{
+    REQUIRE(std::is_trivially_copyable<Action>::value);
+    Action actions[3] = {Action::Move(Direction::N), Action::Shoot(Direction::E, 42), Action::Wait()};
+    Action copies[3];
+    std::memcpy(copies, actions, sizeof(actions));
+    REQUIRE(copies[0] == Action::Move(Direction::N));
+    REQUIRE(copies[1] == Action::Shoot(Direction::E, 42));
+    REQUIRE(copies[2] == Action::Wait());
+}
+
+static constexpr Action kMoves[] = {
+    Action::Move(Direction::N), Action::Move(Direction::E), Action::Move(Direction::S), Action::Move(Direction::W)};
+
+TEST_CASE("Union constexpr factories", "[union]")
+{
+    static_assert(kMoves[1].type == Action::Move_t, "constexpr union tag");
+    static_assert(kMoves[1].data.Move.dir == Direction::E, "constexpr union payload");
+    constexpr Action shoot = Action::Shoot(Direction::W, 42);
+    static_assert(shoot.data.Shoot.strength == 42, "constexpr union payload");
+    constexpr Action undef;
+    static_assert(undef.type == Action::Undef, "constexpr default union");
+    REQUIRE(kMoves[3] == Action::Move(Direction::W));
+}
@@ -16,6 +16,9 @@
 
 #include <iostream>
 #include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
 
 #include "catch.hpp"
 #include "src/enum.gm.hpp"
@@ -35,3 +38,55 @@ TEST_CASE("Enum to ostream with format", "[enum]")
     REQUIRE(output.str() == "1");  
 }
 
+
+TEST_CASE("Enum with integer formats from istream", "[enum]")
+{
+    std::stringstream input("1 0 -1");
+    Owner o1, o2, o3;
+    input >> o1 >> o2 >> o3;
+    REQUIRE(o1 == Owner::SELF);
+    REQUIRE(o2 == Owner::NONE);
+    REQUIRE(o3 == Owner::OTHER);
+}
+
+TEST_CASE("Enum with integer formats out of range", "[enum]")
+{
+    std::stringstream input("2");
+    Owner owner;
+    REQUIRE_THROWS_AS(input >> owner, std::out_of_range);
+}
+
+TEST_CASE("Enum with sparse integer formats", "[enum]")
+{
+    std::string input = "50 -20 10";
+    const char *cur = input.data();
+    Reward rewards[3];
+    readMany(cur, input.data() + input.size(), 3, rewards);
+    REQUIRE(rewards[0] == Reward::BIG);
+    REQUIRE(rewards[1] == Reward::PENALTY);
+    REQUIRE(rewards[2] == Reward::SMALL);
+    std::stringstream output;
+    output << rewards[0] << " " << rewards[1] << " " << Owner::OTHER;
+    REQUIRE(output.str() == "50 -20 -1");
+    std::string invalid = "20";
+    cur = invalid.data();
+    REQUIRE_THROWS_AS(readText(cur, invalid.data() + invalid.size(), rewards[0]), std::runtime_error);
+}
+
+TEST_CASE("Enum constant columns", "[enum]")
+{
+    static_assert(dx(Heading::EAST) == 1 && dy(Heading::NORTH) == -1, "constant columns");
+    static_assert(opposite(Heading::WEST) == Heading::EAST, "enum column");
+    static_assert(std::is_same<decltype(dx(Heading::EAST)), int8_t>::value, "column type");
+    for (auto heading : {Heading::NORTH, Heading::EAST, Heading::SOUTH, Heading::WEST})
+    {
+        REQUIRE(opposite(opposite(heading)) == heading);
+        REQUIRE(dx(opposite(heading)) == -dx(heading));
+        REQUIRE(dy(opposite(heading)) == -dy(heading));
+        REQUIRE(vertical(heading) == (dx(heading) == 0));
+    }
+    std::stringstream input("W");
+    Heading heading;
+    input >> heading;
+    REQUIRE(kHeadingDx[static_cast<size_t>(heading)] == -1);
+}
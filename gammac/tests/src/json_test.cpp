@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2017 Cyril Deguet <cyril.deguet@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include "catch.hpp"
+#include "src/json.gm.hpp"
+
+template <typename T>
+static T parse(const std::string &json)
+{
+    using gm::readJson;
+    T obj;
+    const char *cur = json.data();
+    readJson(cur, json.data() + json.size(), obj);
+    return obj;
+}
+
+TEST_CASE("Enum to JSON", "[json]")
+{
+    std::string out;
+    writeJson(out, Team::NONE);
+    REQUIRE(out == "\"-\"");
+}
+
+TEST_CASE("Enum from JSON", "[json]")
+{
+    REQUIRE(parse<Team>("\"blue\"") == Team::BLUE);
+    REQUIRE(parse<Team>(" \"-\"") == Team::NONE);
+    REQUIRE_THROWS_AS(parse<Team>("\"green\""), std::runtime_error);
+}
+
+TEST_CASE("Struct to JSON", "[json]")
+{
+    Soldier soldier("Bob \"the\" brave", Team::RED, true, -12, 0.25, Command::Goto(Point(1, 2), 1.5));
+    std::string out;
+    writeJson(out, soldier);
+    REQUIRE(out == "{\"name\":\"Bob \\\"the\\\" brave\",\"team\":\"red\",\"alive\":true,\"hp\":-12,"
+                   "\"ratio\":0.25,\"command\":{\"Goto\":{\"target\":{\"x\":1,\"y\":2},\"speed\":1.5}}}");
+}
+
+TEST_CASE("Struct from JSON", "[json]")
+{
+    auto soldier = parse<Soldier>("{ \"hp\": 7, \"extra\": [1, {\"a\": null}], \"name\": \"Al\\n\","
+                                  "  \"command\": {\"Say\": {\"team\": \"blue\"}}, \"alive\": false,"
+                                  "  \"ratio\": -1.5e2, \"team\": \"-\" }");
+    REQUIRE(soldier.name == "Al\n");
+    REQUIRE(soldier.team == Team::NONE);
+    REQUIRE_FALSE(soldier.alive);
+    REQUIRE(soldier.hp == 7);
+    REQUIRE(soldier.ratio == -150.0);
+    REQUIRE(soldier.command == Command::Say(Team::BLUE));
+}
+
+TEST_CASE("Union JSON round trip", "[json]")
+{
+    Command commands[] = {Command::Goto(Point(-3, 4), 0.1), Command::Say(Team::RED), Command::Stop(), Command()};
+    for (const Command &command : commands)
+    {
+        std::string out;
+        writeJson(out, command);
+        REQUIRE(parse<Command>(out) == command);
+    }
+}
+
+TEST_CASE("Invalid JSON", "[json]")
+{
+    REQUIRE_THROWS_AS(parse<Point>("{\"x\": }"), std::runtime_error);
+    REQUIRE_THROWS_AS(parse<Command>("{\"Jump\": {}}"), std::runtime_error);
+}
+
+TEST_CASE("Truncated JSON strings", "[json]")
+{
+    REQUIRE_THROWS_AS(parse<Point>("{\"x\": 1, \"note\": \"a\\"), std::runtime_error);
+    REQUIRE_THROWS_AS(parse<std::string>("\"\\u12G4\""), std::runtime_error);
+    REQUIRE(parse<std::string>("\"\\u00e9\"") == "\xc3\xa9");
+}
+
+TEST_CASE("Non-finite numbers to JSON", "[json]")
+{
+    std::string out;
+    gm::writeJson(out, std::numeric_limits<double>::infinity());
+    REQUIRE(out == "null");
+    REQUIRE(std::isnan(parse<double>(out)));
+}
+
+TEST_CASE("JSON string escapes", "[json]")
+{
+    REQUIRE(parse<std::string>("\"\\\"\\\\\\/\"") == "\"\\/");
+    REQUIRE_THROWS_AS(parse<std::string>("\"\\q\""), std::runtime_error);
+    REQUIRE(parse<std::string>("\"\\uD83D\\uDE00\"") == "\xf0\x9f\x98\x80");
+    REQUIRE_THROWS_AS(parse<std::string>("\"\\uD83D\""), std::runtime_error);
+    REQUIRE_THROWS_AS(parse<std::string>("\"\\uD83Dx\""), std::runtime_error);
+    REQUIRE_THROWS_AS(parse<std::string>("\"\\uDE00\""), std::runtime_error);
+    REQUIRE_THROWS_AS(parse<std::string>("\"\\uD83D\\u0041\""), std::runtime_error);
+}
+
+TEST_CASE("JSON number followed by a NUL", "[json]")
+{
+    const std::string json("1\0" "5", 3);
+    double value;
+    const char *cur = json.data();
+    gm::readJson(cur, json.data() + json.size(), value);
+    REQUIRE(value == 1.0);
+    REQUIRE(cur == json.data() + 1);
+}
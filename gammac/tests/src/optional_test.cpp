@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2017 Cyril Deguet <cyril.deguet@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "buffer_helpers.hpp"
+#include "catch.hpp"
+#include "src/optional.gm.hpp"
+
+static Pet makePet()
+{
+    Pet pet;
+    pet.mood = Mood::ANGRY;
+    pet.weight = uint8_t(12);
+    pet.tag = gm::Str<3>("rex");
+    return pet;
+}
+
+TEST_CASE("Optional niches", "[optional]")
+{
+    static_assert(sizeof(gm::Optional<Mood, gm::ValueNiche<Mood, static_cast<Mood>(2), Mood::CALM, Mood::ANGRY>>) ==
+                      sizeof(Mood),
+                  "enum niche");
+    static_assert(sizeof(decltype(Pet::age)) == sizeof(int), "range niche");
+    static_assert(sizeof(decltype(Pet::weight)) == 2, "flag byte");
+    static_assert(sizeof(decltype(Leash::next)) == sizeof(Trick), "Undef niche");
+    static_assert(sizeof(decltype(Leash::knots)) == 3, "range niche of i8");
+    static_assert(std::is_trivially_copyable<Pet>::value, "optionals are trivially copyable");
+    static_assert(kPetBinSize == 4 + 4 + 2 + 5, "pet encoding size");
+    Pet pet;
+    REQUIRE_FALSE(pet.mood.has_value());
+    REQUIRE_FALSE(pet.age);
+    REQUIRE(pet.age.value_or(3) == 3);
+    pet.age = 0;
+    REQUIRE(pet.age.has_value());
+    REQUIRE(*pet.age == 0);
+    pet.age.reset();
+    REQUIRE(pet == Pet());
+    Leash leash;
+    REQUIRE_FALSE(leash.next.has_value());
+    leash.next = Trick::Walk(3);
+    REQUIRE(leash.next->type == Trick::Walk_t);
+}
+
+TEST_CASE("Optional text", "[optional]")
+{
+    std::ostringstream os;
+    os << makePet();
+    REQUIRE(os.str() == "{ mood: ANGRY, age: -, weight: 12, tag: rex }");
+    REQUIRE(writeBuffered(makePet()) == os.str());
+    const char text[] = "ANGRY - 12 rex";
+    Pet parsed;
+    const char *cur = text;
+    readText(cur, text + sizeof(text) - 1, parsed);
+    REQUIRE(parsed == makePet());
+    std::istringstream is("- 7 - -");
+    is >> parsed;
+    REQUIRE(is);
+    Pet young;
+    young.age = 7;
+    REQUIRE(parsed == young);
+}
+
+TEST_CASE("Optional binary encoding", "[optional]")
+{
+    uint8_t buffer[kPetBinSize];
+    uint8_t *out = buffer;
+    encode(out, makePet());
+    REQUIRE(out == buffer + kPetBinSize);
+    PetView view(buffer);
+    REQUIRE(view.hasMood());
+    REQUIRE(view.mood() == Mood::ANGRY);
+    REQUIRE_FALSE(view.hasAge());
+    REQUIRE(view.hasWeight());
+    REQUIRE(view.weight() == 12);
+    REQUIRE(view.hasTag());
+    REQUIRE(view.tag() == gm::Str<3>("rex"));
+    Pet decoded;
+    decoded.age = 5;
+    const uint8_t *in = buffer;
+    decode(in, decoded);
+    REQUIRE(in == buffer + kPetBinSize);
+    REQUIRE(decoded == makePet());
+    REQUIRE(decoded.age.raw() == 31);
+    REQUIRE(decoded.weight.raw() == 12);
+    out = buffer;
+    encode(out, Pet());
+    in = buffer;
+    decode(in, decoded);
+    REQUIRE(decoded == Pet());
+}
+
+TEST_CASE("Optional invalid values", "[optional]")
+{
+    REQUIRE_THROWS_AS(decltype(Pet::age)(31), std::out_of_range);
+    REQUIRE_THROWS_AS(decltype(Pet::age)(-1), std::out_of_range);
+    REQUIRE_THROWS_AS(decltype(Leash::next)(Trick()), std::out_of_range);
+    Pet pet;
+    const char text[] = "- 31 - -";
+    const char *cur = text;
+    REQUIRE_THROWS_AS(readText(cur, text + sizeof(text) - 1, pet), std::runtime_error);
+    std::istringstream is(text);
+    is >> pet;
+    REQUIRE(is.fail());
+    REQUIRE(pet == Pet());
+    std::string json = "{\"age\":31}";
+    cur = json.data();
+    REQUIRE_THROWS_AS(readJson(cur, json.data() + json.size(), pet), std::runtime_error);
+    uint8_t buffer[kPetBinSize];
+    uint8_t *out = buffer;
+    encode(out, Pet());
+    buffer[4] = 40;
+    const uint8_t *in = buffer;
+    REQUIRE_THROWS_AS(decode(in, pet), std::runtime_error);
+}
+
+TEST_CASE("Optional JSON", "[optional]")
+{
+    std::string json;
+    writeJson(json, makePet());
+    REQUIRE(json == "{\"mood\":\"ANGRY\",\"age\":null,\"weight\":12,\"tag\":\"rex\"}");
+    Pet parsed;
+    parsed.age = 1;
+    const char *cur = json.data();
+    readJson(cur, json.data() + json.size(), parsed);
+    REQUIRE(parsed == makePet());
+}
+
+TEST_CASE("Optional undo and diff", "[optional]")
+{
+    Pet pet = makePet();
+    gm::UndoLog<Pet::Change> log(16);
+    pet.setAge(log, 4);
+    pet.setTag(log, gm::Optional<gm::Str<3>>());
+    Pet::Patch patch = diff(makePet(), pet);
+    REQUIRE(patch.changed == ((uint64_t(1) << Pet::age_f) | (uint64_t(1) << Pet::tag_f)));
+    pet.rollback(log, 0);
+    REQUIRE(pet == makePet());
+    apply(pet, patch);
+    REQUIRE(*pet.age == 4);
+    REQUIRE_FALSE(pet.tag.has_value());
+}
+
+TEST_CASE("Optional random values", "[optional]")
+{
+    gm::Rng rng(11);
+    int empty = 0;
+    for (int i = 0; i < 200; i++)
+    {
+        Leash leash;
+        randomize(rng, leash);
+        uint8_t buffer[kLeashBinSize];
+        uint8_t *out = buffer;
+        encode(out, leash);
+        Leash decoded;
+        const uint8_t *in = buffer;
+        decode(in, decoded);
+        if (!(decoded == leash))
+        {
+            FAIL("random leash not decoded");
+        }
+        empty += !leash.next.has_value();
+    }
+    REQUIRE(empty > 0);
+    REQUIRE(empty < 200);
+}
+
+TEST_CASE("Optional ranged random values", "[optional]")
+{
+    gm::Rng rng(13);
+    for (int i = 0; i < 100; i++)
+    {
+        Pet pet;
+        randomize(rng, pet);
+        if (pet.age && (*pet.age < 0 || *pet.age > 30))
+        {
+            FAIL("random age out of range");
+        }
+    }
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2017 Cyril Deguet <cyril.deguet@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+#include "gamma/profile.hpp"
+#include "src/profile.gm.hpp"
+
+// profile.gm is generated from the counts in profile.txt, and compiled with
+// GAMMA_PROFILE defined
+
+TEST_CASE("Reading with a profile-guided dispatch", "[profile]")
+{
+    std::string input = "TICK SPAWN 3 QUIT TICK";
+    const char *cur = input.data();
+    std::vector<Event> events;
+    readMany(cur, input.data() + input.size(), 4, events);
+    REQUIRE(events[0] == Event::Tick());
+    REQUIRE(events[1] == Event::Spawn(3));
+    REQUIRE(events[2] == Event::Quit());
+    REQUIRE(events[3] == Event::Tick());
+    std::stringstream stream("ROCK WATER GRASS");
+    Terrain t1, t2, t3;
+    stream >> t1 >> t2 >> t3;
+    REQUIRE(t1 == Terrain::ROCK);
+    REQUIRE(t2 == Terrain::WATER);
+    REQUIRE(t3 == Terrain::GRASS);
+}
+
+TEST_CASE("Instrumented readers count variants", "[profile]")
+{
+    std::stringstream before;
+    gm::Profile::instance().write(before);
+    std::stringstream input("QUIT QUIT SPAWN 1");
+    Event event;
+    input >> event >> event >> event;
+    std::stringstream after;
+    gm::Profile::instance().write(after);
+    std::string type, variant;
+    uint64_t countBefore, countAfter;
+    std::vector<uint64_t> delta;
+    while (before >> type >> variant >> countBefore && after >> type >> variant >> countAfter)
+    {
+        if (type == "Event")
+        {
+            delta.push_back(countAfter - countBefore);
+        }
+    }
+    REQUIRE(delta == std::vector<uint64_t>({1, 0, 2}));
+}
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2017 Cyril Deguet <cyril.deguet@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "buffer_helpers.hpp"
+#include "catch.hpp"
+#include "src/sized.gm.hpp"
+
+static const char kSizedText[] = "-128 255 -32768 65535 -2147483648 4294967295 "
+                                 "-9223372036854775808 18446744073709551615 1.5 2.25";
+
+static const Sized kSizedLimits(INT8_MIN, UINT8_MAX, INT16_MIN, UINT16_MAX, INT32_MIN, UINT32_MAX, INT64_MIN,
+                                UINT64_MAX, 1.5f, 2.25);
+
+TEST_CASE("Sized field types", "[sized]")
+{
+    static_assert(std::is_same<decltype(Sized::small), int8_t>::value, "i8 field");
+    static_assert(std::is_same<decltype(Sized::port), uint16_t>::value, "u16 field");
+    static_assert(std::is_same<decltype(Sized::huge), uint64_t>::value, "u64 field");
+    static_assert(std::is_same<decltype(Sized::ratio), float>::value, "f32 field");
+    static_assert(std::is_same<decltype(Sized::precise), double>::value, "f64 field");
+    static_assert(kSizedBinSize == 42, "sized encoding size");
+}
+
+TEST_CASE("Sized text input", "[sized]")
+{
+    Sized sized;
+    std::istringstream is(kSizedText);
+    is >> sized;
+    REQUIRE(is);
+    REQUIRE(sized == kSizedLimits);
+    Sized parsed;
+    const char *cur = kSizedText;
+    readText(cur, kSizedText + sizeof(kSizedText) - 1, parsed);
+    REQUIRE(parsed == kSizedLimits);
+}
+
+TEST_CASE("Sized text input out of range", "[sized]")
+{
+    int8_t small;
+    const char text[] = "128";
+    const char *cur = text;
+    REQUIRE_THROWS_AS(gm::readText(cur, text + 3, small), std::runtime_error);
+    uint8_t byte;
+    std::istringstream is("256");
+    gm::readNumber(is, byte);
+    REQUIRE(is.fail());
+}
+
+TEST_CASE("Sized text output", "[sized]")
+{
+    std::ostringstream os;
+    os << kSizedLimits;
+    REQUIRE(os.str() == "{ small: -128, byte: 255, medium: -32768, port: 65535, count: -2147483648, "
+                        "mask: 4294967295, big: -9223372036854775808, huge: 18446744073709551615, "
+                        "ratio: 1.5, precise: 2.25 }");
+    REQUIRE(writeBuffered(kSizedLimits) == os.str());
+}
+
+TEST_CASE("Sized binary and JSON round trip", "[sized]")
+{
+    uint8_t buffer[kSizedBinSize];
+    uint8_t *out = buffer;
+    encode(out, kSizedLimits);
+    REQUIRE(out == buffer + kSizedBinSize);
+    Sized decoded;
+    const uint8_t *in = buffer;
+    decode(in, decoded);
+    REQUIRE(decoded == kSizedLimits);
+    std::string json;
+    writeJson(json, kSizedLimits);
+    REQUIRE(json.find("\"big\":-9223372036854775808") != std::string::npos);
+    Sized parsed;
+    const char *cur = json.data();
+    readJson(cur, json.data() + json.size(), parsed);
+    REQUIRE(parsed == kSizedLimits);
+}
+
+TEST_CASE("Sized union text", "[sized]")
+{
+    std::ostringstream os;
+    os << Packet::Ping(200) << " " << Packet::Send(8080, -1);
+    REQUIRE(os.str() == "Ping 200 Send 8080 -1");
+    std::istringstream is(os.str());
+    Packet ping, data;
+    is >> ping >> data;
+    REQUIRE(ping == Packet::Ping(200));
+    REQUIRE(data == Packet::Send(8080, -1));
+}
+
+TEST_CASE("Sized ranges checked on input", "[sized]")
+{
+    Gauge gauge;
+    std::istringstream is("200 -5");
+    is >> gauge;
+    REQUIRE(is);
+    REQUIRE(gauge == Gauge(200, -5));
+    std::istringstream low("0 0");
+    low >> gauge;
+    REQUIRE(low.fail());
+    const char text[] = "1 6";
+    const char *cur = text;
+    REQUIRE_THROWS_AS(readText(cur, text + 3, gauge), std::runtime_error);
+    std::string json = "{\"level\":201,\"offset\":0}";
+    cur = json.data();
+    REQUIRE_THROWS_AS(readJson(cur, json.data() + json.size(), gauge), std::runtime_error);
+    uint8_t buffer[kGaugeBinSize];
+    uint8_t *out = buffer;
+    encode(out, Gauge(1, 0));
+    buffer[0] = 0;
+    const uint8_t *in = buffer;
+    REQUIRE_THROWS_AS(decode(in, gauge), std::runtime_error);
+    Packet packet;
+    std::istringstream wait("Wait 61");
+    REQUIRE_THROWS_AS(wait >> packet, std::runtime_error);
+    const char waitText[] = "Wait 0";
+    cur = waitText;
+    REQUIRE_THROWS_AS(readText(cur, waitText + 6, packet), std::runtime_error);
+}
+
+TEST_CASE("Sized fields packed", "[sized]")
+{
+    static_assert(sizeof(CounterPacked) == 2 * sizeof(uint64_t), "packed counter size");
+    const Counter counter(255, -100, 65535, INT64_MIN);
+    CounterPacked packed = pack(counter);
+    REQUIRE(packed.level() == 255);
+    REQUIRE(packed.delta() == -100);
+    REQUIRE(packed.stamp() == INT64_MIN);
+    Counter unpacked;
+    unpack(packed, unpacked);
+    REQUIRE(unpacked == counter);
+    REQUIRE(unpacked.hash == counter.hash);
+    gm::Rng rng(7);
+    for (int i = 0; i < 100; i++)
+    {
+        Counter random;
+        randomize(rng, random);
+        unpack(pack(random), unpacked);
+        if (!(unpacked == random) || random.delta < -100 || random.delta > 100)
+        {
+            FAIL("random counter not packed");
+        }
+    }
+}
@@ -14,7 +14,13 @@
  * limitations under the License.
  */
 
+#include <cstring>
 #include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
 #include "catch.hpp"
 #include "src/struct.gm.hpp"
 
@@ -50,6 +56,61 @@ TEST_CASE("Struct to ostream", "[struct]")
     REQUIRE(out.str() == "{ life: 10, bombs: 5 }");
 }
 
+TEST_CASE("Struct from istream", "[struct]")
+{
+    std::stringstream input("10 5");
+    Player player;
+    input >> player;
+    REQUIRE(player == Player(10, 5));
+}
+
+TEST_CASE("Struct batch read", "[struct]")
+{
+    std::string input = "2\n10 5\n3 0\n";
+    const char *cur = input.data();
+    const char *end = input.data() + input.size();
+    int count;
+    gm::readText(cur, end, count);
+    std::vector<Player> players(1);
+    readMany(cur, end, count, players);
+    REQUIRE(players.size() == 3);
+    REQUIRE(players[1] == Player(10, 5));
+    REQUIRE(players[2] == Player(3, 0));
+}
+
+TEST_CASE("Struct batch read invalid", "[struct]")
+{
+    std::string input = "10 x";
+    const char *cur = input.data();
+    Player player;
+    REQUIRE_THROWS_AS(readMany(cur, input.data() + input.size(), 1, &player), std::runtime_error);
+}
+
+TEST_CASE("Struct read out of range", "[struct]")
+{
+    std::stringstream input("128 1");
+    Player player;
+    input >> player;
+    REQUIRE(input.fail());
+    std::string text = "10 16";
+    const char *cur = text.data();
+    REQUIRE_THROWS_AS(readMany(cur, text.data() + text.size(), 1, &player), std::runtime_error);
+}
+
+TEST_CASE("Struct random values", "[struct]")
+{
+    gm::Rng rng(1);
+    Player p1, p2;
+    randomize(rng, p1);
+    randomize(rng, p2);
+    REQUIRE_FALSE(p1 == p2);
+    std::stringstream text;
+    text << p1.life << " " << p1.bombs;
+    Player parsed;
+    text >> parsed;
+    REQUIRE(parsed == p1);
+}
+
 TEST_CASE("Struct equality", "[struct]")
 {
     REQUIRE(Player(10, 5) == Player(10, 5));
@@ -62,3 +123,298 @@ TEST_CASE("Empty struct", "[struct]")
 {
     Unit unit;
 }
+
+TEST_CASE("Struct trivially copyable", "[struct]")
+{
+    REQUIRE(std::is_trivially_copyable<Player>::value);
+    REQUIRE(std::is_trivially_copy_constructible<Player>::value);
+    REQUIRE(std::is_trivially_move_assignable<Player>::value);
+}
+
+TEST_CASE("Struct bulk copy", "[struct]")
+{
+    Player players[3] = {Player(10, 5), Player(8, 2), Player(1, 0)};
+    Player copies[3];
+    std::memcpy(copies, players, sizeof(players));
+    REQUIRE(copies[0] == Player(10, 5));
+    REQUIRE(copies[1] == Player(8, 2));
+    REQUIRE(copies[2] == Player(1, 0));
+}
+
+TEST_CASE("Struct move", "[struct]")
+{
+    Player player(10, 5);
+    Player moved = std::move(player);
+    REQUIRE(moved == Player(10, 5));
+    REQUIRE(player == Player(10, 5));
+}
+
+TEST_CASE("Struct constructor moves its arguments", "[struct]")
+{
+    std::string name(100, 'x');
+    const char *buffer = name.data();
+    Named named(std::move(name), 3);
+    REQUIRE(named.name.data() == buffer);
+    REQUIRE(named.score == 3);
+}
+
+TEST_CASE("Struct noexcept constructors", "[struct]")
+{
+    REQUIRE(noexcept(Player(10, 5)));
+    REQUIRE(noexcept(Named(std::string(), 0)));
+    REQUIRE(std::is_nothrow_move_constructible<Named>::value);
+}
+
+TEST_CASE("Struct with string to ostream", "[struct]")
+{
+    std::stringstream out;
+    out << Named("bob", 3);
+    REQUIRE(out.str() == "{ name: bob, score: 3 }");
+}
+
+static constexpr Player kPlayers[] = {Player(10, 5), Player(8, 2)};
+
+TEST_CASE("Struct constexpr constructor", "[struct]")
+{
+    static_assert(kPlayers[1].life == 8, "constexpr struct field");
+    static_assert(kPlayers[1].bombs == 2, "constexpr struct field");
+    REQUIRE(kPlayers[0] == Player(10, 5));
+}
+
+TEST_CASE("Struct setters with undo log", "[struct]")
+{
+    GameState state(1, 0.5, Coord(2, 3), true);
+    const GameState initial = state;
+    gm::UndoLog<GameState::Change> log(16);
+    size_t start = log.mark();
+    state.setTurn(log, 2);
+    state.setPos(log, Coord(4, 5));
+    size_t middle = log.mark();
+    state.setTurn(log, 3);
+    state.setScore(log, -1.5);
+    state.setAlive(log, false);
+    REQUIRE(state == GameState(3, -1.5, Coord(4, 5), false));
+    state.rollback(log, middle);
+    REQUIRE(state == GameState(2, 0.5, Coord(4, 5), true));
+    state.rollback(log, start);
+    REQUIRE(state == initial);
+    REQUIRE(log.mark() == start);
+}
+
+TEST_CASE("Struct undo log capacity", "[struct]")
+{
+    GameState state(1, 0.5, Coord(2, 3), true);
+    gm::UndoLog<GameState::Change> log(2);
+    state.setTurn(log, 2);
+    state.setTurn(log, 3);
+    REQUIRE_THROWS_AS(state.setTurn(log, 4), std::length_error);
+    REQUIRE(state.turn == 3);
+}
+
+TEST_CASE("Struct Zobrist hash", "[struct]")
+{
+    Square square(1, Floor::EMPTY, false, 'a');
+    const uint64_t initial = square.hash;
+    REQUIRE(initial == square.computeHash());
+    REQUIRE(initial != Square(1, Floor::WALL, false, 'a').hash);
+    REQUIRE(initial == Square(7, Floor::EMPTY, false, 'a').hash);
+    gm::UndoLog<Square::Change> log(16);
+    size_t start = log.mark();
+    square.setFloor(log, Floor::BOX);
+    square.setLit(log, true);
+    square.setMark(log, '\xe9');
+    REQUIRE(square.hash == square.computeHash());
+    REQUIRE(square.hash == Square(1, Floor::BOX, true, '\xe9').hash);
+    square.setFloor(log, Floor::EMPTY);
+    square.setLit(log, false);
+    square.setMark(log, 'a');
+    REQUIRE(square.hash == initial);
+    square.rollback(log, start + 1);
+    REQUIRE(square.hash == Square(1, Floor::BOX, false, 'a').hash);
+    square.rollback(log, start);
+    REQUIRE(square.hash == initial);
+}
+
+TEST_CASE("Struct Zobrist hash of a default value", "[struct]")
+{
+    Square square;
+    REQUIRE(square == Square(0, Floor::EMPTY, false, '\0'));
+    REQUIRE(square.hash == square.computeHash());
+    gm::UndoLog<Square::Change> log(4);
+    square.setFloor(log, Floor::WALL);
+    REQUIRE(square.hash == Square(0, Floor::WALL, false, '\0').hash);
+    Piece piece;
+    REQUIRE(piece.hash == piece.computeHash());
+    piece.setRow(-4);
+    REQUIRE(piece.hash == piece.computeHash());
+}
+
+TEST_CASE("Struct Zobrist hash out of range", "[struct]")
+{
+    REQUIRE_THROWS_AS(Piece(Floor::WALL, 50, 0, false, 'a', 5, 5), std::out_of_range);
+    Piece piece(Floor::WALL, 0, 0, false, 'a', 5, 5);
+    const uint64_t hash = piece.hash;
+    REQUIRE_THROWS_AS(piece.setRow(100), std::out_of_range);
+    REQUIRE_THROWS_AS(piece.setCol(-1), std::out_of_range);
+    REQUIRE_THROWS_AS(piece.setId(-1), std::out_of_range);
+    REQUIRE(piece.row == 0);
+    REQUIRE(piece.hash == hash);
+    piece.row = 8;
+    REQUIRE_THROWS_AS(piece.rehash(), std::out_of_range);
+    std::istringstream input("WALL 50 0 1 a 5 5");
+    REQUIRE_THROWS_AS(input >> piece, std::out_of_range);
+}
+
+TEST_CASE("Struct Zobrist hash after decoding", "[struct]")
+{
+    Square square;
+    std::istringstream is("3 WALL 1 x");
+    is >> square;
+    REQUIRE(square.hash == Square(3, Floor::WALL, true, 'x').hash);
+    uint8_t buffer[kSquareBinSize];
+    uint8_t *out = buffer;
+    encode(out, Square(4, Floor::BOX, false, 'y'));
+    const uint8_t *in = buffer;
+    decode(in, square);
+    REQUIRE(square.hash == square.computeHash());
+    gm::Rng rng(5);
+    randomize(rng, square);
+    REQUIRE(square.hash == square.computeHash());
+}
+
+TEST_CASE("Struct diff and apply", "[struct]")
+{
+    const GameState before(1, 0.5, Coord(2, 3), true);
+    const GameState after(2, 0.5, Coord(2, 4), true);
+    auto patch = diff(before, after);
+    REQUIRE(patch.changed == ((1 << GameState::turn_f) | (1 << GameState::pos_f)));
+    GameState state = before;
+    apply(state, patch);
+    REQUIRE(state == after);
+    REQUIRE(diff(after, after).changed == 0);
+}
+
+TEST_CASE("Struct patch encoding", "[struct]")
+{
+    const Square before(1, Floor::EMPTY, false, 'a');
+    const Square after(1, Floor::BOX, false, 'b');
+    uint8_t buffer[kSquarePatchMaxBinSize];
+    uint8_t *out = buffer;
+    encode(out, diff(before, after));
+    REQUIRE(out - buffer == 1 + 4 + 1);
+    Square::Patch patch;
+    const uint8_t *in = buffer;
+    decode(in, patch);
+    REQUIRE(in == out);
+    REQUIRE(patch.has(Square::floor_f));
+    REQUIRE(!patch.has(Square::turn_f));
+    Square state = before;
+    apply(state, patch);
+    REQUIRE(state == after);
+    REQUIRE(state.hash == after.hash);
+}
+
+TEST_CASE("Struct corrupt patch", "[struct]")
+{
+    uint8_t buffer[kSquarePatchMaxBinSize] = {};
+    buffer[0] = 1 << 4;
+    Square::Patch patch;
+    const uint8_t *in = buffer;
+    REQUIRE_THROWS_AS(decode(in, patch), std::runtime_error);
+}
+
+TEST_CASE("Struct dirty fields", "[struct]")
+{
+    Stats stats(10, 1.5, "orc");
+    REQUIRE(stats.dirtyFields() == Stats::kAllFields);
+    stats.clearDirty();
+    REQUIRE(stats.dirtyFields() == 0);
+    stats.setName("troll");
+    REQUIRE(stats.isDirty(Stats::name_f));
+    REQUIRE(!stats.isDirty(Stats::hp_f));
+    REQUIRE(stats.name == "troll");
+    stats.clearDirty();
+    apply(stats, diff(stats, Stats(7, 1.5, "troll")));
+    REQUIRE(stats.dirtyFields() == (1 << Stats::hp_f));
+    stats.clearDirty();
+    std::istringstream is("3 2.5 elf");
+    is >> stats;
+    REQUIRE(stats == Stats(3, 2.5, "elf"));
+    REQUIRE(stats.dirtyFields() == Stats::kAllFields);
+}
+
+TEST_CASE("Struct dirty fields of a default value", "[struct]")
+{
+    Stats stats;
+    REQUIRE(stats.dirtyFields() == Stats::kAllFields);
+    stats.clearDirty();
+    stats.setHp(4);
+    REQUIRE(stats.dirtyFields() == (1 << Stats::hp_f));
+}
+
+TEST_CASE("Struct packed into a word", "[struct]")
+{
+    static_assert(sizeof(PlayerPacked) == sizeof(uint64_t), "packed player size");
+    PlayerPacked packed = pack(Player(100, 7));
+    REQUIRE(packed.life() == 100);
+    REQUIRE(packed.bombs() == 7);
+    REQUIRE(packed.words[0] == (100 | (7 << 7)));
+    packed.setBombs(3);
+    Player player;
+    unpack(packed, player);
+    REQUIRE(player == Player(100, 3));
+    REQUIRE(packed == pack(Player(100, 3)));
+    REQUIRE(packed != pack(Player(101, 3)));
+    REQUIRE(packed.hash() == pack(Player(100, 3)).hash());
+}
+
+TEST_CASE("Struct packed into several words", "[struct]")
+{
+    static_assert(sizeof(PiecePacked) == 2 * sizeof(uint64_t), "packed piece size");
+    const Piece piece(Floor::BOX, -4, 7, true, '\xff', 1000000000, -1000000);
+    PiecePacked packed = pack(piece);
+    REQUIRE(packed.row() == -4);
+    REQUIRE(packed.tag() == '\xff');
+    REQUIRE(packed.score() == -1000000);
+    Piece unpacked;
+    unpack(packed, unpacked);
+    REQUIRE(unpacked == piece);
+    REQUIRE(unpacked.hash == piece.hash);
+    gm::Rng rng(3);
+    for (int i = 0; i < 100; i++)
+    {
+        Piece random;
+        randomize(rng, random);
+        unpack(pack(random), unpacked);
+        if (!(unpacked == random) || random.row < -4 || random.row > 3)
+        {
+            FAIL("random piece not packed");
+        }
+    }
+}
+
+TEST_CASE("Struct packed setters check ranges", "[struct]")
+{
+    PlayerPacked player = pack(Player(100, 7));
+    REQUIRE_THROWS_AS(player.setLife(128), std::out_of_range);
+    REQUIRE_THROWS_AS(player.setBombs(-1), std::out_of_range);
+    REQUIRE(player.life() == 100);
+    REQUIRE(player.bombs() == 7);
+    PiecePacked piece;
+    REQUIRE_THROWS_AS(piece.setRow(4), std::out_of_range);
+    REQUIRE_THROWS_AS(piece.setScore(-1000001), std::out_of_range);
+    piece.setRow(-4);
+    REQUIRE(piece.row() == -4);
+}
+
+TEST_CASE("Struct Zobrist hash of integer ranges", "[struct]")
+{
+    Piece piece(Floor::WALL, 0, 0, false, 'a', 5, 5);
+    const uint64_t initial = piece.hash;
+    piece.setRow(3);
+    piece.setCol(7);
+    REQUIRE(piece.hash != initial);
+    REQUIRE(piece.hash == piece.computeHash());
+    piece.setScore(-7);
+    REQUIRE(piece.hash == Piece(Floor::WALL, 3, 7, false, 'a', 5, 5).hash);
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2017 Cyril Deguet <cyril.deguet@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+
+#include "buffer_helpers.hpp"
+#include "catch.hpp"
+#include "src/symbol.gm.hpp"
+
+TEST_CASE("Symbols are interned", "[symbol]")
+{
+    static_assert(std::is_trivially_copyable<gm::Sym>::value, "symbols are trivially copyable");
+    static_assert(sizeof(gm::Sym) == sizeof(uint32_t), "symbols are indexes");
+    const gm::Sym north("north");
+    REQUIRE(north == gm::Sym(std::string("north")));
+    REQUIRE(north != gm::Sym("south"));
+    REQUIRE(north.str() == "north");
+    REQUIRE(gm::Sym().str().empty());
+    REQUIRE(gm::Sym::intern("northern", 5) == north);
+    std::unordered_set<gm::Sym> set{north, gm::Sym("north"), gm::Sym("south")};
+    REQUIRE(set.size() == 2);
+}
+
+TEST_CASE("Symbols are interned by several threads", "[symbol]")
+{
+    const size_t before = gm::SymbolTable::instance().size();
+    std::vector<std::vector<gm::Sym>> results(4);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < results.size(); t++)
+    {
+        threads.emplace_back([t, &results]() {
+            for (int i = 0; i < 200; i++)
+            {
+                results[t].push_back(gm::Sym("thread" + std::to_string(i)));
+            }
+        });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    REQUIRE(gm::SymbolTable::instance().size() == before + 200);
+    for (size_t t = 1; t < results.size(); t++)
+    {
+        REQUIRE(results[t] == results[0]);
+    }
+    REQUIRE(results[0][17].str() == "thread17");
+}
+
+TEST_CASE("Symbol fields text", "[symbol]")
+{
+    const Route route(gm::Sym("home"), gm::Sym("work"), {gm::Sym("park")});
+    std::ostringstream os;
+    os << route;
+    REQUIRE(os.str() == "{ from: home, to: work, hops: 1 park }");
+    REQUIRE(writeBuffered(route) == os.str());
+    const char text[] = "home work 1 park";
+    Route parsed;
+    const char *cur = text;
+    readText(cur, text + sizeof(text) - 1, parsed);
+    REQUIRE(parsed == route);
+    std::istringstream is("Send home hello Quit");
+    Message send, quit;
+    is >> send >> quit;
+    REQUIRE(send == Message::Send(gm::Sym("home"), gm::Sym("hello")));
+    REQUIRE(quit == Message::Quit());
+}
+
+TEST_CASE("Symbol fields JSON", "[symbol]")
+{
+    const Route route(gm::Sym("a\"b"), gm::Sym("work"), {});
+    std::string json;
+    writeJson(json, route);
+    REQUIRE(json == "{\"from\":\"a\\\"b\",\"to\":\"work\",\"hops\":[]}");
+    Route parsed;
+    const char *cur = json.data();
+    readJson(cur, json.data() + json.size(), parsed);
+    REQUIRE(parsed == route);
+    Route::Patch patch = diff(route, Route(gm::Sym("a\"b"), gm::Sym("gym"), {}));
+    REQUIRE(patch.changed == (uint64_t(1) << Route::to_f));
+    REQUIRE(patch.to.str() == "gym");
+}